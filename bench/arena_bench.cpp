@@ -0,0 +1,118 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// The std::string builders under load from several threads at once, each
+// building batches of GGA and VTG strings as a legacy caller would. The
+// heap runs return std::string; the arena runs return NmeaArenaString from
+// the thread's arena and reset it after each batch. Compare allocs/op and
+// the per-batch p99_ns and p999_ns at each thread count.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nmea_arena.hpp"
+#include "nmea_bench.hpp"
+#include "nmea_builder.hpp"
+#include "nmea_latency_histogram.hpp"
+
+using std::string;
+using std::vector;
+
+static size_t const BATCH_SENTENCES = 256U;
+static size_t const BATCHES_PER_THREAD = 32U;
+
+struct HeapStrings
+{
+  typedef string String;
+
+  static String gga(double const seconds)
+  {
+    return build_gga(12U, 35U, seconds, 48.1173, -11.5166667, GGA_RTK_FIXED,
+                     14U, 0.8, 545.4, 46.9);
+  }
+  static String vtg(double const track) { return build_vtg(track, 6.4); }
+  static void end_batch() {}
+};
+
+struct ArenaStrings
+{
+  typedef NmeaArenaString String;
+
+  static String gga(double const seconds)
+  {
+    return build_gga(12U, 35U, seconds, 48.1173, -11.5166667, GGA_RTK_FIXED,
+                     14U, 0.8, 545.4, 46.9, NmeaArenaAllocator<char>());
+  }
+  static String vtg(double const track)
+  {
+    return build_vtg(track, 6.4, NmeaArenaAllocator<char>());
+  }
+  static void end_batch() { nmea_thread_arena().reset(); }
+};
+
+template <typename Strings>
+static void build_batches(NmeaLatencyHistogram &latency)
+{
+  typedef std::chrono::steady_clock Clock;
+  vector<typename Strings::String> sentences;
+  sentences.reserve(BATCH_SENTENCES);
+  for (size_t batch = 0U; batch < BATCHES_PER_THREAD; ++batch)
+  {
+    Clock::time_point const start = Clock::now();
+    for (size_t i = 0U; i < BATCH_SENTENCES; i += 2U)
+    {
+      double const step = static_cast<double>(i);
+      sentences.push_back(Strings::gga(step * 0.1));
+      sentences.push_back(Strings::vtg(step * 0.7));
+    }
+    nmea_bench_keep(sentences.back());
+    sentences.clear();
+    Strings::end_batch();
+    latency.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             start)
+            .count()));
+  }
+}
+
+template <typename Strings>
+static void build_under_load(NmeaBenchState &state)
+{
+  size_t const threads = static_cast<size_t>(state.arg());
+  vector<NmeaLatencyHistogram> latencies(threads);
+  while (state.keep_running())
+  {
+    vector<std::thread> workers;
+    for (size_t i = 0U; i < threads; ++i)
+    {
+      workers.push_back(
+          std::thread(build_batches<Strings>, std::ref(latencies[i])));
+    }
+    for (size_t i = 0U; i < workers.size(); ++i)
+    {
+      workers[i].join();
+    }
+  }
+  NmeaLatencyHistogram latency;
+  for (size_t i = 0U; i < threads; ++i)
+  {
+    latency.merge(latencies[i]);
+  }
+  state.set_items_per_iteration(
+      static_cast<double>(threads * BATCHES_PER_THREAD * BATCH_SENTENCES));
+  state.set_counter("p99_ns", static_cast<double>(latency.percentile(0.99)));
+  state.set_counter("p999_ns",
+                    static_cast<double>(latency.percentile(0.999)));
+}
+
+static void build_strings_heap(NmeaBenchState &state)
+{
+  build_under_load<HeapStrings>(state);
+}
+NMEA_BENCHMARK_ARGS(build_strings_heap, 1, 4, 8);
+
+static void build_strings_arena(NmeaBenchState &state)
+{
+  build_under_load<ArenaStrings>(state);
+}
+NMEA_BENCHMARK_ARGS(build_strings_arena, 1, 4, 8);
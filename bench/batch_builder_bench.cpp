@@ -0,0 +1,87 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Emitting a fleet's GGA and VTG for one epoch. build_fleet_per_sentence
+// calls build_gga and build_vtg for every unit; build_fleet_batch converts
+// the same columns with build_nmea_batch on 1, 2 and 4 threads. Items are
+// sentences, so compare items per second.
+
+#include <string>
+#include "nmea_batch_builder.hpp"
+#include "nmea_bench.hpp"
+#include "nmea_builder.hpp"
+
+using std::string;
+
+static size_t const FLEET_UNITS = 10000U;
+
+struct Fleet
+{
+  Fleet()
+  {
+    gga.reserve(FLEET_UNITS);
+    vtg.reserve(FLEET_UNITS);
+    for (size_t i = 0U; i < FLEET_UNITS; ++i)
+    {
+      double const unit = static_cast<double>(i);
+      GgaMessageData fix(123519.0 + 0.01 * static_cast<double>(i % 100U),
+                         48.1173 + unit * 1e-5, -11.5166667 - unit * 1e-5,
+                         GGA_RTK_FIXED, static_cast<uint16_t>(8U + i % 10U),
+                         0.8, 545.4 + unit * 0.001, 46.9);
+      if (0U == i % 4U)
+      {
+        fix.SetTimeSinceLastDgps(1.5);
+        fix.SetDgpsStationID(static_cast<uint16_t>(i % 1024U));
+      }
+      gga.append(fix);
+      double const track = static_cast<double>(i % 3600U) * 0.1;
+      vtg.append(VtgMessageData(track, true, track + 2.3, 12.5, 23.15));
+    }
+  }
+
+  GgaColumns gga;
+  VtgColumns vtg;
+};
+
+static Fleet const &fleet()
+{
+  static Fleet const units;
+  return units;
+}
+
+static void build_fleet_per_sentence(NmeaBenchState &state)
+{
+  Fleet const &units = fleet();
+  string output;
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  while (state.keep_running())
+  {
+    output.clear();
+    for (size_t i = 0U; i < units.gga.size(); ++i)
+    {
+      output.append(buffer,
+                    build_gga(buffer, sizeof(buffer), units.gga.row(i)));
+      output.append(buffer,
+                    build_vtg(buffer, sizeof(buffer), units.vtg.row(i)));
+    }
+    nmea_bench_keep(output);
+  }
+  state.set_items_per_iteration(2.0 * static_cast<double>(FLEET_UNITS));
+  state.set_bytes_per_iteration(static_cast<double>(output.size()));
+}
+NMEA_BENCHMARK(build_fleet_per_sentence);
+
+static void build_fleet_batch(NmeaBenchState &state)
+{
+  Fleet const &units = fleet();
+  unsigned const threads = static_cast<unsigned>(state.arg());
+  string output;
+  while (state.keep_running())
+  {
+    output.clear();
+    build_nmea_batch(units.gga, &units.vtg, output, threads);
+    nmea_bench_keep(output);
+  }
+  state.set_items_per_iteration(2.0 * static_cast<double>(FLEET_UNITS));
+  state.set_bytes_per_iteration(static_cast<double>(output.size()));
+}
+NMEA_BENCHMARK_ARGS(build_fleet_batch, 1, 2, 4);
@@ -0,0 +1,75 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <string>
+#include "nmea_bench.hpp"
+#include "nmea_builder.hpp"
+
+using std::string;
+
+static void build_gga_string(NmeaBenchState &state)
+{
+  double seconds = 0.0;
+  size_t bytes = 0U;
+  while (state.keep_running())
+  {
+    string const sentence(build_gga(12U, 35U, seconds, 48.1173, -11.5166667,
+                                    GGA_RTK_FIXED, 14U, 0.8, 545.4, 46.9));
+    bytes += sentence.length();
+    seconds = 59.9 < seconds ? 0.0 : seconds + 0.1;
+  }
+  state.set_bytes_per_iteration(static_cast<double>(bytes) /
+                                static_cast<double>(state.iterations()));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(build_gga_string);
+
+static void build_gga_buffer(NmeaBenchState &state)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  double seconds = 0.0;
+  size_t bytes = 0U;
+  while (state.keep_running())
+  {
+    bytes += build_gga(buffer, sizeof(buffer), 12U, 35U, seconds, 48.1173,
+                       -11.5166667, GGA_RTK_FIXED, 14U, 0.8, 545.4, 46.9);
+    nmea_bench_keep(buffer);
+    seconds = 59.9 < seconds ? 0.0 : seconds + 0.1;
+  }
+  state.set_bytes_per_iteration(static_cast<double>(bytes) /
+                                static_cast<double>(state.iterations()));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(build_gga_buffer);
+
+static void build_vtg_string(NmeaBenchState &state)
+{
+  double track = 0.0;
+  size_t bytes = 0U;
+  while (state.keep_running())
+  {
+    string const sentence(build_vtg(track, 12.5));
+    bytes += sentence.length();
+    track = 359.0 < track ? 0.0 : track + 0.7;
+  }
+  state.set_bytes_per_iteration(static_cast<double>(bytes) /
+                                static_cast<double>(state.iterations()));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(build_vtg_string);
+
+static void build_vtg_buffer(NmeaBenchState &state)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  double track = 0.0;
+  size_t bytes = 0U;
+  while (state.keep_running())
+  {
+    bytes += build_vtg(buffer, sizeof(buffer), track, 12.5);
+    nmea_bench_keep(buffer);
+    track = 359.0 < track ? 0.0 : track + 0.7;
+  }
+  state.set_bytes_per_iteration(static_cast<double>(bytes) /
+                                static_cast<double>(state.iterations()));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(build_vtg_buffer);
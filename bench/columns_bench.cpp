@@ -0,0 +1,90 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <vector>
+#include "gga_columns.hpp"
+#include "nmea_bench.hpp"
+
+using std::vector;
+
+static size_t const FIXES = 1U << 20;
+
+static vector<GgaMessageData> const &fix_records()
+{
+  static vector<GgaMessageData> records;
+  if (records.empty())
+  {
+    records.reserve(FIXES);
+    for (size_t i = 0U; i < FIXES; ++i)
+    {
+      double const wobble = static_cast<double>(i % 97U) / 97.0;
+      records.push_back(GgaMessageData(
+          static_cast<double>(i), 37.0 + wobble, -122.0 - wobble,
+          0U == i % 3U ? GGA_RTK_FIXED : GGA_GPS,
+          static_cast<uint16_t>(8U + i % 10U), 0.5 + wobble, 10.0, -32.0));
+    }
+  }
+  return records;
+}
+
+static GgaColumns const &fix_columns()
+{
+  static GgaColumns columns;
+  if (0U == columns.size())
+  {
+    columns.reserve(FIXES);
+    for (size_t i = 0U; i < FIXES; ++i)
+    {
+      columns.append(fix_records()[i]);
+    }
+  }
+  return columns;
+}
+
+// Mean latitude of RTK fixed fixes with hdop below 1.
+static void scan_records(NmeaBenchState &state)
+{
+  vector<GgaMessageData> const &records = fix_records();
+  while (state.keep_running())
+  {
+    double sum = 0.0;
+    size_t count = 0U;
+    for (size_t i = 0U; i < records.size(); ++i)
+    {
+      bool const selected =
+          GGA_RTK_FIXED == records[i].fixQuality && 1.0 > records[i].hdop;
+      sum += selected ? records[i].latitude : 0.0;
+      count += selected ? 1U : 0U;
+    }
+    double const mean = sum / static_cast<double>(count);
+    nmea_bench_keep(mean);
+  }
+  state.set_items_per_iteration(static_cast<double>(records.size()));
+  state.set_counter("bytes_per_fix", sizeof(GgaMessageData));
+}
+NMEA_BENCHMARK(scan_records);
+
+static void scan_columns(NmeaBenchState &state)
+{
+  GgaColumns const &columns = fix_columns();
+  uint8_t const *const quality = columns.fixQuality.data();
+  double const *const hdop = columns.hdop.data();
+  double const *const latitude = columns.latitude.data();
+  size_t const rows = columns.size();
+  while (state.keep_running())
+  {
+    double sum = 0.0;
+    size_t count = 0U;
+    for (size_t i = 0U; i < rows; ++i)
+    {
+      bool const selected = GGA_RTK_FIXED == quality[i] && 1.0 > hdop[i];
+      sum += selected ? latitude[i] : 0.0;
+      count += selected ? 1U : 0U;
+    }
+    double const mean = sum / static_cast<double>(count);
+    nmea_bench_keep(mean);
+  }
+  state.set_items_per_iteration(static_cast<double>(rows));
+  state.set_counter("bytes_per_fix", static_cast<double>(columns.memory_bytes()) /
+                                         static_cast<double>(rows));
+}
+NMEA_BENCHMARK(scan_columns);
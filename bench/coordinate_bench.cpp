@@ -0,0 +1,170 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Coordinate codec against the floating point conversions it replaced, which
+// are kept here as the baseline: three parses and a power of ten per angle
+// in, floor and a fixed point print of the minute fraction out.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_coordinate.hpp"
+#include "nmea_format.hpp"
+
+using std::string;
+using std::vector;
+
+static vector<string> const &angle_texts()
+{
+  static vector<string> texts;
+  if (texts.empty())
+  {
+    std::mt19937_64 generator(14U);
+    std::uniform_int_distribution<int64_t> angle(
+        0, 180 * NMEA_NANO_MINUTES_PER_DEGREE - 1);
+    for (size_t i = 0U; i < 1024U; ++i)
+    {
+      char text[NMEA_COORDINATE_BUFFER_LENGTH];
+      texts.push_back(string(
+          text, nmea_format_nano_minutes(angle(generator), 3U, 8U, text)));
+    }
+  }
+  return texts;
+}
+
+static vector<double> const &angle_degrees()
+{
+  static vector<double> degrees;
+  if (degrees.empty())
+  {
+    vector<string> const &texts = angle_texts();
+    for (size_t i = 0U; i < texts.size(); ++i)
+    {
+      int64_t nano_minutes = 0;
+      nmea_parse_nano_minutes(texts[i].data(), texts[i].length(),
+                              nano_minutes);
+      degrees.push_back(nmea_nano_minutes_to_degrees(nano_minutes));
+    }
+  }
+  return degrees;
+}
+
+static double mean_length(vector<string> const &texts)
+{
+  double total = 0.0;
+  for (size_t i = 0U; i < texts.size(); ++i)
+  {
+    total += static_cast<double>(texts[i].length());
+  }
+  return total / static_cast<double>(texts.size());
+}
+
+static double floating_parse(string const &text)
+{
+  size_t const period = text.find('.');
+  double const degrees = std::strtod(text.substr(0U, period - 2U).c_str(), 0);
+  double const minutes = std::strtod(text.substr(period - 2U, 2U).c_str(), 0);
+  string const fraction(text.substr(period + 1U));
+  double const decimals =
+      std::strtod(fraction.c_str(), 0) /
+      std::pow(10.0, static_cast<double>(fraction.length()));
+  return degrees + (minutes + decimals) / 60.0;
+}
+
+static size_t floating_format(double const angle_degrees, char *const output)
+{
+  double const magnitude = std::fabs(angle_degrees);
+  double minutes = (magnitude - std::floor(magnitude)) * 60.0;
+  int32_t const whole_minutes = static_cast<int32_t>(std::floor(minutes));
+  minutes -= std::floor(minutes);
+  char fraction[NMEA_NUMBER_BUFFER_LENGTH];
+  size_t const fraction_length = format_fixed(minutes, 8, fraction);
+  uint32_t const whole =
+      static_cast<uint32_t>(std::floor(magnitude)) * 100U +
+      static_cast<uint32_t>(whole_minutes);
+  size_t length = 0U;
+  for (uint32_t divisor = 10000U; 0U != divisor; divisor /= 10U)
+  {
+    output[length++] = static_cast<char>('0' + whole / divisor % 10U);
+  }
+  memcpy(output + length, fraction + 1, fraction_length - 1U);
+  return length + fraction_length - 1U;
+}
+
+static void parse_angle_floating(NmeaBenchState &state)
+{
+  vector<string> const &texts = angle_texts();
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    nmea_bench_keep(floating_parse(texts[i++ % texts.size()]));
+  }
+  state.set_bytes_per_iteration(mean_length(texts));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_angle_floating);
+
+static void parse_angle_fixed(NmeaBenchState &state)
+{
+  vector<string> const &texts = angle_texts();
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &text = texts[i++ % texts.size()];
+    int64_t nano_minutes = 0;
+    nmea_parse_nano_minutes(text.data(), text.length(), nano_minutes);
+    nmea_bench_keep(nmea_nano_minutes_to_degrees(nano_minutes));
+  }
+  state.set_bytes_per_iteration(mean_length(texts));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_angle_fixed);
+
+static void format_angle_floating(NmeaBenchState &state)
+{
+  vector<double> const &degrees = angle_degrees();
+  char text[NMEA_COORDINATE_BUFFER_LENGTH];
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    nmea_bench_keep(floating_format(degrees[i++ % degrees.size()], text));
+    nmea_bench_keep(text);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(format_angle_floating);
+
+static void format_angle_fixed(NmeaBenchState &state)
+{
+  vector<double> const &degrees = angle_degrees();
+  char text[NMEA_COORDINATE_BUFFER_LENGTH];
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    int64_t const nano_minutes =
+        nmea_degrees_to_nano_minutes(degrees[i++ % degrees.size()], 8U);
+    nmea_bench_keep(nmea_format_nano_minutes(nano_minutes, 3U, 8U, text));
+    nmea_bench_keep(text);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(format_angle_fixed);
+
+// The digit kernel alone.
+static void parse_eight_digits(NmeaBenchState &state)
+{
+  static char const DIGITS[] = "8267305139";
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    uint32_t value = 0U;
+    nmea_parse_eight_digits(DIGITS + (i++ & 1U), value);
+    nmea_bench_keep(value);
+  }
+  state.set_bytes_per_iteration(8.0);
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_eight_digits);
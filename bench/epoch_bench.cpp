@@ -0,0 +1,65 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// A 100 Hz receiver: GGA, VTG and AVR every 10 ms joined into 10 ms epochs.
+// Items are input messages; epochs_per_message should stay at 1/3. The
+// second run uses one-second epochs, where the 99 sets after the first of
+// each second are turned away.
+
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_epoch_assembler.hpp"
+
+using std::vector;
+
+static vector<NmeaMessage> hundred_hertz_input(size_t const seconds)
+{
+  vector<NmeaMessage> messages;
+  messages.reserve(seconds * 300U);
+  for (size_t i = 0U; i < seconds * 100U; ++i)
+  {
+    double const second = static_cast<double>(i / 100U % 60U);
+    double const minute = static_cast<double>(i / 6000U % 60U);
+    double const timestamp = 120000.0 + minute * 100.0 + second +
+                             0.01 * static_cast<double>(i % 100U);
+    double const track = static_cast<double>(i % 3600U) * 0.1;
+    messages.push_back(NmeaMessage(
+        GgaMessageData(timestamp, 48.1173, 11.5166667, GGA_RTK_FIXED, 14U, 0.8,
+                       545.4, 46.9)));
+    messages.push_back(
+        NmeaMessage(VtgMessageData(track, false, 0.0, 12.5, 23.15)));
+    messages.push_back(NmeaMessage(AvrMessageData(timestamp, track, 0.2, 1.5,
+                                                  AVR_RTK_FIXED, 1.8, 14U)));
+  }
+  return messages;
+}
+
+static void epoch_assemble(NmeaBenchState &state)
+{
+  static vector<NmeaMessage> const messages(hundred_hertz_input(60U));
+  NmeaEpochAssemblerConfig config;
+  config.periodMs = static_cast<uint32_t>(state.arg());
+  config.timeoutMs = 3U * config.periodMs;
+  NmeaEpochAssembler assembler(config);
+  NmeaNavigationEpoch epoch;
+  uint64_t epochs = 0U;
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < messages.size(); ++i)
+    {
+      assembler.add(messages[i]);
+      while (assembler.next(epoch))
+      {
+        ++epochs;
+        nmea_bench_keep(epoch);
+      }
+    }
+    assembler.flush();
+    assembler.reset();
+  }
+  double const count = static_cast<double>(messages.size());
+  state.set_items_per_iteration(count);
+  state.set_counter("epochs_per_message",
+                    static_cast<double>(epochs) /
+                        static_cast<double>(state.iterations()) / count);
+}
+NMEA_BENCHMARK_ARGS(epoch_assemble, 10, 1000);
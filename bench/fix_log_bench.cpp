@@ -0,0 +1,140 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Fix log against re-parsing text. fix_log_reparse_gga and
+// fix_log_decode_gga turn the same GGA fixes into GgaMessageData, from the
+// text and from a mapped fix log; compare their ns per item. stored_bytes
+// is what one GGA costs on disk in each form. fix_log_convert writes the
+// fix log from the mixed text log and reports the size ratio.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_fix_log.hpp"
+#include "nmea_stream_framer.hpp"
+
+using std::string;
+using std::vector;
+
+struct FixLogFiles
+{
+  FixLogFiles()
+      : textPath(string(P_tmpdir) + "/nmea_fix_log_bench.nmea")
+      , fixPath(string(P_tmpdir) + "/nmea_fix_log_bench.nfx")
+      , text(generate_nmea_log(4U << 20, 31U))
+      , ggaBytes(0U)
+  {
+    {
+      std::ofstream file(textPath.c_str(), std::ios::binary);
+      file << text;
+    }
+    nmea_fix_log_convert(textPath, fixPath, conversion);
+    size_t start = 0U;
+    size_t end = 0U;
+    while (string::npos != (end = text.find('\n', start)))
+    {
+      size_t const length = end - start;
+      if (NMEA_GGA == identify_nmea(text.data() + start, length))
+      {
+        gga.push_back(NmeaSentence());
+        gga.back().data = text.data() + start;
+        gga.back().length = length;
+        ggaBytes += length + 1U;
+      }
+      start = end + 1U;
+    }
+  }
+
+  ~FixLogFiles()
+  {
+    remove(textPath.c_str());
+    remove(fixPath.c_str());
+  }
+
+  string const textPath;
+  string const fixPath;
+  string const text;
+  NmeaFixLogConversion conversion;
+  vector<NmeaSentence> gga;
+  size_t ggaBytes;
+};
+
+static FixLogFiles const &fix_log_files()
+{
+  static FixLogFiles const files;
+  return files;
+}
+
+static void fix_log_reparse_gga(NmeaBenchState &state)
+{
+  FixLogFiles const &files = fix_log_files();
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < files.gga.size(); ++i)
+    {
+      GgaMessageData const gga(
+          parse_gga(files.gga[i].data, files.gga[i].length));
+      nmea_bench_keep(gga);
+    }
+  }
+  double const count = static_cast<double>(files.gga.size());
+  state.set_items_per_iteration(count);
+  state.set_bytes_per_iteration(static_cast<double>(files.ggaBytes));
+  state.set_counter("stored_bytes",
+                    static_cast<double>(files.ggaBytes) / count);
+}
+NMEA_BENCHMARK(fix_log_reparse_gga);
+
+static void fix_log_decode_gga(NmeaBenchState &state)
+{
+  FixLogFiles const &files = fix_log_files();
+  NmeaFixLogReader reader;
+  reader.open(files.fixPath);
+  double gga_bytes = 0.0;
+  for (size_t b = 0U; b < reader.blocks(); ++b)
+  {
+    gga_bytes += nullptr == reader.gga(b)
+                     ? 0.0
+                     : static_cast<double>(sizeof(NmeaFixBlockHeader) +
+                                           reader.block(b).count *
+                                               sizeof(NmeaFixGgaRecord));
+  }
+  while (state.keep_running())
+  {
+    for (size_t b = 0U; b < reader.blocks(); ++b)
+    {
+      NmeaFixBlockHeader const &block = reader.block(b);
+      NmeaFixGgaRecord const *const records = reader.gga(b);
+      for (uint32_t i = 0U; nullptr != records && i < block.count; ++i)
+      {
+        GgaMessageData const gga(nmea_fix_decode(block, records[i]));
+        nmea_bench_keep(gga);
+      }
+    }
+  }
+  double const count = static_cast<double>(reader.count(NMEA_GGA));
+  state.set_items_per_iteration(count);
+  state.set_bytes_per_iteration(gga_bytes);
+  state.set_counter("stored_bytes", gga_bytes / count);
+}
+NMEA_BENCHMARK(fix_log_decode_gga);
+
+static void fix_log_convert(NmeaBenchState &state)
+{
+  FixLogFiles const &files = fix_log_files();
+  string const path(files.fixPath + ".convert");
+  NmeaFixLogConversion conversion;
+  while (state.keep_running())
+  {
+    nmea_fix_log_convert(files.textPath, path, conversion);
+    nmea_bench_keep(conversion);
+  }
+  remove(path.c_str());
+  state.set_items_per_iteration(static_cast<double>(conversion.sentences));
+  state.set_bytes_per_iteration(static_cast<double>(conversion.textBytes));
+  state.set_counter("size_ratio", static_cast<double>(conversion.fixBytes) /
+                                      static_cast<double>(conversion.textBytes));
+}
+NMEA_BENCHMARK(fix_log_convert);
@@ -0,0 +1,211 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// "RTK fixed with hdop below 1 inside a box during an afternoon" over a
+// survey drive: 10 Hz east-west passes of 6000 fixes, each a little north
+// of the last. query_records is the loop ops tooling runs, over
+// std::vector<GgaMessageData> collecting the rows; the others go through
+// NmeaFixIndex, with query_scalar testing every row one at a time. The
+// argument is the number of fixes; the records and the columns take about
+// 150 bytes a fix together, so a run at 100M fixes needs over 15 GB.
+
+#include <random>
+#include <vector>
+#include "gga_columns.hpp"
+#include "nmea_bench.hpp"
+#include "nmea_fix_query.hpp"
+
+using std::vector;
+
+static size_t const PASS_FIXES = 6000U;
+static double const PASS_DEGREES = 0.06;
+static double const PASS_SPACING = 2e-4;
+
+struct SurveyDrive
+{
+  explicit SurveyDrive(size_t const count)
+  {
+    std::mt19937 generator(13U);
+    std::uniform_real_distribution<double> noise(-1e-6, 1e-6);
+    std::uniform_real_distribution<double> hdop(0.6, 1.6);
+    GgaFixQuality const qualities[] = {GGA_RTK_FIXED, GGA_RTK_FIXED,
+                                       GGA_RTK_FLOAT, GGA_DGPS};
+    records.reserve(count);
+    columns.reserve(count);
+    for (size_t i = 0U; i < count; ++i)
+    {
+      size_t const pass = i / PASS_FIXES;
+      double const along = static_cast<double>(i % PASS_FIXES) /
+                           static_cast<double>(PASS_FIXES) * PASS_DEGREES;
+      size_t const tenths = i % 864000U;
+      double const timestamp =
+          static_cast<double>(tenths / 36000U) * 10000.0 +
+          static_cast<double>(tenths / 600U % 60U) * 100.0 +
+          static_cast<double>(tenths % 600U) / 10.0;
+      records.push_back(GgaMessageData(
+          timestamp, 37.0 + static_cast<double>(pass) * PASS_SPACING +
+                         noise(generator),
+          -122.0 + (0U == pass % 2U ? along : PASS_DEGREES - along) +
+              noise(generator),
+          qualities[i / 500U % 4U], static_cast<uint16_t>(9U + i / 200U % 8U),
+          hdop(generator), 10.0, -32.0));
+      columns.append(records.back());
+    }
+    // The middle of the surveyed area, a fifth of it each way.
+    double const north =
+        static_cast<double>(count / PASS_FIXES) * PASS_SPACING;
+    query.fixQualities = nmea_fix_quality_bit(GGA_RTK_FIXED);
+    query.hdopBelow = 1.0;
+    query.minLatitude = 37.0 + 0.4 * north;
+    query.maxLatitude = 37.0 + 0.6 * north;
+    query.minLongitude = -122.0 + 0.4 * PASS_DEGREES;
+    query.maxLongitude = -122.0 + 0.6 * PASS_DEGREES;
+    query.minTimestamp = 120000.0;
+    query.maxTimestamp = 180000.0;
+  }
+
+  vector<GgaMessageData> records;
+  GgaColumns columns;
+  NmeaFixQuery query;
+};
+
+// One drive at a time, rebuilt when the argument changes.
+static SurveyDrive const &survey(size_t const count)
+{
+  static SurveyDrive *drive = nullptr;
+  if (nullptr == drive || count != drive->records.size())
+  {
+    delete drive;
+    drive = new SurveyDrive(count);
+  }
+  return *drive;
+}
+
+static void finish(NmeaBenchState &state, size_t const fixes,
+                   size_t const selected)
+{
+  state.set_items_per_iteration(static_cast<double>(fixes));
+  state.set_counter("selected", static_cast<double>(selected));
+}
+
+static void query_records(NmeaBenchState &state)
+{
+  SurveyDrive const &drive = survey(static_cast<size_t>(state.arg()));
+  vector<GgaMessageData> const &records = drive.records;
+  NmeaFixQuery const &query = drive.query;
+  vector<size_t> rows;
+  while (state.keep_running())
+  {
+    rows.clear();
+    for (size_t i = 0U; i < records.size(); ++i)
+    {
+      GgaMessageData const &fix = records[i];
+      if (GGA_RTK_FIXED == fix.fixQuality && query.hdopBelow > fix.hdop &&
+          query.minLatitude <= fix.latitude &&
+          query.maxLatitude >= fix.latitude &&
+          query.minLongitude <= fix.longitude &&
+          query.maxLongitude >= fix.longitude &&
+          query.minTimestamp <= fix.timestamp &&
+          query.maxTimestamp >= fix.timestamp)
+      {
+        rows.push_back(i);
+      }
+    }
+    nmea_bench_keep(rows.data());
+  }
+  finish(state, records.size(), rows.size());
+}
+NMEA_BENCHMARK_ARGS(query_records, 1 << 22);
+
+static void query_scalar(NmeaBenchState &state)
+{
+  SurveyDrive const &drive = survey(static_cast<size_t>(state.arg()));
+  NmeaFixIndex const index(drive.columns);
+  vector<uint64_t> bitmap;
+  size_t selected = 0U;
+  while (state.keep_running())
+  {
+    selected = index.select_scalar(drive.query, bitmap);
+    nmea_bench_keep(bitmap.data());
+  }
+  finish(state, drive.columns.size(), selected);
+}
+NMEA_BENCHMARK_ARGS(query_scalar, 1 << 22);
+
+static void query_index_bitmap(NmeaBenchState &state)
+{
+  SurveyDrive const &drive = survey(static_cast<size_t>(state.arg()));
+  NmeaFixIndex const index(drive.columns);
+  vector<uint64_t> bitmap;
+  size_t selected = 0U;
+  while (state.keep_running())
+  {
+    selected = index.select(drive.query, bitmap);
+    nmea_bench_keep(bitmap.data());
+  }
+  finish(state, drive.columns.size(), selected);
+  state.set_counter("candidate_tiles",
+                    static_cast<double>(index.candidate_tiles(drive.query)));
+  state.set_counter("tiles", static_cast<double>(index.tiles().size()));
+}
+NMEA_BENCHMARK_ARGS(query_index_bitmap, 1 << 22);
+
+static void query_index_rows(NmeaBenchState &state)
+{
+  SurveyDrive const &drive = survey(static_cast<size_t>(state.arg()));
+  NmeaFixIndex const index(drive.columns);
+  vector<size_t> rows;
+  size_t selected = 0U;
+  while (state.keep_running())
+  {
+    selected = index.select_rows(drive.query, rows);
+    nmea_bench_keep(rows.data());
+  }
+  finish(state, drive.columns.size(), selected);
+}
+NMEA_BENCHMARK_ARGS(query_index_rows, 1 << 22);
+
+// No box or time: the quality and hdop conditions alone, so almost every
+// tile is scanned and the filters do the work.
+static void query_index_quality(NmeaBenchState &state)
+{
+  SurveyDrive const &drive = survey(static_cast<size_t>(state.arg()));
+  NmeaFixIndex const index(drive.columns);
+  NmeaFixQuery query;
+  query.fixQualities = nmea_fix_quality_bit(GGA_RTK_FIXED);
+  query.hdopBelow = 1.0;
+  vector<uint64_t> bitmap;
+  size_t selected = 0U;
+  while (state.keep_running())
+  {
+    selected = index.select(query, bitmap);
+    nmea_bench_keep(bitmap.data());
+  }
+  finish(state, drive.columns.size(), selected);
+}
+NMEA_BENCHMARK_ARGS(query_index_quality, 1 << 22);
+
+// The box as a geofence polygon, a diamond inside it.
+static void query_index_fence(NmeaBenchState &state)
+{
+  SurveyDrive const &drive = survey(static_cast<size_t>(state.arg()));
+  NmeaFixIndex const index(drive.columns);
+  NmeaFixQuery query = drive.query;
+  double const middle_latitude = 0.5 * (query.minLatitude + query.maxLatitude);
+  double const middle_longitude =
+      0.5 * (query.minLongitude + query.maxLongitude);
+  double const latitudes[] = {query.minLatitude, middle_latitude,
+                              query.maxLatitude, middle_latitude};
+  double const longitudes[] = {middle_longitude, query.maxLongitude,
+                               middle_longitude, query.minLongitude};
+  query.fenceLatitudes.assign(latitudes, latitudes + 4);
+  query.fenceLongitudes.assign(longitudes, longitudes + 4);
+  vector<uint64_t> bitmap;
+  size_t selected = 0U;
+  while (state.keep_running())
+  {
+    selected = index.select(query, bitmap);
+    nmea_bench_keep(bitmap.data());
+  }
+  finish(state, drive.columns.size(), selected);
+}
+NMEA_BENCHMARK_ARGS(query_index_fence, 1 << 22);
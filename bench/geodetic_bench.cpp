@@ -0,0 +1,117 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Converting a replayed log's GGA fixes, parsed into GgaColumns, to ECEF or
+// to ENU around the first fix. enu_per_fix is the usual consumer: a fresh
+// frame, and so the origin's trigonometry, for every fix. enu_scalar keeps
+// one NmeaLocalFrame but stays scalar; gga_to_ecef and gga_to_enu are the
+// batch stages. Bytes are the 56 each fix reads and writes.
+
+#include <vector>
+#include "gga_columns.hpp"
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_geodetic.hpp"
+
+static size_t const EPOCHS = 1U << 16;
+static double const BYTES_PER_FIX = 7.0 * sizeof(double);
+
+static GgaColumns const &replayed_fixes()
+{
+  static GgaColumns columns;
+  if (0U == columns.size())
+  {
+    NmeaCorpus const corpus = generate_nmea_corpus(EPOCHS, 5U);
+    columns.reserve(corpus.gga.size());
+    for (size_t i = 0U; i < corpus.gga.size(); ++i)
+    {
+      columns.append(parse_gga(corpus.gga[i]));
+    }
+  }
+  return columns;
+}
+
+static NmeaLocalFrame first_fix_frame(GgaColumns const &fixes)
+{
+  return NmeaLocalFrame(fixes.latitude[0], fixes.longitude[0],
+                        fixes.altitude[0] + fixes.geoidHeight[0]);
+}
+
+static void finish(NmeaBenchState &state, size_t const fixes)
+{
+  state.set_items_per_iteration(static_cast<double>(fixes));
+  state.set_bytes_per_iteration(static_cast<double>(fixes) * BYTES_PER_FIX);
+}
+
+static void geodetic_enu_per_fix(NmeaBenchState &state)
+{
+  GgaColumns const &fixes = replayed_fixes();
+  NmeaCartesianColumns enu;
+  enu.resize(fixes.size());
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < fixes.size(); ++i)
+    {
+      NmeaLocalFrame const frame(first_fix_frame(fixes));
+      double x = 0.0;
+      double y = 0.0;
+      double z = 0.0;
+      nmea_geodetic_to_ecef(fixes.latitude[i], fixes.longitude[i],
+                            fixes.altitude[i] + fixes.geoidHeight[i], x, y,
+                            z);
+      frame.ecef_to_enu(x, y, z, enu.x[i], enu.y[i], enu.z[i]);
+    }
+    nmea_bench_keep(enu.x.data());
+  }
+  finish(state, fixes.size());
+}
+NMEA_BENCHMARK(geodetic_enu_per_fix);
+
+static void geodetic_enu_scalar(NmeaBenchState &state)
+{
+  GgaColumns const &fixes = replayed_fixes();
+  NmeaLocalFrame const frame(first_fix_frame(fixes));
+  NmeaCartesianColumns enu;
+  enu.resize(fixes.size());
+  std::vector<double> heights(fixes.size());
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < fixes.size(); ++i)
+    {
+      heights[i] = fixes.altitude[i] + fixes.geoidHeight[i];
+    }
+    nmea_geodetic_to_enu_scalar(fixes.latitude.data(),
+                                fixes.longitude.data(), heights.data(),
+                                fixes.size(), frame, enu.x.data(),
+                                enu.y.data(), enu.z.data());
+    nmea_bench_keep(enu.x.data());
+  }
+  finish(state, fixes.size());
+}
+NMEA_BENCHMARK(geodetic_enu_scalar);
+
+static void geodetic_gga_to_ecef(NmeaBenchState &state)
+{
+  GgaColumns const &fixes = replayed_fixes();
+  NmeaCartesianColumns ecef;
+  while (state.keep_running())
+  {
+    nmea_gga_to_ecef(fixes, ecef);
+    nmea_bench_keep(ecef.x.data());
+  }
+  finish(state, fixes.size());
+}
+NMEA_BENCHMARK(geodetic_gga_to_ecef);
+
+static void geodetic_gga_to_enu(NmeaBenchState &state)
+{
+  GgaColumns const &fixes = replayed_fixes();
+  NmeaLocalFrame const frame(first_fix_frame(fixes));
+  NmeaCartesianColumns enu;
+  while (state.keep_running())
+  {
+    nmea_gga_to_enu(fixes, frame, enu);
+    nmea_bench_keep(enu.x.data());
+  }
+  finish(state, fixes.size());
+}
+NMEA_BENCHMARK(geodetic_gga_to_enu);
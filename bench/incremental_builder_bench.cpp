@@ -0,0 +1,115 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// One emulated receiver's GGA and VTG at 10 Hz along a drive: the time,
+// position, altitude, track and speed move every epoch, the satellite count
+// and hdop every few seconds. trajectory_full calls build_gga and build_vtg
+// each epoch; trajectory_incremental feeds the same epochs to
+// GgaIncrementalBuilder and VtgIncrementalBuilder. Items are sentences.
+
+#include <cmath>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_builder.hpp"
+#include "nmea_incremental_builder.hpp"
+
+// An hour of epochs.
+static size_t const EPOCH_COUNT = 36000U;
+static double const METERS_PER_DEGREE = 111320.0;
+
+struct Epoch
+{
+  uint8_t hour;
+  uint8_t minute;
+  double seconds;
+  double latitude;
+  double longitude;
+  uint16_t satellites;
+  double hdop;
+  double altitude;
+  double track;
+  double speed;
+};
+
+static std::vector<Epoch> const &drive()
+{
+  static std::vector<Epoch> epochs;
+  if (epochs.empty())
+  {
+    double const pi = std::acos(-1.0);
+    double latitude = 48.1173;
+    double longitude = 11.5166667;
+    for (size_t i = 0U; i < EPOCH_COUNT; ++i)
+    {
+      double const t = static_cast<double>(i) * 0.1;
+      Epoch epoch;
+      epoch.hour = static_cast<uint8_t>(12U + i / 36000U);
+      epoch.minute = static_cast<uint8_t>(i / 600U % 60U);
+      epoch.seconds = static_cast<double>(i % 600U) / 10.0;
+      epoch.speed = 14.0 + 3.0 * std::sin(t / 40.0);
+      epoch.track = std::fmod(90.0 + 0.5 * t, 360.0);
+      double const heading = epoch.track * pi / 180.0;
+      latitude += epoch.speed * 0.1 * std::cos(heading) / METERS_PER_DEGREE;
+      longitude += epoch.speed * 0.1 * std::sin(heading) /
+                   (METERS_PER_DEGREE * std::cos(latitude * pi / 180.0));
+      epoch.latitude = latitude;
+      epoch.longitude = longitude;
+      epoch.satellites = static_cast<uint16_t>(10U + i / 150U % 4U);
+      epoch.hdop = 0.7 + 0.1 * static_cast<double>(i / 200U % 3U);
+      epoch.altitude = 520.0 + 5.0 * std::sin(t / 60.0);
+      epochs.push_back(epoch);
+    }
+  }
+  return epochs;
+}
+
+static void trajectory_full(NmeaBenchState &state)
+{
+  std::vector<Epoch> const &epochs = drive();
+  char gga[NMEA_MAX_BUILD_LENGTH];
+  char vtg[NMEA_MAX_BUILD_LENGTH];
+  size_t bytes = 0U;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    Epoch const &epoch = epochs[i];
+    bytes += build_gga(gga, sizeof(gga), epoch.hour, epoch.minute,
+                       epoch.seconds, epoch.latitude, epoch.longitude,
+                       GGA_RTK_FIXED, epoch.satellites, epoch.hdop,
+                       epoch.altitude, 46.9);
+    bytes += build_vtg(vtg, sizeof(vtg), epoch.track, epoch.speed);
+    nmea_bench_keep(gga);
+    nmea_bench_keep(vtg);
+    i = epochs.size() == i + 1U ? 0U : i + 1U;
+  }
+  state.set_bytes_per_iteration(static_cast<double>(bytes) /
+                                static_cast<double>(state.iterations()));
+  state.set_items_per_iteration(2.0);
+}
+NMEA_BENCHMARK(trajectory_full);
+
+static void trajectory_incremental(NmeaBenchState &state)
+{
+  std::vector<Epoch> const &epochs = drive();
+  GgaIncrementalBuilder gga;
+  VtgIncrementalBuilder vtg;
+  size_t bytes = 0U;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    Epoch const &epoch = epochs[i];
+    bytes += gga.build(epoch.hour, epoch.minute, epoch.seconds,
+                       epoch.latitude, epoch.longitude, GGA_RTK_FIXED,
+                       epoch.satellites, epoch.hdop, epoch.altitude, 46.9);
+    bytes += vtg.build(epoch.track, epoch.speed);
+    nmea_bench_keep(gga.data());
+    nmea_bench_keep(vtg.data());
+    i = epochs.size() == i + 1U ? 0U : i + 1U;
+  }
+  state.set_bytes_per_iteration(static_cast<double>(bytes) /
+                                static_cast<double>(state.iterations()));
+  state.set_items_per_iteration(2.0);
+  state.set_counter("full_builds",
+                    static_cast<double>(gga.fullBuilds() + vtg.fullBuilds()) /
+                        static_cast<double>(state.iterations()));
+}
+NMEA_BENCHMARK(trajectory_incremental);
@@ -0,0 +1,122 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// NmeaIngestEngine draining 1, 8 and 32 ports at once. Each port is a Unix
+// socket pair fed 64 KiB of log per iteration by one writer thread, which
+// stands in for the devices; the engine runs on the benchmark thread. The
+// per port rate is sustained throughput, and engine_cpu is the engine
+// thread's CPU time over wall time, so about 1.0 means it was the bottleneck
+// and lower means it spent the rest waiting for input.
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_ingest.hpp"
+
+using std::string;
+using std::vector;
+
+static size_t const PORT_BYTES = 64U << 10;
+static size_t const WRITE_BYTES = 512U;
+
+static string const &port_log()
+{
+  static string const log(generate_nmea_log(PORT_BYTES, 23U));
+  return log;
+}
+
+static double thread_cpu_seconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return static_cast<double>(now.tv_sec) +
+         static_cast<double>(now.tv_nsec) * 1e-9;
+}
+
+static uint64_t received_bytes(NmeaIngestEngine const &engine)
+{
+  uint64_t bytes = 0U;
+  for (size_t i = 0U; i < engine.sources(); ++i)
+  {
+    bytes += engine.stats(i).bytes;
+  }
+  return bytes;
+}
+
+// Round robin over the ports, a serial-sized write at a time.
+static void feed_ports(vector<int> const &writers, string const &log)
+{
+  for (size_t offset = 0U; offset < log.length(); offset += WRITE_BYTES)
+  {
+    size_t const length = std::min(WRITE_BYTES, log.length() - offset);
+    for (size_t i = 0U; i < writers.size(); ++i)
+    {
+      for (size_t written = 0U; written < length;)
+      {
+        ssize_t const count =
+            write(writers[i], log.data() + offset + written, length - written);
+        written += 0 < count ? static_cast<size_t>(count) : 0U;
+      }
+    }
+  }
+}
+
+static void ingest_ports(NmeaBenchState &state)
+{
+  size_t const ports = static_cast<size_t>(state.arg());
+  string const &log = port_log();
+  NmeaIngestEngine engine;
+  uint64_t sentences = 0U;
+  NmeaIngestCallback const count = [&sentences](NmeaIngestEvent const &event) {
+    sentences += event.message.valid() ? 1U : 0U;
+  };
+  vector<int> writers;
+  for (size_t i = 0U; i < ports; ++i)
+  {
+    int pair[2];
+    socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+    writers.push_back(pair[0]);
+    size_t source = 0U;
+    engine.add_fd(pair[1], count, source);
+  }
+
+  uint64_t expected = 0U;
+  double cpu_seconds = 0.0;
+  std::chrono::steady_clock::time_point const start =
+      std::chrono::steady_clock::now();
+  while (state.keep_running())
+  {
+    double const cpu_start = thread_cpu_seconds();
+    std::thread writer(feed_ports, std::cref(writers), std::cref(log));
+    expected += ports * log.length();
+    while (received_bytes(engine) < expected)
+    {
+      engine.poll(100);
+    }
+    writer.join();
+    cpu_seconds += thread_cpu_seconds() - cpu_start;
+  }
+  double const wall_seconds = std::chrono::duration<double>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count();
+  for (size_t i = 0U; i < writers.size(); ++i)
+  {
+    close(writers[i]);
+  }
+  engine.run();
+
+  double const iterations = static_cast<double>(state.iterations());
+  state.set_bytes_per_iteration(static_cast<double>(ports * log.length()));
+  state.set_items_per_iteration(static_cast<double>(sentences) / iterations);
+  state.set_counter("sentences_per_port_s",
+                    static_cast<double>(sentences) / wall_seconds /
+                        static_cast<double>(ports));
+  state.set_counter("engine_cpu", cpu_seconds / wall_seconds);
+}
+NMEA_BENCHMARK_ARGS(ingest_ports, 1, 8, 32);
@@ -0,0 +1,83 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Cost of parser metrics. parse_instrumented runs parse_nmea over a mixed
+// log and reports whether the library was built with NMEALIB_METRICS; build
+// with -DMETRICS=ON and OFF and compare its ns/op (or any parse_* benchmark)
+// to get the overhead. The snapshot and exporter benchmarks cost a scrape.
+
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_metrics.hpp"
+#include "nmea_parser.hpp"
+
+using std::string;
+using std::vector;
+
+static vector<string> const &mixed_sentences()
+{
+  static vector<string> sentences;
+  if (sentences.empty())
+  {
+    string const log(generate_nmea_log(64U << 10, 29U));
+    size_t start = 0U;
+    size_t end = 0U;
+    while (string::npos != (end = log.find('\n', start)))
+    {
+      sentences.push_back(log.substr(start, end + 1U - start));
+      start = end + 1U;
+    }
+  }
+  return sentences;
+}
+
+static void parse_instrumented(NmeaBenchState &state)
+{
+  vector<string> const &sentences = mixed_sentences();
+  double bytes = 0.0;
+  for (size_t i = 0U; i < sentences.size(); ++i)
+  {
+    bytes += static_cast<double>(sentences[i].length());
+  }
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    NmeaMessage const message(parse_nmea(sentence.data(), sentence.length()));
+    nmea_bench_keep(message);
+  }
+  state.set_bytes_per_iteration(bytes / static_cast<double>(sentences.size()));
+  state.set_items_per_iteration(1.0);
+  state.set_counter("metrics_enabled", nmea_metrics_enabled() ? 1.0 : 0.0);
+}
+NMEA_BENCHMARK(parse_instrumented);
+
+static void metrics_snapshot(NmeaBenchState &state)
+{
+  NmeaMetricsSnapshot snapshot;
+  while (state.keep_running())
+  {
+    nmea_metrics_snapshot(snapshot);
+    nmea_bench_keep(snapshot);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(metrics_snapshot);
+
+static void metrics_prometheus(NmeaBenchState &state)
+{
+  NmeaMetricsSnapshot snapshot;
+  for (size_t type = 0U; type < NMEA_MESSAGE_TYPE_COUNT; ++type)
+  {
+    snapshot.sentences[type].results.add(NMEA_PARSE_OK, 1000U + type);
+    snapshot.sentences[type].latency.record(200U + type, 10U);
+  }
+  while (state.keep_running())
+  {
+    string const text(nmea_metrics_prometheus(snapshot));
+    nmea_bench_keep(text);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(metrics_prometheus);
@@ -0,0 +1,111 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEABENCH_HPP
+#define NMEALIB_NMEABENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal self-contained benchmark harness. A benchmark is a function that
+// loops on keep_running() and reports how much work one iteration does:
+//
+//   static void parse_gga_buffer(NmeaBenchState &state)
+//   {
+//     while (state.keep_running())
+//     {
+//       ...
+//     }
+//     state.set_bytes_per_iteration(sentence.length());
+//   }
+//   NMEA_BENCHMARK(parse_gga_buffer);
+//
+// The harness times batches of growing size until the minimum run time is
+// reached, and counts heap allocations made inside the timed loop through
+// the replaced global operator new in nmea_bench_main.cpp.
+
+uint64_t nmea_bench_allocations();
+// Size of the synthetic log used by the whole-log benchmarks (--log-mb).
+size_t nmea_bench_log_bytes();
+
+class NmeaBenchState
+{
+public:
+  NmeaBenchState(int64_t const arg, double const min_seconds);
+
+  bool keep_running();
+
+  inline int64_t arg() const { return arg_; }
+  inline uint64_t iterations() const { return iterations_; }
+  inline double seconds() const { return seconds_; }
+  inline uint64_t allocations() const { return allocations_; }
+  inline double bytesPerIteration() const { return bytesPerIteration_; }
+  inline double itemsPerIteration() const { return itemsPerIteration_; }
+  inline std::vector<std::pair<std::string, double> > const &counters() const
+  {
+    return counters_;
+  }
+
+  inline void set_bytes_per_iteration(double const bytes)
+  {
+    bytesPerIteration_ = bytes;
+  }
+  inline void set_items_per_iteration(double const items)
+  {
+    itemsPerIteration_ = items;
+  }
+  void set_counter(std::string const &name, double const value);
+
+  // Exclude setup work done inside the loop from the timing.
+  void pause_timing();
+  void resume_timing();
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  int64_t arg_;
+  double minSeconds_;
+  bool started_;
+  bool paused_;
+  uint64_t batch_;
+  uint64_t remaining_;
+  uint64_t iterations_;
+  Clock::time_point start_;
+  Clock::time_point pausedAt_;
+  Clock::duration pausedFor_;
+  double seconds_;
+  uint64_t allocationsAtStart_;
+  uint64_t allocations_;
+  double bytesPerIteration_;
+  double itemsPerIteration_;
+  std::vector<std::pair<std::string, double> > counters_;
+};
+
+typedef void (*NmeaBenchFunction)(NmeaBenchState &);
+
+struct NmeaBenchRegistration
+{
+  NmeaBenchRegistration(char const *const name,
+                        NmeaBenchFunction const function,
+                        std::vector<int64_t> const &args =
+                            std::vector<int64_t>());
+};
+
+// Keeps a computed value alive so the optimizer cannot drop the work.
+template <typename T>
+inline void nmea_bench_keep(T const &value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+#define NMEA_BENCHMARK(function)                                              \
+  static NmeaBenchRegistration const function##_registration(#function,      \
+                                                             function)
+#define NMEA_BENCHMARK_ARGS(function, ...)                                    \
+  static NmeaBenchRegistration const function##_registration(                 \
+      #function, function, std::vector<int64_t>{__VA_ARGS__})
+
+#endif // NMEALIB_NMEABENCH_HPP
@@ -0,0 +1,287 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+
+using std::string;
+using std::vector;
+
+static std::atomic<uint64_t> allocation_count(0U);
+
+void *operator new(size_t size)
+{
+  allocation_count.fetch_add(1U, std::memory_order_relaxed);
+  void *const memory = malloc(0U == size ? 1U : size);
+  if (nullptr == memory)
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *memory) noexcept { free(memory); }
+void operator delete[](void *memory) noexcept { free(memory); }
+void operator delete(void *memory, size_t) noexcept { free(memory); }
+void operator delete[](void *memory, size_t) noexcept { free(memory); }
+
+uint64_t nmea_bench_allocations()
+{
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+struct RegisteredBenchmark
+{
+  string name;
+  NmeaBenchFunction function;
+  int64_t arg;
+  bool hasArg;
+};
+
+static vector<RegisteredBenchmark> &registry()
+{
+  static vector<RegisteredBenchmark> benchmarks;
+  return benchmarks;
+}
+
+static size_t log_bytes = 64U << 20;
+
+size_t nmea_bench_log_bytes() { return log_bytes; }
+
+NmeaBenchRegistration::NmeaBenchRegistration(char const *const name,
+                                             NmeaBenchFunction const function,
+                                             vector<int64_t> const &args)
+{
+  RegisteredBenchmark benchmark;
+  benchmark.function = function;
+  benchmark.hasArg = !args.empty();
+  if (args.empty())
+  {
+    benchmark.name = name;
+    benchmark.arg = 0;
+    registry().push_back(benchmark);
+  }
+  for (size_t i = 0U; i < args.size(); ++i)
+  {
+    benchmark.name = string(name) + "/" + std::to_string(args[i]);
+    benchmark.arg = args[i];
+    registry().push_back(benchmark);
+  }
+}
+
+NmeaBenchState::NmeaBenchState(int64_t const arg, double const min_seconds)
+    : arg_(arg)
+    , minSeconds_(min_seconds)
+    , started_(false)
+    , paused_(false)
+    , batch_(0U)
+    , remaining_(0U)
+    , iterations_(0U)
+    , pausedFor_(Clock::duration::zero())
+    , seconds_(0.0)
+    , allocationsAtStart_(0U)
+    , allocations_(0U)
+    , bytesPerIteration_(0.0)
+    , itemsPerIteration_(0.0)
+{
+}
+
+bool NmeaBenchState::keep_running()
+{
+  bool running = 0U < remaining_;
+  if (running)
+  {
+    --remaining_;
+  }
+  else
+  {
+    Clock::time_point const now = Clock::now();
+    if (!started_)
+    {
+      started_ = true;
+      start_ = now;
+      allocationsAtStart_ = nmea_bench_allocations();
+    }
+    seconds_ = std::chrono::duration<double>(now - start_ - pausedFor_).count();
+    running = seconds_ < minSeconds_;
+    if (running)
+    {
+      batch_ = 0U == batch_ ? 1U : batch_ * 2U;
+      iterations_ += batch_;
+      remaining_ = batch_ - 1U;
+    }
+    else
+    {
+      allocations_ = nmea_bench_allocations() - allocationsAtStart_;
+    }
+  }
+  return running;
+}
+
+void NmeaBenchState::pause_timing()
+{
+  paused_ = true;
+  pausedAt_ = Clock::now();
+}
+
+void NmeaBenchState::resume_timing()
+{
+  if (paused_)
+  {
+    pausedFor_ += Clock::now() - pausedAt_;
+    paused_ = false;
+  }
+}
+
+void NmeaBenchState::set_counter(string const &name, double const value)
+{
+  counters_.push_back(std::make_pair(name, value));
+}
+
+static string json_escape(string const &text)
+{
+  string escaped;
+  for (size_t i = 0U; i < text.length(); ++i)
+  {
+    if ('"' == text[i] || '\\' == text[i])
+    {
+      escaped += '\\';
+    }
+    escaped += text[i];
+  }
+  return escaped;
+}
+
+static void usage()
+{
+  printf("usage: nmea_bench [--filter=SUBSTRING] [--min-time=SECONDS]\n"
+         "                  [--json=FILE] [--log-mb=MEGABYTES] [--list]\n"
+         "                  [--write-corpus=FILE]\n");
+}
+
+int main(int argc, char **argv)
+{
+  string filter;
+  string json_path;
+  string corpus_path;
+  double min_seconds = 0.2;
+  bool list_only = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    string const argument(argv[i]);
+    if (0U == argument.find("--filter="))
+    {
+      filter = argument.substr(9U);
+    }
+    else if (0U == argument.find("--min-time="))
+    {
+      min_seconds = atof(argument.c_str() + 11);
+    }
+    else if (0U == argument.find("--json="))
+    {
+      json_path = argument.substr(7U);
+    }
+    else if (0U == argument.find("--log-mb="))
+    {
+      log_bytes = static_cast<size_t>(atol(argument.c_str() + 9)) << 20;
+    }
+    else if (0U == argument.find("--write-corpus="))
+    {
+      corpus_path = argument.substr(15U);
+    }
+    else if ("--list" == argument)
+    {
+      list_only = true;
+    }
+    else
+    {
+      usage();
+      return 1;
+    }
+  }
+
+  if (!corpus_path.empty())
+  {
+    string const log(generate_nmea_log(log_bytes, 1U));
+    std::ofstream corpus(corpus_path.c_str(), std::ios::binary);
+    corpus.write(log.data(), static_cast<std::streamsize>(log.length()));
+    printf("wrote %zu bytes to %s\n", log.length(), corpus_path.c_str());
+    return corpus ? 0 : 1;
+  }
+
+  string json("{\n  \"context\": {\"hardware_concurrency\": " +
+              std::to_string(std::thread::hardware_concurrency()) +
+              ", \"timestamp\": " + std::to_string(time(nullptr)) +
+              ", \"min_time\": " + std::to_string(min_seconds) +
+              "},\n  \"benchmarks\": [");
+  bool first = true;
+  printf("%-44s %14s %14s %12s %10s\n", "benchmark", "ns/op", "MB/s",
+         "items/s", "allocs/op");
+  for (size_t b = 0U; b < registry().size(); ++b)
+  {
+    RegisteredBenchmark const &benchmark = registry()[b];
+    if (string::npos == benchmark.name.find(filter))
+    {
+      continue;
+    }
+    if (list_only)
+    {
+      printf("%s\n", benchmark.name.c_str());
+      continue;
+    }
+    NmeaBenchState state(benchmark.arg, min_seconds);
+    benchmark.function(state);
+    double const iterations =
+        static_cast<double>(0U == state.iterations() ? 1U : state.iterations());
+    double const ns_per_op = state.seconds() * 1e9 / iterations;
+    double const bytes_per_second =
+        state.bytesPerIteration() * iterations / state.seconds();
+    double const items_per_second =
+        state.itemsPerIteration() * iterations / state.seconds();
+    double const allocations_per_op =
+        static_cast<double>(state.allocations()) / iterations;
+    printf("%-44s %14.1f %14.1f %12.4g %10.3f", benchmark.name.c_str(),
+           ns_per_op, bytes_per_second / 1e6, items_per_second,
+           allocations_per_op);
+    for (size_t c = 0U; c < state.counters().size(); ++c)
+    {
+      printf(" %s=%g", state.counters()[c].first.c_str(),
+             state.counters()[c].second);
+    }
+    printf("\n");
+    fflush(stdout);
+
+    json += first ? "\n    {" : ",\n    {";
+    first = false;
+    json += "\"name\": \"" + json_escape(benchmark.name) + "\"";
+    json += ", \"iterations\": " + std::to_string(state.iterations());
+    json += ", \"ns_per_op\": " + std::to_string(ns_per_op);
+    json += ", \"bytes_per_second\": " + std::to_string(bytes_per_second);
+    json += ", \"items_per_second\": " + std::to_string(items_per_second);
+    json += ", \"allocations_per_op\": " + std::to_string(allocations_per_op);
+    for (size_t c = 0U; c < state.counters().size(); ++c)
+    {
+      json += ", \"" + json_escape(state.counters()[c].first) +
+              "\": " + std::to_string(state.counters()[c].second);
+    }
+    json += "}";
+  }
+  json += "\n  ]\n}\n";
+
+  if (!json_path.empty() && !list_only)
+  {
+    std::ofstream output(json_path.c_str());
+    output << json;
+  }
+  return 0;
+}
@@ -0,0 +1,280 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "nmea_builder.hpp"
+#include "nmea_checksum.hpp"
+#include "nmea_corpus.hpp"
+
+using std::string;
+
+static double const METERS_PER_DEGREE = 111320.0;
+static double const DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+static double const MPS_TO_KNOTS = 1.94384;
+// Once per second at 10 Hz, as receivers send the slower sentences.
+static size_t const SLOW_SENTENCE_EPOCHS = 10U;
+
+class TrajectorySimulator
+{
+public:
+  explicit TrajectorySimulator(uint32_t const seed)
+      : generator_(seed)
+      , noise_(0.0, 1.0)
+      , seconds_(12.0 * 3600.0)
+      , latitude_(37.7749)
+      , longitude_(-122.4194)
+      , altitude_(15.0)
+      , heading_(45.0)
+      , speed_(12.0)
+  {
+  }
+
+  void step(double const dt)
+  {
+    heading_ = std::fmod(heading_ + 2.0 * noise_(generator_) + 360.0, 360.0);
+    speed_ = std::max(0.0, speed_ + 0.3 * noise_(generator_));
+    double const distance = speed_ * dt;
+    latitude_ += distance * std::cos(heading_ * DEGREES_TO_RADIANS) /
+                 METERS_PER_DEGREE;
+    longitude_ += distance * std::sin(heading_ * DEGREES_TO_RADIANS) /
+                  (METERS_PER_DEGREE * std::cos(latitude_ * DEGREES_TO_RADIANS));
+    altitude_ += 0.05 * noise_(generator_);
+    seconds_ = std::fmod(seconds_ + dt, 86400.0);
+  }
+
+  string gga()
+  {
+    uint8_t const hour = static_cast<uint8_t>(seconds_ / 3600.0);
+    uint8_t const minute =
+        static_cast<uint8_t>(std::fmod(seconds_, 3600.0) / 60.0);
+    double const second = std::round(std::fmod(seconds_, 60.0) * 100.0) / 100.0;
+    GgaFixQuality const quality =
+        0.0 < noise_(generator_) ? GGA_RTK_FIXED : GGA_RTK_FLOAT;
+    uint16_t const satellites =
+        static_cast<uint16_t>(12 + static_cast<int>(2.0 * noise_(generator_)));
+    double const hdop =
+        std::round((0.8 + 0.1 * std::fabs(noise_(generator_))) * 10.0) / 10.0;
+    return build_gga(hour, minute, std::min(second, 59.99), latitude_,
+                     longitude_, quality, satellites, hdop, altitude_, -32.1);
+  }
+
+  string vtg() const { return build_vtg(heading_, speed_); }
+
+  string avr()
+  {
+    return build_avr_sentence(timestamp(), heading_, 0.5 * noise_(generator_),
+                              1.2, 3, 1.9, 11);
+  }
+
+  string rmc() const
+  {
+    RmcMessageData message;
+    message.timestamp = timestamp();
+    message.status = 'A';
+    message.latitude = latitude_;
+    message.longitude = longitude_;
+    message.speedKnots = speed_ * MPS_TO_KNOTS;
+    message.trackMadeGoodValid = true;
+    message.trackMadeGood = heading_;
+    message.date = 150316U;
+    message.magneticVariationValid = true;
+    message.magneticVariation = 13.2;
+    message.modeIndicator = 'R';
+    return build(build_rmc, message);
+  }
+
+  string gsa() const
+  {
+    GsaMessageData message;
+    message.selectionMode = 'A';
+    message.fixType = 3U;
+    message.numSatellites = static_cast<uint8_t>(SATELLITES_IN_VIEW);
+    for (size_t i = 0U; i < SATELLITES_IN_VIEW; ++i)
+    {
+      message.satelliteIds[i] = static_cast<uint16_t>(3U * i + 2U);
+    }
+    message.pdop = 1.6;
+    message.hdop = 0.9;
+    message.vdop = 1.3;
+    return build(build_gsa, message);
+  }
+
+  // One sentence per four satellites of the sky view.
+  string gsv()
+  {
+    uint8_t const total = static_cast<uint8_t>(
+        (SATELLITES_IN_VIEW + NMEA_GSV_SATELLITES_PER_SENTENCE - 1U) /
+        NMEA_GSV_SATELLITES_PER_SENTENCE);
+    string group;
+    for (uint8_t number = 1U; number <= total; ++number)
+    {
+      GsvMessageData message;
+      message.totalMessages = total;
+      message.messageNumber = number;
+      message.satellitesInView = SATELLITES_IN_VIEW;
+      for (size_t i = (number - 1U) * NMEA_GSV_SATELLITES_PER_SENTENCE;
+           i < SATELLITES_IN_VIEW &&
+           NMEA_GSV_SATELLITES_PER_SENTENCE > message.numSatellites;
+           ++i)
+      {
+        GsvSatellite &satellite = message.satellites[message.numSatellites++];
+        satellite.id = static_cast<uint16_t>(3U * i + 2U);
+        satellite.elevationValid = true;
+        satellite.elevation = static_cast<int8_t>(5U + 7U * i);
+        satellite.azimuthValid = true;
+        satellite.azimuth = static_cast<uint16_t>((37U * i) % 360U);
+        satellite.snrValid = true;
+        satellite.snr = static_cast<uint8_t>(
+            40 + static_cast<int>(3.0 * noise_(generator_)));
+      }
+      group += build(build_gsv, message);
+    }
+    return group;
+  }
+
+  string gst()
+  {
+    GstMessageData message;
+    message.timestamp = timestamp();
+    message.rangeRms = 0.012 + 0.002 * std::fabs(noise_(generator_));
+    message.semiMajorSigma = 0.021;
+    message.semiMinorSigma = 0.014;
+    message.semiMajorOrientation = 47.3;
+    message.latitudeSigma = 0.018;
+    message.longitudeSigma = 0.016;
+    message.altitudeSigma = 0.035;
+    return build(build_gst, message);
+  }
+
+  string zda() const
+  {
+    ZdaMessageData message;
+    message.timestamp = timestamp();
+    message.day = 15U;
+    message.month = 3U;
+    message.year = 2016U;
+    return build(build_zda, message);
+  }
+
+  string hdt() const
+  {
+    HdtMessageData message;
+    message.heading = heading_;
+    return build(build_hdt, message);
+  }
+
+  string gns() const
+  {
+    static char const MODES[] = "RRN";
+    GnsMessageData message;
+    message.timestamp = timestamp();
+    message.latitude = latitude_;
+    message.longitude = longitude_;
+    memcpy(message.modeIndicator, MODES, sizeof(MODES));
+    message.numSatellites = SATELLITES_IN_VIEW;
+    message.hdop = 0.9;
+    message.altitude = altitude_;
+    message.geoidHeight = -32.1;
+    message.timeSinceLastDgpsValid = true;
+    message.timeSinceLastDgps = 1.0;
+    message.dgpsStationIDValid = true;
+    message.dgpsStationID = 31U;
+    message.navigationalStatus = 'S';
+    return build(build_gns, message);
+  }
+
+private:
+  static size_t const SATELLITES_IN_VIEW = 10U;
+
+  template <typename Message>
+  static string build(size_t (*builder)(char *const, size_t const,
+                                        Message const &),
+                      Message const &message)
+  {
+    char text[NMEA_MAX_BUILD_LENGTH];
+    return string(text, builder(text, sizeof(text), message));
+  }
+
+  // hhmmss.ss
+  double timestamp() const
+  {
+    double const hours = std::floor(seconds_ / 3600.0);
+    double const minutes = std::floor(std::fmod(seconds_, 3600.0) / 60.0);
+    return hours * 10000.0 + minutes * 100.0 + std::fmod(seconds_, 60.0);
+  }
+
+  std::mt19937 generator_;
+  std::normal_distribution<double> noise_;
+  double seconds_;
+  double latitude_;
+  double longitude_;
+  double altitude_;
+  double heading_;
+  double speed_;
+};
+
+string build_avr_sentence(double const timestamp, double const yaw,
+                          double const tilt, double const range,
+                          int const fix_quality, double const pdop,
+                          int const num_satellites)
+{
+  char text[160];
+  int const length =
+      snprintf(text, sizeof(text), "$PTNL,AVR,%09.2f,%+.4f,Yaw,%+.4f,Tilt,,,"
+                                   "%.3f,%d,%.1f,%d*",
+               timestamp, yaw, tilt, range, fix_quality, pdop, num_satellites);
+  uint8_t const checksum =
+      nmea_checksum(text + 1, static_cast<size_t>(length) - 2U);
+  snprintf(text + length, sizeof(text) - static_cast<size_t>(length),
+           "%02X\n", checksum);
+  return text;
+}
+
+NmeaCorpus generate_nmea_corpus(size_t const epochs, uint32_t const seed)
+{
+  TrajectorySimulator simulator(seed);
+  NmeaCorpus corpus;
+  for (size_t i = 0U; i < epochs; ++i)
+  {
+    simulator.step(0.1);
+    corpus.gga.push_back(simulator.gga());
+    corpus.vtg.push_back(simulator.vtg());
+    corpus.avr.push_back(simulator.avr());
+    corpus.rmc.push_back(simulator.rmc());
+    corpus.gsa.push_back(simulator.gsa());
+    corpus.gsv.push_back(simulator.gsv());
+    corpus.gst.push_back(simulator.gst());
+    corpus.zda.push_back(simulator.zda());
+    corpus.hdt.push_back(simulator.hdt());
+    corpus.gns.push_back(simulator.gns());
+  }
+  return corpus;
+}
+
+string generate_nmea_log(size_t const bytes, uint32_t const seed)
+{
+  TrajectorySimulator simulator(seed);
+  string log;
+  log.reserve(bytes + 512U);
+  for (size_t epoch = 0U; log.length() < bytes; ++epoch)
+  {
+    simulator.step(0.1);
+    log += simulator.gga();
+    log += simulator.rmc();
+    log += simulator.vtg();
+    log += simulator.gst();
+    log += simulator.hdt();
+    log += simulator.avr();
+    if (0U == epoch % SLOW_SENTENCE_EPOCHS)
+    {
+      log += simulator.gsa();
+      log += simulator.gsv();
+      log += simulator.zda();
+      log += simulator.gns();
+    }
+  }
+  return log;
+}
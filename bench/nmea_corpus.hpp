@@ -0,0 +1,40 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEACORPUS_HPP
+#define NMEALIB_NMEACORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Realistic sentences for the benchmarks, produced by the builders along a
+// simulated 10 Hz vehicle trajectory plus matching Trimble AVR heading
+// sentences. Every sentence ends in "\n"; each gsv entry is a whole group of
+// three sentences.
+struct NmeaCorpus
+{
+  std::vector<std::string> gga;
+  std::vector<std::string> vtg;
+  std::vector<std::string> avr;
+  std::vector<std::string> rmc;
+  std::vector<std::string> gsa;
+  std::vector<std::string> gsv;
+  std::vector<std::string> gst;
+  std::vector<std::string> zda;
+  std::vector<std::string> hdt;
+  std::vector<std::string> gns;
+};
+
+NmeaCorpus generate_nmea_corpus(size_t const epochs, uint32_t const seed);
+
+// Epochs of GGA, RMC, VTG, GST, HDT and AVR, with GSA, GSV, ZDA and GNS once
+// a second, concatenated until the log is at least bytes long.
+std::string generate_nmea_log(size_t const bytes, uint32_t const seed);
+
+std::string build_avr_sentence(double const timestamp, double const yaw,
+                               double const tilt, double const range,
+                               int const fix_quality, double const pdop,
+                               int const num_satellites);
+
+#endif // NMEALIB_NMEACORPUS_HPP
@@ -0,0 +1,218 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_checksum.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_parser.hpp"
+
+using std::string;
+using std::vector;
+
+static NmeaCorpus const &corpus()
+{
+  static NmeaCorpus const sentences(generate_nmea_corpus(1024U, 7U));
+  return sentences;
+}
+
+static double mean_length(vector<string> const &sentences)
+{
+  double total = 0.0;
+  for (size_t i = 0U; i < sentences.size(); ++i)
+  {
+    total += static_cast<double>(sentences[i].length());
+  }
+  return total / static_cast<double>(sentences.size());
+}
+
+static void parse_gga_string(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().gga;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    GgaMessageData const fix(parse_gga(sentences[i++ % sentences.size()]));
+    nmea_bench_keep(fix);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_gga_string);
+
+static void parse_gga_buffer(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().gga;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    GgaMessageData const fix(parse_gga(sentence.data(), sentence.length()));
+    nmea_bench_keep(fix);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_gga_buffer);
+
+static void parse_gga_skip_checksum(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().gga;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    GgaMessageData const fix(
+        parse_gga(sentence.data(), sentence.length(), NMEA_SKIP_CHECKSUM));
+    nmea_bench_keep(fix);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_gga_skip_checksum);
+
+static void parse_vtg_buffer(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().vtg;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    VtgMessageData const velocity(
+        parse_vtg(sentence.data(), sentence.length()));
+    nmea_bench_keep(velocity);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_vtg_buffer);
+
+static void parse_avr_buffer(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().avr;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    AvrMessageData const attitude(
+        parse_avr(sentence.data(), sentence.length()));
+    nmea_bench_keep(attitude);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_avr_buffer);
+
+static void parse_nmea_mixed(NmeaBenchState &state)
+{
+  vector<string> sentences;
+  for (size_t i = 0U; i < corpus().gga.size(); ++i)
+  {
+    sentences.push_back(corpus().gga[i]);
+    sentences.push_back(corpus().vtg[i]);
+    sentences.push_back(corpus().avr[i]);
+  }
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    NmeaMessage const message(parse_nmea(sentence.data(), sentence.length()));
+    nmea_bench_keep(message);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_nmea_mixed);
+
+// Worst cases: 0 unknown sentence, 1 bad checksum, 2 GGA without a fix,
+// 3 over-long numeric fields that miss the exact fast path, 4 a 4 KiB line
+// with no delimiters at all.
+static string malformed_sentence(int64_t const kind)
+{
+  string sentence;
+  switch (kind)
+  {
+  case 0:
+    sentence = "$GPXYZ,1,2,3,4,5,6,7,8,9*00";
+    break;
+  case 1:
+    sentence = corpus().gga[0];
+    sentence[sentence.length() - 2U] =
+        '0' == sentence[sentence.length() - 2U] ? '1' : '0';
+    break;
+  case 2:
+    sentence = "$GPGGA,,,,,,0,,,,,,,,*66";
+    break;
+  case 3:
+    sentence = "$GPGGA,123519.000000000000000001,4807.0380000000000000000001,"
+               "N,01131.0000000000000000000001,E,1,08,0.900000000000000000001,"
+               "545.4000000000000000000001,M,46.9000000000000000000001,M,,*";
+    sentence += "00";
+    break;
+  default:
+    sentence = "$GPGGA" + string(4096U, '9');
+    break;
+  }
+  return sentence;
+}
+
+static void parse_malformed(NmeaBenchState &state)
+{
+  string const sentence(malformed_sentence(state.arg()));
+  while (state.keep_running())
+  {
+    NmeaMessage const message(parse_nmea(sentence.data(), sentence.length()));
+    nmea_bench_keep(message);
+  }
+  state.set_bytes_per_iteration(static_cast<double>(sentence.length()));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK_ARGS(parse_malformed, 0, 1, 2, 3, 4);
+
+static void parse_malformed_skip_checksum(NmeaBenchState &state)
+{
+  string const sentence(malformed_sentence(state.arg()));
+  while (state.keep_running())
+  {
+    NmeaMessage const message(
+        parse_nmea(sentence.data(), sentence.length(), NMEA_SKIP_CHECKSUM));
+    nmea_bench_keep(message);
+  }
+  state.set_bytes_per_iteration(static_cast<double>(sentence.length()));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK_ARGS(parse_malformed_skip_checksum, 2, 3, 4);
+
+static string checksum_input(int64_t const length)
+{
+  string data(static_cast<size_t>(length), '\0');
+  for (size_t i = 0U; i < data.length(); ++i)
+  {
+    data[i] = static_cast<char>(' ' + i % 90U);
+  }
+  return data;
+}
+
+static void checksum_scalar(NmeaBenchState &state)
+{
+  string const data(checksum_input(state.arg()));
+  while (state.keep_running())
+  {
+    uint8_t const checksum = nmea_checksum_scalar(data.data(), data.length());
+    nmea_bench_keep(checksum);
+  }
+  state.set_bytes_per_iteration(static_cast<double>(data.length()));
+}
+NMEA_BENCHMARK_ARGS(checksum_scalar, 16, 64, 82, 256, 1024, 4096);
+
+static void checksum_simd(NmeaBenchState &state)
+{
+  string const data(checksum_input(state.arg()));
+  while (state.keep_running())
+  {
+    uint8_t const checksum = nmea_checksum(data.data(), data.length());
+    nmea_bench_keep(checksum);
+  }
+  state.set_bytes_per_iteration(static_cast<double>(data.length()));
+}
+NMEA_BENCHMARK_ARGS(checksum_simd, 16, 64, 82, 256, 1024, 4096);
@@ -0,0 +1,169 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Byte arrival to parsed record latency through NmeaPipeline with 1, 4 and
+// 16 reader threads, each feeding its share of the log in 64 byte reads to
+// one parser thread and one subscriber. Percentiles are in nanoseconds and
+// include time spent queued, so they grow once the readers outrun the
+// parser.
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_latency_histogram.hpp"
+#include "nmea_pipeline.hpp"
+
+using std::string;
+using std::vector;
+
+static size_t const READ_BYTES = 64U;
+
+static string const &pipeline_log()
+{
+  static string const log(generate_nmea_log(256U << 10, 21U));
+  return log;
+}
+
+// Splits at line starts so no sentence is cut between readers.
+static vector<size_t> reader_offsets(string const &log, size_t const readers)
+{
+  vector<size_t> offsets(1U, 0U);
+  for (size_t i = 1U; i < readers; ++i)
+  {
+    size_t const target = log.length() * i / readers;
+    size_t const line = log.find('\n', target);
+    offsets.push_back(string::npos == line ? log.length() : line + 1U);
+  }
+  offsets.push_back(log.length());
+  return offsets;
+}
+
+static void read_share(NmeaPipeline &pipeline, char const *const begin,
+                       char const *const end)
+{
+  NmeaStreamFramer framer;
+  for (char const *position = begin; position < end; position += READ_BYTES)
+  {
+    size_t const length =
+        std::min(READ_BYTES, static_cast<size_t>(end - position));
+    uint64_t const arrival_ns = nmea_pipeline_now_ns();
+    framer.push(position, length);
+    NmeaSentence sentence;
+    while (framer.next(sentence))
+    {
+      while (!pipeline.submit(sentence.data, sentence.length, arrival_ns))
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+static void pipeline_latency(NmeaBenchState &state)
+{
+  size_t const readers = static_cast<size_t>(state.arg());
+  string const &log = pipeline_log();
+  vector<size_t> const offsets(reader_offsets(log, readers));
+  NmeaLatencyHistogram latency;
+  uint64_t records = 0U;
+  uint64_t lost = 0U;
+  while (state.keep_running())
+  {
+    NmeaPipeline pipeline(1024U, 1U << 16);
+    std::atomic<bool> reading(true);
+    std::atomic<bool> parsing(true);
+    NmeaRecordSubscriber subscriber(pipeline.records());
+    std::thread consumer([&subscriber, &parsing, &latency]() {
+      NmeaRecord record;
+      bool more = true;
+      while (more)
+      {
+        bool const still_parsing = parsing.load();
+        bool const received = subscriber.next(record);
+        if (received)
+        {
+          latency.record(nmea_pipeline_now_ns() - record.arrivalNs);
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+        more = received || still_parsing;
+      }
+    });
+    std::thread parser([&pipeline, &reading]() {
+      bool more = true;
+      while (more)
+      {
+        bool const still_reading = reading.load();
+        bool const parsed = 0U != pipeline.parse_pending(64U);
+        if (!parsed)
+        {
+          std::this_thread::yield();
+        }
+        more = parsed || still_reading;
+      }
+    });
+    vector<std::thread> threads;
+    for (size_t i = 0U; i < readers; ++i)
+    {
+      threads.push_back(std::thread(read_share, std::ref(pipeline),
+                                    log.data() + offsets[i],
+                                    log.data() + offsets[i + 1U]));
+    }
+    for (size_t i = 0U; i < threads.size(); ++i)
+    {
+      threads[i].join();
+    }
+    reading = false;
+    parser.join();
+    parsing = false;
+    consumer.join();
+    records += subscriber.received();
+    lost += subscriber.lost();
+  }
+  double const iterations = static_cast<double>(state.iterations());
+  state.set_bytes_per_iteration(static_cast<double>(log.length()));
+  state.set_items_per_iteration(static_cast<double>(records) / iterations);
+  state.set_counter("p50_ns", static_cast<double>(latency.percentile(0.5)));
+  state.set_counter("p99_ns", static_cast<double>(latency.percentile(0.99)));
+  state.set_counter("p999_ns",
+                    static_cast<double>(latency.percentile(0.999)));
+  state.set_counter("lost", static_cast<double>(lost) / iterations);
+}
+NMEA_BENCHMARK_ARGS(pipeline_latency, 1, 4, 16);
+
+// Publication alone: one thread publishing into a ring nobody reads.
+static void record_ring_publish(NmeaBenchState &state)
+{
+  NmeaRecordRing ring(1024U);
+  NmeaRecord record;
+  while (state.keep_running())
+  {
+    ++record.arrivalNs;
+    ring.publish(record);
+  }
+  nmea_bench_keep(ring);
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(record_ring_publish);
+
+static void sentence_queue_push_pop(NmeaBenchState &state)
+{
+  static char const SENTENCE[] =
+      "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48";
+  NmeaSentenceQueue queue(1024U);
+  NmeaQueuedSentence sentence;
+  while (state.keep_running())
+  {
+    queue.try_push(SENTENCE, sizeof(SENTENCE) - 1U, 0U);
+    queue.try_pop(sentence);
+    nmea_bench_keep(sentence);
+  }
+  state.set_bytes_per_iteration(sizeof(SENTENCE) - 1U);
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(sentence_queue_push_pop);
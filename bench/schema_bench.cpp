@@ -0,0 +1,174 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Schema generated parsers and builders against the hand written code they
+// replaced, which is kept here as the baseline. Checksums are skipped so
+// only field handling is compared.
+
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_builder.hpp"
+#include "nmea_checksum.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_fields.hpp"
+#include "nmea_format.hpp"
+#include "nmea_parser.hpp"
+
+using std::string;
+using std::vector;
+
+static NmeaCorpus const &corpus()
+{
+  static NmeaCorpus const sentences(generate_nmea_corpus(1024U, 13U));
+  return sentences;
+}
+
+static GgaMessageData hand_parse_gga(char const *const message,
+                                     size_t const length)
+{
+  static size_t const HEADER_LENGTH = 7U;
+  GgaMessageData output;
+  NmeaFieldReader fields(message + HEADER_LENGTH, message + length);
+  NmeaField field;
+  double latitude = 0.0;
+  double longitude = 0.0;
+  double latitude_multiplier = 0.0;
+  double longitude_multiplier = 0.0;
+  int32_t fix_quality = 0;
+  int32_t num_satellites = 0;
+  bool const valid =
+      HEADER_LENGTH <= length && fields.next(field) &&
+      parse_field_double(field, output.timestamp) && fields.next(field) &&
+      parse_field_degrees_minutes(field, latitude) && fields.next(field) &&
+      parse_field_hemisphere(field, 'N', latitude_multiplier) &&
+      fields.next(field) && parse_field_degrees_minutes(field, longitude) &&
+      fields.next(field) &&
+      parse_field_hemisphere(field, 'E', longitude_multiplier) &&
+      fields.next(field) && parse_field_int(field, fix_quality) &&
+      fields.next(field) && parse_field_int(field, num_satellites) &&
+      fields.next(field) && parse_field_double(field, output.hdop) &&
+      fields.next(field) && parse_field_double(field, output.altitude) &&
+      fields.skip(1U) && fields.next(field) &&
+      parse_field_double(field, output.geoidHeight) && fields.skip(1U);
+  if (valid)
+  {
+    output.latitude = latitude * latitude_multiplier;
+    output.longitude = longitude * longitude_multiplier;
+    output.fixQuality = static_cast<GgaFixQuality>(fix_quality);
+    output.numSatellites = static_cast<uint16_t>(num_satellites);
+    double time_since_last_dgps = 0.0;
+    int32_t dgps_station_id = 0;
+    output.valid = true;
+    if (fields.next(field) && !field.empty())
+    {
+      output.valid = parse_field_double(field, time_since_last_dgps);
+      output.SetTimeSinceLastDgps(time_since_last_dgps);
+    }
+    if (output.valid && fields.next(field) && !field.empty())
+    {
+      output.valid = parse_field_int(field, dgps_station_id);
+      output.SetDgpsStationID(static_cast<uint16_t>(dgps_station_id));
+    }
+  }
+  return output;
+}
+
+static void parse_gga_hand_written(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().gga;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    GgaMessageData const fix(
+        hand_parse_gga(sentence.data(), sentence.length()));
+    nmea_bench_keep(fix);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_gga_hand_written);
+
+static void parse_gga_schema(NmeaBenchState &state)
+{
+  vector<string> const &sentences = corpus().gga;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    GgaMessageData const fix(
+        parse_gga(sentence.data(), sentence.length(), NMEA_SKIP_CHECKSUM));
+    nmea_bench_keep(fix);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(parse_gga_schema);
+
+static size_t hand_build_vtg(char *const buffer, size_t const capacity,
+                             VtgMessageData const &message)
+{
+  static char const START[] = "$GPVTG,";
+  NmeaWriter writer(buffer, capacity);
+  writer.put(START, sizeof(START) - 1U);
+  writer.put_fixed(message.trueTrackMadeGood, 1, 5U);
+  writer.put(",T,", 3U);
+  if (message.magneticTrackMadeGoodValid)
+  {
+    writer.put_fixed(message.magneticTrackMadeGood, 1, 5U);
+  }
+  writer.put(",M,", 3U);
+  writer.put_fixed(message.groundSpeedKnots, 3);
+  writer.put(",N,", 3U);
+  writer.put_fixed(message.groundSpeedKph, 3);
+  writer.put(",K*", 3U);
+  size_t const length = writer.length();
+  writer.put_hex_byte(
+      2U <= length ? nmea_checksum(writer.data() + 1, length - 2U) : 0U);
+  writer.put('\n');
+  return writer.length();
+}
+
+static vector<VtgMessageData> const &vtg_messages()
+{
+  static vector<VtgMessageData> messages;
+  if (messages.empty())
+  {
+    vector<string> const &sentences = corpus().vtg;
+    for (size_t i = 0U; i < sentences.size(); ++i)
+    {
+      messages.push_back(parse_vtg(sentences[i]));
+    }
+  }
+  return messages;
+}
+
+static void build_vtg_hand_written(NmeaBenchState &state)
+{
+  vector<VtgMessageData> const &messages = vtg_messages();
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    size_t const length = hand_build_vtg(buffer, sizeof(buffer),
+                                         messages[i++ % messages.size()]);
+    nmea_bench_keep(length);
+    nmea_bench_keep(buffer);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(build_vtg_hand_written);
+
+static void build_vtg_schema(NmeaBenchState &state)
+{
+  vector<VtgMessageData> const &messages = vtg_messages();
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    size_t const length =
+        build_vtg(buffer, sizeof(buffer), messages[i++ % messages.size()]);
+    nmea_bench_keep(length);
+    nmea_bench_keep(buffer);
+  }
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(build_vtg_schema);
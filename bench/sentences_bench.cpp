@@ -0,0 +1,154 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Parse and build cost of the sentences beyond GGA, VTG and AVR, plus GSV
+// group assembly.
+
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_builder.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_gsv_aggregator.hpp"
+#include "nmea_parser.hpp"
+
+using std::string;
+using std::vector;
+
+static NmeaCorpus const &corpus()
+{
+  static NmeaCorpus const sentences(generate_nmea_corpus(1024U, 17U));
+  return sentences;
+}
+
+static double mean_length(vector<string> const &sentences)
+{
+  double total = 0.0;
+  for (size_t i = 0U; i < sentences.size(); ++i)
+  {
+    total += static_cast<double>(sentences[i].length());
+  }
+  return total / static_cast<double>(sentences.size());
+}
+
+template <typename Message>
+static void run_parse(NmeaBenchState &state, vector<string> const &sentences,
+                      Message (*parser)(char const *const, size_t const,
+                                        NmeaChecksumMode const))
+{
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &sentence = sentences[i++ % sentences.size()];
+    Message const message(
+        parser(sentence.data(), sentence.length(), NMEA_VERIFY_CHECKSUM));
+    nmea_bench_keep(message);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+
+template <typename Message>
+static void run_build(NmeaBenchState &state, vector<string> const &sentences,
+                      Message (*parser)(std::string const &,
+                                        NmeaChecksumMode const),
+                      size_t (*builder)(char *const, size_t const,
+                                        Message const &))
+{
+  vector<Message> messages;
+  for (size_t i = 0U; i < sentences.size(); ++i)
+  {
+    messages.push_back(parser(sentences[i], NMEA_VERIFY_CHECKSUM));
+  }
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    size_t const length =
+        builder(buffer, sizeof(buffer), messages[i++ % messages.size()]);
+    nmea_bench_keep(length);
+    nmea_bench_keep(buffer);
+  }
+  state.set_bytes_per_iteration(mean_length(sentences));
+  state.set_items_per_iteration(1.0);
+}
+
+#define NMEA_SENTENCE_BENCHMARKS(name)                                        \
+  static void parse_##name##_buffer(NmeaBenchState &state)                    \
+  {                                                                           \
+    run_parse(state, corpus().name, parse_##name);                            \
+  }                                                                           \
+  NMEA_BENCHMARK(parse_##name##_buffer);                                      \
+  static void build_##name##_message(NmeaBenchState &state)                   \
+  {                                                                           \
+    run_build(state, corpus().name, parse_##name, build_##name);              \
+  }                                                                           \
+  NMEA_BENCHMARK(build_##name##_message)
+
+NMEA_SENTENCE_BENCHMARKS(rmc);
+NMEA_SENTENCE_BENCHMARKS(gsa);
+NMEA_SENTENCE_BENCHMARKS(gst);
+NMEA_SENTENCE_BENCHMARKS(zda);
+NMEA_SENTENCE_BENCHMARKS(hdt);
+NMEA_SENTENCE_BENCHMARKS(gns);
+
+// The corpus keeps whole GSV groups, so split them back into sentences.
+static vector<string> const &gsv_sentences()
+{
+  static vector<string> sentences;
+  if (sentences.empty())
+  {
+    vector<string> const &groups = corpus().gsv;
+    for (size_t i = 0U; i < groups.size(); ++i)
+    {
+      size_t start = 0U;
+      size_t end = 0U;
+      while (string::npos != (end = groups[i].find('\n', start)))
+      {
+        sentences.push_back(groups[i].substr(start, end + 1U - start));
+        start = end + 1U;
+      }
+    }
+  }
+  return sentences;
+}
+
+static void parse_gsv_buffer(NmeaBenchState &state)
+{
+  run_parse(state, gsv_sentences(), parse_gsv);
+}
+NMEA_BENCHMARK(parse_gsv_buffer);
+
+static void build_gsv_message(NmeaBenchState &state)
+{
+  run_build(state, gsv_sentences(), parse_gsv, build_gsv);
+}
+NMEA_BENCHMARK(build_gsv_message);
+
+// Parse and join whole groups; items are groups.
+static void aggregate_gsv_groups(NmeaBenchState &state)
+{
+  vector<string> const &groups = corpus().gsv;
+  NmeaGsvAggregator aggregator;
+  size_t i = 0U;
+  while (state.keep_running())
+  {
+    string const &group = groups[i++ % groups.size()];
+    char const *position = group.data();
+    char const *const end = position + group.length();
+    GsvSatelliteGroup const *complete = nullptr;
+    while (position < end)
+    {
+      char const *next = position;
+      while ('\n' != *next++)
+      {
+      }
+      complete = aggregator.add(parse_gsv(
+          position, static_cast<size_t>(next - position)));
+      position = next;
+    }
+    nmea_bench_keep(complete);
+  }
+  state.set_bytes_per_iteration(mean_length(groups));
+  state.set_items_per_iteration(1.0);
+}
+NMEA_BENCHMARK(aggregate_gsv_groups);
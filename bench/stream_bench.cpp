@@ -0,0 +1,91 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nmea_batch_parser.hpp"
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_stream_framer.hpp"
+
+using std::string;
+using std::vector;
+
+static string const &stream_log()
+{
+  static string const log(generate_nmea_log(4U << 20, 3U));
+  return log;
+}
+
+static string const &whole_log()
+{
+  static string const log(generate_nmea_log(nmea_bench_log_bytes(), 5U));
+  return log;
+}
+
+static void frame_stream(NmeaBenchState &state)
+{
+  string const &log = stream_log();
+  size_t const chunk = static_cast<size_t>(state.arg());
+  NmeaStreamFramer framer;
+  size_t sentences = 0U;
+  while (state.keep_running())
+  {
+    for (size_t offset = 0U; offset < log.length(); offset += chunk)
+    {
+      framer.push(log.data() + offset, std::min(chunk, log.length() - offset));
+      NmeaSentence sentence;
+      while (framer.next(sentence))
+      {
+        ++sentences;
+      }
+    }
+  }
+  state.set_bytes_per_iteration(static_cast<double>(log.length()));
+  state.set_items_per_iteration(static_cast<double>(sentences) /
+                                static_cast<double>(state.iterations()));
+}
+NMEA_BENCHMARK_ARGS(frame_stream, 1, 64, 65536);
+
+static void frame_and_parse_stream(NmeaBenchState &state)
+{
+  string const &log = stream_log();
+  size_t const chunk = static_cast<size_t>(state.arg());
+  NmeaStreamFramer framer;
+  size_t valid = 0U;
+  while (state.keep_running())
+  {
+    for (size_t offset = 0U; offset < log.length(); offset += chunk)
+    {
+      framer.push(log.data() + offset, std::min(chunk, log.length() - offset));
+      NmeaSentence sentence;
+      while (framer.next(sentence))
+      {
+        valid += parse_nmea(sentence.data, sentence.length).valid() ? 1U : 0U;
+      }
+    }
+  }
+  state.set_bytes_per_iteration(static_cast<double>(log.length()));
+  state.set_items_per_iteration(static_cast<double>(valid) /
+                                static_cast<double>(state.iterations()));
+}
+NMEA_BENCHMARK_ARGS(frame_and_parse_stream, 1, 64, 65536);
+
+static void parse_batch(NmeaBenchState &state)
+{
+  unsigned const threads = static_cast<unsigned>(state.arg());
+  string const &log = whole_log();
+  vector<NmeaMessage> output(count_nmea_lines(log.data(), log.length(), 0U));
+  size_t parsed = 0U;
+  while (state.keep_running())
+  {
+    parsed = parse_nmea_batch(log.data(), log.length(), output.data(),
+                              output.size(), threads);
+  }
+  state.set_bytes_per_iteration(static_cast<double>(log.length()));
+  state.set_items_per_iteration(static_cast<double>(parsed));
+  state.set_counter("threads", threads);
+  state.set_counter("cores", std::thread::hardware_concurrency());
+}
+NMEA_BENCHMARK_ARGS(parse_batch, 1, 2, 4, 8, 16, 32);
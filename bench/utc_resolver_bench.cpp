@@ -0,0 +1,130 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Turning GGA times of a 10 Hz stream that crosses midnight into absolute
+// ns. utc_timegm is what consumers did by hand: split the double with fmod
+// and floor, then timegm with the date, checking for midnight by comparing
+// with the previous time. The others use NmeaUtcResolver on the doubles,
+// on the fields' text, and on the whole array at once.
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_utc_resolver.hpp"
+
+static size_t const TIME_COUNT = 100000U;
+// 10 Hz from 23:50:00.
+static size_t const FIRST_TENTH = 858000U;
+
+struct Times
+{
+  Times()
+  {
+    for (size_t i = 0U; i < TIME_COUNT; ++i)
+    {
+      size_t const tenths = (FIRST_TENTH + i) % 864000U;
+      char field[16];
+      int const length = std::snprintf(
+          field, sizeof(field), "%02u%02u%02u.%02u",
+          static_cast<unsigned>(tenths / 36000U),
+          static_cast<unsigned>(tenths / 600U % 60U),
+          static_cast<unsigned>(tenths / 10U % 60U),
+          static_cast<unsigned>(tenths % 10U * 10U));
+      text.push_back(std::string(field, static_cast<size_t>(length)));
+      timestamps.push_back(std::atof(field));
+    }
+  }
+
+  std::vector<double> timestamps;
+  std::vector<std::string> text;
+};
+
+static Times const &times()
+{
+  static Times const all;
+  return all;
+}
+
+static void utc_timegm(NmeaBenchState &state)
+{
+  std::vector<double> const &timestamps = times().timestamps;
+  int64_t sum = 0;
+  while (state.keep_running())
+  {
+    int day = 15;
+    double previous = 0.0;
+    for (size_t i = 0U; i < timestamps.size(); ++i)
+    {
+      double const timestamp = timestamps[i];
+      day += timestamp < previous ? 1 : 0;
+      previous = timestamp;
+      std::tm fields = std::tm();
+      fields.tm_year = 116;
+      fields.tm_mon = 2;
+      fields.tm_mday = day;
+      fields.tm_hour = static_cast<int>(std::floor(timestamp / 10000.0));
+      fields.tm_min =
+          static_cast<int>(std::floor(std::fmod(timestamp, 10000.0) / 100.0));
+      double const seconds = std::fmod(timestamp, 100.0);
+      fields.tm_sec = static_cast<int>(std::floor(seconds));
+      sum += static_cast<int64_t>(timegm(&fields)) * 1000000000LL +
+             std::llround((seconds - std::floor(seconds)) * 1e9);
+    }
+  }
+  nmea_bench_keep(sum);
+  state.set_items_per_iteration(static_cast<double>(timestamps.size()));
+}
+NMEA_BENCHMARK(utc_timegm);
+
+static void utc_resolver_double(NmeaBenchState &state)
+{
+  std::vector<double> const &timestamps = times().timestamps;
+  int64_t sum = 0;
+  while (state.keep_running())
+  {
+    NmeaUtcResolver resolver;
+    resolver.set_date(2016, 3U, 15U);
+    for (size_t i = 0U; i < timestamps.size(); ++i)
+    {
+      sum += resolver.resolve(timestamps[i]);
+    }
+  }
+  nmea_bench_keep(sum);
+  state.set_items_per_iteration(static_cast<double>(timestamps.size()));
+}
+NMEA_BENCHMARK(utc_resolver_double);
+
+static void utc_resolver_text(NmeaBenchState &state)
+{
+  std::vector<std::string> const &text = times().text;
+  int64_t sum = 0;
+  while (state.keep_running())
+  {
+    NmeaUtcResolver resolver;
+    resolver.set_date(2016, 3U, 15U);
+    for (size_t i = 0U; i < text.size(); ++i)
+    {
+      sum += resolver.resolve(text[i].data(), text[i].length());
+    }
+  }
+  nmea_bench_keep(sum);
+  state.set_items_per_iteration(static_cast<double>(text.size()));
+}
+NMEA_BENCHMARK(utc_resolver_text);
+
+static void utc_resolver_batch(NmeaBenchState &state)
+{
+  std::vector<double> const &timestamps = times().timestamps;
+  std::vector<int64_t> resolved(timestamps.size());
+  while (state.keep_running())
+  {
+    NmeaUtcResolver resolver;
+    resolver.set_date(2016, 3U, 15U);
+    resolver.resolve(timestamps.data(), timestamps.size(), resolved.data());
+    nmea_bench_keep(resolved.data());
+  }
+  state.set_items_per_iteration(static_cast<double>(timestamps.size()));
+}
+NMEA_BENCHMARK(utc_resolver_batch);
@@ -0,0 +1,152 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Position-only consumers: read latitude, longitude and fix quality from
+// every GGA of a generated log, and ground speed from every VTG, through
+// the eager parsers and through the lazy views. Items are sentences.
+// view_*_full converts every field through message() for comparison.
+
+#include <string>
+#include <vector>
+#include "nmea_bench.hpp"
+#include "nmea_corpus.hpp"
+#include "nmea_stream_framer.hpp"
+#include "nmea_view.hpp"
+
+using std::string;
+using std::vector;
+
+struct ViewCorpus
+{
+  ViewCorpus()
+      : text(generate_nmea_log(1U << 20, 7U))
+      , ggaBytes(0U)
+      , vtgBytes(0U)
+  {
+    size_t start = 0U;
+    size_t end = 0U;
+    while (string::npos != (end = text.find('\n', start)))
+    {
+      NmeaSentence sentence;
+      sentence.data = text.data() + start;
+      sentence.length = end - start;
+      NmeaMessageType const type =
+          identify_nmea(sentence.data, sentence.length);
+      if (NMEA_GGA == type)
+      {
+        gga.push_back(sentence);
+        ggaBytes += sentence.length + 1U;
+      }
+      else if (NMEA_VTG == type)
+      {
+        vtg.push_back(sentence);
+        vtgBytes += sentence.length + 1U;
+      }
+      start = end + 1U;
+    }
+  }
+
+  string const text;
+  vector<NmeaSentence> gga;
+  vector<NmeaSentence> vtg;
+  size_t ggaBytes;
+  size_t vtgBytes;
+};
+
+static ViewCorpus const &view_corpus()
+{
+  static ViewCorpus const corpus;
+  return corpus;
+}
+
+static void parse_gga_position(NmeaBenchState &state)
+{
+  ViewCorpus const &corpus = view_corpus();
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < corpus.gga.size(); ++i)
+    {
+      GgaMessageData const gga(
+          parse_gga(corpus.gga[i].data, corpus.gga[i].length));
+      double const position[3] = {gga.latitude, gga.longitude,
+                                  static_cast<double>(gga.fixQuality)};
+      nmea_bench_keep(position);
+    }
+  }
+  state.set_items_per_iteration(static_cast<double>(corpus.gga.size()));
+  state.set_bytes_per_iteration(static_cast<double>(corpus.ggaBytes));
+}
+NMEA_BENCHMARK(parse_gga_position);
+
+static void view_gga_position(NmeaBenchState &state)
+{
+  ViewCorpus const &corpus = view_corpus();
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < corpus.gga.size(); ++i)
+    {
+      GgaView const gga(corpus.gga[i].data, corpus.gga[i].length);
+      double position[3] = {0.0, 0.0, 0.0};
+      GgaFixQuality quality = GGA_INVALID;
+      gga.latitude(position[0]);
+      gga.longitude(position[1]);
+      gga.fix_quality(quality);
+      position[2] = static_cast<double>(quality);
+      nmea_bench_keep(position);
+    }
+  }
+  state.set_items_per_iteration(static_cast<double>(corpus.gga.size()));
+  state.set_bytes_per_iteration(static_cast<double>(corpus.ggaBytes));
+}
+NMEA_BENCHMARK(view_gga_position);
+
+static void view_gga_full(NmeaBenchState &state)
+{
+  ViewCorpus const &corpus = view_corpus();
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < corpus.gga.size(); ++i)
+    {
+      GgaMessageData const gga(
+          GgaView(corpus.gga[i].data, corpus.gga[i].length).message());
+      nmea_bench_keep(gga);
+    }
+  }
+  state.set_items_per_iteration(static_cast<double>(corpus.gga.size()));
+  state.set_bytes_per_iteration(static_cast<double>(corpus.ggaBytes));
+}
+NMEA_BENCHMARK(view_gga_full);
+
+static void parse_vtg_speed(NmeaBenchState &state)
+{
+  ViewCorpus const &corpus = view_corpus();
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < corpus.vtg.size(); ++i)
+    {
+      VtgMessageData const vtg(
+          parse_vtg(corpus.vtg[i].data, corpus.vtg[i].length));
+      nmea_bench_keep(vtg.groundSpeedKph);
+    }
+  }
+  state.set_items_per_iteration(static_cast<double>(corpus.vtg.size()));
+  state.set_bytes_per_iteration(static_cast<double>(corpus.vtgBytes));
+}
+NMEA_BENCHMARK(parse_vtg_speed);
+
+static void view_vtg_speed(NmeaBenchState &state)
+{
+  ViewCorpus const &corpus = view_corpus();
+  while (state.keep_running())
+  {
+    for (size_t i = 0U; i < corpus.vtg.size(); ++i)
+    {
+      VtgView const vtg(corpus.vtg[i].data, corpus.vtg[i].length);
+      double kph = 0.0;
+      vtg.ground_speed_kph(kph);
+      nmea_bench_keep(kph);
+    }
+  }
+  state.set_items_per_iteration(static_cast<double>(corpus.vtg.size()));
+  state.set_bytes_per_iteration(static_cast<double>(corpus.vtgBytes));
+}
+NMEA_BENCHMARK(view_vtg_speed);
@@ -0,0 +1,180 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+// Feeds arbitrary bytes to every parser entry point. Built with
+// -fsanitize=fuzzer it is a libFuzzer target; otherwise it carries its own
+// seeded mutator:
+//
+//   nmea_parser_fuzzer [ITERATIONS] [SEED]
+//
+// Either way, build with -fsanitize=address,undefined to catch reads past
+// the input.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <string>
+#include <vector>
+#include "nmea_checksum.hpp"
+#include "nmea_parser.hpp"
+#include "nmea_stream_framer.hpp"
+
+using std::string;
+using std::vector;
+
+static void check(bool const condition, char const *const what,
+                  uint8_t const *const data, size_t const size)
+{
+  if (!condition)
+  {
+    fprintf(stderr, "%s: \"%.*s\"\n", what, static_cast<int>(size),
+            reinterpret_cast<char const *>(data));
+    abort();
+  }
+}
+
+static void parse_everything(uint8_t const *const data, size_t const size)
+{
+  char const *const message = reinterpret_cast<char const *>(data);
+  NmeaParseError error;
+  for (int mode = 0; mode < 2; ++mode)
+  {
+    NmeaChecksumMode const checksum_mode =
+        0 == mode ? NMEA_VERIFY_CHECKSUM : NMEA_SKIP_CHECKSUM;
+    bool const nmea_valid =
+        parse_nmea(message, size, error, checksum_mode).valid();
+    check(nmea_valid == error.ok(), "parse_nmea", data, size);
+    bool const gga_valid = parse_gga(message, size, error, checksum_mode).valid;
+    check(gga_valid == error.ok(), "parse_gga", data, size);
+    bool const vtg_valid = parse_vtg(message, size, error, checksum_mode).valid;
+    check(vtg_valid == error.ok(), "parse_vtg", data, size);
+    bool const avr_valid = parse_avr(message, size, error, checksum_mode).valid;
+    check(avr_valid == error.ok(), "parse_avr", data, size);
+    bool const rmc_valid = parse_rmc(message, size, error, checksum_mode).valid;
+    check(rmc_valid == error.ok(), "parse_rmc", data, size);
+    bool const gsa_valid = parse_gsa(message, size, error, checksum_mode).valid;
+    check(gsa_valid == error.ok(), "parse_gsa", data, size);
+    bool const gsv_valid = parse_gsv(message, size, error, checksum_mode).valid;
+    check(gsv_valid == error.ok(), "parse_gsv", data, size);
+    bool const gst_valid = parse_gst(message, size, error, checksum_mode).valid;
+    check(gst_valid == error.ok(), "parse_gst", data, size);
+    bool const zda_valid = parse_zda(message, size, error, checksum_mode).valid;
+    check(zda_valid == error.ok(), "parse_zda", data, size);
+    bool const hdt_valid = parse_hdt(message, size, error, checksum_mode).valid;
+    check(hdt_valid == error.ok(), "parse_hdt", data, size);
+    bool const gns_valid = parse_gns(message, size, error, checksum_mode).valid;
+    check(gns_valid == error.ok(), "parse_gns", data, size);
+  }
+  identify_nmea(message, size);
+  nmea_checksum_valid(message, size);
+
+  NmeaStreamFramer framer(64U);
+  framer.push(message, size);
+  NmeaSentence sentence;
+  while (framer.next(sentence))
+  {
+    parse_nmea(sentence.data, sentence.length, error);
+  }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const *data, size_t size)
+{
+  parse_everything(data, size);
+  return 0;
+}
+
+#if !defined(NMEALIB_LIBFUZZER)
+
+static string const SEEDS[] = {
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47",
+    "$GNGGA,001043.00,4404.14036,N,12118.85961,W,1,12,0.98,1113.0,M,-21.3,M,"
+    "1.2,0031*68",
+    "$GPGGA,,,,,,0,00,99.99,,,,,,*48",
+    "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48",
+    "$GPVTG,054.7,T,,M,005.5,N,010.2,K*",
+    "$PTNL,AVR,212405.20,+52.1531,Yaw,-0.0806,Tilt,,,12.575,3,1.4,16*39",
+    "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A",
+    "$GNRMC,,V,,,,,,,,,,N*4D",
+    "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39",
+    "$GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*75",
+    "$GLGSV,2,2,08,70,-05,,,71,,,,,,,,,,,,1*59",
+    "$GPGST,024603.00,3.2,6.6,4.7,47.3,5.8,5.6,22.0*58",
+    "$GPZDA,201530.00,04,07,2002,-05,30*4B",
+    "$GPHDT,274.07,T*03",
+    "$GNGNS,014035.00,4332.69262,S,17235.48549,E,RR,13,0.9,25.63,11.24,,*70",
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+    "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n"};
+
+static void mutate(std::mt19937 &generator, string &input)
+{
+  static char const INTERESTING[] = "0123456789.,-+*$NEWSMTKYawTiltPTNL\r\n";
+  size_t const mutations = 1U + generator() % 8U;
+  for (size_t m = 0U; m < mutations; ++m)
+  {
+    size_t const position =
+        input.empty() ? 0U : generator() % (input.length() + 1U);
+    char const c = 0U == generator() % 4U
+                       ? static_cast<char>(generator())
+                       : INTERESTING[generator() % (sizeof(INTERESTING) - 1U)];
+    switch (generator() % 5U)
+    {
+    case 0U:
+      if (position < input.length())
+      {
+        input[position] = c;
+      }
+      break;
+    case 1U:
+      input.insert(position, 1U, c);
+      break;
+    case 2U:
+      input.erase(position, 1U + generator() % 16U);
+      break;
+    case 3U:
+      // Splice part of another seed in, which recombines whole fields.
+      {
+        string const &other = SEEDS[generator() % (sizeof(SEEDS) /
+                                                    sizeof(SEEDS[0]))];
+        size_t const from = generator() % other.length();
+        input.insert(position, other, from, 1U + generator() % 24U);
+      }
+      break;
+    default:
+      input.resize(position);
+      break;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  uint64_t const iterations =
+      1 < argc ? strtoull(argv[1], nullptr, 10) : 10000000U;
+  uint32_t const seed =
+      2 < argc ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 1U;
+  std::mt19937 generator(seed);
+  size_t const seed_count = sizeof(SEEDS) / sizeof(SEEDS[0]);
+  int status = 0;
+  try
+  {
+    for (uint64_t i = 0U; i < iterations; ++i)
+    {
+      string input(SEEDS[generator() % seed_count]);
+      mutate(generator, input);
+      // An exactly sized copy, so one byte past the end is out of bounds.
+      vector<uint8_t> const exact(input.begin(), input.end());
+      parse_everything(exact.empty() ? nullptr : exact.data(), exact.size());
+    }
+    printf("%llu inputs, no failures\n",
+           static_cast<unsigned long long>(iterations));
+  }
+  catch (std::exception const &exception)
+  {
+    fprintf(stderr, "parser threw: %s\n", exception.what());
+    status = 1;
+  }
+  return status;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_GGACOLUMNS_HPP
+#define NMEALIB_GGACOLUMNS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "nmea_parser.hpp"
+
+// Structure-of-arrays store of valid GGA fixes. Row i of every column belongs
+// to the same fix, so each column can be scanned on its own without the
+// padding and interleaved flags of std::vector<GgaMessageData>. The optional
+// DGPS fields keep one validity bit per row.
+struct GgaColumns
+{
+  void reserve(size_t const rows);
+  void clear();
+  inline size_t size() const { return timestamp.size(); }
+
+  // Invalid fixes and messages that are not GGA are skipped. Both return the
+  // number of rows added.
+  size_t append(GgaMessageData const &fix);
+  size_t append(NmeaMessage const *const messages, size_t const count);
+
+  GgaMessageData row(size_t const i) const;
+  inline bool hasTimeSinceLastDgps(size_t const i) const
+  {
+    return test_bit(timeSinceLastDgpsValid, i);
+  }
+  inline bool hasDgpsStationID(size_t const i) const
+  {
+    return test_bit(dgpsStationIDValid, i);
+  }
+
+  // Heap bytes held by the columns, counting reserved capacity.
+  size_t memory_bytes() const;
+
+  std::vector<double> timestamp;
+  std::vector<double> latitude;
+  std::vector<double> longitude;
+  std::vector<double> altitude;
+  std::vector<double> geoidHeight;
+  std::vector<double> hdop;
+  std::vector<uint8_t> fixQuality;
+  std::vector<uint16_t> numSatellites;
+  std::vector<double> timeSinceLastDgps;
+  std::vector<uint16_t> dgpsStationID;
+  std::vector<uint64_t> timeSinceLastDgpsValid;
+  std::vector<uint64_t> dgpsStationIDValid;
+
+private:
+  static inline bool test_bit(std::vector<uint64_t> const &bits,
+                              size_t const i)
+  {
+    return 0U != ((bits[i / 64U] >> (i % 64U)) & 1U);
+  }
+};
+
+#endif // NMEALIB_GGACOLUMNS_HPP
@@ -0,0 +1,115 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAARENA_HPP
+#define NMEALIB_NMEAARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Size of each block an arena takes from the heap, unless told otherwise.
+static size_t const NMEA_ARENA_BLOCK_BYTES = 64U * 1024U;
+
+// Monotonic memory for the strings of the std::string style API: handing
+// memory out is a pointer bump, giving it back does nothing, and reset()
+// makes all of it reusable at once. Blocks are kept across resets, so a
+// caller that resets once per batch stops touching the global heap after
+// the first few batches. Everything allocated before a reset must be gone
+// by then. Not thread safe; see nmea_thread_arena().
+class NmeaArena
+{
+public:
+  explicit NmeaArena(size_t const block_bytes = NMEA_ARENA_BLOCK_BYTES);
+  ~NmeaArena();
+
+  // alignment must be a power of two.
+  void *allocate(size_t const bytes, size_t const alignment);
+  void reset();
+  // Also returns the blocks to the heap.
+  void release();
+
+  // Bytes handed out since the last reset, counting alignment padding.
+  inline size_t used() const { return used_; }
+  // Bytes held in blocks.
+  inline size_t capacity() const { return capacity_; }
+  inline size_t blocks() const { return blocks_.size(); }
+
+private:
+  struct Block
+  {
+    char *data;
+    size_t size;
+  };
+
+  NmeaArena(NmeaArena const &);
+  NmeaArena &operator=(NmeaArena const &);
+
+  size_t blockBytes_;
+  std::vector<Block> blocks_;
+  // Block being carved up and the offset of its first free byte.
+  size_t current_;
+  size_t offset_;
+  size_t used_;
+  size_t capacity_;
+};
+
+// The calling thread's arena, created on first use and freed when the
+// thread exits.
+NmeaArena &nmea_thread_arena();
+
+// Standard allocator over an arena, the calling thread's by default. Two
+// allocators are equal when they share an arena.
+template <typename T>
+class NmeaArenaAllocator
+{
+public:
+  typedef T value_type;
+
+  inline NmeaArenaAllocator()
+      : arena_(&nmea_thread_arena())
+  {
+  }
+  inline explicit NmeaArenaAllocator(NmeaArena &arena)
+      : arena_(&arena)
+  {
+  }
+  template <typename U>
+  inline NmeaArenaAllocator(NmeaArenaAllocator<U> const &other)
+      : arena_(other.arena())
+  {
+  }
+
+  inline T *allocate(size_t const count)
+  {
+    return static_cast<T *>(arena_->allocate(count * sizeof(T), alignof(T)));
+  }
+  inline void deallocate(T *const, size_t const) {}
+
+  inline NmeaArena *arena() const { return arena_; }
+
+private:
+  NmeaArena *arena_;
+};
+
+template <typename T, typename U>
+inline bool operator==(NmeaArenaAllocator<T> const &a,
+                       NmeaArenaAllocator<U> const &b)
+{
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+inline bool operator!=(NmeaArenaAllocator<T> const &a,
+                       NmeaArenaAllocator<U> const &b)
+{
+  return a.arena() != b.arena();
+}
+
+// What the allocator-aware build_gga / build_vtg return for
+// NmeaArenaAllocator<char>(), and what the parsers take without a copy.
+typedef std::basic_string<char, std::char_traits<char>,
+                          NmeaArenaAllocator<char> >
+    NmeaArenaString;
+
+#endif // NMEALIB_NMEAARENA_HPP
@@ -0,0 +1,27 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEABATCHBUILDER_HPP
+#define NMEALIB_NMEABATCHBUILDER_HPP
+
+#include <cstddef>
+#include <string>
+#include "gga_columns.hpp"
+#include "vtg_columns.hpp"
+
+// Bulk sentence output, e.g. a receiver emulator publishing thousands of
+// units per epoch. Row i of the columns becomes the GGA of unit i followed
+// by its VTG when vtg is given, all appended back to back to output. Every
+// sentence is byte for byte what build_gga / build_vtg return for the row's
+// message, line feed included.
+//
+// Numbers are converted a column at a time, four per instruction where the
+// CPU has AVX2 and FMA, and only the digit writing runs row by row. A
+// num_threads of 0 uses one thread per hardware core; each thread writes a
+// contiguous range of rows and the pieces are joined in order.
+//
+// Returns the number of bytes appended; 0, with output unchanged, when vtg
+// does not have as many rows as gga.
+size_t build_nmea_batch(GgaColumns const &gga, VtgColumns const *const vtg,
+                        std::string &output, unsigned const num_threads = 1U);
+
+#endif // NMEALIB_NMEABATCHBUILDER_HPP
@@ -0,0 +1,25 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEABATCHPARSER_HPP
+#define NMEALIB_NMEABATCHPARSER_HPP
+
+#include <cstddef>
+#include "nmea_parser.hpp"
+
+// Bulk parsing of a contiguous, newline separated buffer such as a whole log
+// file. Every non-empty line yields one NmeaMessage, in input order; lines
+// that are not a supported sentence come back as NMEA_UNKNOWN so that
+// output[i] always corresponds to the i-th line.
+
+size_t count_nmea_lines(char const *const buffer, size_t const length,
+                        unsigned const num_threads = 1U);
+
+// Writes at most capacity records and returns how many were written. A
+// num_threads of 0 uses one thread per hardware core.
+size_t parse_nmea_batch(char const *const buffer, size_t const length,
+                        NmeaMessage *const output, size_t const capacity,
+                        unsigned const num_threads = 1U,
+                        NmeaChecksumMode const checksum_mode =
+                            NMEA_VERIFY_CHECKSUM);
+
+#endif // NMEALIB_NMEABATCHPARSER_HPP
@@ -3,9 +3,11 @@
 #ifndef NMEALIB_NMEABUILDER_HPP
 #define NMEALIB_NMEABUILDER_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include "gga_fix_quality.hpp"
+#include "nmea_parser.hpp"
 
 std::string build_gga(uint8_t utc_hour, uint8_t utc_minute, double utc_seconds,
                       double latitude_degrees, double longitude_degrees,
@@ -14,4 +16,90 @@ std::string build_gga(uint8_t utc_hour, uint8_t utc_minute, double utc_seconds,
 std::string build_vtg(double true_track_made_good_ned_degrees,
                       double ground_velocity_mps);
 
+// Enough room for any sentence the builders can produce, even with every
+// number at its largest.
+static size_t const NMEA_MAX_BUILD_LENGTH = 2048U;
+
+// The std::string versions with the string's memory from allocator, e.g.
+// NmeaArenaAllocator<char>() for the calling thread's NmeaArena.
+template <typename Allocator>
+std::basic_string<char, std::char_traits<char>, Allocator>
+build_gga(uint8_t utc_hour, uint8_t utc_minute, double utc_seconds,
+          double latitude_degrees, double longitude_degrees,
+          GgaFixQuality fix_quality, uint16_t num_satellites, double hdop,
+          double altitude_m, double geoid_height, Allocator const &allocator);
+template <typename Allocator>
+std::basic_string<char, std::char_traits<char>, Allocator>
+build_vtg(double true_track_made_good_ned_degrees, double ground_velocity_mps,
+          Allocator const &allocator);
+
+// Format into a caller supplied buffer without allocating. The text is the
+// same as the std::string versions return, is not null terminated, and the
+// return value is its length, or 0 if it did not fit in capacity.
+size_t build_gga(char *const buffer, size_t const capacity, uint8_t utc_hour,
+                 uint8_t utc_minute, double utc_seconds,
+                 double latitude_degrees, double longitude_degrees,
+                 GgaFixQuality fix_quality, uint16_t num_satellites,
+                 double hdop, double altitude_m, double geoid_height);
+size_t build_vtg(char *const buffer, size_t const capacity,
+                 double true_track_made_good_ned_degrees,
+                 double ground_velocity_mps);
+
+// Write a message back out as parsed, e.g. to re-emit a filtered stream.
+// Optional fields whose flag is clear are left empty, and AVR is written as
+// the Trimble "$PTNL,AVR," sentence.
+size_t build_avr(char *const buffer, size_t const capacity,
+                 AvrMessageData const &message);
+size_t build_gga(char *const buffer, size_t const capacity,
+                 GgaMessageData const &message);
+size_t build_vtg(char *const buffer, size_t const capacity,
+                 VtgMessageData const &message);
+// GNS is written with the "GN" talker and GSV with the one it was parsed
+// with; the rest use "GP".
+size_t build_rmc(char *const buffer, size_t const capacity,
+                 RmcMessageData const &message);
+size_t build_gsa(char *const buffer, size_t const capacity,
+                 GsaMessageData const &message);
+size_t build_gsv(char *const buffer, size_t const capacity,
+                 GsvMessageData const &message);
+size_t build_gst(char *const buffer, size_t const capacity,
+                 GstMessageData const &message);
+size_t build_zda(char *const buffer, size_t const capacity,
+                 ZdaMessageData const &message);
+size_t build_hdt(char *const buffer, size_t const capacity,
+                 HdtMessageData const &message);
+size_t build_gns(char *const buffer, size_t const capacity,
+                 GnsMessageData const &message);
+
+template <typename Allocator>
+std::basic_string<char, std::char_traits<char>, Allocator>
+build_gga(uint8_t const utc_hour, uint8_t const utc_minute,
+          double const utc_seconds, double const latitude_degrees,
+          double const longitude_degrees, GgaFixQuality const fix_quality,
+          uint16_t const num_satellites, double const hdop,
+          double const altitude_m, double const geoid_height,
+          Allocator const &allocator)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t const length =
+      build_gga(buffer, sizeof(buffer), utc_hour, utc_minute, utc_seconds,
+                latitude_degrees, longitude_degrees, fix_quality,
+                num_satellites, hdop, altitude_m, geoid_height);
+  return std::basic_string<char, std::char_traits<char>, Allocator>(
+      buffer, length, allocator);
+}
+
+template <typename Allocator>
+std::basic_string<char, std::char_traits<char>, Allocator>
+build_vtg(double const true_track_made_good_ned_degrees,
+          double const ground_velocity_mps, Allocator const &allocator)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t const length = build_vtg(buffer, sizeof(buffer),
+                                  true_track_made_good_ned_degrees,
+                                  ground_velocity_mps);
+  return std::basic_string<char, std::char_traits<char>, Allocator>(
+      buffer, length, allocator);
+}
+
 #endif // NMEALIB_NMEABUILDER_HPP
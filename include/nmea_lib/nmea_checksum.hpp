@@ -0,0 +1,24 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEACHECKSUM_HPP
+#define NMEALIB_NMEACHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+enum NmeaChecksumMode
+{
+  NMEA_VERIFY_CHECKSUM = 0,
+  NMEA_SKIP_CHECKSUM
+};
+
+// XOR of every byte in [data, data + length). Uses AVX2 or SSE2 when the CPU
+// has them.
+uint8_t nmea_checksum(char const *const data, size_t const length);
+uint8_t nmea_checksum_scalar(char const *const data, size_t const length);
+
+// True when a "$...*hh" sentence, optionally followed by CR/LF, carries the
+// checksum of the bytes between '$' and '*'.
+bool nmea_checksum_valid(char const *const sentence, size_t const length);
+
+#endif // NMEALIB_NMEACHECKSUM_HPP
@@ -0,0 +1,50 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEACOORDINATE_HPP
+#define NMEALIB_NMEACOORDINATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-point codec for the "ddmm.mmmm" / "dddmm.mmmm" angles of NMEA
+// positions. An angle is a signed count of nano-minutes (1e-9 arc minute,
+// about 1.9 mm of latitude): every text with up to nine decimals maps to
+// exactly one value and back, and 180 degrees is 1.08e13, well inside
+// int64_t. Callers that want no floating point can stay in this
+// representation; the conversions to and from degrees round only once.
+
+static int64_t const NMEA_NANO_MINUTES_PER_MINUTE = 1000000000;
+static int64_t const NMEA_NANO_MINUTES_PER_DEGREE =
+    60 * NMEA_NANO_MINUTES_PER_MINUTE;
+static size_t const NMEA_MAX_MINUTE_DECIMALS = 9U;
+// Room for any formatted angle, including one whose degrees overflow
+// degree_digits.
+static size_t const NMEA_COORDINATE_BUFFER_LENGTH = 40U;
+
+// Unsigned "ddmm.mmmm" with at least one degree digit, at most three, and a
+// '.'; minutes of 60 or more are rejected. Decimals past the ninth are
+// rounded half up on the tenth. The value is never negative; apply the
+// hemisphere separately.
+bool nmea_parse_nano_minutes(char const *const text, size_t const length,
+                             int64_t &nano_minutes);
+
+// Writes |nano_minutes| as degree_digits zero padded degrees, two minute
+// digits, '.' and decimals (at most nine) places, rounding half up and
+// carrying into minutes and degrees so "60" never appears. Returns the
+// length; nothing is null terminated.
+size_t nmea_format_nano_minutes(int64_t const nano_minutes,
+                                size_t const degree_digits,
+                                size_t const decimals, char *const output);
+
+// Nearest multiple of 10^(9 - decimals) nano-minutes, i.e. the value of the
+// angle printed with that many decimals, rounded once. Saturates far outside
+// any valid angle.
+int64_t nmea_degrees_to_nano_minutes(
+    double const degrees, size_t const decimals = NMEA_MAX_MINUTE_DECIMALS);
+double nmea_nano_minutes_to_degrees(int64_t const nano_minutes);
+
+// Exposed for tests and benchmarks: value of eight ASCII digits, or false if
+// any of them is not a digit.
+bool nmea_parse_eight_digits(char const *const text, uint32_t &value);
+
+#endif // NMEALIB_NMEACOORDINATE_HPP
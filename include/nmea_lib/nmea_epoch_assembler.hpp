@@ -0,0 +1,134 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAEPOCHASSEMBLER_HPP
+#define NMEALIB_NMEAEPOCHASSEMBLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "nmea_parser.hpp"
+
+// Epochs being assembled at once, and completed ones waiting to be read.
+static size_t const NMEA_EPOCH_MAX_PENDING = 8U;
+static size_t const NMEA_EPOCH_MAX_READY = 16U;
+
+enum NmeaEpochPart
+{
+  NMEA_EPOCH_POSITION = 1,
+  NMEA_EPOCH_VELOCITY = 2,
+  NMEA_EPOCH_HEADING = 4,
+  NMEA_EPOCH_ALL = 7
+};
+
+// Position from GGA, velocity from VTG and heading from AVR for one epoch.
+// Only the messages whose NmeaEpochPart bit is set in parts are filled in.
+struct NmeaNavigationEpoch
+{
+  // Start of the epoch in ms since midnight UTC.
+  uint32_t timeMs;
+  uint8_t parts;
+  GgaMessageData position;
+  VtgMessageData velocity;
+  AvrMessageData heading;
+};
+
+struct NmeaEpochAssemblerConfig
+{
+  inline NmeaEpochAssemblerConfig()
+      : periodMs(1000U)
+      , timeoutMs(2000U)
+      , requiredParts(NMEA_EPOCH_ALL)
+      , emitIncomplete(true)
+  {
+  }
+
+  // Message times are floored to a multiple of the period to find their
+  // epoch; 1000 gives one epoch per UTC second.
+  uint32_t periodMs;
+  // An epoch still missing parts is given up once a message arrives this
+  // many ms after the epoch's start.
+  uint32_t timeoutMs;
+  // The NmeaEpochPart bits that make an epoch complete.
+  uint8_t requiredParts;
+  // Whether given up epochs are still handed out with the parts they have.
+  bool emitIncomplete;
+};
+
+// Joins GGA, VTG and AVR into navigation epochs. GGA and AVR are placed by
+// their UTC time; VTG has none, so it joins the epoch of the last GGA or AVR
+// before it, and is dropped with that message when it was. A later message
+// of a type an epoch already has replaces it, and messages for an epoch
+// already handed out are dropped.
+//
+// Epochs are handed out as soon as they are complete, so one given up on a
+// timeout can follow a later complete one. All storage is inside the object,
+// so nothing is allocated per message or epoch.
+class NmeaEpochAssembler
+{
+public:
+  explicit NmeaEpochAssembler(
+      NmeaEpochAssemblerConfig const &config = NmeaEpochAssemblerConfig());
+
+  // Each returns the number of epochs made ready by the message. Messages of
+  // other types are ignored.
+  size_t add(NmeaMessage const &message);
+  size_t add(GgaMessageData const &gga);
+  size_t add(VtgMessageData const &vtg);
+  size_t add(AvrMessageData const &avr);
+
+  // Copies out the oldest ready epoch; false when there is none. When more
+  // than NMEA_EPOCH_MAX_READY are waiting, the oldest are overwritten.
+  bool next(NmeaNavigationEpoch &epoch);
+  // Gives up every pending epoch, e.g. at the end of the input. Returns the
+  // number made ready.
+  size_t flush();
+  void reset();
+
+  inline NmeaEpochAssemblerConfig const &config() const { return config_; }
+  inline size_t pending() const { return pendingCount_; }
+  inline size_t ready() const { return readyCount_; }
+  inline uint64_t completed() const { return completed_; }
+  // Epochs given up without all required parts, emitted or not.
+  inline uint64_t timedOut() const { return timedOut_; }
+  // Invalid messages, GGA and AVR with an unusable or stale time or for an
+  // epoch already handed out, and VTG with no open epoch to join.
+  inline uint64_t droppedMessages() const { return droppedMessages_; }
+  // Ready epochs overwritten before they were read.
+  inline uint64_t overwritten() const { return overwritten_; }
+
+private:
+  struct Slot
+  {
+    bool used;
+    // Handed out or given up, and kept only to turn away late messages
+    // until it times out.
+    bool closed;
+    // Creation order, to pick the oldest slot when all are in use.
+    uint64_t sequence;
+    NmeaNavigationEpoch epoch;
+  };
+
+  Slot *find_slot(uint32_t const time_ms, size_t &made_ready);
+  size_t expire(uint32_t const time_ms);
+  void close(Slot &slot);
+  size_t give_up(Slot &slot);
+  size_t finish(Slot &slot);
+  void push_ready(NmeaNavigationEpoch const &epoch);
+
+  NmeaEpochAssemblerConfig config_;
+  Slot slots_[NMEA_EPOCH_MAX_PENDING];
+  size_t pendingCount_;
+  uint64_t sequence_;
+  // The slot VTG joins, or null.
+  Slot *current_;
+  bool latestValid_;
+  uint32_t latestMs_;
+  NmeaNavigationEpoch ready_[NMEA_EPOCH_MAX_READY];
+  size_t readyHead_;
+  size_t readyCount_;
+  uint64_t completed_;
+  uint64_t timedOut_;
+  uint64_t droppedMessages_;
+  uint64_t overwritten_;
+};
+
+#endif // NMEALIB_NMEAEPOCHASSEMBLER_HPP
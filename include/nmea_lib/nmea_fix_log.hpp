@@ -0,0 +1,252 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAFIXLOG_HPP
+#define NMEALIB_NMEAFIXLOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "nmea_log_reader.hpp"
+#include "nmea_parser.hpp"
+
+// Compact binary log of parsed GGA, VTG and AVR fixes, so recorded drives
+// can be replayed without parsing text again.
+//
+// The file is a 16 byte header followed by blocks. Each block holds up to
+// a few thousand records of one type behind a 32 byte block header, and
+// every record is a fixed-width struct stored little-endian whatever the
+// host; nmea_fix_decode() handles the byte order. Timestamps and GGA
+// coordinates are stored as signed offsets from the block's base values,
+// which keeps records small while leaving each one decodable on its own: a
+// reader can index any record of a mapped block directly.
+//
+// Values are stored in fixed point:
+//   time of day                 1 ms
+//   latitude, longitude         1e-9 minute (nmea_coordinate.hpp)
+//   altitude, geoid height      1 mm
+//   HDOP, PDOP, tracks          0.01
+//   DGPS age                    1 ms
+//   speeds, AVR range           0.001
+//   AVR yaw, tilt               0.0001 degree
+// Any sentence written with no more decimals than these decodes to exactly
+// the double parse_* returns for it. Coordinates of one block lie within
+// about 2 minutes of its first record; a record further away, or a record
+// whose time presence differs, starts a new block.
+
+static uint32_t const NMEA_FIX_LOG_VERSION = 1U;
+static size_t const NMEA_FIX_LOG_BLOCK_RECORDS = 4096U;
+
+struct NmeaFixLogHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t blockHeaderSize;
+};
+
+struct NmeaFixBlockHeader
+{
+  uint8_t type;
+  uint8_t recordSize;
+  uint16_t reserved;
+  uint32_t count;
+  // NMEA_LOG_NO_TIME when the block's records carry no time
+  uint32_t baseTimeMs;
+  uint32_t reserved2;
+  // Nano-minutes; zero for blocks without coordinates
+  int64_t baseLatitude;
+  int64_t baseLongitude;
+};
+
+static uint8_t const NMEA_FIX_GGA_DGPS_AGE = 0x01U;
+static uint8_t const NMEA_FIX_GGA_DGPS_STATION = 0x02U;
+
+struct NmeaFixGgaRecord
+{
+  int32_t timeMs;
+  int32_t latitude;
+  int32_t longitude;
+  int32_t altitudeMm;
+  int32_t geoidHeightMm;
+  uint32_t dgpsAgeMs;
+  uint16_t hdop;
+  uint16_t numSatellites;
+  uint16_t dgpsStationId;
+  uint8_t fixQuality;
+  // NMEA_FIX_GGA_DGPS_* bits
+  uint8_t flags;
+};
+
+static uint16_t const NMEA_FIX_VTG_NO_MAGNETIC_TRACK = 0xFFFFU;
+
+struct NmeaFixVtgRecord
+{
+  int32_t timeMs;
+  uint16_t trueTrack;
+  uint16_t magneticTrack;
+  uint32_t speedKnots;
+  uint32_t speedKph;
+};
+
+struct NmeaFixAvrRecord
+{
+  int32_t timeMs;
+  int32_t yaw;
+  int32_t tilt;
+  uint32_t rangeMm;
+  uint16_t pdop;
+  uint16_t numSatellites;
+  uint8_t fixQuality;
+  uint8_t reserved[3];
+};
+
+// Decodes one mapped record against its block header from
+// NmeaFixLogReader::block().
+GgaMessageData nmea_fix_decode(NmeaFixBlockHeader const &block,
+                               NmeaFixGgaRecord const &record);
+VtgMessageData nmea_fix_decode(NmeaFixBlockHeader const &block,
+                               NmeaFixVtgRecord const &record);
+AvrMessageData nmea_fix_decode(NmeaFixBlockHeader const &block,
+                               NmeaFixAvrRecord const &record);
+// UTC time of day in ms of a record's timeMs as stored, or
+// NMEA_LOG_NO_TIME. GGA and AVR records carry their own time; VTG records
+// carry the last time appended before them.
+uint32_t nmea_fix_time_ms(NmeaFixBlockHeader const &block,
+                          int32_t const record_time_ms);
+
+// Appends fixes to a new file. Each type fills its own block, which is
+// written once full, so blocks of different types interleave in the file
+// in the order they filled up rather than in arrival order.
+class NmeaFixLogWriter
+{
+public:
+  explicit NmeaFixLogWriter(
+      size_t const block_records = NMEA_FIX_LOG_BLOCK_RECORDS);
+  ~NmeaFixLogWriter();
+
+  bool open(std::string const &path);
+  // Writes the partly filled blocks; false if any write failed.
+  bool close();
+
+  // False for invalid messages and for values the format cannot hold, such
+  // as a negative speed; those are counted as skipped.
+  bool append(GgaMessageData const &gga);
+  bool append(VtgMessageData const &vtg);
+  bool append(AvrMessageData const &avr);
+  // Stores GGA, VTG and AVR messages. RMC, GST, ZDA and GNS only update the
+  // time given to the VTG records that follow; they return false.
+  bool append(NmeaMessage const &message);
+
+  inline uint64_t records() const { return records_; }
+  inline uint64_t skipped() const { return skipped_; }
+  inline uint64_t blocks() const { return blocks_; }
+  inline uint64_t bytes() const { return bytes_; }
+
+private:
+  NmeaFixLogWriter(NmeaFixLogWriter const &);
+  NmeaFixLogWriter &operator=(NmeaFixLogWriter const &);
+
+  bool fits(NmeaFixBlockHeader const &block, size_t const count,
+            uint32_t const time_ms, int64_t const latitude,
+            int64_t const longitude) const;
+  void begin_block(NmeaFixBlockHeader &block, NmeaMessageType const type,
+                   size_t const record_size, uint32_t const time_ms,
+                   int64_t const latitude, int64_t const longitude);
+  void write_block(NmeaFixBlockHeader &block, void const *const records,
+                   size_t const count);
+
+  size_t blockRecords_;
+  FILE *file_;
+  bool failed_;
+  uint32_t lastTimeMs_;
+  NmeaFixBlockHeader ggaBlock_;
+  NmeaFixBlockHeader vtgBlock_;
+  NmeaFixBlockHeader avrBlock_;
+  std::vector<NmeaFixGgaRecord> gga_;
+  std::vector<NmeaFixVtgRecord> vtg_;
+  std::vector<NmeaFixAvrRecord> avr_;
+  uint64_t records_;
+  uint64_t skipped_;
+  uint64_t blocks_;
+  uint64_t bytes_;
+};
+
+// Read-only, memory mapped view of a fix log. open() checks the file
+// header and walks the block headers once; records are decoded only when
+// asked for, straight from the mapping.
+//
+//   for (size_t b = 0U; b < reader.blocks(); ++b)
+//   {
+//     NmeaFixGgaRecord const *const records = reader.gga(b);
+//     for (uint32_t i = 0U; nullptr != records && i < reader.block(b).count;
+//          ++i)
+//     {
+//       GgaMessageData const gga(nmea_fix_decode(reader.block(b),
+//                                                records[i]));
+//     }
+//   }
+class NmeaFixLogReader
+{
+public:
+  NmeaFixLogReader();
+  ~NmeaFixLogReader();
+
+  // False if the file is missing, is not a fix log, or is truncated.
+  bool open(std::string const &path);
+  void close();
+
+  inline size_t blocks() const { return blocks_.size(); }
+  // In host byte order
+  inline NmeaFixBlockHeader const &block(size_t const i) const
+  {
+    return blocks_[i];
+  }
+  // The block's records, or nullptr if it holds another type.
+  NmeaFixGgaRecord const *gga(size_t const i) const;
+  NmeaFixVtgRecord const *vtg(size_t const i) const;
+  NmeaFixAvrRecord const *avr(size_t const i) const;
+
+  // Number of records of one type in the whole file.
+  uint64_t count(NmeaMessageType const type) const;
+
+private:
+  NmeaFixLogReader(NmeaFixLogReader const &);
+  NmeaFixLogReader &operator=(NmeaFixLogReader const &);
+
+  void const *records(size_t const i, NmeaMessageType const type) const;
+
+  void *mapping_;
+  size_t length_;
+  std::vector<NmeaFixBlockHeader> blocks_;
+  std::vector<char const *> records_;
+};
+
+struct NmeaFixLogConversion
+{
+  inline NmeaFixLogConversion()
+      : textBytes(0U)
+      , sentences(0U)
+      , records(0U)
+      , skipped(0U)
+      , fixBytes(0U)
+  {
+  }
+
+  uint64_t textBytes;
+  uint64_t sentences;
+  uint64_t records;
+  // Sentences of a stored type that failed to parse or to encode
+  uint64_t skipped;
+  uint64_t fixBytes;
+};
+
+// Converts a recorded NMEA text log into a fix log, keeping its GGA, VTG
+// and AVR sentences. The text is streamed, so logs of any size convert in
+// constant memory.
+bool nmea_fix_log_convert(
+    std::string const &text_path, std::string const &fix_path,
+    NmeaFixLogConversion &conversion,
+    NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM);
+
+#endif // NMEALIB_NMEAFIXLOG_HPP
@@ -0,0 +1,113 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAFIXQUERY_HPP
+#define NMEALIB_NMEAFIXQUERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "gga_columns.hpp"
+
+// Consecutive fixes summarized together by NmeaFixIndex, a multiple of 64 so
+// that a tile is whole words of a selection bitmap.
+static size_t const NMEA_FIX_TILE_ROWS = 1024U;
+
+inline uint32_t nmea_fix_quality_bit(GgaFixQuality const quality)
+{
+  return static_cast<uint32_t>(1U) << static_cast<uint32_t>(quality);
+}
+
+// Conditions a selected fix meets all of. The defaults select every fix
+// whose numbers are not NaN, so only the conditions wanted need setting:
+//
+//   NmeaFixQuery query;
+//   query.fixQualities = nmea_fix_quality_bit(GGA_RTK_FIXED);
+//   query.hdopBelow = 1.0;
+struct NmeaFixQuery
+{
+  NmeaFixQuery();
+
+  // nmea_fix_quality_bit of every accepted fix quality.
+  uint32_t fixQualities;
+  // Exclusive upper bound.
+  double hdopBelow;
+  uint16_t minSatellites;
+  // Inclusive ranges in degrees and in GGA hhmmss.ss times of day. Ranges
+  // across the antimeridian or midnight take two queries.
+  double minLatitude;
+  double maxLatitude;
+  double minLongitude;
+  double maxLongitude;
+  double minTimestamp;
+  double maxTimestamp;
+  // Optional geofence: a polygon of latitude and longitude vertices in
+  // degrees, closed from the last back to the first, with straight edges in
+  // degrees. Fixes are inside by the even-odd rule; those exactly on an edge
+  // may fall either way. No vertices means no fence.
+  std::vector<double> fenceLatitudes;
+  std::vector<double> fenceLongitudes;
+};
+
+// Summary of the fixes of one tile.
+struct NmeaFixTile
+{
+  double minLatitude;
+  double maxLatitude;
+  double minLongitude;
+  double maxLongitude;
+  double minTimestamp;
+  double maxTimestamp;
+  double minHdop;
+  double maxHdop;
+  // nmea_fix_quality_bit of every quality present.
+  uint32_t fixQualities;
+  uint16_t minSatellites;
+  uint16_t maxSatellites;
+  // No NaN and no quality past the bits, so the ranges bound every fix.
+  bool bounded;
+};
+
+// Query index over GgaColumns. Fixes are summarized in tiles of
+// NMEA_FIX_TILE_ROWS rows: bounding box, time span, hdop and satellite
+// ranges and the fix qualities present. A log is a track, so a tile covers
+// a small area and time, and a query skips the tiles that cannot match and
+// takes those lying wholly inside it without looking at their rows. The
+// other rows are filtered four to an instruction where the CPU has AVX2,
+// and only the fixes passing every other condition are tested against the
+// geofence.
+class NmeaFixIndex
+{
+public:
+  // The columns must outlive the index, which is built again after they
+  // change.
+  explicit NmeaFixIndex(GgaColumns const &fixes);
+
+  // Bit i % 64 of word i / 64 is set if fix i is selected; the bitmap is
+  // resized to the fixes. All three return the number of fixes selected.
+  size_t select(NmeaFixQuery const &query,
+                std::vector<uint64_t> &bitmap) const;
+  // Rows of the selected fixes in increasing order, replacing those held.
+  size_t select_rows(NmeaFixQuery const &query,
+                     std::vector<size_t> &rows) const;
+  // The same selection tested one fix at a time, without the tiles.
+  size_t select_scalar(NmeaFixQuery const &query,
+                       std::vector<uint64_t> &bitmap) const;
+
+  // Tiles a query has to look at, whole or row by row; the rest are pruned.
+  size_t candidate_tiles(NmeaFixQuery const &query) const;
+  inline std::vector<NmeaFixTile> const &tiles() const { return tiles_; }
+
+private:
+  NmeaFixIndex(NmeaFixIndex const &);
+  NmeaFixIndex &operator=(NmeaFixIndex const &);
+
+  GgaColumns const &fixes_;
+  std::vector<NmeaFixTile> tiles_;
+};
+
+// Rows of the set bits of a selection bitmap in increasing order, replacing
+// those held.
+void nmea_selection_rows(std::vector<uint64_t> const &bitmap,
+                         std::vector<size_t> &rows);
+
+#endif // NMEALIB_NMEAFIXQUERY_HPP
@@ -0,0 +1,67 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAGSVAGGREGATOR_HPP
+#define NMEALIB_NMEAGSVAGGREGATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "nmea_parser.hpp"
+
+// A GSV group is at most nine sentences of four satellites.
+static size_t const NMEA_GSV_MAX_SATELLITES =
+    9U * NMEA_GSV_SATELLITES_PER_SENTENCE;
+// Groups assembled at once, one per talker and signal ID. A new talker and
+// signal beyond these takes the place of the least recently used one.
+static size_t const NMEA_GSV_MAX_GROUPS = 16U;
+
+struct GsvSatelliteGroup
+{
+  char talker[2];
+  bool signalIdValid;
+  uint8_t signalId;
+  uint16_t satellitesInView;
+  uint8_t numSatellites;
+  GsvSatellite satellites[NMEA_GSV_MAX_SATELLITES];
+};
+
+// Joins the sentences of each GSV group into one satellite list. All storage
+// is inside the object, so nothing is allocated per message.
+class NmeaGsvAggregator
+{
+public:
+  NmeaGsvAggregator();
+
+  // Returns the whole group when message is its last sentence, otherwise
+  // null. The group stays valid until the next sentence from the same talker
+  // and signal, or until a new talker and signal takes its place. Invalid
+  // and out of sequence sentences are dropped along with the partial group
+  // they interrupt.
+  GsvSatelliteGroup const *add(GsvMessageData const &message);
+
+  inline uint64_t groups() const { return groups_; }
+  // Sentences that did not end up in a completed group.
+  inline uint64_t dropped() const { return dropped_; }
+  void reset();
+
+private:
+  struct Slot
+  {
+    bool used;
+    uint8_t totalMessages;
+    // 0 when no group is in progress
+    uint8_t nextMessage;
+    // When the slot last took a sentence, to pick one to reuse.
+    uint64_t lastUsed;
+    GsvSatelliteGroup group;
+  };
+
+  Slot *find_slot(GsvMessageData const &message);
+  void abandon(Slot &slot);
+
+  Slot slots_[NMEA_GSV_MAX_GROUPS];
+  uint64_t uses_;
+  uint64_t groups_;
+  uint64_t dropped_;
+};
+
+#endif // NMEALIB_NMEAGSVAGGREGATOR_HPP
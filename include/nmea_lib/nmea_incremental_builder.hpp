@@ -0,0 +1,116 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAINCREMENTALBUILDER_HPP
+#define NMEALIB_NMEAINCREMENTALBUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "gga_fix_quality.hpp"
+#include "nmea_builder.hpp"
+
+// Stateful alternatives to build_gga and build_vtg for one stream whose
+// consecutive sentences differ in a few fields, e.g. an emulated receiver.
+// The last sentence is kept; a field whose input changed is formatted again
+// and written over its old text, and the checksum is updated by XOR with the
+// bytes that changed instead of recomputed. When a field's text changes
+// width the whole sentence is built again. The text is always what
+// build_gga / build_vtg return for the same arguments.
+class NmeaIncrementalSentence
+{
+public:
+  // The last sentence built, valid until the next call.
+  inline char const *data() const { return sentence_; }
+  inline size_t length() const { return length_; }
+
+  // Sentences built from scratch: the first one and every one where a field
+  // changed width.
+  inline uint64_t fullBuilds() const { return fullBuilds_; }
+  // Fields rewritten in place.
+  inline uint64_t patchedFields() const { return patchedFields_; }
+
+  // Forgets the last sentence, so the next one is built from scratch.
+  void reset();
+
+  // The text a patched field covers: wire fields first through last, counted
+  // from the one after the header, and the commas between them.
+  struct Span
+  {
+    uint8_t first;
+    uint8_t last;
+  };
+
+  static size_t const MAX_SPANS = 8U;
+
+protected:
+  NmeaIncrementalSentence();
+
+  // Takes the sentence just written to sentence_ and finds each span in it.
+  void adopt(size_t const length, size_t const header_length,
+             Span const *const spans, size_t const count);
+  // Writes text over span if it is as wide as the old text; false if not,
+  // and the sentence must then be built again.
+  bool patch(size_t const span, char const *const text, size_t const length);
+  // patch with the text Field, a field kind of the sentence schemas, writes
+  // for message.
+  template <typename Field, typename Message>
+  bool patch_field(size_t const span, Message const &message);
+  // Puts the checksum of the patched sentence in place.
+  void seal();
+
+  char sentence_[NMEA_MAX_BUILD_LENGTH];
+  size_t length_;
+
+private:
+  NmeaIncrementalSentence(NmeaIncrementalSentence const &);
+  NmeaIncrementalSentence &operator=(NmeaIncrementalSentence const &);
+
+  uint16_t offsets_[MAX_SPANS];
+  uint16_t widths_[MAX_SPANS];
+  uint8_t checksum_;
+  uint64_t fullBuilds_;
+  uint64_t patchedFields_;
+};
+
+class GgaIncrementalBuilder : public NmeaIncrementalSentence
+{
+public:
+  GgaIncrementalBuilder();
+
+  // Same arguments as build_gga; returns the length, or 0 if the sentence
+  // could not be built.
+  size_t build(uint8_t const utc_hour, uint8_t const utc_minute,
+               double const utc_seconds, double const latitude_degrees,
+               double const longitude_degrees,
+               GgaFixQuality const fix_quality, uint16_t const num_satellites,
+               double const hdop, double const altitude_m,
+               double const geoid_height);
+
+private:
+  uint8_t utcHour_;
+  uint8_t utcMinute_;
+  double utcSeconds_;
+  double latitude_;
+  double longitude_;
+  GgaFixQuality fixQuality_;
+  uint16_t numSatellites_;
+  double hdop_;
+  double altitude_;
+  double geoidHeight_;
+};
+
+class VtgIncrementalBuilder : public NmeaIncrementalSentence
+{
+public:
+  VtgIncrementalBuilder();
+
+  // Same arguments as build_vtg; returns the length, or 0 if the sentence
+  // could not be built.
+  size_t build(double const true_track_made_good_ned_degrees,
+               double const ground_velocity_mps);
+
+private:
+  double trueTrack_;
+  double groundVelocity_;
+};
+
+#endif // NMEALIB_NMEAINCREMENTALBUILDER_HPP
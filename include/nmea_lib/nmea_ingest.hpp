@@ -0,0 +1,141 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAINGEST_HPP
+#define NMEALIB_NMEAINGEST_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+#include "nmea_parser.hpp"
+#include "nmea_stream_framer.hpp"
+
+// One parsed sentence from one source, handed to that source's callback. The
+// sentence view and the message are only valid during the call.
+struct NmeaIngestEvent
+{
+  inline NmeaIngestEvent()
+      : source(0U)
+      , arrivalNs(0U)
+      , sentence()
+      , error()
+      , message()
+  {
+  }
+
+  size_t source;
+  // Steady clock time of the read that completed the sentence, on the same
+  // base as nmea_pipeline_now_ns().
+  uint64_t arrivalNs;
+  NmeaSentence sentence;
+  NmeaParseError error;
+  NmeaMessage message;
+};
+
+typedef std::function<void(NmeaIngestEvent const &)> NmeaIngestCallback;
+
+struct NmeaIngestSourceStats
+{
+  inline NmeaIngestSourceStats()
+      : bytes(0U)
+      , reads(0U)
+      , sentences(0U)
+      , parseErrors(0U)
+  {
+  }
+
+  uint64_t bytes;
+  uint64_t reads;
+  uint64_t sentences;
+  uint64_t parseErrors;
+};
+
+// Reads any number of serial ports, TCP feeds or other byte streams from one
+// thread. Every source is a non-blocking descriptor registered with a single
+// epoll set; when one becomes readable it gets one read of up to
+// read_bytes, which is framed with that source's NmeaStreamFramer, decoded
+// with parse_nmea and passed to that source's callback. One read per
+// readiness keeps a busy port from starving the others.
+//
+//   NmeaIngestEngine engine;
+//   size_t gps = 0U;
+//   engine.open_serial("/dev/ttyUSB0", 115200U, on_gps, gps);
+//   size_t base = 0U;
+//   engine.connect_tcp("10.0.0.5", 5017U, on_base, base);
+//   engine.run();  // until stop() or every source has closed
+//
+// A source is closed when its peer hangs up or a read fails, and its
+// descriptor is closed with it. Sources may only be added and removed from
+// the thread that polls, including from inside a callback; stop() may be
+// called from any thread. For more cores, run one engine per thread over a
+// share of the sources. Linux only.
+class NmeaIngestEngine
+{
+public:
+  explicit NmeaIngestEngine(
+      NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM,
+      size_t const read_bytes = 4096U);
+  ~NmeaIngestEngine();
+
+  // False if the epoll set could not be created; nothing else will work.
+  inline bool valid() const { return 0 <= epollFd_; }
+
+  // Takes ownership of fd, which is switched to non-blocking.
+  bool add_fd(int const fd, NmeaIngestCallback const &callback,
+              size_t &source);
+  // Opens a tty raw, 8N1, without becoming its controlling terminal. baud is
+  // one of the standard rates from 1200 to 230400.
+  bool open_serial(std::string const &device, uint32_t const baud,
+                   NmeaIngestCallback const &callback, size_t &source);
+  // Connects (blocking) to host:port, then reads the socket like any other
+  // source.
+  bool connect_tcp(std::string const &host, uint16_t const port,
+                   NmeaIngestCallback const &callback, size_t &source);
+  // Closes the source; false if it was not open.
+  bool remove(size_t const source);
+
+  // Waits up to timeout_ms (-1 forever) for input and handles whatever is
+  // ready. Returns the number of sentences delivered.
+  size_t poll(int const timeout_ms);
+  // Polls until stop() is called or no source is left open.
+  void run();
+  void stop();
+
+  inline size_t sources() const { return sources_.size(); }
+  inline size_t open_sources() const { return openSources_; }
+  bool is_open(size_t const source) const;
+  NmeaIngestSourceStats const &stats(size_t const source) const;
+  NmeaStreamFramer const &framer(size_t const source) const;
+
+private:
+  NmeaIngestEngine(NmeaIngestEngine const &);
+  NmeaIngestEngine &operator=(NmeaIngestEngine const &);
+
+  struct Source
+  {
+    Source();
+
+    int fd;
+    NmeaIngestCallback callback;
+    NmeaStreamFramer framer;
+    NmeaIngestSourceStats stats;
+  };
+
+  size_t read_source(size_t const source);
+
+  NmeaChecksumMode checksumMode_;
+  int epollFd_;
+  // Written by stop() to wake a blocked poll().
+  int wakeFd_;
+  // A deque so a callback that adds a source does not move its own.
+  std::deque<Source> sources_;
+  size_t openSources_;
+  std::vector<char> readBuffer_;
+  NmeaIngestEvent event_;
+  std::atomic<bool> stopping_;
+};
+
+#endif // NMEALIB_NMEAINGEST_HPP
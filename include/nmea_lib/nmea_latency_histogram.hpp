@@ -0,0 +1,50 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEALATENCYHISTOGRAM_HPP
+#define NMEALIB_NMEALATENCYHISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear histogram of nanosecond latencies: each power of two is split
+// into eight buckets, so a reported percentile is within 12.5% of the true
+// value. Recording is a few instructions and never allocates. Not
+// synchronized; keep one per thread and merge.
+class NmeaLatencyHistogram
+{
+public:
+  static size_t const SUB_BUCKET_BITS = 3U;
+  static size_t const SUB_BUCKETS = 1U << SUB_BUCKET_BITS;
+  // Up to 2^40 ns, about 18 minutes; longer samples land in the last bucket.
+  static size_t const BUCKETS = (41U - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+  NmeaLatencyHistogram();
+
+  void record(uint64_t const nanoseconds);
+  // The same value several times over, e.g. when rebuilding from buckets.
+  void record(uint64_t const nanoseconds, uint64_t const samples);
+  void merge(NmeaLatencyHistogram const &other);
+  void reset();
+
+  inline uint64_t count() const { return count_; }
+  inline uint64_t min() const { return 0U == count_ ? 0U : min_; }
+  inline uint64_t max() const { return max_; }
+  double mean() const;
+  // Upper bound of the bucket holding the given fraction of samples, e.g.
+  // 0.99 for the 99th percentile; 0 when empty.
+  uint64_t percentile(double const fraction) const;
+
+  inline uint64_t bucket(size_t const index) const { return buckets_[index]; }
+
+  static size_t bucket_index(uint64_t const nanoseconds);
+  static uint64_t bucket_upper_bound(size_t const index);
+
+private:
+  uint64_t buckets_[BUCKETS];
+  uint64_t count_;
+  uint64_t min_;
+  uint64_t max_;
+  double sum_;
+};
+
+#endif // NMEALIB_NMEALATENCYHISTOGRAM_HPP
@@ -0,0 +1,81 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEALOGREADER_HPP
+#define NMEALIB_NMEALOGREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "nmea_parser.hpp"
+
+// One line of the log as recorded in the index. timeMs is the UTC time of day
+// in milliseconds taken from the sentence itself for GGA/AVR and carried over
+// from the last timed sentence for the others; NMEA_LOG_NO_TIME if none has
+// been seen yet.
+struct NmeaLogIndexEntry
+{
+  uint64_t offset;
+  uint32_t timeMs;
+  uint16_t length;
+  uint8_t type;
+  uint8_t reserved;
+};
+
+static uint32_t const NMEA_LOG_NO_TIME = 0xFFFFFFFFU;
+
+// Read-only, memory mapped view of a recorded NMEA log. The first open()
+// scans the file once and stores the index as "<path>.idx"; later opens map
+// that sidecar instead of rescanning as long as the log's size and
+// modification time still match. Sentences are only decoded on request.
+class NmeaLogReader
+{
+public:
+  NmeaLogReader();
+  ~NmeaLogReader();
+
+  bool open(std::string const &path);
+  void close();
+
+  inline size_t size() const { return count_; }
+  inline bool indexFromSidecar() const { return indexFromSidecar_; }
+  inline NmeaLogIndexEntry const &entry(size_t const i) const
+  {
+    return entries_[i];
+  }
+  inline char const *sentence(size_t const i) const
+  {
+    return data_ + entries_[i].offset;
+  }
+
+  NmeaMessage decode(size_t const i,
+                     NmeaChecksumMode const checksum_mode =
+                         NMEA_VERIFY_CHECKSUM) const;
+
+  // Appends the entry numbers of sentences of the given type whose time lies
+  // in [begin_timestamp, end_timestamp], both in hhmmss.ss like
+  // GgaMessageData::timestamp. Only the index is read. Nothing matches if
+  // either bound is not a time of day. A begin after the end is a window
+  // across midnight. The index keeps the time of day only, so a log spanning
+  // several days returns the matches from every one of them.
+  size_t find(NmeaMessageType const type, double const begin_timestamp,
+              double const end_timestamp, std::vector<size_t> &matches) const;
+
+private:
+  NmeaLogReader(NmeaLogReader const &);
+  NmeaLogReader &operator=(NmeaLogReader const &);
+
+  bool load_index(std::string const &index_path, int64_t const modified);
+  void build_index(std::string const &index_path, int64_t const modified);
+
+  char const *data_;
+  size_t dataLength_;
+  void *indexMapping_;
+  size_t indexMappingLength_;
+  std::vector<NmeaLogIndexEntry> builtEntries_;
+  NmeaLogIndexEntry const *entries_;
+  size_t count_;
+  bool indexFromSidecar_;
+};
+
+#endif // NMEALIB_NMEALOGREADER_HPP
@@ -0,0 +1,21 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAMESSAGETYPE_HPP
+#define NMEALIB_NMEAMESSAGETYPE_HPP
+
+enum NmeaMessageType
+{
+  NMEA_UNKNOWN = 0,
+  NMEA_AVR,
+  NMEA_GGA,
+  NMEA_VTG,
+  NMEA_RMC,
+  NMEA_GSA,
+  NMEA_GSV,
+  NMEA_GST,
+  NMEA_ZDA,
+  NMEA_HDT,
+  NMEA_GNS
+};
+
+#endif // NMEALIB_NMEAMESSAGETYPE_HPP
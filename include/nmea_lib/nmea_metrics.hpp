@@ -0,0 +1,74 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAMETRICS_HPP
+#define NMEALIB_NMEAMETRICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "nmea_latency_histogram.hpp"
+#include "nmea_message_type.hpp"
+#include "nmea_parse_error.hpp"
+
+// Process-wide parser health, collected when the library is built with
+// NMEALIB_METRICS (cmake -DMETRICS=ON). Every parse_* and parse_nmea call is
+// counted by sentence type and result in per-thread counters, and one call in
+// NMEA_METRICS_SAMPLE_PERIOD on each thread is timed on the steady clock.
+// Without the flag the parser contains no instrumentation at all, and the
+// functions below report nothing.
+//
+//   NmeaMetricsSnapshot snapshot;
+//   nmea_metrics_snapshot(snapshot);
+//   std::string const page(nmea_metrics_prometheus(snapshot));
+
+static size_t const NMEA_MESSAGE_TYPE_COUNT = NMEA_GNS + 1U;
+static uint32_t const NMEA_METRICS_SAMPLE_PERIOD = 64U;
+
+// Lower case sentence ID, e.g. "gga"; "unknown" for NMEA_UNKNOWN.
+char const *nmea_message_type_name(NmeaMessageType const type);
+
+// Tallies for one sentence type, taken from the header of what arrived:
+// a VTG handed to parse_gga counts as a VTG with NMEA_PARSE_WRONG_SENTENCE,
+// and sentences with unsupported or malformed headers count as
+// NMEA_UNKNOWN.
+struct NmeaSentenceMetrics
+{
+  NmeaSentenceMetrics();
+
+  inline uint64_t parsed() const { return results.count(NMEA_PARSE_OK); }
+  inline uint64_t invalid() const { return results.failures(); }
+  inline uint64_t checksumFailures() const
+  {
+    return results.count(NMEA_PARSE_CHECKSUM_MISMATCH);
+  }
+
+  NmeaParseStats results;
+  // Sampled parse times. Samples are stored by bucket, so min, max and mean
+  // are bucket upper bounds rather than exact values.
+  NmeaLatencyHistogram latency;
+};
+
+struct NmeaMetricsSnapshot
+{
+  inline NmeaSentenceMetrics const &
+  operator[](NmeaMessageType const type) const
+  {
+    return sentences[type];
+  }
+
+  uint64_t sentences_total() const;
+
+  NmeaSentenceMetrics sentences[NMEA_MESSAGE_TYPE_COUNT];
+};
+
+bool nmea_metrics_enabled();
+// Sums every thread's counters, including threads that have exited. Safe to
+// call while other threads parse; their latest sentences may be missed.
+void nmea_metrics_snapshot(NmeaMetricsSnapshot &snapshot);
+
+// Prometheus text exposition format: nmea_sentences_total by type and
+// result, and nmea_parse_duration_seconds as a histogram by type. Counters
+// only grow, as Prometheus expects; there is no reset.
+std::string nmea_metrics_prometheus(NmeaMetricsSnapshot const &snapshot);
+
+#endif // NMEALIB_NMEAMETRICS_HPP
@@ -0,0 +1,83 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAPARSEERROR_HPP
+#define NMEALIB_NMEAPARSEERROR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+enum NmeaParseErrorCode
+{
+  NMEA_PARSE_OK = 0,
+  // No "$ttSSS," or "$PTNL,SSS," header.
+  NMEA_PARSE_MALFORMED_HEADER,
+  // Well formed header naming a sentence this library does not decode.
+  NMEA_PARSE_UNSUPPORTED_SENTENCE,
+  // A supported sentence handed to the parser for a different one.
+  NMEA_PARSE_WRONG_SENTENCE,
+  // "*hh" missing or not matching the sentence.
+  NMEA_PARSE_CHECKSUM_MISMATCH,
+  // The sentence ends before a required field.
+  NMEA_PARSE_MISSING_FIELD,
+  // A required field is present but empty, e.g. GGA without a fix.
+  NMEA_PARSE_EMPTY_FIELD,
+  NMEA_PARSE_BAD_NUMBER,
+  // A number that parsed but does not fit the field, e.g. 70000 satellites.
+  NMEA_PARSE_OUT_OF_RANGE,
+  // A status or mode field that is not a single letter.
+  NMEA_PARSE_BAD_FLAG,
+  NMEA_PARSE_ERROR_CODE_COUNT
+};
+
+// Why a sentence was rejected. field is the 1-based position after the
+// sentence ID, so GGA field 1 is the UTC time; it is 0 for header and
+// checksum errors.
+struct NmeaParseError
+{
+  inline NmeaParseError()
+      : code(NMEA_PARSE_OK)
+      , field(0U)
+  {
+  }
+
+  inline NmeaParseError(NmeaParseErrorCode const in_code,
+                        uint8_t const in_field)
+      : code(in_code)
+      , field(in_field)
+  {
+  }
+
+  inline bool ok() const { return NMEA_PARSE_OK == code; }
+
+  NmeaParseErrorCode code;
+  uint8_t field;
+};
+
+char const *nmea_parse_error_name(NmeaParseErrorCode const code);
+
+// Per-code tallies for a long running ingest. Not synchronized; keep one per
+// thread and merge.
+class NmeaParseStats
+{
+public:
+  NmeaParseStats();
+
+  inline void record(NmeaParseError const &error) { ++counts_[error.code]; }
+  inline void add(NmeaParseErrorCode const code, uint64_t const count)
+  {
+    counts_[code] += count;
+  }
+  inline uint64_t count(NmeaParseErrorCode const code) const
+  {
+    return counts_[code];
+  }
+  uint64_t sentences() const;
+  uint64_t failures() const;
+  void merge(NmeaParseStats const &other);
+  void reset();
+
+private:
+  uint64_t counts_[NMEA_PARSE_ERROR_CODE_COUNT];
+};
+
+#endif // NMEALIB_NMEAPARSEERROR_HPP
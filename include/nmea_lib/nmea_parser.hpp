@@ -3,9 +3,14 @@
 #ifndef NMEALIB_NMEAPARSER_HPP
 #define NMEALIB_NMEAPARSER_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include "avr_fix_quality.hpp"
 #include "gga_fix_quality.hpp"
+#include "nmea_checksum.hpp"
+#include "nmea_message_type.hpp"
+#include "nmea_parse_error.hpp"
 
 struct AvrMessageData
 {
@@ -96,6 +101,7 @@ struct VtgMessageData
 {
   inline VtgMessageData()
       : valid(false)
+      , magneticTrackMadeGoodValid(false)
   {
   }
 
@@ -127,8 +133,521 @@ struct VtgMessageData
   double groundSpeedKph;
 };
 
-AvrMessageData parse_avr(std::string const &message);
-GgaMessageData parse_gga(std::string const &message);
-VtgMessageData parse_vtg(std::string const &message);
+struct RmcMessageData
+{
+  inline RmcMessageData()
+      : valid(false)
+      , timestamp(0.0)
+      , status('V')
+      , latitude(0.0)
+      , longitude(0.0)
+      , speedKnots(0.0)
+      , trackMadeGoodValid(false)
+      , trackMadeGood(0.0)
+      , date(0U)
+      , magneticVariationValid(false)
+      , magneticVariation(0.0)
+      , modeIndicator('\0')
+  {
+  }
+
+  inline bool active() const { return 'A' == status; }
+
+  bool valid;
+  double timestamp;
+  // 'A' active or 'V' void
+  char status;
+  double latitude;
+  double longitude;
+  double speedKnots;
+  bool trackMadeGoodValid;
+  double trackMadeGood;
+  // ddmmyy
+  uint32_t date;
+  bool magneticVariationValid;
+  // Degrees, east positive
+  double magneticVariation;
+  // NMEA 2.3 and later, e.g. 'A' autonomous or 'D' differential; '\0' if
+  // absent
+  char modeIndicator;
+};
+
+static size_t const NMEA_GSA_MAX_SATELLITES = 12U;
+
+struct GsaMessageData
+{
+  inline GsaMessageData()
+      : valid(false)
+      , selectionMode('A')
+      , fixType(1U)
+      , numSatellites(0U)
+      , pdop(0.0)
+      , hdop(0.0)
+      , vdop(0.0)
+      , systemIdValid(false)
+      , systemId(0U)
+  {
+  }
+
+  bool valid;
+  // 'M' manual or 'A' automatic 2D/3D switching
+  char selectionMode;
+  // 1 no fix, 2 2D, 3 3D
+  uint8_t fixType;
+  uint8_t numSatellites;
+  uint16_t satelliteIds[NMEA_GSA_MAX_SATELLITES];
+  double pdop;
+  double hdop;
+  double vdop;
+  // NMEA 4.11 GNSS system ID
+  bool systemIdValid;
+  uint8_t systemId;
+};
+
+struct GsvSatellite
+{
+  inline GsvSatellite()
+      : id(0U)
+      , elevationValid(false)
+      , elevation(0)
+      , azimuthValid(false)
+      , azimuth(0U)
+      , snrValid(false)
+      , snr(0U)
+  {
+  }
+
+  uint16_t id;
+  bool elevationValid;
+  int8_t elevation;
+  bool azimuthValid;
+  uint16_t azimuth;
+  // dB-Hz, absent when the satellite is not tracked
+  bool snrValid;
+  uint8_t snr;
+};
+
+static size_t const NMEA_GSV_SATELLITES_PER_SENTENCE = 4U;
+
+// One sentence of a GSV group; see NmeaGsvAggregator for whole groups.
+struct GsvMessageData
+{
+  inline GsvMessageData()
+      : valid(false)
+      , totalMessages(0U)
+      , messageNumber(0U)
+      , satellitesInView(0U)
+      , numSatellites(0U)
+      , signalIdValid(false)
+      , signalId(0U)
+  {
+    talker[0] = 'G';
+    talker[1] = 'P';
+  }
+
+  bool valid;
+  // Talker ID of the sentence, e.g. "GP" or "GL", which names the
+  // constellation the satellite IDs belong to.
+  char talker[2];
+  uint8_t totalMessages;
+  uint8_t messageNumber;
+  uint16_t satellitesInView;
+  uint8_t numSatellites;
+  GsvSatellite satellites[NMEA_GSV_SATELLITES_PER_SENTENCE];
+  // NMEA 4.10 signal ID
+  bool signalIdValid;
+  uint8_t signalId;
+};
+
+struct GstMessageData
+{
+  inline GstMessageData()
+      : valid(false)
+      , timestamp(0.0)
+      , rangeRms(0.0)
+      , semiMajorSigma(0.0)
+      , semiMinorSigma(0.0)
+      , semiMajorOrientation(0.0)
+      , latitudeSigma(0.0)
+      , longitudeSigma(0.0)
+      , altitudeSigma(0.0)
+  {
+  }
+
+  bool valid;
+  double timestamp;
+  double rangeRms;
+  // Error ellipse in meters, orientation in degrees from true north
+  double semiMajorSigma;
+  double semiMinorSigma;
+  double semiMajorOrientation;
+  double latitudeSigma;
+  double longitudeSigma;
+  double altitudeSigma;
+};
+
+struct ZdaMessageData
+{
+  inline ZdaMessageData()
+      : valid(false)
+      , timestamp(0.0)
+      , day(0U)
+      , month(0U)
+      , year(0U)
+      , localZoneValid(false)
+      , localZoneHours(0)
+      , localZoneMinutes(0U)
+  {
+  }
+
+  bool valid;
+  double timestamp;
+  uint8_t day;
+  uint8_t month;
+  uint16_t year;
+  bool localZoneValid;
+  int8_t localZoneHours;
+  uint8_t localZoneMinutes;
+};
+
+struct HdtMessageData
+{
+  inline HdtMessageData()
+      : valid(false)
+      , heading(0.0)
+  {
+  }
+
+  bool valid;
+  // Degrees from true north
+  double heading;
+};
+
+static size_t const NMEA_GNS_MAX_MODES = 8U;
+
+struct GnsMessageData
+{
+  inline GnsMessageData()
+      : valid(false)
+      , timestamp(0.0)
+      , latitude(0.0)
+      , longitude(0.0)
+      , numSatellites(0U)
+      , hdop(0.0)
+      , altitude(0.0)
+      , geoidHeight(0.0)
+      , timeSinceLastDgpsValid(false)
+      , timeSinceLastDgps(0.0)
+      , dgpsStationIDValid(false)
+      , dgpsStationID(0U)
+      , navigationalStatus('\0')
+  {
+    modeIndicator[0] = '\0';
+  }
+
+  bool valid;
+  double timestamp;
+  double latitude;
+  double longitude;
+  // One letter per constellation, GPS first, e.g. "AA"; null terminated
+  char modeIndicator[NMEA_GNS_MAX_MODES + 1U];
+  uint16_t numSatellites;
+  double hdop;
+  double altitude;
+  double geoidHeight;
+  bool timeSinceLastDgpsValid;
+  double timeSinceLastDgps;
+  bool dgpsStationIDValid;
+  uint16_t dgpsStationID;
+  // NMEA 4.10 'S' safe, 'C' caution, 'U' unsafe, 'V' not valid; '\0' if
+  // absent
+  char navigationalStatus;
+};
+
+// Tagged result of parse_nmea. Only the member named by type is meaningful.
+struct NmeaMessage
+{
+  inline NmeaMessage()
+      : type(NMEA_UNKNOWN)
+      , gga()
+  {
+  }
+
+  inline explicit NmeaMessage(AvrMessageData const &in_avr)
+      : type(NMEA_AVR)
+      , avr(in_avr)
+  {
+  }
+
+  inline explicit NmeaMessage(GgaMessageData const &in_gga)
+      : type(NMEA_GGA)
+      , gga(in_gga)
+  {
+  }
+
+  inline explicit NmeaMessage(VtgMessageData const &in_vtg)
+      : type(NMEA_VTG)
+      , vtg(in_vtg)
+  {
+  }
+
+  inline explicit NmeaMessage(RmcMessageData const &in_rmc)
+      : type(NMEA_RMC)
+      , rmc(in_rmc)
+  {
+  }
+
+  inline explicit NmeaMessage(GsaMessageData const &in_gsa)
+      : type(NMEA_GSA)
+      , gsa(in_gsa)
+  {
+  }
+
+  inline explicit NmeaMessage(GsvMessageData const &in_gsv)
+      : type(NMEA_GSV)
+      , gsv(in_gsv)
+  {
+  }
+
+  inline explicit NmeaMessage(GstMessageData const &in_gst)
+      : type(NMEA_GST)
+      , gst(in_gst)
+  {
+  }
+
+  inline explicit NmeaMessage(ZdaMessageData const &in_zda)
+      : type(NMEA_ZDA)
+      , zda(in_zda)
+  {
+  }
+
+  inline explicit NmeaMessage(HdtMessageData const &in_hdt)
+      : type(NMEA_HDT)
+      , hdt(in_hdt)
+  {
+  }
+
+  inline explicit NmeaMessage(GnsMessageData const &in_gns)
+      : type(NMEA_GNS)
+      , gns(in_gns)
+  {
+  }
+
+  inline bool valid() const
+  {
+    bool valid = false;
+    switch (type)
+    {
+    case NMEA_AVR:
+      valid = avr.valid;
+      break;
+    case NMEA_GGA:
+      valid = gga.valid;
+      break;
+    case NMEA_VTG:
+      valid = vtg.valid;
+      break;
+    case NMEA_RMC:
+      valid = rmc.valid;
+      break;
+    case NMEA_GSA:
+      valid = gsa.valid;
+      break;
+    case NMEA_GSV:
+      valid = gsv.valid;
+      break;
+    case NMEA_GST:
+      valid = gst.valid;
+      break;
+    case NMEA_ZDA:
+      valid = zda.valid;
+      break;
+    case NMEA_HDT:
+      valid = hdt.valid;
+      break;
+    case NMEA_GNS:
+      valid = gns.valid;
+      break;
+    default:
+      break;
+    }
+    return valid;
+  }
+
+  NmeaMessageType type;
+  union
+  {
+    AvrMessageData avr;
+    GgaMessageData gga;
+    VtgMessageData vtg;
+    RmcMessageData rmc;
+    GsaMessageData gsa;
+    GsvMessageData gsv;
+    GstMessageData gst;
+    ZdaMessageData zda;
+    HdtMessageData hdt;
+    GnsMessageData gns;
+  };
+};
+
+AvrMessageData parse_avr(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GgaMessageData parse_gga(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+VtgMessageData parse_vtg(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+
+// Parse in place from a buffer that need not be null terminated. These do not
+// allocate and return valid == false rather than throwing on bad fields or,
+// unless told to skip it, a missing or wrong "*hh" checksum.
+AvrMessageData parse_avr(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GgaMessageData parse_gga(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+VtgMessageData parse_vtg(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+
+// Same as above, and on failure error says which field was rejected and why.
+// error is reset to NMEA_PARSE_OK when the sentence is valid.
+AvrMessageData parse_avr(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GgaMessageData parse_gga(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+VtgMessageData parse_vtg(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+
+// RMC, GSA, GSV, GST, ZDA, HDT and GNS from any talker, with the same
+// guarantees as above.
+RmcMessageData parse_rmc(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+RmcMessageData parse_rmc(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+RmcMessageData parse_rmc(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GsaMessageData parse_gsa(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GsaMessageData parse_gsa(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GsaMessageData parse_gsa(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GsvMessageData parse_gsv(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GsvMessageData parse_gsv(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GsvMessageData parse_gsv(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GstMessageData parse_gst(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GstMessageData parse_gst(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GstMessageData parse_gst(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+ZdaMessageData parse_zda(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+ZdaMessageData parse_zda(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+ZdaMessageData parse_zda(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+HdtMessageData parse_hdt(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+HdtMessageData parse_hdt(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+HdtMessageData parse_hdt(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GnsMessageData parse_gns(std::string const &message,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GnsMessageData parse_gns(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+GnsMessageData parse_gns(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode =
+                             NMEA_VERIFY_CHECKSUM);
+
+// Reads the header once and decodes whichever supported sentence follows.
+// Any two letter talker ID is accepted, e.g. $GNGGA or $BDVTG.
+NmeaMessageType identify_nmea(char const *const message, size_t const length);
+NmeaMessage parse_nmea(char const *const message, size_t const length,
+                       NmeaChecksumMode const checksum_mode =
+                           NMEA_VERIFY_CHECKSUM);
+NmeaMessage parse_nmea(char const *const message, size_t const length,
+                       NmeaParseError &error,
+                       NmeaChecksumMode const checksum_mode =
+                           NMEA_VERIFY_CHECKSUM);
+NmeaMessage parse_nmea(std::string const &message,
+                       NmeaChecksumMode const checksum_mode =
+                           NMEA_VERIFY_CHECKSUM);
+
+// The std::string versions for strings with any other allocator, such as
+// NmeaArenaString, without copying them into a std::string first.
+template <typename Allocator>
+inline AvrMessageData
+parse_avr(std::basic_string<char, std::char_traits<char>, Allocator> const
+              &message,
+          NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM)
+{
+  return parse_avr(message.data(), message.length(), checksum_mode);
+}
+template <typename Allocator>
+inline GgaMessageData
+parse_gga(std::basic_string<char, std::char_traits<char>, Allocator> const
+              &message,
+          NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM)
+{
+  return parse_gga(message.data(), message.length(), checksum_mode);
+}
+template <typename Allocator>
+inline VtgMessageData
+parse_vtg(std::basic_string<char, std::char_traits<char>, Allocator> const
+              &message,
+          NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM)
+{
+  return parse_vtg(message.data(), message.length(), checksum_mode);
+}
+template <typename Allocator>
+inline NmeaMessage
+parse_nmea(std::basic_string<char, std::char_traits<char>, Allocator> const
+               &message,
+           NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM)
+{
+  return parse_nmea(message.data(), message.length(), checksum_mode);
+}
 
 #endif // NMEALIB_NMEAPARSER_HPP
@@ -0,0 +1,209 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAPIPELINE_HPP
+#define NMEALIB_NMEAPIPELINE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "nmea_parser.hpp"
+#include "nmea_stream_framer.hpp"
+
+// Lock-free handoff from port readers to a parser thread to any number of
+// subscribers, with all storage allocated up front:
+//
+//   reader threads --NmeaSentenceQueue--> parser thread
+//                  --NmeaRecordRing--> NmeaRecordSubscriber per consumer
+//
+// NmeaPipeline wires the two together; the pieces can also be used alone.
+
+// Nanoseconds on the steady clock, the time base of every arrivalNs.
+uint64_t nmea_pipeline_now_ns();
+
+// Longest sentence a queue slot holds. The standard allows 82 characters;
+// the extra room is for proprietary sentences.
+static size_t const NMEA_QUEUED_SENTENCE_BYTES = 118U;
+
+struct NmeaQueuedSentence
+{
+  uint64_t arrivalNs;
+  uint16_t length;
+  char data[NMEA_QUEUED_SENTENCE_BYTES];
+};
+
+// Bounded multi-producer multi-consumer queue of sentence slots. Each slot
+// carries a sequence number that tells producers and consumers whose turn it
+// is, so neither side takes a lock and a full or empty queue is reported
+// rather than waited on. Capacity is rounded up to a power of two.
+class NmeaSentenceQueue
+{
+public:
+  explicit NmeaSentenceQueue(size_t const capacity);
+
+  // False when the queue is full or the sentence does not fit a slot.
+  bool try_push(char const *const data, size_t const length,
+                uint64_t const arrival_ns);
+  bool try_pop(NmeaQueuedSentence &sentence);
+
+  inline size_t capacity() const { return mask_ + 1U; }
+  // Approximate while other threads are pushing or popping.
+  size_t size() const;
+
+private:
+  struct Cell
+  {
+    Cell();
+
+    std::atomic<size_t> sequence;
+    NmeaQueuedSentence sentence;
+  };
+
+  std::vector<Cell> cells_;
+  size_t mask_;
+  // Producers and consumers each get their own cache line.
+  char padding0_[64];
+  std::atomic<size_t> enqueue_;
+  char padding1_[64];
+  std::atomic<size_t> dequeue_;
+  char padding2_[64];
+};
+
+struct NmeaRecord
+{
+  inline NmeaRecord()
+      : sequence(0U)
+      , arrivalNs(0U)
+      , parsedNs(0U)
+      , error()
+      , message()
+  {
+  }
+
+  // Position in the ring's stream, from 0.
+  uint64_t sequence;
+  uint64_t arrivalNs;
+  uint64_t parsedNs;
+  NmeaParseError error;
+  NmeaMessage message;
+};
+
+// Single-producer broadcast ring of parsed records. publish() never waits:
+// it overwrites the oldest record whether or not every subscriber has read
+// it, and a subscriber that falls a full ring behind skips ahead and counts
+// what it missed. Capacity is rounded up to a power of two.
+class NmeaRecordRing
+{
+public:
+  explicit NmeaRecordRing(size_t const capacity);
+
+  // Only one thread may publish.
+  void publish(NmeaRecord const &record);
+
+  inline size_t capacity() const { return mask_ + 1U; }
+  inline uint64_t published() const
+  {
+    return head_.load(std::memory_order_acquire);
+  }
+
+private:
+  friend class NmeaRecordSubscriber;
+
+  // The record is held as relaxed atomic words, so that a reader copying it
+  // while the producer overwrites it sees a torn copy, not a data race.
+  static size_t const RECORD_WORDS =
+      (sizeof(NmeaRecord) + sizeof(uint64_t) - 1U) / sizeof(uint64_t);
+
+  // version is odd while the record is being written and 2 * (sequence + 1)
+  // once it is complete, so a reader can tell a torn copy from a good one.
+  struct Cell
+  {
+    Cell();
+
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> words[RECORD_WORDS];
+  };
+
+  std::vector<Cell> cells_;
+  size_t mask_;
+  char padding0_[64];
+  std::atomic<uint64_t> head_;
+  char padding1_[64];
+};
+
+// One consumer's position in a ring; each subscriber thread owns its own.
+class NmeaRecordSubscriber
+{
+public:
+  // Starts with the next record published.
+  explicit NmeaRecordSubscriber(NmeaRecordRing const &ring);
+
+  // False when nothing new has been published.
+  bool next(NmeaRecord &record);
+
+  inline uint64_t received() const { return received_; }
+  // Records overwritten before this subscriber got to them.
+  inline uint64_t lost() const { return lost_; }
+
+private:
+  NmeaRecordRing const *ring_;
+  uint64_t cursor_;
+  uint64_t received_;
+  uint64_t lost_;
+};
+
+// Readers call submit() from any number of threads, one thread calls
+// parse_pending() in a loop, and consumers attach NmeaRecordSubscribers to
+// records().
+//
+//   // reader thread, one framer per port
+//   pipeline.submit(framer, bytes, count);
+//
+//   // parser thread
+//   while (running)
+//   {
+//     if (0U == pipeline.parse_pending(64U))
+//     {
+//       std::this_thread::yield();
+//     }
+//   }
+//
+//   // consumer thread
+//   NmeaRecordSubscriber subscriber(pipeline.records());
+//   NmeaRecord record;
+//   while (subscriber.next(record)) { ... }
+class NmeaPipeline
+{
+public:
+  NmeaPipeline(size_t const sentence_capacity = 1024U,
+               size_t const record_capacity = 1024U,
+               NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM);
+
+  bool submit(char const *const data, size_t const length,
+              uint64_t const arrival_ns);
+  // Frames newly read bytes and queues every complete sentence, stamped
+  // with the time of this call. Returns how many were queued.
+  size_t submit(NmeaStreamFramer &framer, char const *const bytes,
+                size_t const length);
+
+  // Parses and publishes up to max_sentences queued sentences; returns how
+  // many. Call from one thread only.
+  size_t parse_pending(size_t const max_sentences);
+
+  inline NmeaRecordRing const &records() const { return records_; }
+  // Sentences refused because the queue was full or they were too long.
+  inline uint64_t dropped() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  NmeaSentenceQueue sentences_;
+  NmeaRecordRing records_;
+  NmeaChecksumMode checksumMode_;
+  std::atomic<uint64_t> dropped_;
+  NmeaQueuedSentence pending_;
+  NmeaRecord record_;
+};
+
+#endif // NMEALIB_NMEAPIPELINE_HPP
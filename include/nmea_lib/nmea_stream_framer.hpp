@@ -0,0 +1,69 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEASTREAMFRAMER_HPP
+#define NMEALIB_NMEASTREAMFRAMER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A complete "$...*hh" sentence without its line terminator.
+struct NmeaSentence
+{
+  inline NmeaSentence()
+      : data(nullptr)
+      , length(0U)
+  {
+  }
+
+  char const *data;
+  size_t length;
+};
+
+// Splits an arbitrarily chunked byte stream into sentences. Sentences that lie
+// inside one chunk are returned as views into that chunk; only a sentence
+// straddling two chunks is copied into the fixed-capacity carry buffer. A
+// returned view stays valid until the next call to push() or next().
+//
+// Only the bytes of a sentence still open at the end of a chunk are carried
+// over, so next() must have returned false before the next push().
+//
+//   framer.push(bytes, count);
+//   NmeaSentence sentence;
+//   while (framer.next(sentence))
+//   {
+//     parse_gga(sentence.data, sentence.length);
+//   }
+class NmeaStreamFramer
+{
+public:
+  explicit NmeaStreamFramer(size_t const capacity = 256U);
+
+  // Starts on the next chunk; the previous one must have been drained.
+  void push(char const *const data, size_t const length);
+  bool next(NmeaSentence &sentence);
+  void reset();
+
+  inline size_t capacity() const { return carry_.size(); }
+  inline uint64_t sentences() const { return sentences_; }
+  inline uint64_t discardedBytes() const { return discardedBytes_; }
+  inline uint64_t overflows() const { return overflows_; }
+  inline uint64_t truncated() const { return truncated_; }
+
+private:
+  bool append_to_carry(char const *const begin, char const *const end);
+  void drop_sentence(char const *const resume);
+
+  std::vector<char> carry_;
+  size_t carryLength_;
+  char const *cursor_;
+  char const *end_;
+  char const *segment_;
+  bool inSentence_;
+  uint64_t sentences_;
+  uint64_t discardedBytes_;
+  uint64_t overflows_;
+  uint64_t truncated_;
+};
+
+#endif // NMEALIB_NMEASTREAMFRAMER_HPP
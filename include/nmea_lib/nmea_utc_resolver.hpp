@@ -0,0 +1,108 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAUTCRESOLVER_HPP
+#define NMEALIB_NMEAUTCRESOLVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "nmea_parser.hpp"
+
+// What the resolver returns for a timestamp that is not a time of day.
+static int64_t const NMEA_NO_TIME = INT64_MIN;
+static int64_t const NMEA_DAY_NS = 86400000000000LL;
+
+// hhmmss.ss to ns since midnight; false for anything that is not a time of
+// day, leap seconds included. A double carries no more than microseconds
+// for times this large, so the result is rounded to the microsecond.
+bool nmea_time_of_day_ns(double const timestamp, int64_t &time_ns);
+// The same in ms since midnight, rounded to the ms before the fields are
+// checked, so 235959.9996 is no time of day.
+bool nmea_time_of_day_ms(double const timestamp, uint32_t &time_ms);
+// The same from the field's text, e.g. "123519.25", in integers only. Up
+// to 9 decimals are used and any further ones ignored.
+bool nmea_time_of_day_ns(char const *const text, size_t const length,
+                         int64_t &time_ns);
+// Days from 1970-01-01 to a Gregorian date; false if there is no such date.
+bool nmea_days_since_epoch(int32_t const year, uint32_t const month,
+                           uint32_t const day, int64_t &days);
+
+struct NmeaUtcResolverConfig
+{
+  inline NmeaUtcResolverConfig()
+      : lateWindowMs(43200000U)
+      , useMessageDates(true)
+  {
+  }
+
+  // How far before the latest time resolved a time of day may be and still
+  // be a late message. Each time is put on the day that places it at most
+  // this far before, and less than a day minus this after, the latest one,
+  // so a time further back starts the next day. A smaller window also takes
+  // a receiver's backward jump larger than it for a rollover. At most half
+  // a day, the default.
+  uint32_t lateWindowMs;
+  // Whether the dates in ZDA and RMC move the resolver to their day.
+  bool useMessageDates;
+};
+
+// Turns the hhmmss.ss times of one stream into ns since 1970-01-01 UTC that
+// keep increasing across midnight. The day is carried from one time to the
+// next and only changes on a rollover or a date, so each time costs a few
+// integer operations. Without a date the first time lands on 1970-01-01
+// and later ones count days from there; see dated().
+//
+// Times are not reordered: a late message comes out before the latest time,
+// on the day it belongs to. Gaps of a day or more can only be bridged by a
+// date.
+class NmeaUtcResolver
+{
+public:
+  explicit NmeaUtcResolver(
+      NmeaUtcResolverConfig const &config = NmeaUtcResolverConfig());
+
+  // ns since the epoch, or NMEA_NO_TIME.
+  int64_t resolve(double const timestamp);
+  int64_t resolve(char const *const text, size_t const length);
+  // Times of GGA, AVR, RMC, GST, ZDA and GNS; NMEA_NO_TIME for invalid
+  // messages and other types. ZDA and RMC dates are taken first if the
+  // config says so.
+  int64_t resolve(NmeaMessage const &message);
+
+  // Resolve in order, as the calls above would, into times. Return the
+  // number of times written that are not NMEA_NO_TIME.
+  size_t resolve(double const *const timestamps, size_t const count,
+                 int64_t *const times);
+  size_t resolve(NmeaMessage const *const messages, size_t const count,
+                 int64_t *const times);
+
+  // Puts the latest time, or the next one if there is none yet, on a date.
+  // False, changing nothing, if there is no such date.
+  bool set_date(int32_t const year, uint32_t const month, uint32_t const day);
+  void reset();
+
+  inline NmeaUtcResolverConfig const &config() const { return config_; }
+  // Whether the day came from a date rather than from 1970-01-01.
+  inline bool dated() const { return dated_; }
+  // The latest time resolved, or NMEA_NO_TIME.
+  inline int64_t latest() const { return latest_; }
+  inline uint64_t rollovers() const { return rollovers_; }
+  // Times placed on the day before the latest one.
+  inline uint64_t lateTimes() const { return lateTimes_; }
+  inline uint64_t invalidTimes() const { return invalidTimes_; }
+
+private:
+  int64_t place(int64_t const time_ns);
+  int64_t anchor(int64_t const days, int64_t const time_ns);
+
+  NmeaUtcResolverConfig config_;
+  int64_t windowNs_;
+  // ns since the epoch of the midnight starting the latest time's day.
+  int64_t dayStart_;
+  int64_t latest_;
+  bool dated_;
+  uint64_t rollovers_;
+  uint64_t lateTimes_;
+  uint64_t invalidTimes_;
+};
+
+#endif // NMEALIB_NMEAUTCRESOLVER_HPP
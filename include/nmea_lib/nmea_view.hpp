@@ -0,0 +1,121 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAVIEW_HPP
+#define NMEALIB_NMEAVIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "nmea_parser.hpp"
+
+// Lazy alternatives to parse_gga, parse_vtg and parse_avr for consumers that
+// read a few fields. Construction checks the header and checksum and finds
+// where every field starts in one pass; a field is only converted when its
+// accessor is first called, and the result is kept for later calls.
+//
+// Accessors return false where the eager parser would reject the field, and
+// leave value alone then. message() decodes the rest and returns what the
+// eager parser returns for the same text. A view points into the sentence,
+// which must outlive it.
+class NmeaSentenceView
+{
+public:
+  // Right sentence type, checksum unless skipped, and every required field
+  // there. Says nothing of the fields' contents.
+  inline bool ok() const { return ok_; }
+  // Fields found, up to MAX_FIELDS.
+  inline size_t fields() const { return count_; }
+
+  static size_t const MAX_FIELDS = 16U;
+
+protected:
+  NmeaSentenceView(char const *const message, size_t const length,
+                   NmeaChecksumMode const checksum_mode,
+                   NmeaMessageType const type, size_t const required_fields);
+
+  bool number(size_t const field, double &value) const;
+  // present is false, and the result true, for an empty or missing field.
+  bool optional_number(size_t const field, double &value,
+                       bool &present) const;
+  bool integer(size_t const field, int32_t const minimum,
+               int32_t const maximum, int32_t &value) const;
+  bool optional_integer(size_t const field, int32_t const minimum,
+                        int32_t const maximum, int32_t &value,
+                        bool &present) const;
+  // Degrees and minutes in field, the hemisphere letter in the next one.
+  bool angle(size_t const field, char const positive, double &value) const;
+
+private:
+  enum Kind
+  {
+    NUMBER,
+    INTEGER,
+    ANGLE
+  };
+
+  bool decode(size_t const field, Kind const kind, int32_t const minimum,
+              int32_t const maximum, char const positive) const;
+
+  char const *body_;
+  bool ok_;
+  uint8_t count_;
+  // Offset of each field from body_; starts_[count_] is one past the end of
+  // the last field.
+  uint16_t starts_[MAX_FIELDS + 1U];
+  mutable uint16_t decoded_;
+  mutable uint16_t valid_;
+  mutable uint16_t present_;
+  mutable double values_[MAX_FIELDS];
+};
+
+class GgaView : public NmeaSentenceView
+{
+public:
+  GgaView(char const *const message, size_t const length,
+          NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM);
+
+  bool timestamp(double &value) const;
+  bool latitude(double &value) const;
+  bool longitude(double &value) const;
+  bool fix_quality(GgaFixQuality &value) const;
+  bool num_satellites(uint16_t &value) const;
+  bool hdop(double &value) const;
+  bool altitude(double &value) const;
+  bool geoid_height(double &value) const;
+  bool time_since_last_dgps(double &value, bool &present) const;
+  bool dgps_station_id(uint16_t &value, bool &present) const;
+
+  GgaMessageData message() const;
+};
+
+class VtgView : public NmeaSentenceView
+{
+public:
+  VtgView(char const *const message, size_t const length,
+          NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM);
+
+  bool true_track_made_good(double &value) const;
+  bool magnetic_track_made_good(double &value, bool &present) const;
+  bool ground_speed_knots(double &value) const;
+  bool ground_speed_kph(double &value) const;
+
+  VtgMessageData message() const;
+};
+
+class AvrView : public NmeaSentenceView
+{
+public:
+  AvrView(char const *const message, size_t const length,
+          NmeaChecksumMode const checksum_mode = NMEA_VERIFY_CHECKSUM);
+
+  bool timestamp(double &value) const;
+  bool yaw(double &value) const;
+  bool tilt(double &value) const;
+  bool range(double &value) const;
+  bool fix_quality(AvrFixQuality &value) const;
+  bool pdop(double &value) const;
+  bool num_satellites(uint16_t &value) const;
+
+  AvrMessageData message() const;
+};
+
+#endif // NMEALIB_NMEAVIEW_HPP
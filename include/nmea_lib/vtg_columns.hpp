@@ -0,0 +1,40 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_VTGCOLUMNS_HPP
+#define NMEALIB_VTGCOLUMNS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "nmea_parser.hpp"
+
+// Structure-of-arrays store of valid VTG messages, the companion of
+// GgaColumns. The optional magnetic track keeps one validity bit per row.
+struct VtgColumns
+{
+  void reserve(size_t const rows);
+  void clear();
+  inline size_t size() const { return trueTrackMadeGood.size(); }
+
+  // Invalid messages and messages that are not VTG are skipped. Both return
+  // the number of rows added.
+  size_t append(VtgMessageData const &vtg);
+  size_t append(NmeaMessage const *const messages, size_t const count);
+
+  VtgMessageData row(size_t const i) const;
+  inline bool hasMagneticTrackMadeGood(size_t const i) const
+  {
+    return 0U != ((magneticTrackMadeGoodValid[i / 64U] >> (i % 64U)) & 1U);
+  }
+
+  // Heap bytes held by the columns, counting reserved capacity.
+  size_t memory_bytes() const;
+
+  std::vector<double> trueTrackMadeGood;
+  std::vector<double> magneticTrackMadeGood;
+  std::vector<double> groundSpeedKnots;
+  std::vector<double> groundSpeedKph;
+  std::vector<uint64_t> magneticTrackMadeGoodValid;
+};
+
+#endif // NMEALIB_VTGCOLUMNS_HPP
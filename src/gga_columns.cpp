@@ -0,0 +1,119 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gga_columns.hpp"
+
+using std::vector;
+
+template <typename T>
+static size_t heap_bytes(vector<T> const &column)
+{
+  return column.capacity() * sizeof(T);
+}
+
+static void push_bit(vector<uint64_t> &bits, size_t const i, bool const set)
+{
+  if (0U == i % 64U)
+  {
+    bits.push_back(0U);
+  }
+  if (set)
+  {
+    bits.back() |= static_cast<uint64_t>(1U) << (i % 64U);
+  }
+}
+
+void GgaColumns::reserve(size_t const rows)
+{
+  timestamp.reserve(rows);
+  latitude.reserve(rows);
+  longitude.reserve(rows);
+  altitude.reserve(rows);
+  geoidHeight.reserve(rows);
+  hdop.reserve(rows);
+  fixQuality.reserve(rows);
+  numSatellites.reserve(rows);
+  timeSinceLastDgps.reserve(rows);
+  dgpsStationID.reserve(rows);
+  timeSinceLastDgpsValid.reserve((rows + 63U) / 64U);
+  dgpsStationIDValid.reserve((rows + 63U) / 64U);
+}
+
+void GgaColumns::clear()
+{
+  timestamp.clear();
+  latitude.clear();
+  longitude.clear();
+  altitude.clear();
+  geoidHeight.clear();
+  hdop.clear();
+  fixQuality.clear();
+  numSatellites.clear();
+  timeSinceLastDgps.clear();
+  dgpsStationID.clear();
+  timeSinceLastDgpsValid.clear();
+  dgpsStationIDValid.clear();
+}
+
+size_t GgaColumns::append(GgaMessageData const &fix)
+{
+  size_t added = 0U;
+  if (fix.valid)
+  {
+    size_t const i = size();
+    timestamp.push_back(fix.timestamp);
+    latitude.push_back(fix.latitude);
+    longitude.push_back(fix.longitude);
+    altitude.push_back(fix.altitude);
+    geoidHeight.push_back(fix.geoidHeight);
+    hdop.push_back(fix.hdop);
+    fixQuality.push_back(static_cast<uint8_t>(fix.fixQuality));
+    numSatellites.push_back(fix.numSatellites);
+    timeSinceLastDgps.push_back(
+        fix.timeSinceLastDgpsValid ? fix.timeSinceLastDgps : 0.0);
+    dgpsStationID.push_back(fix.dgpdStationIDValid ? fix.dgpdStationID : 0U);
+    push_bit(timeSinceLastDgpsValid, i, fix.timeSinceLastDgpsValid);
+    push_bit(dgpsStationIDValid, i, fix.dgpdStationIDValid);
+    added = 1U;
+  }
+  return added;
+}
+
+size_t GgaColumns::append(NmeaMessage const *const messages,
+                          size_t const count)
+{
+  size_t added = 0U;
+  for (size_t i = 0U; i < count; ++i)
+  {
+    if (NMEA_GGA == messages[i].type)
+    {
+      added += append(messages[i].gga);
+    }
+  }
+  return added;
+}
+
+GgaMessageData GgaColumns::row(size_t const i) const
+{
+  GgaMessageData fix(timestamp[i], latitude[i], longitude[i],
+                     static_cast<GgaFixQuality>(fixQuality[i]),
+                     numSatellites[i], hdop[i], altitude[i], geoidHeight[i]);
+  if (hasTimeSinceLastDgps(i))
+  {
+    fix.SetTimeSinceLastDgps(timeSinceLastDgps[i]);
+  }
+  if (hasDgpsStationID(i))
+  {
+    fix.SetDgpsStationID(dgpsStationID[i]);
+  }
+  return fix;
+}
+
+size_t GgaColumns::memory_bytes() const
+{
+  return heap_bytes(timestamp) + heap_bytes(latitude) +
+         heap_bytes(longitude) + heap_bytes(altitude) +
+         heap_bytes(geoidHeight) + heap_bytes(hdop) + heap_bytes(fixQuality) +
+         heap_bytes(numSatellites) + heap_bytes(timeSinceLastDgps) +
+         heap_bytes(dgpsStationID) + heap_bytes(timeSinceLastDgpsValid) +
+         heap_bytes(dgpsStationIDValid);
+}
@@ -0,0 +1,75 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <new>
+#include "nmea_arena.hpp"
+
+NmeaArena::NmeaArena(size_t const block_bytes)
+    : blockBytes_(0U == block_bytes ? NMEA_ARENA_BLOCK_BYTES : block_bytes)
+    , blocks_()
+    , current_(0U)
+    , offset_(0U)
+    , used_(0U)
+    , capacity_(0U)
+{
+}
+
+NmeaArena::~NmeaArena() { release(); }
+
+void *NmeaArena::allocate(size_t const bytes, size_t const alignment)
+{
+  void *memory = nullptr;
+  while (nullptr == memory)
+  {
+    if (current_ == blocks_.size())
+    {
+      // Oversized requests get a block of their own.
+      Block block;
+      block.size =
+          bytes + alignment > blockBytes_ ? bytes + alignment : blockBytes_;
+      block.data = static_cast<char *>(::operator new(block.size));
+      blocks_.push_back(block);
+      capacity_ += block.size;
+    }
+    Block const &block = blocks_[current_];
+    uintptr_t const address =
+        reinterpret_cast<uintptr_t>(block.data) + offset_;
+    size_t const padding =
+        static_cast<size_t>((alignment - address % alignment) % alignment);
+    if (offset_ + padding + bytes <= block.size)
+    {
+      memory = block.data + offset_ + padding;
+      offset_ += padding + bytes;
+      used_ += padding + bytes;
+    }
+    else
+    {
+      ++current_;
+      offset_ = 0U;
+    }
+  }
+  return memory;
+}
+
+void NmeaArena::reset()
+{
+  current_ = 0U;
+  offset_ = 0U;
+  used_ = 0U;
+}
+
+void NmeaArena::release()
+{
+  for (size_t i = 0U; i < blocks_.size(); ++i)
+  {
+    ::operator delete(blocks_[i].data);
+  }
+  blocks_.clear();
+  capacity_ = 0U;
+  reset();
+}
+
+NmeaArena &nmea_thread_arena()
+{
+  static thread_local NmeaArena arena;
+  return arena;
+}
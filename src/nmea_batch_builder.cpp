@@ -0,0 +1,458 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "nmea_batch_builder.hpp"
+#include "nmea_builder.hpp"
+#include "nmea_checksum.hpp"
+#include "nmea_coordinate.hpp"
+#include "nmea_cpu_features.hpp"
+#include "nmea_format.hpp"
+
+using std::string;
+
+static char const GGA_HEADER[] = "$GPGGA,";
+static char const VTG_HEADER[] = "$GPVTG,";
+static char const HEX_DIGITS[] = "0123456789ABCDEF";
+
+// Rows converted per pass; the tile's columns stay in L1.
+static size_t const TILE_ROWS = 256U;
+// Room left before each row, so the row writers need no bounds checks.
+static size_t const ROW_SLACK = 2U * NMEA_MAX_BUILD_LENGTH;
+// Typical GGA plus VTG length, to size the output up front.
+static size_t const EXPECTED_ROW_LENGTH = 128U;
+static size_t const MIN_ROWS_PER_THREAD = 1024U;
+
+// Angles are printed with 8 minute decimals, so in units of 10 nano-minutes.
+static size_t const ANGLE_DECIMALS = 8U;
+static double const ANGLE_SCALE = 6e9;
+static int64_t const ANGLE_STEP = 10;
+// Beyond this the product is no longer an exact integer after rounding and
+// the scalar codec, which also saturates, takes over.
+static double const ANGLE_LIMIT = 4503599627370496.0;
+
+static double const SCALES[4] = {1.0, 10.0, 100.0, 1000.0};
+// Magnitudes whose scaled value still fits in 31 bits.
+static double const SCALED_LIMITS[4] = {2147483000.0, 214748300.0,
+                                        21474830.0, 2147483.0};
+// Marks a value left to format_fixed.
+static int32_t const NOT_SCALED = -1;
+
+// One tile of numbers already turned into integers: fixed point fields as
+// round(|value| * 10^precision) or NOT_SCALED, angles in nano-minutes.
+struct BatchTile
+{
+  int32_t timestamp[TILE_ROWS];
+  int32_t altitude[TILE_ROWS];
+  int32_t geoidHeight[TILE_ROWS];
+  int32_t timeSinceLastDgps[TILE_ROWS];
+  int32_t trueTrack[TILE_ROWS];
+  int32_t magneticTrack[TILE_ROWS];
+  int32_t speedKnots[TILE_ROWS];
+  int32_t speedKph[TILE_ROWS];
+  int64_t latitude[TILE_ROWS];
+  int64_t longitude[TILE_ROWS];
+};
+
+// round(|value| * 10^precision) with ties to even, computed exactly from the
+// binary value as printf does, or NOT_SCALED if it would not fit.
+static int32_t scale_fixed_scalar(double const value, int const precision)
+{
+  double const magnitude = std::fabs(value);
+  int32_t scaled = NOT_SCALED;
+  if (SCALED_LIMITS[precision] > magnitude)
+  {
+    int exponent = 0;
+    double const fraction = std::frexp(magnitude, &exponent);
+    // below 2^53 * 1000, so the product is exact in 64 bits
+    uint64_t const product =
+        static_cast<uint64_t>(std::ldexp(fraction, 53)) *
+        static_cast<uint64_t>(SCALES[precision]);
+    int const shift = 53 - exponent;
+    uint64_t rounded = 0U;
+    if (64 > shift)
+    {
+      uint64_t const remainder = product & ((1ULL << shift) - 1U);
+      uint64_t const half = 1ULL << (shift - 1);
+      rounded = product >> shift;
+      rounded += remainder > half || (remainder == half && 0U != (rounded & 1U))
+                     ? 1U
+                     : 0U;
+    }
+    scaled = static_cast<int32_t>(rounded);
+  }
+  return scaled;
+}
+
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+// The same rounding four values at a time. The product p = |value| * 10^n
+// is rounded, but fma recovers its exact error e. p and 0.5 are multiples
+// of ulp(p) and |e| is at most half of one, so the fractional part of p
+// decides the rounding except at exactly 0.5, where the sign of e, and
+// then the parity, does.
+__attribute__((target("avx2,fma"))) static void
+scale_fixed_avx2(double const *const values, size_t const count,
+                 int const precision, int32_t *const scaled)
+{
+  __m256d const scale = _mm256_set1_pd(SCALES[precision]);
+  __m256d const limit = _mm256_set1_pd(SCALED_LIMITS[precision]);
+  __m256d const sign = _mm256_set1_pd(-0.0);
+  __m256d const zero = _mm256_setzero_pd();
+  __m256d const half = _mm256_set1_pd(0.5);
+  __m256d const one = _mm256_set1_pd(1.0);
+  __m256d const not_scaled = _mm256_set1_pd(NOT_SCALED);
+  size_t i = 0U;
+  for (; i + 4U <= count; i += 4U)
+  {
+    __m256d const magnitude =
+        _mm256_andnot_pd(sign, _mm256_loadu_pd(values + i));
+    __m256d const in_range = _mm256_cmp_pd(magnitude, limit, _CMP_LT_OQ);
+    __m256d const product = _mm256_mul_pd(magnitude, scale);
+    __m256d const error = _mm256_fmsub_pd(magnitude, scale, product);
+    __m256d const whole =
+        _mm256_and_pd(in_range, _mm256_floor_pd(product));
+    __m256d const fraction = _mm256_sub_pd(product, whole);
+    __m128i const whole_bits = _mm256_cvtpd_epi32(whole);
+    __m256d const odd = _mm256_cmp_pd(
+        _mm256_cvtepi32_pd(_mm_and_si128(whole_bits, _mm_set1_epi32(1))),
+        one, _CMP_EQ_OQ);
+    __m256d const tie_up = _mm256_or_pd(
+        _mm256_cmp_pd(error, zero, _CMP_GT_OQ),
+        _mm256_and_pd(_mm256_cmp_pd(error, zero, _CMP_EQ_OQ), odd));
+    __m256d const up = _mm256_or_pd(
+        _mm256_cmp_pd(fraction, half, _CMP_GT_OQ),
+        _mm256_and_pd(_mm256_cmp_pd(fraction, half, _CMP_EQ_OQ), tie_up));
+    __m256d const rounded = _mm256_add_pd(whole, _mm256_and_pd(up, one));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(scaled + i),
+        _mm256_cvtpd_epi32(_mm256_blendv_pd(not_scaled, rounded, in_range)));
+  }
+  _mm256_zeroupper();
+  for (; i < count; ++i)
+  {
+    scaled[i] = scale_fixed_scalar(values[i], precision);
+  }
+}
+
+// llround(degrees * 6e9), as nmea_degrees_to_nano_minutes rounds it: the
+// product is formed the same way and halves round away from zero.
+__attribute__((target("avx2"))) static void
+round_angles_avx2(double const *const degrees, size_t const count,
+                  int64_t *const nano_minutes)
+{
+  __m256d const scale = _mm256_set1_pd(ANGLE_SCALE);
+  __m256d const limit = _mm256_set1_pd(ANGLE_LIMIT);
+  __m256d const sign = _mm256_set1_pd(-0.0);
+  __m256d const half = _mm256_set1_pd(0.5);
+  __m256d const one = _mm256_set1_pd(1.0);
+  size_t i = 0U;
+  for (; i + 4U <= count; i += 4U)
+  {
+    __m256d const product =
+        _mm256_mul_pd(_mm256_loadu_pd(degrees + i), scale);
+    __m256d const magnitude = _mm256_andnot_pd(sign, product);
+    __m256d const whole = _mm256_floor_pd(magnitude);
+    __m256d const up = _mm256_cmp_pd(_mm256_sub_pd(magnitude, whole), half,
+                                     _CMP_GE_OQ);
+    __m256d const rounded = _mm256_or_pd(
+        _mm256_add_pd(whole, _mm256_and_pd(up, one)),
+        _mm256_and_pd(sign, product));
+    int const in_range =
+        _mm256_movemask_pd(_mm256_cmp_pd(magnitude, limit, _CMP_LT_OQ));
+    double rounded_values[4];
+    _mm256_storeu_pd(rounded_values, rounded);
+    for (size_t j = 0U; j < 4U; ++j)
+    {
+      nano_minutes[i + j] =
+          0 != ((in_range >> j) & 1)
+              ? static_cast<int64_t>(rounded_values[j]) * ANGLE_STEP
+              : nmea_degrees_to_nano_minutes(degrees[i + j], ANGLE_DECIMALS);
+    }
+  }
+  _mm256_zeroupper();
+  for (; i < count; ++i)
+  {
+    nano_minutes[i] =
+        nmea_degrees_to_nano_minutes(degrees[i], ANGLE_DECIMALS);
+  }
+}
+#endif
+
+static void scale_fixed(double const *const values, size_t const count,
+                        int const precision, int32_t *const scaled)
+{
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+  bool const use_avx2 = nmea_cpu_has_avx2_fma();
+  if (use_avx2)
+  {
+    scale_fixed_avx2(values, count, precision, scaled);
+  }
+  else
+#endif
+  {
+    for (size_t i = 0U; i < count; ++i)
+    {
+      scaled[i] = scale_fixed_scalar(values[i], precision);
+    }
+  }
+}
+
+static void round_angles(double const *const degrees, size_t const count,
+                         int64_t *const nano_minutes)
+{
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+  bool const use_avx2 = nmea_cpu_has_avx2_fma();
+  if (use_avx2)
+  {
+    round_angles_avx2(degrees, count, nano_minutes);
+  }
+  else
+#endif
+  {
+    for (size_t i = 0U; i < count; ++i)
+    {
+      nano_minutes[i] =
+          nmea_degrees_to_nano_minutes(degrees[i], ANGLE_DECIMALS);
+    }
+  }
+}
+
+static void convert_tile(GgaColumns const &gga, VtgColumns const *const vtg,
+                         size_t const first, size_t const rows,
+                         BatchTile &tile)
+{
+  scale_fixed(&gga.timestamp[first], rows, 2, tile.timestamp);
+  scale_fixed(&gga.altitude[first], rows, 3, tile.altitude);
+  scale_fixed(&gga.geoidHeight[first], rows, 1, tile.geoidHeight);
+  scale_fixed(&gga.timeSinceLastDgps[first], rows, 1,
+              tile.timeSinceLastDgps);
+  round_angles(&gga.latitude[first], rows, tile.latitude);
+  round_angles(&gga.longitude[first], rows, tile.longitude);
+  if (nullptr != vtg)
+  {
+    scale_fixed(&vtg->trueTrackMadeGood[first], rows, 1, tile.trueTrack);
+    scale_fixed(&vtg->magneticTrackMadeGood[first], rows, 1,
+                tile.magneticTrack);
+    scale_fixed(&vtg->groundSpeedKnots[first], rows, 3, tile.speedKnots);
+    scale_fixed(&vtg->groundSpeedKph[first], rows, 3, tile.speedKph);
+  }
+}
+
+// The row writers below produce what NmeaWriter would: fill in front of the
+// whole number, sign included.
+static inline char *put_padded(char *output, char const *const text,
+                               size_t const length, size_t const width)
+{
+  for (size_t i = length; i < width; ++i)
+  {
+    *output++ = '0';
+  }
+  memcpy(output, text, length);
+  return output + length;
+}
+
+static inline char *put_text(char *const output, char const *const text,
+                             size_t const length)
+{
+  memcpy(output, text, length);
+  return output + length;
+}
+
+static inline char *put_uint(char *const output, uint32_t value,
+                             size_t const width)
+{
+  char digits[10];
+  char *const end = digits + sizeof(digits);
+  char *first = end;
+  do
+  {
+    *--first = static_cast<char>('0' + value % 10U);
+    value /= 10U;
+  } while (0U != value);
+  return put_padded(output, first, static_cast<size_t>(end - first), width);
+}
+
+static inline char *put_fixed(char *const output, double const value,
+                              int32_t const scaled, int const precision,
+                              size_t const width)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  char *const end = text + sizeof(text);
+  char *first = end;
+  size_t length = 0U;
+  if (NOT_SCALED == scaled)
+  {
+    // NaN, infinity and large magnitudes
+    first = text;
+    length = format_fixed(value, precision, text);
+  }
+  else
+  {
+    uint32_t rest = static_cast<uint32_t>(scaled);
+    for (int i = 0; i < precision; ++i)
+    {
+      *--first = static_cast<char>('0' + rest % 10U);
+      rest /= 10U;
+    }
+    *--first = '.';
+    do
+    {
+      *--first = static_cast<char>('0' + rest % 10U);
+      rest /= 10U;
+    } while (0U != rest);
+    if (std::signbit(value))
+    {
+      *--first = '-';
+    }
+    length = static_cast<size_t>(end - first);
+  }
+  return put_padded(output, first, length, width);
+}
+
+static inline char *put_angle(char *output, double const angle,
+                              int64_t const nano_minutes,
+                              size_t const degree_digits,
+                              char const positive, char const negative)
+{
+  output += nmea_format_nano_minutes(nano_minutes, degree_digits,
+                                     ANGLE_DECIMALS, output);
+  *output++ = ',';
+  *output++ = angle > 0 ? positive : negative;
+  return output;
+}
+
+static inline char *finish(char *const sentence, char *output)
+{
+  uint8_t const checksum =
+      nmea_checksum(sentence + 1, static_cast<size_t>(output - sentence - 1));
+  *output++ = '*';
+  *output++ = HEX_DIGITS[checksum >> 4];
+  *output++ = HEX_DIGITS[checksum & 0x0FU];
+  *output++ = '\n';
+  return output;
+}
+
+static char *put_gga(char *const sentence, GgaColumns const &gga,
+                     size_t const row, BatchTile const &tile,
+                     size_t const j)
+{
+  char *output = put_text(sentence, GGA_HEADER, sizeof(GGA_HEADER) - 1U);
+  output = put_fixed(output, gga.timestamp[row], tile.timestamp[j], 2, 9U);
+  *output++ = ',';
+  output =
+      put_angle(output, gga.latitude[row], tile.latitude[j], 2U, 'N', 'S');
+  *output++ = ',';
+  output =
+      put_angle(output, gga.longitude[row], tile.longitude[j], 3U, 'E', 'W');
+  *output++ = ',';
+  output = put_uint(output, gga.fixQuality[row], 0U);
+  *output++ = ',';
+  output = put_uint(output, gga.numSatellites[row], 0U);
+  *output++ = ',';
+  output += format_general(gga.hdop[row], output);
+  *output++ = ',';
+  output = put_fixed(output, gga.altitude[row], tile.altitude[j], 3, 6U);
+  output = put_text(output, ",M,", 3U);
+  output = put_fixed(output, gga.geoidHeight[row], tile.geoidHeight[j], 1, 0U);
+  output = put_text(output, ",M,", 3U);
+  if (gga.hasTimeSinceLastDgps(row))
+  {
+    output = put_fixed(output, gga.timeSinceLastDgps[row],
+                       tile.timeSinceLastDgps[j], 1, 0U);
+  }
+  *output++ = ',';
+  if (gga.hasDgpsStationID(row))
+  {
+    output = put_uint(output, gga.dgpsStationID[row], 4U);
+  }
+  return finish(sentence, output);
+}
+
+static char *put_vtg(char *const sentence, VtgColumns const &vtg,
+                     size_t const row, BatchTile const &tile,
+                     size_t const j)
+{
+  char *output = put_text(sentence, VTG_HEADER, sizeof(VTG_HEADER) - 1U);
+  output =
+      put_fixed(output, vtg.trueTrackMadeGood[row], tile.trueTrack[j], 1, 5U);
+  output = put_text(output, ",T,", 3U);
+  if (vtg.hasMagneticTrackMadeGood(row))
+  {
+    output = put_fixed(output, vtg.magneticTrackMadeGood[row],
+                       tile.magneticTrack[j], 1, 5U);
+  }
+  output = put_text(output, ",M,", 3U);
+  output =
+      put_fixed(output, vtg.groundSpeedKnots[row], tile.speedKnots[j], 3, 0U);
+  output = put_text(output, ",N,", 3U);
+  output = put_fixed(output, vtg.groundSpeedKph[row], tile.speedKph[j], 3, 0U);
+  output = put_text(output, ",K", 2U);
+  return finish(sentence, output);
+}
+
+// Appends rows [first, last) to text.
+static void build_rows(GgaColumns const &gga, VtgColumns const *const vtg,
+                       size_t const first, size_t const last, string &text)
+{
+  std::unique_ptr<BatchTile> const tile(new BatchTile());
+  size_t length = text.size();
+  text.resize(length + (last - first) * EXPECTED_ROW_LENGTH + ROW_SLACK);
+  for (size_t begin = first; begin < last; begin += TILE_ROWS)
+  {
+    size_t const rows = std::min(TILE_ROWS, last - begin);
+    convert_tile(gga, vtg, begin, rows, *tile);
+    for (size_t j = 0U; j < rows; ++j)
+    {
+      if (text.size() - length < ROW_SLACK)
+      {
+        text.resize(2U * text.size() + ROW_SLACK);
+      }
+      char *const start = &text[length];
+      char *output = put_gga(start, gga, begin + j, *tile, j);
+      if (nullptr != vtg)
+      {
+        output = put_vtg(output, *vtg, begin + j, *tile, j);
+      }
+      length += static_cast<size_t>(output - start);
+    }
+  }
+  text.resize(length);
+}
+
+size_t build_nmea_batch(GgaColumns const &gga, VtgColumns const *const vtg,
+                        string &output, unsigned const num_threads)
+{
+  size_t const before = output.size();
+  size_t const rows = gga.size();
+  if (nullptr == vtg || vtg->size() == rows)
+  {
+    unsigned const threads =
+        0U == num_threads ? std::thread::hardware_concurrency() : num_threads;
+    size_t const shards = std::max<size_t>(
+        1U, std::min<size_t>(threads, rows / MIN_ROWS_PER_THREAD));
+    size_t const shard_rows = (rows + shards - 1U) / shards;
+    // Shard 0 writes straight into output; the others get their own text,
+    // appended in order once all are done.
+    std::vector<string> texts(shards - 1U);
+    std::vector<std::thread> workers;
+    workers.reserve(texts.size());
+    for (size_t i = 1U; i < shards; ++i)
+    {
+      size_t const first = std::min(rows, i * shard_rows);
+      size_t const last = std::min(rows, first + shard_rows);
+      workers.push_back(std::thread(build_rows, std::cref(gga), vtg, first,
+                                    last, std::ref(texts[i - 1U])));
+    }
+    build_rows(gga, vtg, 0U, std::min(rows, shard_rows), output);
+    for (size_t i = 0U; i < workers.size(); ++i)
+    {
+      workers[i].join();
+      output += texts[i];
+    }
+  }
+  return output.size() - before;
+}
@@ -0,0 +1,161 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "nmea_batch_parser.hpp"
+
+using std::vector;
+
+struct BatchShard
+{
+  char const *begin;
+  char const *end;
+  size_t firstRecord;
+  size_t records;
+};
+
+// Calls line(begin, end) for every non-empty line with CR/LF stripped.
+template <typename LineFunction>
+static void for_each_line(char const *position, char const *const end,
+                          LineFunction line)
+{
+  while (position != end)
+  {
+    char const *newline = static_cast<char const *>(
+        memchr(position, '\n', static_cast<size_t>(end - position)));
+    char const *const next = nullptr == newline ? end : newline + 1;
+    char const *stop = nullptr == newline ? end : newline;
+    while (stop != position && '\r' == stop[-1])
+    {
+      --stop;
+    }
+    if (stop != position)
+    {
+      line(position, stop);
+    }
+    position = next;
+  }
+}
+
+static unsigned resolve_threads(unsigned const num_threads)
+{
+  unsigned const resolved =
+      0U == num_threads ? std::thread::hardware_concurrency() : num_threads;
+  return std::max(1U, resolved);
+}
+
+// Cuts the buffer into roughly equal shards that start just after a newline.
+static vector<BatchShard> split_shards(char const *const buffer,
+                                       size_t const length,
+                                       unsigned const num_threads)
+{
+  vector<BatchShard> shards;
+  char const *const end = buffer + length;
+  char const *begin = buffer;
+  size_t const target = length / num_threads + 1U;
+  while (begin != end)
+  {
+    char const *stop = end;
+    if (static_cast<size_t>(end - begin) > target)
+    {
+      char const *const newline = static_cast<char const *>(memchr(
+          begin + target, '\n', static_cast<size_t>(end - begin - target)));
+      stop = nullptr == newline ? end : newline + 1;
+    }
+    BatchShard shard;
+    shard.begin = begin;
+    shard.end = stop;
+    shard.firstRecord = 0U;
+    shard.records = 0U;
+    shards.push_back(shard);
+    begin = stop;
+  }
+  return shards;
+}
+
+template <typename ShardFunction>
+static void run_shards(vector<BatchShard> &shards, ShardFunction function)
+{
+  vector<std::thread> workers;
+  workers.reserve(shards.size());
+  for (size_t i = 1U; i < shards.size(); ++i)
+  {
+    workers.push_back(std::thread(function, std::ref(shards[i])));
+  }
+  if (!shards.empty())
+  {
+    function(shards[0]);
+  }
+  for (size_t i = 0U; i < workers.size(); ++i)
+  {
+    workers[i].join();
+  }
+}
+
+static void count_shard(BatchShard &shard)
+{
+  size_t records = 0U;
+  for_each_line(shard.begin, shard.end,
+                [&records](char const *, char const *) { ++records; });
+  shard.records = records;
+}
+
+size_t count_nmea_lines(char const *const buffer, size_t const length,
+                        unsigned const num_threads)
+{
+  vector<BatchShard> shards(
+      split_shards(buffer, length, resolve_threads(num_threads)));
+  run_shards(shards, count_shard);
+  size_t total = 0U;
+  for (size_t i = 0U; i < shards.size(); ++i)
+  {
+    total += shards[i].records;
+  }
+  return total;
+}
+
+size_t parse_nmea_batch(char const *const buffer, size_t const length,
+                        NmeaMessage *const output, size_t const capacity,
+                        unsigned const num_threads,
+                        NmeaChecksumMode const checksum_mode)
+{
+  vector<BatchShard> shards(
+      split_shards(buffer, length, resolve_threads(num_threads)));
+  if (1U < shards.size())
+  {
+    // Only a multi-shard run needs to know where each shard starts writing.
+    run_shards(shards, count_shard);
+    size_t first_record = 0U;
+    for (size_t i = 0U; i < shards.size(); ++i)
+    {
+      shards[i].firstRecord = first_record;
+      first_record += shards[i].records;
+    }
+  }
+
+  run_shards(shards, [output, capacity, checksum_mode](BatchShard &shard) {
+    size_t record = shard.firstRecord;
+    for_each_line(shard.begin, shard.end,
+                  [output, capacity, checksum_mode,
+                   &record](char const *begin, char const *end) {
+                    if (record < capacity)
+                    {
+                      output[record] = parse_nmea(
+                          begin, static_cast<size_t>(end - begin),
+                          checksum_mode);
+                    }
+                    ++record;
+                  });
+    shard.records = record - shard.firstRecord;
+  });
+
+  size_t written = 0U;
+  for (size_t i = 0U; i < shards.size(); ++i)
+  {
+    written += shards[i].records;
+  }
+  return std::min(written, capacity);
+}
@@ -1,174 +1,147 @@
 // Copyright 2016 Geoffrey Lawrence Viola
 
 #include <string>
-#include <sstream>
-#include <iomanip>
-#include <cmath>
 #include "nmea_builder.hpp"
+#include "nmea_sentences.hpp"
 
 using std::string;
-using std::stringstream;
-using std::fabs;
-using std::floor;
-using std::setw;
-using std::setprecision;
-using std::setfill;
-using std::fixed;
-
-string convert_to_nmea_degrees(double const angle_degrees,
-                               bool const three_digits);
-uint8_t calc_checksum(char const *const in, uint8_t const length);
-string get_checksum_string(string const &in);
-
-string convert_to_nmea_degrees(double const angle_degrees,
-                               bool const three_digits)
 
+static char const AVR_HEADER[] = "$PTNL,AVR,";
+static char const GGA_HEADER[] = "$GPGGA,";
+static char const VTG_HEADER[] = "$GPVTG,";
+static char const RMC_HEADER[] = "$GPRMC,";
+static char const GSA_HEADER[] = "$GPGSA,";
+static char const GST_HEADER[] = "$GPGST,";
+static char const ZDA_HEADER[] = "$GPZDA,";
+static char const HDT_HEADER[] = "$GPHDT,";
+static char const GNS_HEADER[] = "$GNGNS,";
+
+size_t build_avr(char *const buffer, size_t const capacity,
+                 AvrMessageData const &message)
 {
-  string output;
-  double const pos_angle_degrees = fabs(angle_degrees);
+  return build_sentence<AvrSchema>(buffer, capacity, AVR_HEADER,
+                                   sizeof(AVR_HEADER) - 1U, message);
+}
 
-  // Get the decimal value to use for the minutes
-  double min_dec = pos_angle_degrees - floor(pos_angle_degrees);
-  min_dec *= 60.0;
+size_t build_gga(char *const buffer, size_t const capacity,
+                 GgaMessageData const &message)
+{
+  return build_sentence<GgaSchema>(buffer, capacity, GGA_HEADER,
+                                   sizeof(GGA_HEADER) - 1U, message);
+}
 
-  int32_t angle_degrees_int;
-  int32_t min_int;
+size_t build_vtg(char *const buffer, size_t const capacity,
+                 VtgMessageData const &message)
+{
+  return build_sentence<VtgSchema>(buffer, capacity, VTG_HEADER,
+                                   sizeof(VTG_HEADER) - 1U, message);
+}
 
-  min_int = static_cast<int32_t>(floor(min_dec));
-  min_dec = min_dec - floor(min_dec);
-  angle_degrees_int = static_cast<int32_t>(floor(pos_angle_degrees));
+size_t build_rmc(char *const buffer, size_t const capacity,
+                 RmcMessageData const &message)
+{
+  return build_sentence<RmcSchema>(buffer, capacity, RMC_HEADER,
+                                   sizeof(RMC_HEADER) - 1U, message);
+}
 
-  stringstream ss, min_int_ss, min_dec_ss;
+size_t build_gsa(char *const buffer, size_t const capacity,
+                 GsaMessageData const &message)
+{
+  return build_sentence<GsaSchema>(buffer, capacity, GSA_HEADER,
+                                   sizeof(GSA_HEADER) - 1U, message);
+}
 
-  ss << fixed << setfill('0') << (three_digits ? setw(3) : setw(2))
-     << angle_degrees_int;
-  output = ss.str();
-  min_int_ss << fixed << setfill('0') << std::setw(2) << min_int;
-  output += min_int_ss.str();
-  min_dec_ss << fixed << setw(8) << std::setprecision(8) << min_dec;
-  string const tmp1 = min_dec_ss.str();
-  string const tmp2 = tmp1.substr(1, tmp1.length() - 1);
-  output += tmp2.c_str();
+size_t build_gsv(char *const buffer, size_t const capacity,
+                 GsvMessageData const &message)
+{
+  char const header[] = {'$', message.talker[0], message.talker[1], 'G', 'S',
+                         'V', ','};
+  return build_sentence<GsvSchema>(buffer, capacity, header, sizeof(header),
+                                   message);
+}
 
-  return output;
+size_t build_gst(char *const buffer, size_t const capacity,
+                 GstMessageData const &message)
+{
+  return build_sentence<GstSchema>(buffer, capacity, GST_HEADER,
+                                   sizeof(GST_HEADER) - 1U, message);
 }
 
-uint8_t calc_checksum(char const *const in, uint8_t const length)
+size_t build_zda(char *const buffer, size_t const capacity,
+                 ZdaMessageData const &message)
 {
-  uint8_t calculatedCheckSum = 0;
-  for (uint16_t i = 1; i < length - 1; i++)
-  {
-    calculatedCheckSum = calculatedCheckSum ^ in[i];
-  }
-  return calculatedCheckSum;
+  return build_sentence<ZdaSchema>(buffer, capacity, ZDA_HEADER,
+                                   sizeof(ZDA_HEADER) - 1U, message);
 }
 
-string get_checksum_string(string const &in)
+size_t build_hdt(char *const buffer, size_t const capacity,
+                 HdtMessageData const &message)
 {
-  string output;
-  uint8_t checksum =
-      calc_checksum(in.c_str(), static_cast<uint8_t>(in.length()));
-  stringstream checksumSS;
-  checksumSS << std::hex << std::setfill('0') << std::uppercase << std::setw(2)
-             << static_cast<uint16_t>(checksum);
-  output = checksumSS.str();
-  return output;
+  return build_sentence<HdtSchema>(buffer, capacity, HDT_HEADER,
+                                   sizeof(HDT_HEADER) - 1U, message);
 }
 
-string build_gga(uint8_t const utc_hour, uint8_t const utc_minute,
+size_t build_gns(char *const buffer, size_t const capacity,
+                 GnsMessageData const &message)
+{
+  return build_sentence<GnsSchema>(buffer, capacity, GNS_HEADER,
+                                   sizeof(GNS_HEADER) - 1U, message);
+}
+
+size_t build_gga(char *const buffer, size_t const capacity,
+                 uint8_t const utc_hour, uint8_t const utc_minute,
                  double const utc_seconds, double const latitude_degrees,
                  double const longitude_degrees,
                  GgaFixQuality const fix_quality, uint16_t const num_satellites,
                  double const hdop, double const altitude_m,
                  double const geoid_height)
 {
-  stringstream utcTime, fixType, numSats, hdop_ss, mslAlt, heightOfGeoid;
-  string output = "$GPGGA,";
-  // time
-  utcTime << setfill('0') << setw(2) << static_cast<uint16_t>(utc_hour);
-  utcTime << setfill('0') << setw(2) << static_cast<uint16_t>(utc_minute);
-  utcTime << setfill('0') << fixed << setw(5) << setprecision(2) << utc_seconds;
-  output += utcTime.str() + ",";
-  // lat
-  output += convert_to_nmea_degrees(latitude_degrees, false) + ",";
-  if (latitude_degrees > 0)
-  {
-    output += "N,";
-  }
-  else
-  {
-    output += "S,";
-  }
-
-  // lon
-  output += convert_to_nmea_degrees(longitude_degrees, true) + ",";
-  if (longitude_degrees > 0)
-  {
-    output += "E,";
-  }
-  else
-  {
-    output += "W,";
-  }
-
-  // fix type
-  fixType << static_cast<uint16_t>(fix_quality);
-  output += fixType.str() + ",";
-
-  // num sats
-  numSats << num_satellites;
-  output += numSats.str() + ",";
-
-  // hdop
-  hdop_ss << hdop;
-  output += hdop_ss.str() + ",";
-
-  // altitude
-  mslAlt << setfill('0') << fixed << setw(6) << setprecision(3) << altitude_m;
-  output += mslAlt.str() + ",M,";
-
-  // height of geoid
-  heightOfGeoid << fixed << setprecision(1) << geoid_height;
-  output += heightOfGeoid.str() + ",M,";
-
-  output += ",*";
-
-  output += get_checksum_string(output);
-
-  output += "\n";
-
-  return output;
+  GgaMessageData const message(0.0, latitude_degrees, longitude_degrees,
+                               fix_quality, num_satellites, hdop, altitude_m,
+                               geoid_height);
+  NmeaWriter writer(buffer, capacity);
+  writer.put(GGA_HEADER, sizeof(GGA_HEADER) - 1U);
+  // The time is printed from its parts; folding them into one hhmmss.ss
+  // double first could round differently.
+  writer.put_uint(utc_hour, 2U);
+  writer.put_uint(utc_minute, 2U);
+  writer.put_fixed(utc_seconds, 2, 5U);
+  writer.put(',');
+  GgaSchema::Tail::build(writer, message);
+  return finish_sentence(writer);
 }
 
-string build_vtg(double const true_track_made_good_ned_degrees,
+size_t build_vtg(char *const buffer, size_t const capacity,
+                 double const true_track_made_good_ned_degrees,
                  double const ground_velocity_mps)
 {
-  string output = "$GPVTG,";
-
-  stringstream trackSS, velocityKnotsSS, velocityKphSS;
-
-  double const vel_knots = ground_velocity_mps * 1.94384;
-  double const vel_kph = ground_velocity_mps * 3.6;
-
-  // track angle (no mag angle)
-  trackSS << std::setfill('0') << std::fixed << std::setw(5)
-          << std::setprecision(1) << true_track_made_good_ned_degrees;
-  output += trackSS.str();
-  output += ",T,,M,";
-
-  // vel knots
-  velocityKnotsSS << std::fixed << std::setprecision(3) << vel_knots;
-  output += velocityKnotsSS.str();
-  output += ",N,";
-
-  // vel kph
-  velocityKphSS << std::fixed << std::setprecision(3) << vel_kph;
-  output += velocityKphSS.str();
-  output += ",K*";
+  VtgMessageData const message(true_track_made_good_ned_degrees, false, 0.0,
+                               ground_velocity_mps * MPS_TO_KNOTS,
+                               ground_velocity_mps * MPS_TO_KPH);
+  return build_vtg(buffer, capacity, message);
+}
 
-  // checksum
-  output += get_checksum_string(output);
-  output += "\n";
+string build_gga(uint8_t const utc_hour, uint8_t const utc_minute,
+                 double const utc_seconds, double const latitude_degrees,
+                 double const longitude_degrees,
+                 GgaFixQuality const fix_quality, uint16_t const num_satellites,
+                 double const hdop, double const altitude_m,
+                 double const geoid_height)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t const length =
+      build_gga(buffer, sizeof(buffer), utc_hour, utc_minute, utc_seconds,
+                latitude_degrees, longitude_degrees, fix_quality,
+                num_satellites, hdop, altitude_m, geoid_height);
+  return string(buffer, length);
+}
 
-  return output;
+string build_vtg(double const true_track_made_good_ned_degrees,
+                 double const ground_velocity_mps)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  size_t const length = build_vtg(buffer, sizeof(buffer),
+                                  true_track_made_good_ned_degrees,
+                                  ground_velocity_mps);
+  return string(buffer, length);
 }
@@ -0,0 +1,121 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_checksum.hpp"
+#include "nmea_cpu_features.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static size_t const CHECKSUM_FIELD_LENGTH = 3U;
+
+uint8_t nmea_checksum_scalar(char const *const data, size_t const length)
+{
+  uint8_t checksum = 0U;
+  for (size_t i = 0U; i < length; ++i)
+  {
+    checksum = static_cast<uint8_t>(checksum ^ static_cast<uint8_t>(data[i]));
+  }
+  return checksum;
+}
+
+#if defined(__SSE2__)
+static uint8_t reduce_xor(__m128i value)
+{
+  value = _mm_xor_si128(value, _mm_srli_si128(value, 8));
+  value = _mm_xor_si128(value, _mm_srli_si128(value, 4));
+  value = _mm_xor_si128(value, _mm_srli_si128(value, 2));
+  value = _mm_xor_si128(value, _mm_srli_si128(value, 1));
+  return static_cast<uint8_t>(_mm_cvtsi128_si32(value));
+}
+
+static uint8_t nmea_checksum_sse2(char const *const data, size_t const length)
+{
+  __m128i accumulator = _mm_setzero_si128();
+  size_t i = 0U;
+  for (; i + 16U <= length; i += 16U)
+  {
+    accumulator = _mm_xor_si128(
+        accumulator,
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i)));
+  }
+  return static_cast<uint8_t>(reduce_xor(accumulator) ^
+                              nmea_checksum_scalar(data + i, length - i));
+}
+#endif
+
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+__attribute__((target("avx2"))) static uint8_t
+nmea_checksum_avx2(char const *const data, size_t const length)
+{
+  __m256i accumulator = _mm256_setzero_si256();
+  size_t i = 0U;
+  for (; i + 32U <= length; i += 32U)
+  {
+    accumulator = _mm256_xor_si256(
+        accumulator,
+        _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + i)));
+  }
+  __m128i const folded =
+      _mm_xor_si128(_mm256_castsi256_si128(accumulator),
+                    _mm256_extracti128_si256(accumulator, 1));
+  // The SSE2 tail is legacy encoded; leaving the upper halves dirty costs a
+  // state transition on every call.
+  _mm256_zeroupper();
+  return static_cast<uint8_t>(reduce_xor(folded) ^
+                              nmea_checksum_sse2(data + i, length - i));
+}
+#endif
+
+uint8_t nmea_checksum(char const *const data, size_t const length)
+{
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+  bool const use_avx2 = nmea_cpu_has_avx2();
+  return use_avx2 ? nmea_checksum_avx2(data, length)
+                  : nmea_checksum_sse2(data, length);
+#elif defined(__SSE2__)
+  return nmea_checksum_sse2(data, length);
+#else
+  return nmea_checksum_scalar(data, length);
+#endif
+}
+
+static bool hex_value(char const c, uint8_t &value)
+{
+  bool valid = true;
+  if ('0' <= c && '9' >= c)
+  {
+    value = static_cast<uint8_t>(c - '0');
+  }
+  else if ('A' <= c && 'F' >= c)
+  {
+    value = static_cast<uint8_t>(c - 'A' + 10);
+  }
+  else if ('a' <= c && 'f' >= c)
+  {
+    value = static_cast<uint8_t>(c - 'a' + 10);
+  }
+  else
+  {
+    valid = false;
+  }
+  return valid;
+}
+
+bool nmea_checksum_valid(char const *const sentence, size_t length)
+{
+  while (0U < length &&
+         ('\r' == sentence[length - 1U] || '\n' == sentence[length - 1U]))
+  {
+    --length;
+  }
+  uint8_t high = 0U;
+  uint8_t low = 0U;
+  return CHECKSUM_FIELD_LENGTH + 1U <= length && '$' == sentence[0] &&
+         '*' == sentence[length - CHECKSUM_FIELD_LENGTH] &&
+         hex_value(sentence[length - 2U], high) &&
+         hex_value(sentence[length - 1U], low) &&
+         static_cast<uint8_t>((high << 4) | low) ==
+             nmea_checksum(sentence + 1,
+                           length - CHECKSUM_FIELD_LENGTH - 1U);
+}
@@ -0,0 +1,192 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cmath>
+#include <cstring>
+#include "nmea_coordinate.hpp"
+
+static uint64_t const ASCII_ZEROS = 0x3030303030303030ULL;
+static uint64_t const HIGH_NIBBLES = 0xF0F0F0F0F0F0F0F0ULL;
+static uint64_t const PLUS_SIX = 0x0606060606060606ULL;
+// Beyond every real angle but far from overflowing int64_t.
+static double const MAX_NANO_MINUTES = 9.0e17;
+
+static uint32_t const POWERS_OF_TEN[] = {
+    1U,      10U,      100U,      1000U,      10000U,
+    100000U, 1000000U, 10000000U, 100000000U, 1000000000U};
+
+// SWAR: all eight bytes are checked and combined in a handful of 64-bit
+// operations. Digits are '0'..'9' when the high nibble is 3 and adding 6
+// does not carry out of the low nibble. Neighbouring digits are then merged
+// into pairs, quads and the full number, relying on the first character
+// being the least significant byte.
+bool nmea_parse_eight_digits(char const *const text, uint32_t &value)
+{
+  uint64_t chunk = 0U;
+  memcpy(&chunk, text, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  bool const digits = ASCII_ZEROS == (chunk & HIGH_NIBBLES) &&
+                      ASCII_ZEROS == ((chunk + PLUS_SIX) & HIGH_NIBBLES);
+  chunk -= ASCII_ZEROS;
+  chunk = (chunk * 10U + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+  chunk = (chunk * 100U + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+  chunk = (chunk * 10000U + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+  value = static_cast<uint32_t>(chunk);
+#else
+  bool digits = true;
+  value = 0U;
+  for (size_t i = 0U; i < 8U; ++i)
+  {
+    digits = digits && '0' <= text[i] && '9' >= text[i];
+    value = value * 10U + static_cast<uint32_t>(text[i] - '0');
+  }
+#endif
+  return digits;
+}
+
+static bool parse_small_digits(char const *const begin, char const *const end,
+                               uint32_t &value)
+{
+  bool valid = true;
+  value = 0U;
+  for (char const *c = begin; valid && c != end; ++c)
+  {
+    valid = '0' <= *c && '9' >= *c;
+    value = value * 10U + static_cast<uint32_t>(*c - '0');
+  }
+  return valid;
+}
+
+// Up to nine decimals as nano-minutes. The first eight go through the SWAR
+// kernel padded on the right with '0', which scales them at the same time.
+static bool parse_decimals(char const *const begin, char const *const end,
+                           int64_t &nano_minutes)
+{
+  size_t const length = static_cast<size_t>(end - begin);
+  char padded[8] = {'0', '0', '0', '0', '0', '0', '0', '0'};
+  memcpy(padded, begin, length < 8U ? length : 8U);
+  uint32_t first_eight = 0U;
+  bool valid = nmea_parse_eight_digits(padded, first_eight);
+  uint32_t ninth = 0U;
+  if (8U < length)
+  {
+    valid = valid && '0' <= begin[8] && '9' >= begin[8];
+    ninth = static_cast<uint32_t>(begin[8] - '0');
+  }
+  uint32_t round_up = 0U;
+  for (size_t i = NMEA_MAX_MINUTE_DECIMALS; valid && i < length; ++i)
+  {
+    valid = '0' <= begin[i] && '9' >= begin[i];
+    round_up = NMEA_MAX_MINUTE_DECIMALS == i && '5' <= begin[i] ? 1U : round_up;
+  }
+  nano_minutes = static_cast<int64_t>(first_eight) * 10 + ninth + round_up;
+  return valid;
+}
+
+bool nmea_parse_nano_minutes(char const *const text, size_t const length,
+                             int64_t &nano_minutes)
+{
+  char const *const end = text + length;
+  char const *const period =
+      static_cast<char const *>(memchr(text, '.', length));
+  // one to three degree digits, then two minute digits
+  bool valid = nullptr != period && 3 <= period - text && 5 >= period - text;
+  if (valid)
+  {
+    uint32_t degrees = 0U;
+    uint32_t minutes = 0U;
+    int64_t decimals = 0;
+    valid = parse_small_digits(text, period - 2, degrees) &&
+            parse_small_digits(period - 2, period, minutes) && 60U > minutes &&
+            parse_decimals(period + 1, end, decimals);
+    if (valid)
+    {
+      nano_minutes = static_cast<int64_t>(degrees) *
+                         NMEA_NANO_MINUTES_PER_DEGREE +
+                     static_cast<int64_t>(minutes) *
+                         NMEA_NANO_MINUTES_PER_MINUTE +
+                     decimals;
+    }
+  }
+  return valid;
+}
+
+// Exactly width digits of value, most significant first.
+static void put_fixed_width(uint32_t value, size_t const width,
+                            char *const output)
+{
+  for (size_t i = width; 0U != i; --i)
+  {
+    output[i - 1U] = static_cast<char>('0' + value % 10U);
+    value /= 10U;
+  }
+}
+
+static size_t digit_count(uint64_t value)
+{
+  size_t count = 1U;
+  while (10U <= value)
+  {
+    value /= 10U;
+    ++count;
+  }
+  return count;
+}
+
+size_t nmea_format_nano_minutes(int64_t const nano_minutes,
+                                size_t const degree_digits,
+                                size_t const decimals, char *const output)
+{
+  size_t const places =
+      decimals < NMEA_MAX_MINUTE_DECIMALS ? decimals : NMEA_MAX_MINUTE_DECIMALS;
+  uint32_t const step = POWERS_OF_TEN[NMEA_MAX_MINUTE_DECIMALS - places];
+  uint64_t const magnitude =
+      0 > nano_minutes ? 0U - static_cast<uint64_t>(nano_minutes)
+                       : static_cast<uint64_t>(nano_minutes);
+  // Round half up to a multiple of step, then split with constant divisors
+  // so the carry into minutes and degrees falls out of the division.
+  uint64_t const half_up = magnitude + step / 2U;
+  uint64_t const rounded =
+      half_up - static_cast<uint32_t>(half_up % NMEA_NANO_MINUTES_PER_MINUTE) %
+                    step;
+  uint64_t const degrees = rounded / NMEA_NANO_MINUTES_PER_DEGREE;
+  uint64_t const in_degree = rounded % NMEA_NANO_MINUTES_PER_DEGREE;
+  size_t const whole_digits = digit_count(degrees);
+  size_t length = whole_digits < degree_digits ? degree_digits : whole_digits;
+  uint64_t remaining = degrees;
+  for (size_t i = length; 0U != i; --i)
+  {
+    output[i - 1U] = static_cast<char>('0' + remaining % 10U);
+    remaining /= 10U;
+  }
+  put_fixed_width(
+      static_cast<uint32_t>(in_degree / NMEA_NANO_MINUTES_PER_MINUTE), 2U,
+      output + length);
+  length += 2U;
+  output[length++] = '.';
+  put_fixed_width(
+      static_cast<uint32_t>(in_degree % NMEA_NANO_MINUTES_PER_MINUTE) / step,
+      places, output + length);
+  return length + places;
+}
+
+int64_t nmea_degrees_to_nano_minutes(double const degrees,
+                                     size_t const decimals)
+{
+  size_t const places =
+      decimals < NMEA_MAX_MINUTE_DECIMALS ? decimals : NMEA_MAX_MINUTE_DECIMALS;
+  int64_t const step = POWERS_OF_TEN[NMEA_MAX_MINUTE_DECIMALS - places];
+  // 6e10 / step is an integer, so the only rounding is llround's.
+  double const scaled =
+      degrees * static_cast<double>(NMEA_NANO_MINUTES_PER_DEGREE / step);
+  double const limit = MAX_NANO_MINUTES / static_cast<double>(step);
+  double clamped = std::isnan(scaled) ? 0.0 : scaled;
+  clamped = clamped > limit ? limit : clamped;
+  clamped = clamped < -limit ? -limit : clamped;
+  return static_cast<int64_t>(std::llround(clamped)) * step;
+}
+
+double nmea_nano_minutes_to_degrees(int64_t const nano_minutes)
+{
+  return static_cast<double>(nano_minutes) /
+         static_cast<double>(NMEA_NANO_MINUTES_PER_DEGREE);
+}
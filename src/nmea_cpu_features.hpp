@@ -0,0 +1,41 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEACPUFEATURES_HPP
+#define NMEALIB_NMEACPUFEATURES_HPP
+
+// Kernels using more than the build's baseline instruction set are compiled
+// with __attribute__((target(...))) where NMEALIB_HAVE_AVX2_TARGET is
+// defined, and only called once the probes below have found the CPU runs
+// them.
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define NMEALIB_HAVE_AVX2_TARGET 1
+
+inline bool nmea_probe_avx2()
+{
+  __builtin_cpu_init();
+  return 0 != __builtin_cpu_supports("avx2");
+}
+
+inline bool nmea_probe_avx2_fma()
+{
+  __builtin_cpu_init();
+  return 0 != __builtin_cpu_supports("avx2") &&
+         0 != __builtin_cpu_supports("fma");
+}
+
+// Probed on the first call and kept for the process, shared by every file.
+inline bool nmea_cpu_has_avx2()
+{
+  static bool const has = nmea_probe_avx2();
+  return has;
+}
+
+inline bool nmea_cpu_has_avx2_fma()
+{
+  static bool const has = nmea_probe_avx2_fma();
+  return has;
+}
+#endif
+
+#endif // NMEALIB_NMEACPUFEATURES_HPP
@@ -0,0 +1,283 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_epoch_assembler.hpp"
+#include "nmea_utc_resolver.hpp"
+
+static uint32_t const DAY_MS = 86400000U;
+
+// ms from one time of day to the next one at or after it, across midnight.
+static inline uint32_t elapsed_ms(uint32_t const from, uint32_t const to)
+{
+  return (to + DAY_MS - from) % DAY_MS;
+}
+
+// Times less than half a day ahead count as later.
+static inline bool is_later(uint32_t const from, uint32_t const to)
+{
+  return elapsed_ms(from, to) < DAY_MS / 2U;
+}
+
+NmeaEpochAssembler::NmeaEpochAssembler(NmeaEpochAssemblerConfig const &config)
+    : config_(config)
+{
+  config_.periodMs = 0U == config_.periodMs ? 1U : config_.periodMs;
+  reset();
+}
+
+void NmeaEpochAssembler::reset()
+{
+  for (size_t i = 0U; i < NMEA_EPOCH_MAX_PENDING; ++i)
+  {
+    slots_[i].used = false;
+  }
+  pendingCount_ = 0U;
+  sequence_ = 0U;
+  current_ = nullptr;
+  latestValid_ = false;
+  latestMs_ = 0U;
+  readyHead_ = 0U;
+  readyCount_ = 0U;
+  completed_ = 0U;
+  timedOut_ = 0U;
+  droppedMessages_ = 0U;
+  overwritten_ = 0U;
+}
+
+void NmeaEpochAssembler::push_ready(NmeaNavigationEpoch const &epoch)
+{
+  if (NMEA_EPOCH_MAX_READY == readyCount_)
+  {
+    readyHead_ = (readyHead_ + 1U) % NMEA_EPOCH_MAX_READY;
+    --readyCount_;
+    ++overwritten_;
+  }
+  ready_[(readyHead_ + readyCount_) % NMEA_EPOCH_MAX_READY] = epoch;
+  ++readyCount_;
+}
+
+bool NmeaEpochAssembler::next(NmeaNavigationEpoch &epoch)
+{
+  bool const found = 0U != readyCount_;
+  if (found)
+  {
+    epoch = ready_[readyHead_];
+    readyHead_ = (readyHead_ + 1U) % NMEA_EPOCH_MAX_READY;
+    --readyCount_;
+  }
+  return found;
+}
+
+void NmeaEpochAssembler::close(Slot &slot)
+{
+  slot.closed = true;
+  --pendingCount_;
+  current_ = &slot == current_ ? nullptr : current_;
+}
+
+size_t NmeaEpochAssembler::give_up(Slot &slot)
+{
+  size_t made_ready = 0U;
+  if (!slot.closed)
+  {
+    ++timedOut_;
+    if (config_.emitIncomplete && 0U != slot.epoch.parts)
+    {
+      push_ready(slot.epoch);
+      made_ready = 1U;
+    }
+    close(slot);
+  }
+  slot.used = false;
+  return made_ready;
+}
+
+size_t NmeaEpochAssembler::finish(Slot &slot)
+{
+  size_t made_ready = 0U;
+  if (config_.requiredParts == (slot.epoch.parts & config_.requiredParts))
+  {
+    push_ready(slot.epoch);
+    ++completed_;
+    close(slot);
+    made_ready = 1U;
+  }
+  return made_ready;
+}
+
+size_t NmeaEpochAssembler::expire(uint32_t const time_ms)
+{
+  size_t made_ready = 0U;
+  for (size_t i = 0U; i < NMEA_EPOCH_MAX_PENDING; ++i)
+  {
+    Slot &slot = slots_[i];
+    if (slot.used && is_later(slot.epoch.timeMs, time_ms) &&
+        elapsed_ms(slot.epoch.timeMs, time_ms) >= config_.timeoutMs)
+    {
+      made_ready += give_up(slot);
+    }
+  }
+  return made_ready;
+}
+
+size_t NmeaEpochAssembler::flush()
+{
+  size_t made_ready = 0U;
+  for (size_t i = 0U; i < NMEA_EPOCH_MAX_PENDING; ++i)
+  {
+    if (slots_[i].used)
+    {
+      made_ready += give_up(slots_[i]);
+    }
+  }
+  return made_ready;
+}
+
+NmeaEpochAssembler::Slot *
+NmeaEpochAssembler::find_slot(uint32_t const time_ms, size_t &made_ready)
+{
+  uint32_t const start = time_ms - time_ms % config_.periodMs;
+  Slot *found = nullptr;
+  // An epoch that would already have timed out is not reopened, and one
+  // already handed out takes no more messages.
+  bool const stale = latestValid_ && is_later(start, latestMs_) &&
+                     elapsed_ms(start, latestMs_) >= config_.timeoutMs;
+  if (!stale)
+  {
+    if (!latestValid_ || is_later(latestMs_, time_ms))
+    {
+      latestMs_ = time_ms;
+      latestValid_ = true;
+    }
+    made_ready += expire(latestMs_);
+    Slot *matched = nullptr;
+    Slot *unused = nullptr;
+    Slot *oldest = nullptr;
+    for (size_t i = 0U; nullptr == matched && i < NMEA_EPOCH_MAX_PENDING;
+         ++i)
+    {
+      Slot &slot = slots_[i];
+      if (slot.used && start == slot.epoch.timeMs)
+      {
+        matched = &slot;
+      }
+      else if (!slot.used)
+      {
+        unused = nullptr == unused ? &slot : unused;
+      }
+      // Closed epochs go first, then the oldest open one.
+      else if (nullptr == oldest ||
+               (slot.closed && !oldest->closed) ||
+               (slot.closed == oldest->closed &&
+                slot.sequence < oldest->sequence))
+      {
+        oldest = &slot;
+      }
+    }
+    if (nullptr != matched)
+    {
+      found = matched->closed ? nullptr : matched;
+    }
+    else
+    {
+      if (nullptr == unused)
+      {
+        made_ready += give_up(*oldest);
+        unused = oldest;
+      }
+      found = unused;
+      found->used = true;
+      found->closed = false;
+      found->sequence = sequence_++;
+      found->epoch.timeMs = start;
+      found->epoch.parts = 0U;
+      found->epoch.position = GgaMessageData();
+      found->epoch.velocity = VtgMessageData();
+      found->epoch.heading = AvrMessageData();
+      ++pendingCount_;
+    }
+    current_ = found;
+  }
+  return found;
+}
+
+size_t NmeaEpochAssembler::add(GgaMessageData const &gga)
+{
+  size_t made_ready = 0U;
+  uint32_t time_ms = 0U;
+  Slot *const slot =
+      gga.valid && nmea_time_of_day_ms(gga.timestamp, time_ms)
+          ? find_slot(time_ms, made_ready)
+          : nullptr;
+  if (nullptr == slot)
+  {
+    // The VTG after it belongs to this epoch too, not to the last one.
+    current_ = nullptr;
+    ++droppedMessages_;
+  }
+  else
+  {
+    slot->epoch.position = gga;
+    slot->epoch.parts |= NMEA_EPOCH_POSITION;
+    made_ready += finish(*slot);
+  }
+  return made_ready;
+}
+
+size_t NmeaEpochAssembler::add(AvrMessageData const &avr)
+{
+  size_t made_ready = 0U;
+  uint32_t time_ms = 0U;
+  Slot *const slot =
+      avr.valid && nmea_time_of_day_ms(avr.timestamp, time_ms)
+          ? find_slot(time_ms, made_ready)
+          : nullptr;
+  if (nullptr == slot)
+  {
+    // The VTG after it belongs to this epoch too, not to the last one.
+    current_ = nullptr;
+    ++droppedMessages_;
+  }
+  else
+  {
+    slot->epoch.heading = avr;
+    slot->epoch.parts |= NMEA_EPOCH_HEADING;
+    made_ready += finish(*slot);
+  }
+  return made_ready;
+}
+
+size_t NmeaEpochAssembler::add(VtgMessageData const &vtg)
+{
+  size_t made_ready = 0U;
+  if (!vtg.valid || nullptr == current_)
+  {
+    ++droppedMessages_;
+  }
+  else
+  {
+    current_->epoch.velocity = vtg;
+    current_->epoch.parts |= NMEA_EPOCH_VELOCITY;
+    made_ready = finish(*current_);
+  }
+  return made_ready;
+}
+
+size_t NmeaEpochAssembler::add(NmeaMessage const &message)
+{
+  size_t made_ready = 0U;
+  switch (message.type)
+  {
+  case NMEA_GGA:
+    made_ready = add(message.gga);
+    break;
+  case NMEA_VTG:
+    made_ready = add(message.vtg);
+    break;
+  case NMEA_AVR:
+    made_ready = add(message.avr);
+    break;
+  default:
+    break;
+  }
+  return made_ready;
+}
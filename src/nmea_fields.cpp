@@ -0,0 +1,216 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include "nmea_coordinate.hpp"
+#include "nmea_fields.hpp"
+
+static size_t const MAX_FIELD_LENGTH = 63U;
+static uint64_t const MAX_EXACT_MANTISSA = 1ULL << 53;
+static double const POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+static size_t const MAX_EXACT_POWER_OF_TEN =
+    sizeof(POWERS_OF_TEN) / sizeof(POWERS_OF_TEN[0]) - 1U;
+
+static bool is_terminator(char const c)
+{
+  return '*' == c || '\r' == c || '\n' == c;
+}
+
+static bool copy_field(NmeaField const &field, char *const buffer)
+{
+  bool const fits = field.length() <= MAX_FIELD_LENGTH;
+  if (fits)
+  {
+    memcpy(buffer, field.begin, field.length());
+    buffer[field.length()] = '\0';
+  }
+  return fits;
+}
+
+static bool strtod_field(NmeaField const &field, double &value)
+{
+  char buffer[MAX_FIELD_LENGTH + 1U];
+  bool valid = copy_field(field, buffer);
+  if (valid)
+  {
+    char *end = nullptr;
+    errno = 0;
+    double const converted = strtod(buffer, &end);
+    valid = end != buffer && ERANGE != errno;
+    if (valid)
+    {
+      value = converted;
+    }
+  }
+  return valid;
+}
+
+static bool strtol_field(NmeaField const &field, int32_t &value)
+{
+  char buffer[MAX_FIELD_LENGTH + 1U];
+  bool valid = copy_field(field, buffer);
+  if (valid)
+  {
+    char *end = nullptr;
+    errno = 0;
+    long const converted = strtol(buffer, &end, 10);
+    valid = end != buffer && ERANGE != errno && converted >= INT_MIN &&
+            converted <= INT_MAX;
+    if (valid)
+    {
+      value = static_cast<int32_t>(converted);
+    }
+  }
+  return valid;
+}
+
+NmeaFieldReader::NmeaFieldReader(char const *const begin,
+                                 char const *const end)
+    : position_(begin)
+    , end_(end)
+    , done_(false)
+{
+}
+
+bool NmeaFieldReader::next(NmeaField &field)
+{
+  bool const available = !done_;
+  if (available)
+  {
+    char const *stop = position_;
+    while (stop != end_ && ',' != *stop && !is_terminator(*stop))
+    {
+      ++stop;
+    }
+    field = NmeaField(position_, stop);
+    if (stop != end_ && ',' == *stop)
+    {
+      position_ = stop + 1;
+    }
+    else
+    {
+      done_ = true;
+    }
+  }
+  return available;
+}
+
+bool NmeaFieldReader::skip(size_t const count)
+{
+  NmeaField ignored;
+  bool available = true;
+  for (size_t i = 0U; available && i < count; ++i)
+  {
+    available = next(ignored);
+  }
+  return available;
+}
+
+bool has_prefix(char const *const message, size_t const length,
+                char const *const prefix, size_t const prefix_length)
+{
+  return length >= prefix_length && 0 == memcmp(message, prefix, prefix_length);
+}
+
+bool parse_field_double(NmeaField const &field, double &value)
+{
+  // Plain decimals with at most 53 bits of mantissa and 22 fractional digits
+  // are exactly representable as mantissa / 10^n, so one correctly rounded
+  // division yields the same bits strtod would.
+  char const *c = field.begin;
+  bool const negative = c != field.end && '-' == *c;
+  if (c != field.end && ('-' == *c || '+' == *c))
+  {
+    ++c;
+  }
+  uint64_t mantissa = 0U;
+  size_t digits = 0U;
+  size_t fraction_digits = 0U;
+  bool seen_dot = false;
+  bool simple = c != field.end;
+  for (; simple && c != field.end; ++c)
+  {
+    if ('0' <= *c && '9' >= *c && digits < 19U)
+    {
+      mantissa = mantissa * 10U + static_cast<uint64_t>(*c - '0');
+      ++digits;
+      fraction_digits += seen_dot ? 1U : 0U;
+    }
+    else if ('.' == *c && !seen_dot)
+    {
+      seen_dot = true;
+    }
+    else
+    {
+      simple = false;
+    }
+  }
+  simple = simple && 0U < digits && mantissa <= MAX_EXACT_MANTISSA &&
+           fraction_digits <= MAX_EXACT_POWER_OF_TEN;
+
+  bool valid = true;
+  if (simple)
+  {
+    double const magnitude =
+        static_cast<double>(mantissa) / POWERS_OF_TEN[fraction_digits];
+    value = negative ? -magnitude : magnitude;
+  }
+  else
+  {
+    valid = strtod_field(field, value);
+  }
+  return valid;
+}
+
+bool parse_field_int(NmeaField const &field, int32_t &value)
+{
+  char const *c = field.begin;
+  bool const negative = c != field.end && '-' == *c;
+  if (c != field.end && ('-' == *c || '+' == *c))
+  {
+    ++c;
+  }
+  size_t const digits = static_cast<size_t>(field.end - c);
+  bool simple = 0U < digits && digits <= 9U;
+  int32_t magnitude = 0;
+  for (; simple && c != field.end; ++c)
+  {
+    simple = '0' <= *c && '9' >= *c;
+    magnitude = magnitude * 10 + (*c - '0');
+  }
+
+  bool valid = true;
+  if (simple)
+  {
+    value = negative ? -magnitude : magnitude;
+  }
+  else
+  {
+    valid = strtol_field(field, value);
+  }
+  return valid;
+}
+
+bool parse_field_degrees_minutes(NmeaField const &field,
+                                 double &angle_degrees)
+{
+  int64_t nano_minutes = 0;
+  bool const valid =
+      nmea_parse_nano_minutes(field.begin, field.length(), nano_minutes);
+  if (valid)
+  {
+    angle_degrees = nmea_nano_minutes_to_degrees(nano_minutes);
+  }
+  return valid;
+}
+
+bool parse_field_hemisphere(NmeaField const &field, char const positive,
+                            double &sign)
+{
+  sign = field.equals(positive) ? 1.0 : -1.0;
+  return true;
+}
@@ -0,0 +1,64 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAFIELDS_HPP
+#define NMEALIB_NMEAFIELDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// A non-owning [begin, end) slice of one comma separated sentence field.
+struct NmeaField
+{
+  inline NmeaField()
+      : begin(nullptr)
+      , end(nullptr)
+  {
+  }
+
+  inline NmeaField(char const *const in_begin, char const *const in_end)
+      : begin(in_begin)
+      , end(in_end)
+  {
+  }
+
+  inline bool empty() const { return begin == end; }
+  inline size_t length() const { return static_cast<size_t>(end - begin); }
+  inline bool equals(char const c) const
+  {
+    return 1U == length() && c == *begin;
+  }
+
+  char const *begin;
+  char const *end;
+};
+
+// Walks the fields of a sentence body in place. The body ends at the
+// checksum delimiter, a line terminator or the end of the buffer.
+class NmeaFieldReader
+{
+public:
+  NmeaFieldReader(char const *const begin, char const *const end);
+
+  bool next(NmeaField &field);
+  bool skip(size_t const count);
+
+private:
+  char const *position_;
+  char const *end_;
+  bool done_;
+};
+
+bool has_prefix(char const *const message, size_t const length,
+                char const *const prefix, size_t const prefix_length);
+
+// Number conversions matching std::stod/std::stoi results without touching
+// the heap. They return false where the std functions would throw.
+bool parse_field_double(NmeaField const &field, double &value);
+bool parse_field_int(NmeaField const &field, int32_t &value);
+bool parse_field_degrees_minutes(NmeaField const &field,
+                                 double &angle_degrees);
+// Anything other than the positive hemisphere letter is taken as negative.
+bool parse_field_hemisphere(NmeaField const &field, char const positive,
+                            double &sign);
+
+#endif // NMEALIB_NMEAFIELDS_HPP
@@ -0,0 +1,621 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sys/mman.h>
+#include "nmea_coordinate.hpp"
+#include "nmea_fix_log.hpp"
+#include "nmea_mapped_file.hpp"
+#include "nmea_stream_framer.hpp"
+#include "nmea_utc_resolver.hpp"
+
+using std::string;
+
+static char const FIX_LOG_MAGIC[8] = {'N', 'M', 'E', 'A', 'F', 'I', 'X', '1'};
+static size_t const CONVERT_CHUNK_BYTES = 64U << 10;
+
+static_assert(16U == sizeof(NmeaFixLogHeader), "fix log header layout");
+static_assert(32U == sizeof(NmeaFixBlockHeader), "fix block header layout");
+static_assert(32U == sizeof(NmeaFixGgaRecord), "GGA record layout");
+static_assert(16U == sizeof(NmeaFixVtgRecord), "VTG record layout");
+static_assert(24U == sizeof(NmeaFixAvrRecord), "AVR record layout");
+
+// Stored byte order to host byte order and back; a no-op on little-endian
+// hosts.
+#if defined(__BYTE_ORDER__) && __ORDER_BIG_ENDIAN__ == __BYTE_ORDER__
+static inline uint16_t little_endian(uint16_t const value)
+{
+  return __builtin_bswap16(value);
+}
+static inline uint32_t little_endian(uint32_t const value)
+{
+  return __builtin_bswap32(value);
+}
+static inline uint64_t little_endian(uint64_t const value)
+{
+  return __builtin_bswap64(value);
+}
+#else
+static inline uint16_t little_endian(uint16_t const value) { return value; }
+static inline uint32_t little_endian(uint32_t const value) { return value; }
+static inline uint64_t little_endian(uint64_t const value) { return value; }
+#endif
+
+static inline int32_t little_endian(int32_t const value)
+{
+  return static_cast<int32_t>(little_endian(static_cast<uint32_t>(value)));
+}
+
+static inline int64_t little_endian(int64_t const value)
+{
+  return static_cast<int64_t>(little_endian(static_cast<uint64_t>(value)));
+}
+
+static NmeaFixBlockHeader little_endian(NmeaFixBlockHeader const &block)
+{
+  NmeaFixBlockHeader swapped(block);
+  swapped.reserved = little_endian(block.reserved);
+  swapped.count = little_endian(block.count);
+  swapped.baseTimeMs = little_endian(block.baseTimeMs);
+  swapped.reserved2 = little_endian(block.reserved2);
+  swapped.baseLatitude = little_endian(block.baseLatitude);
+  swapped.baseLongitude = little_endian(block.baseLongitude);
+  return swapped;
+}
+
+// Rounds value * scale to the nearest integer in [minimum, maximum]; false
+// for anything outside, NaN included.
+static bool to_fixed(double const value, double const scale,
+                     int64_t const minimum, int64_t const maximum,
+                     int64_t &fixed)
+{
+  double const scaled = value * scale;
+  bool const fits = static_cast<double>(minimum) - 0.5 < scaled &&
+                    static_cast<double>(maximum) + 0.5 > scaled;
+  if (fits)
+  {
+    fixed = std::llround(scaled);
+  }
+  return fits;
+}
+
+template <typename Unsigned>
+static bool to_unsigned(double const value, double const scale,
+                        Unsigned &fixed)
+{
+  int64_t rounded = 0;
+  bool const fits =
+      to_fixed(value, scale, 0,
+               static_cast<int64_t>(std::numeric_limits<Unsigned>::max()),
+               rounded);
+  fixed = static_cast<Unsigned>(rounded);
+  return fits;
+}
+
+static bool to_signed(double const value, double const scale, int32_t &fixed)
+{
+  int64_t rounded = 0;
+  bool const fits = to_fixed(value, scale,
+                             std::numeric_limits<int32_t>::min(),
+                             std::numeric_limits<int32_t>::max(), rounded);
+  fixed = static_cast<int32_t>(rounded);
+  return fits;
+}
+
+static double to_timestamp(uint32_t const time_ms)
+{
+  uint32_t const hours = time_ms / 3600000U;
+  uint32_t const minutes = time_ms / 60000U % 60U;
+  uint32_t const seconds_ms = time_ms % 60000U;
+  // one correctly rounded division gives the bits parse_* produces
+  return static_cast<double>(hours * 10000000U + minutes * 100000U +
+                             seconds_ms) /
+         1000.0;
+}
+
+static bool fits_offset(int64_t const value, int64_t const base)
+{
+  int64_t const offset = value - base;
+  return std::numeric_limits<int32_t>::min() <= offset &&
+         std::numeric_limits<int32_t>::max() >= offset;
+}
+
+static int32_t time_offset(NmeaFixBlockHeader const &block,
+                           uint32_t const time_ms)
+{
+  return NMEA_LOG_NO_TIME == block.baseTimeMs
+             ? 0
+             : static_cast<int32_t>(static_cast<int64_t>(time_ms) -
+                                    static_cast<int64_t>(block.baseTimeMs));
+}
+
+uint32_t nmea_fix_time_ms(NmeaFixBlockHeader const &block,
+                          int32_t const record_time_ms)
+{
+  return NMEA_LOG_NO_TIME == block.baseTimeMs
+             ? NMEA_LOG_NO_TIME
+             : static_cast<uint32_t>(
+                   static_cast<int64_t>(block.baseTimeMs) +
+                   little_endian(record_time_ms));
+}
+
+GgaMessageData nmea_fix_decode(NmeaFixBlockHeader const &block,
+                               NmeaFixGgaRecord const &record)
+{
+  GgaMessageData gga(
+      to_timestamp(nmea_fix_time_ms(block, record.timeMs)),
+      nmea_nano_minutes_to_degrees(block.baseLatitude +
+                                   little_endian(record.latitude)),
+      nmea_nano_minutes_to_degrees(block.baseLongitude +
+                                   little_endian(record.longitude)),
+      static_cast<GgaFixQuality>(record.fixQuality),
+      little_endian(record.numSatellites),
+      static_cast<double>(little_endian(record.hdop)) / 100.0,
+      static_cast<double>(little_endian(record.altitudeMm)) / 1000.0,
+      static_cast<double>(little_endian(record.geoidHeightMm)) / 1000.0);
+  if (0U != (NMEA_FIX_GGA_DGPS_AGE & record.flags))
+  {
+    gga.SetTimeSinceLastDgps(
+        static_cast<double>(little_endian(record.dgpsAgeMs)) / 1000.0);
+  }
+  if (0U != (NMEA_FIX_GGA_DGPS_STATION & record.flags))
+  {
+    gga.SetDgpsStationID(little_endian(record.dgpsStationId));
+  }
+  return gga;
+}
+
+VtgMessageData nmea_fix_decode(NmeaFixBlockHeader const &,
+                               NmeaFixVtgRecord const &record)
+{
+  uint16_t const magnetic = little_endian(record.magneticTrack);
+  bool const magnetic_valid = NMEA_FIX_VTG_NO_MAGNETIC_TRACK != magnetic;
+  return VtgMessageData(
+      static_cast<double>(little_endian(record.trueTrack)) / 100.0,
+      magnetic_valid,
+      magnetic_valid ? static_cast<double>(magnetic) / 100.0 : 0.0,
+      static_cast<double>(little_endian(record.speedKnots)) / 1000.0,
+      static_cast<double>(little_endian(record.speedKph)) / 1000.0);
+}
+
+AvrMessageData nmea_fix_decode(NmeaFixBlockHeader const &block,
+                               NmeaFixAvrRecord const &record)
+{
+  return AvrMessageData(
+      to_timestamp(nmea_fix_time_ms(block, record.timeMs)),
+      static_cast<double>(little_endian(record.yaw)) / 10000.0,
+      static_cast<double>(little_endian(record.tilt)) / 10000.0,
+      static_cast<double>(little_endian(record.rangeMm)) / 1000.0,
+      static_cast<AvrFixQuality>(record.fixQuality),
+      static_cast<double>(little_endian(record.pdop)) / 100.0,
+      little_endian(record.numSatellites));
+}
+
+NmeaFixLogWriter::NmeaFixLogWriter(size_t const block_records)
+    : blockRecords_(0U == block_records ? 1U : block_records)
+    , file_(nullptr)
+    , failed_(false)
+    , lastTimeMs_(NMEA_LOG_NO_TIME)
+    , records_(0U)
+    , skipped_(0U)
+    , blocks_(0U)
+    , bytes_(0U)
+{
+  memset(&ggaBlock_, 0, sizeof(ggaBlock_));
+  memset(&vtgBlock_, 0, sizeof(vtgBlock_));
+  memset(&avrBlock_, 0, sizeof(avrBlock_));
+}
+
+NmeaFixLogWriter::~NmeaFixLogWriter() { close(); }
+
+bool NmeaFixLogWriter::open(string const &path)
+{
+  close();
+  file_ = fopen(path.c_str(), "wb");
+  failed_ = nullptr == file_;
+  lastTimeMs_ = NMEA_LOG_NO_TIME;
+  records_ = 0U;
+  skipped_ = 0U;
+  blocks_ = 0U;
+  bytes_ = 0U;
+  if (!failed_)
+  {
+    NmeaFixLogHeader header;
+    memcpy(header.magic, FIX_LOG_MAGIC, sizeof(FIX_LOG_MAGIC));
+    header.version = little_endian(NMEA_FIX_LOG_VERSION);
+    header.blockHeaderSize =
+        little_endian(static_cast<uint32_t>(sizeof(NmeaFixBlockHeader)));
+    failed_ = 1U != fwrite(&header, sizeof(header), 1U, file_);
+    bytes_ = sizeof(header);
+  }
+  return !failed_;
+}
+
+bool NmeaFixLogWriter::close()
+{
+  bool closed = true;
+  if (nullptr != file_)
+  {
+    write_block(ggaBlock_, gga_.data(), gga_.size());
+    write_block(vtgBlock_, vtg_.data(), vtg_.size());
+    write_block(avrBlock_, avr_.data(), avr_.size());
+    closed = 0 == fclose(file_) && !failed_;
+    file_ = nullptr;
+  }
+  gga_.clear();
+  vtg_.clear();
+  avr_.clear();
+  return closed;
+}
+
+bool NmeaFixLogWriter::fits(NmeaFixBlockHeader const &block,
+                            size_t const count, uint32_t const time_ms,
+                            int64_t const latitude,
+                            int64_t const longitude) const
+{
+  return 0U != count && blockRecords_ > count &&
+         (NMEA_LOG_NO_TIME == block.baseTimeMs) ==
+             (NMEA_LOG_NO_TIME == time_ms) &&
+         fits_offset(latitude, block.baseLatitude) &&
+         fits_offset(longitude, block.baseLongitude);
+}
+
+void NmeaFixLogWriter::begin_block(NmeaFixBlockHeader &block,
+                                   NmeaMessageType const type,
+                                   size_t const record_size,
+                                   uint32_t const time_ms,
+                                   int64_t const latitude,
+                                   int64_t const longitude)
+{
+  memset(&block, 0, sizeof(block));
+  block.type = static_cast<uint8_t>(type);
+  block.recordSize = static_cast<uint8_t>(record_size);
+  block.baseTimeMs = time_ms;
+  block.baseLatitude = latitude;
+  block.baseLongitude = longitude;
+}
+
+void NmeaFixLogWriter::write_block(NmeaFixBlockHeader &block,
+                                   void const *const records,
+                                   size_t const count)
+{
+  if (0U != count && nullptr != file_)
+  {
+    block.count = static_cast<uint32_t>(count);
+    NmeaFixBlockHeader const stored(little_endian(block));
+    failed_ = failed_ || 1U != fwrite(&stored, sizeof(stored), 1U, file_) ||
+              count != fwrite(records, block.recordSize, count, file_);
+    bytes_ += sizeof(stored) + count * block.recordSize;
+    ++blocks_;
+  }
+}
+
+bool NmeaFixLogWriter::append(GgaMessageData const &gga)
+{
+  NmeaFixGgaRecord record;
+  memset(&record, 0, sizeof(record));
+  uint32_t time_ms = 0U;
+  int64_t const latitude = nmea_degrees_to_nano_minutes(gga.latitude);
+  int64_t const longitude = nmea_degrees_to_nano_minutes(gga.longitude);
+  bool stored =
+      gga.valid && nullptr != file_ &&
+      nmea_time_of_day_ms(gga.timestamp, time_ms) &&
+      std::fabs(gga.latitude) <= 90.0 && std::fabs(gga.longitude) <= 180.0 &&
+      to_signed(gga.altitude, 1000.0, record.altitudeMm) &&
+      to_signed(gga.geoidHeight, 1000.0, record.geoidHeightMm) &&
+      to_unsigned(gga.hdop, 100.0, record.hdop) &&
+      (!gga.timeSinceLastDgpsValid ||
+       to_unsigned(gga.timeSinceLastDgps, 1000.0, record.dgpsAgeMs));
+  if (stored)
+  {
+    if (!fits(ggaBlock_, gga_.size(), time_ms, latitude, longitude))
+    {
+      write_block(ggaBlock_, gga_.data(), gga_.size());
+      gga_.clear();
+      begin_block(ggaBlock_, NMEA_GGA, sizeof(record), time_ms, latitude,
+                  longitude);
+    }
+    record.timeMs = little_endian(time_offset(ggaBlock_, time_ms));
+    record.latitude = little_endian(
+        static_cast<int32_t>(latitude - ggaBlock_.baseLatitude));
+    record.longitude = little_endian(
+        static_cast<int32_t>(longitude - ggaBlock_.baseLongitude));
+    record.altitudeMm = little_endian(record.altitudeMm);
+    record.geoidHeightMm = little_endian(record.geoidHeightMm);
+    record.dgpsAgeMs = little_endian(record.dgpsAgeMs);
+    record.hdop = little_endian(record.hdop);
+    record.numSatellites = little_endian(gga.numSatellites);
+    record.dgpsStationId =
+        little_endian(gga.dgpdStationIDValid ? gga.dgpdStationID
+                                             : static_cast<uint16_t>(0U));
+    record.fixQuality = static_cast<uint8_t>(gga.fixQuality);
+    record.flags = static_cast<uint8_t>(
+        (gga.timeSinceLastDgpsValid ? NMEA_FIX_GGA_DGPS_AGE : 0U) |
+        (gga.dgpdStationIDValid ? NMEA_FIX_GGA_DGPS_STATION : 0U));
+    gga_.push_back(record);
+    lastTimeMs_ = time_ms;
+    ++records_;
+  }
+  else
+  {
+    ++skipped_;
+  }
+  return stored;
+}
+
+bool NmeaFixLogWriter::append(VtgMessageData const &vtg)
+{
+  NmeaFixVtgRecord record;
+  memset(&record, 0, sizeof(record));
+  record.magneticTrack = NMEA_FIX_VTG_NO_MAGNETIC_TRACK;
+  bool stored =
+      vtg.valid && nullptr != file_ &&
+      to_unsigned(vtg.trueTrackMadeGood, 100.0, record.trueTrack) &&
+      NMEA_FIX_VTG_NO_MAGNETIC_TRACK != record.trueTrack &&
+      (!vtg.magneticTrackMadeGoodValid ||
+       (to_unsigned(vtg.magneticTrackMadeGood, 100.0, record.magneticTrack) &&
+        NMEA_FIX_VTG_NO_MAGNETIC_TRACK != record.magneticTrack)) &&
+      to_unsigned(vtg.groundSpeedKnots, 1000.0, record.speedKnots) &&
+      to_unsigned(vtg.groundSpeedKph, 1000.0, record.speedKph);
+  if (stored)
+  {
+    if (!fits(vtgBlock_, vtg_.size(), lastTimeMs_, 0, 0))
+    {
+      write_block(vtgBlock_, vtg_.data(), vtg_.size());
+      vtg_.clear();
+      begin_block(vtgBlock_, NMEA_VTG, sizeof(record), lastTimeMs_, 0, 0);
+    }
+    record.timeMs = little_endian(time_offset(vtgBlock_, lastTimeMs_));
+    record.trueTrack = little_endian(record.trueTrack);
+    record.magneticTrack = little_endian(record.magneticTrack);
+    record.speedKnots = little_endian(record.speedKnots);
+    record.speedKph = little_endian(record.speedKph);
+    vtg_.push_back(record);
+    ++records_;
+  }
+  else
+  {
+    ++skipped_;
+  }
+  return stored;
+}
+
+bool NmeaFixLogWriter::append(AvrMessageData const &avr)
+{
+  NmeaFixAvrRecord record;
+  memset(&record, 0, sizeof(record));
+  uint32_t time_ms = 0U;
+  bool stored = avr.valid && nullptr != file_ &&
+                nmea_time_of_day_ms(avr.timestamp, time_ms) &&
+                to_signed(avr.yaw, 10000.0, record.yaw) &&
+                to_signed(avr.tilt, 10000.0, record.tilt) &&
+                to_unsigned(avr.range, 1000.0, record.rangeMm) &&
+                to_unsigned(avr.pdop, 100.0, record.pdop);
+  if (stored)
+  {
+    if (!fits(avrBlock_, avr_.size(), time_ms, 0, 0))
+    {
+      write_block(avrBlock_, avr_.data(), avr_.size());
+      avr_.clear();
+      begin_block(avrBlock_, NMEA_AVR, sizeof(record), time_ms, 0, 0);
+    }
+    record.timeMs = little_endian(time_offset(avrBlock_, time_ms));
+    record.yaw = little_endian(record.yaw);
+    record.tilt = little_endian(record.tilt);
+    record.rangeMm = little_endian(record.rangeMm);
+    record.pdop = little_endian(record.pdop);
+    record.numSatellites = little_endian(avr.numSatellites);
+    record.fixQuality = static_cast<uint8_t>(avr.fixQuality);
+    avr_.push_back(record);
+    lastTimeMs_ = time_ms;
+    ++records_;
+  }
+  else
+  {
+    ++skipped_;
+  }
+  return stored;
+}
+
+bool NmeaFixLogWriter::append(NmeaMessage const &message)
+{
+  bool stored = false;
+  uint32_t time_ms = 0U;
+  switch (message.type)
+  {
+  case NMEA_GGA:
+    stored = append(message.gga);
+    break;
+  case NMEA_VTG:
+    stored = append(message.vtg);
+    break;
+  case NMEA_AVR:
+    stored = append(message.avr);
+    break;
+  case NMEA_RMC:
+  case NMEA_GST:
+  case NMEA_ZDA:
+  case NMEA_GNS:
+    // every one of these starts with the same hhmmss.ss timestamp
+    if (message.valid() &&
+        nmea_time_of_day_ms(NMEA_RMC == message.type
+                                ? message.rmc.timestamp
+                                : NMEA_GST == message.type
+                                      ? message.gst.timestamp
+                                      : NMEA_ZDA == message.type
+                                            ? message.zda.timestamp
+                                            : message.gns.timestamp,
+                            time_ms))
+    {
+      lastTimeMs_ = time_ms;
+    }
+    break;
+  default:
+    break;
+  }
+  return stored;
+}
+
+NmeaFixLogReader::NmeaFixLogReader()
+    : mapping_(nullptr)
+    , length_(0U)
+{
+}
+
+NmeaFixLogReader::~NmeaFixLogReader() { close(); }
+
+static size_t record_size(uint8_t const type)
+{
+  size_t size = 0U;
+  switch (type)
+  {
+  case NMEA_GGA:
+    size = sizeof(NmeaFixGgaRecord);
+    break;
+  case NMEA_VTG:
+    size = sizeof(NmeaFixVtgRecord);
+    break;
+  case NMEA_AVR:
+    size = sizeof(NmeaFixAvrRecord);
+    break;
+  default:
+    break;
+  }
+  return size;
+}
+
+bool NmeaFixLogReader::open(string const &path)
+{
+  close();
+  int64_t modified = 0;
+  bool opened = nmea_map_file(path.c_str(), mapping_, length_, modified) &&
+                sizeof(NmeaFixLogHeader) <= length_;
+  if (opened)
+  {
+    NmeaFixLogHeader header;
+    memcpy(&header, mapping_, sizeof(header));
+    opened =
+        0 == memcmp(header.magic, FIX_LOG_MAGIC, sizeof(FIX_LOG_MAGIC)) &&
+        NMEA_FIX_LOG_VERSION == little_endian(header.version) &&
+        sizeof(NmeaFixBlockHeader) == little_endian(header.blockHeaderSize);
+  }
+  char const *const data = static_cast<char const *>(mapping_);
+  size_t offset = sizeof(NmeaFixLogHeader);
+  while (opened && offset != length_)
+  {
+    NmeaFixBlockHeader block;
+    opened = sizeof(block) <= length_ - offset;
+    if (opened)
+    {
+      memcpy(&block, data + offset, sizeof(block));
+      block = little_endian(block);
+      offset += sizeof(block);
+      size_t const size = record_size(block.type);
+      opened = 0U != size && size == block.recordSize &&
+               block.count <= (length_ - offset) / size;
+      if (opened)
+      {
+        blocks_.push_back(block);
+        records_.push_back(data + offset);
+        offset += block.count * size;
+      }
+    }
+  }
+  if (!opened)
+  {
+    close();
+  }
+  return opened;
+}
+
+void NmeaFixLogReader::close()
+{
+  if (nullptr != mapping_)
+  {
+    munmap(mapping_, length_);
+  }
+  mapping_ = nullptr;
+  length_ = 0U;
+  blocks_.clear();
+  records_.clear();
+}
+
+void const *NmeaFixLogReader::records(size_t const i,
+                                      NmeaMessageType const type) const
+{
+  return type == blocks_[i].type ? records_[i] : nullptr;
+}
+
+NmeaFixGgaRecord const *NmeaFixLogReader::gga(size_t const i) const
+{
+  return static_cast<NmeaFixGgaRecord const *>(records(i, NMEA_GGA));
+}
+
+NmeaFixVtgRecord const *NmeaFixLogReader::vtg(size_t const i) const
+{
+  return static_cast<NmeaFixVtgRecord const *>(records(i, NMEA_VTG));
+}
+
+NmeaFixAvrRecord const *NmeaFixLogReader::avr(size_t const i) const
+{
+  return static_cast<NmeaFixAvrRecord const *>(records(i, NMEA_AVR));
+}
+
+uint64_t NmeaFixLogReader::count(NmeaMessageType const type) const
+{
+  uint64_t total = 0U;
+  for (size_t i = 0U; i < blocks_.size(); ++i)
+  {
+    total += type == blocks_[i].type ? blocks_[i].count : 0U;
+  }
+  return total;
+}
+
+bool nmea_fix_log_convert(string const &text_path, string const &fix_path,
+                          NmeaFixLogConversion &conversion,
+                          NmeaChecksumMode const checksum_mode)
+{
+  conversion = NmeaFixLogConversion();
+  FILE *const text = fopen(text_path.c_str(), "rb");
+  NmeaFixLogWriter writer;
+  bool converted = nullptr != text && writer.open(fix_path);
+  if (converted)
+  {
+    NmeaStreamFramer framer;
+    std::vector<char> chunk(CONVERT_CHUNK_BYTES);
+    bool more = true;
+    while (more)
+    {
+      size_t const length = fread(chunk.data(), 1U, chunk.size(), text);
+      conversion.textBytes += length;
+      more = 0U != length;
+      // a final line without its terminator still ends a sentence
+      framer.push(more ? chunk.data() : "\n", more ? length : 1U);
+      NmeaSentence sentence;
+      while (framer.next(sentence))
+      {
+        NmeaMessageType const type =
+            identify_nmea(sentence.data, sentence.length);
+        if (NMEA_GGA == type || NMEA_VTG == type || NMEA_AVR == type ||
+            NMEA_RMC == type || NMEA_GST == type || NMEA_ZDA == type ||
+            NMEA_GNS == type)
+        {
+          writer.append(
+              parse_nmea(sentence.data, sentence.length, checksum_mode));
+        }
+      }
+    }
+    converted = 0 == ferror(text);
+    conversion.sentences = framer.sentences();
+  }
+  converted = writer.close() && converted;
+  conversion.records = writer.records();
+  conversion.skipped = writer.skipped();
+  conversion.fixBytes = writer.bytes();
+  if (nullptr != text)
+  {
+    fclose(text);
+  }
+  return converted;
+}
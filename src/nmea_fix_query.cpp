@@ -0,0 +1,416 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "nmea_cpu_features.hpp"
+#include "nmea_fix_query.hpp"
+
+using std::vector;
+
+static double const INFINITE = std::numeric_limits<double>::infinity();
+static size_t const WORD_BITS = 64U;
+
+NmeaFixQuery::NmeaFixQuery()
+    : fixQualities(~static_cast<uint32_t>(0U))
+    , hdopBelow(INFINITE)
+    , minSatellites(0U)
+    , minLatitude(-INFINITE)
+    , maxLatitude(INFINITE)
+    , minLongitude(-INFINITE)
+    , maxLongitude(INFINITE)
+    , minTimestamp(-INFINITE)
+    , maxTimestamp(INFINITE)
+{
+}
+
+// The columns and the query as the filters use them: raw pointers, and the
+// bounding box narrowed to the geofence's.
+struct FixScan
+{
+  FixScan(GgaColumns const &fixes, NmeaFixQuery const &query)
+      : latitude(fixes.latitude.data())
+      , longitude(fixes.longitude.data())
+      , timestamp(fixes.timestamp.data())
+      , hdop(fixes.hdop.data())
+      , fixQuality(fixes.fixQuality.data())
+      , numSatellites(fixes.numSatellites.data())
+      , fixQualities(query.fixQualities)
+      , hdopBelow(query.hdopBelow)
+      , minSatellites(query.minSatellites)
+      , minLatitude(query.minLatitude)
+      , maxLatitude(query.maxLatitude)
+      , minLongitude(query.minLongitude)
+      , maxLongitude(query.maxLongitude)
+      , minTimestamp(query.minTimestamp)
+      , maxTimestamp(query.maxTimestamp)
+      , fenceLatitudes(query.fenceLatitudes.data())
+      , fenceLongitudes(query.fenceLongitudes.data())
+      , fenceVertices(std::min(query.fenceLatitudes.size(),
+                               query.fenceLongitudes.size()))
+  {
+    if (0U < fenceVertices)
+    {
+      double const *const latitudes = fenceLatitudes + fenceVertices;
+      double const *const longitudes = fenceLongitudes + fenceVertices;
+      minLatitude =
+          std::max(minLatitude, *std::min_element(fenceLatitudes, latitudes));
+      maxLatitude =
+          std::min(maxLatitude, *std::max_element(fenceLatitudes, latitudes));
+      minLongitude = std::max(minLongitude,
+                              *std::min_element(fenceLongitudes, longitudes));
+      maxLongitude = std::min(maxLongitude,
+                              *std::max_element(fenceLongitudes, longitudes));
+    }
+  }
+
+  double const *latitude;
+  double const *longitude;
+  double const *timestamp;
+  double const *hdop;
+  uint8_t const *fixQuality;
+  uint16_t const *numSatellites;
+  uint32_t fixQualities;
+  double hdopBelow;
+  uint16_t minSatellites;
+  double minLatitude;
+  double maxLatitude;
+  double minLongitude;
+  double maxLongitude;
+  double minTimestamp;
+  double maxTimestamp;
+  double const *fenceLatitudes;
+  double const *fenceLongitudes;
+  size_t fenceVertices;
+};
+
+static bool row_matches(FixScan const &scan, size_t const i)
+{
+  uint32_t const quality = scan.fixQuality[i];
+  return 32U > quality && 0U != ((scan.fixQualities >> quality) & 1U) &&
+         scan.hdopBelow > scan.hdop[i] &&
+         scan.minSatellites <= scan.numSatellites[i] &&
+         scan.minLatitude <= scan.latitude[i] &&
+         scan.maxLatitude >= scan.latitude[i] &&
+         scan.minLongitude <= scan.longitude[i] &&
+         scan.maxLongitude >= scan.longitude[i] &&
+         scan.minTimestamp <= scan.timestamp[i] &&
+         scan.maxTimestamp >= scan.timestamp[i];
+}
+
+// Even-odd rule: a ray from the fix toward increasing longitude crosses the
+// fence an odd number of times from inside.
+static bool inside_fence(FixScan const &scan, size_t const i)
+{
+  double const latitude = scan.latitude[i];
+  double const longitude = scan.longitude[i];
+  double const *const latitudes = scan.fenceLatitudes;
+  double const *const longitudes = scan.fenceLongitudes;
+  bool inside = false;
+  size_t previous = scan.fenceVertices - 1U;
+  for (size_t vertex = 0U; vertex < scan.fenceVertices; ++vertex)
+  {
+    if ((latitudes[vertex] > latitude) != (latitudes[previous] > latitude))
+    {
+      double const crossing =
+          longitudes[vertex] +
+          (longitudes[previous] - longitudes[vertex]) *
+              (latitude - latitudes[vertex]) /
+              (latitudes[previous] - latitudes[vertex]);
+      inside = longitude < crossing ? !inside : inside;
+    }
+    previous = vertex;
+  }
+  return inside;
+}
+
+// Selection bits of rows [first, first + rows), rows at most 64, before the
+// geofence.
+static uint64_t match_word_scalar(FixScan const &scan, size_t const first,
+                                  size_t const rows)
+{
+  uint64_t word = 0U;
+  for (size_t j = 0U; j < rows; ++j)
+  {
+    word |= static_cast<uint64_t>(row_matches(scan, first + j) ? 1U : 0U)
+            << j;
+  }
+  return word;
+}
+
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+__attribute__((target("avx2"))) static uint64_t
+match_word_avx2(FixScan const &scan, size_t const first)
+{
+  __m256d const min_latitude = _mm256_set1_pd(scan.minLatitude);
+  __m256d const max_latitude = _mm256_set1_pd(scan.maxLatitude);
+  __m256d const min_longitude = _mm256_set1_pd(scan.minLongitude);
+  __m256d const max_longitude = _mm256_set1_pd(scan.maxLongitude);
+  __m256d const min_timestamp = _mm256_set1_pd(scan.minTimestamp);
+  __m256d const max_timestamp = _mm256_set1_pd(scan.maxTimestamp);
+  __m256d const hdop_below = _mm256_set1_pd(scan.hdopBelow);
+  // Shifts of 64 or more give 0, so qualities past the bits never match.
+  __m256i const fix_qualities =
+      _mm256_set1_epi64x(static_cast<int64_t>(scan.fixQualities));
+  __m256i const one = _mm256_set1_epi64x(1);
+  __m256i const satellites_above =
+      _mm256_set1_epi64x(static_cast<int64_t>(scan.minSatellites) - 1);
+  uint64_t word = 0U;
+  for (size_t j = 0U; j < WORD_BITS; j += 4U)
+  {
+    size_t const i = first + j;
+    __m256d const latitude = _mm256_loadu_pd(scan.latitude + i);
+    __m256d const longitude = _mm256_loadu_pd(scan.longitude + i);
+    __m256d const timestamp = _mm256_loadu_pd(scan.timestamp + i);
+    __m256d const hdop = _mm256_loadu_pd(scan.hdop + i);
+    int32_t qualities = 0;
+    int64_t satellites = 0;
+    std::memcpy(&qualities, scan.fixQuality + i, sizeof(qualities));
+    std::memcpy(&satellites, scan.numSatellites + i, sizeof(satellites));
+    __m256i const quality = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(qualities));
+    __m256i const accepted = _mm256_cmpeq_epi64(
+        _mm256_and_si256(_mm256_srlv_epi64(fix_qualities, quality), one), one);
+    __m256i const enough = _mm256_cmpgt_epi64(
+        _mm256_cvtepu16_epi64(_mm_cvtsi64_si128(satellites)),
+        satellites_above);
+    __m256d mask = _mm256_castsi256_pd(_mm256_and_si256(accepted, enough));
+    mask = _mm256_and_pd(mask, _mm256_cmp_pd(hdop, hdop_below, _CMP_LT_OQ));
+    mask = _mm256_and_pd(
+        mask,
+        _mm256_and_pd(_mm256_cmp_pd(latitude, min_latitude, _CMP_GE_OQ),
+                      _mm256_cmp_pd(latitude, max_latitude, _CMP_LE_OQ)));
+    mask = _mm256_and_pd(
+        mask,
+        _mm256_and_pd(_mm256_cmp_pd(longitude, min_longitude, _CMP_GE_OQ),
+                      _mm256_cmp_pd(longitude, max_longitude, _CMP_LE_OQ)));
+    mask = _mm256_and_pd(
+        mask,
+        _mm256_and_pd(_mm256_cmp_pd(timestamp, min_timestamp, _CMP_GE_OQ),
+                      _mm256_cmp_pd(timestamp, max_timestamp, _CMP_LE_OQ)));
+    word |= static_cast<uint64_t>(_mm256_movemask_pd(mask)) << j;
+  }
+  return word;
+}
+#endif
+
+static uint64_t match_word(FixScan const &scan, size_t const first,
+                           size_t const rows)
+{
+  uint64_t word = 0U;
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+  bool const use_avx2 = nmea_cpu_has_avx2();
+  if (use_avx2 && WORD_BITS == rows)
+  {
+    word = match_word_avx2(scan, first);
+  }
+  else
+#endif
+  {
+    word = match_word_scalar(scan, first, rows);
+  }
+  return word;
+}
+
+static uint64_t fence_word(FixScan const &scan, size_t const first,
+                           uint64_t const word)
+{
+  uint64_t fenced = word;
+  for (uint64_t bits = word; 0U != bits; bits &= bits - 1U)
+  {
+    unsigned const j = static_cast<unsigned>(__builtin_ctzll(bits));
+    fenced &= inside_fence(scan, first + j)
+                  ? ~static_cast<uint64_t>(0U)
+                  : ~(static_cast<uint64_t>(1U) << j);
+  }
+  return fenced;
+}
+
+// NaN leaves the range as it is; returns whether value was a number.
+static bool widen(double &low, double &high, double const value)
+{
+  low = value < low ? value : low;
+  high = value > high ? value : high;
+  return !std::isnan(value);
+}
+
+static bool overlaps(double const low, double const high, double const min,
+                     double const max)
+{
+  return high >= min && low <= max;
+}
+
+static bool within(double const low, double const high, double const min,
+                   double const max)
+{
+  return low >= min && high <= max;
+}
+
+enum TileCoverage
+{
+  TILE_PRUNED,
+  TILE_SCANNED,
+  TILE_WHOLE
+};
+
+NmeaFixIndex::NmeaFixIndex(GgaColumns const &fixes)
+    : fixes_(fixes)
+{
+  size_t const rows = fixes.size();
+  tiles_.reserve((rows + NMEA_FIX_TILE_ROWS - 1U) / NMEA_FIX_TILE_ROWS);
+  for (size_t first = 0U; first < rows; first += NMEA_FIX_TILE_ROWS)
+  {
+    size_t const last = std::min(rows, first + NMEA_FIX_TILE_ROWS);
+    NmeaFixTile tile;
+    tile.minLatitude = INFINITE;
+    tile.maxLatitude = -INFINITE;
+    tile.minLongitude = INFINITE;
+    tile.maxLongitude = -INFINITE;
+    tile.minTimestamp = INFINITE;
+    tile.maxTimestamp = -INFINITE;
+    tile.minHdop = INFINITE;
+    tile.maxHdop = -INFINITE;
+    tile.fixQualities = 0U;
+    tile.minSatellites = std::numeric_limits<uint16_t>::max();
+    tile.maxSatellites = 0U;
+    tile.bounded = true;
+    for (size_t i = first; i < last; ++i)
+    {
+      bool const numbers =
+          widen(tile.minLatitude, tile.maxLatitude, fixes.latitude[i]) &
+          widen(tile.minLongitude, tile.maxLongitude, fixes.longitude[i]) &
+          widen(tile.minTimestamp, tile.maxTimestamp, fixes.timestamp[i]) &
+          widen(tile.minHdop, tile.maxHdop, fixes.hdop[i]);
+      uint32_t const quality = fixes.fixQuality[i];
+      tile.fixQualities |=
+          32U > quality ? static_cast<uint32_t>(1U) << quality : 0U;
+      tile.minSatellites = std::min(tile.minSatellites, fixes.numSatellites[i]);
+      tile.maxSatellites = std::max(tile.maxSatellites, fixes.numSatellites[i]);
+      tile.bounded = tile.bounded && numbers && 32U > quality;
+    }
+    tiles_.push_back(tile);
+  }
+}
+
+// Rows of a pruned tile cannot match the query, and every row of a whole
+// one does. Pruning holds for any tile: a row with a NaN or a quality past
+// the bits never matches, and the others are inside the ranges.
+static TileCoverage coverage(FixScan const &scan, NmeaFixTile const &tile)
+{
+  TileCoverage result = TILE_SCANNED;
+  if (!overlaps(tile.minLatitude, tile.maxLatitude, scan.minLatitude,
+                scan.maxLatitude) ||
+      !overlaps(tile.minLongitude, tile.maxLongitude, scan.minLongitude,
+                scan.maxLongitude) ||
+      !overlaps(tile.minTimestamp, tile.maxTimestamp, scan.minTimestamp,
+                scan.maxTimestamp) ||
+      !(tile.minHdop < scan.hdopBelow) ||
+      0U == (tile.fixQualities & scan.fixQualities) ||
+      tile.maxSatellites < scan.minSatellites)
+  {
+    result = TILE_PRUNED;
+  }
+  else if (tile.bounded && 0U == scan.fenceVertices &&
+           within(tile.minLatitude, tile.maxLatitude, scan.minLatitude,
+                  scan.maxLatitude) &&
+           within(tile.minLongitude, tile.maxLongitude, scan.minLongitude,
+                  scan.maxLongitude) &&
+           within(tile.minTimestamp, tile.maxTimestamp, scan.minTimestamp,
+                  scan.maxTimestamp) &&
+           tile.maxHdop < scan.hdopBelow &&
+           0U == (tile.fixQualities & ~scan.fixQualities) &&
+           tile.minSatellites >= scan.minSatellites)
+  {
+    result = TILE_WHOLE;
+  }
+  return result;
+}
+
+size_t NmeaFixIndex::select(NmeaFixQuery const &query,
+                            vector<uint64_t> &bitmap) const
+{
+  size_t const rows = fixes_.size();
+  FixScan const scan(fixes_, query);
+  bitmap.assign((rows + WORD_BITS - 1U) / WORD_BITS, 0U);
+  size_t selected = 0U;
+  for (size_t t = 0U; t < tiles_.size(); ++t)
+  {
+    TileCoverage const covered = coverage(scan, tiles_[t]);
+    size_t const first = t * NMEA_FIX_TILE_ROWS;
+    size_t const last = std::min(rows, first + NMEA_FIX_TILE_ROWS);
+    for (size_t i = first; TILE_PRUNED != covered && i < last;
+         i += WORD_BITS)
+    {
+      size_t const count = std::min(WORD_BITS, last - i);
+      uint64_t word = WORD_BITS == count
+                          ? ~static_cast<uint64_t>(0U)
+                          : (static_cast<uint64_t>(1U) << count) - 1U;
+      if (TILE_SCANNED == covered)
+      {
+        word = match_word(scan, i, count);
+        word = 0U < scan.fenceVertices ? fence_word(scan, i, word) : word;
+      }
+      bitmap[i / WORD_BITS] = word;
+      selected += static_cast<size_t>(__builtin_popcountll(word));
+    }
+  }
+  return selected;
+}
+
+size_t NmeaFixIndex::select_rows(NmeaFixQuery const &query,
+                                 vector<size_t> &rows) const
+{
+  vector<uint64_t> bitmap;
+  size_t const selected = select(query, bitmap);
+  nmea_selection_rows(bitmap, rows);
+  return selected;
+}
+
+size_t NmeaFixIndex::select_scalar(NmeaFixQuery const &query,
+                                   vector<uint64_t> &bitmap) const
+{
+  size_t const rows = fixes_.size();
+  FixScan const scan(fixes_, query);
+  bitmap.assign((rows + WORD_BITS - 1U) / WORD_BITS, 0U);
+  size_t selected = 0U;
+  for (size_t i = 0U; i < rows; ++i)
+  {
+    bool const match = row_matches(scan, i) &&
+                       (0U == scan.fenceVertices || inside_fence(scan, i));
+    bitmap[i / WORD_BITS] |= static_cast<uint64_t>(match ? 1U : 0U)
+                             << (i % WORD_BITS);
+    selected += match ? 1U : 0U;
+  }
+  return selected;
+}
+
+size_t NmeaFixIndex::candidate_tiles(NmeaFixQuery const &query) const
+{
+  FixScan const scan(fixes_, query);
+  size_t candidates = 0U;
+  for (size_t t = 0U; t < tiles_.size(); ++t)
+  {
+    TileCoverage const covered = coverage(scan, tiles_[t]);
+    candidates += TILE_PRUNED != covered ? 1U : 0U;
+  }
+  return candidates;
+}
+
+void nmea_selection_rows(vector<uint64_t> const &bitmap, vector<size_t> &rows)
+{
+  size_t selected = 0U;
+  for (size_t w = 0U; w < bitmap.size(); ++w)
+  {
+    selected += static_cast<size_t>(__builtin_popcountll(bitmap[w]));
+  }
+  rows.clear();
+  rows.reserve(selected);
+  for (size_t w = 0U; w < bitmap.size(); ++w)
+  {
+    for (uint64_t bits = bitmap[w]; 0U != bits; bits &= bits - 1U)
+    {
+      rows.push_back(w * WORD_BITS +
+                     static_cast<size_t>(__builtin_ctzll(bits)));
+    }
+  }
+}
@@ -0,0 +1,260 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "nmea_coordinate.hpp"
+#include "nmea_format.hpp"
+
+static char const HEX_DIGITS[] = "0123456789ABCDEF";
+
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 ScaledDecimal;
+
+static int const MAX_EXACT_PRECISION = 17;
+static uint64_t const POWERS_OF_TEN[MAX_EXACT_PRECISION + 1] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL};
+
+// round(magnitude * 10^precision) computed exactly from the binary value,
+// ties to even, which is what glibc's printf does. Finite magnitudes below
+// 2^63 keep the product within 128 bits.
+static bool scale_exact(double const magnitude, int const precision,
+                        ScaledDecimal &scaled)
+{
+  bool const in_range = std::isfinite(magnitude) && 0 <= precision &&
+                        MAX_EXACT_PRECISION >= precision &&
+                        9.2e18 > magnitude;
+  if (in_range)
+  {
+    int exponent = 0;
+    double const fraction = std::frexp(magnitude, &exponent);
+    uint64_t const mantissa = static_cast<uint64_t>(std::ldexp(fraction, 53));
+    int const shift = 53 - exponent;
+    ScaledDecimal const product =
+        static_cast<ScaledDecimal>(mantissa) * POWERS_OF_TEN[precision];
+    if (0 >= shift)
+    {
+      scaled = product << -shift;
+    }
+    else if (120 <= shift)
+    {
+      scaled = 0U;
+    }
+    else
+    {
+      ScaledDecimal const one = 1U;
+      ScaledDecimal const remainder = product & ((one << shift) - 1U);
+      ScaledDecimal const half = one << (shift - 1);
+      scaled = product >> shift;
+      if (remainder > half || (remainder == half && 0U != (scaled & 1U)))
+      {
+        ++scaled;
+      }
+    }
+  }
+  return in_range;
+}
+
+static size_t write_scaled(bool const negative, ScaledDecimal scaled,
+                           int const precision, bool const trim_zeros,
+                           char *const output)
+{
+  char digits[48];
+  size_t count = 0U;
+  do
+  {
+    digits[count++] = static_cast<char>('0' + static_cast<int>(scaled % 10U));
+    scaled /= 10U;
+  } while (0U != scaled || count <= static_cast<size_t>(precision));
+
+  size_t length = 0U;
+  if (negative)
+  {
+    output[length++] = '-';
+  }
+  while (count > static_cast<size_t>(precision))
+  {
+    output[length++] = digits[--count];
+  }
+  size_t last = count;
+  if (trim_zeros)
+  {
+    size_t first_kept = 0U;
+    while (first_kept < count && '0' == digits[first_kept])
+    {
+      ++first_kept;
+    }
+    last = count - first_kept;
+  }
+  if (0U < last)
+  {
+    output[length++] = '.';
+    for (size_t i = 0U; i < last; ++i)
+    {
+      output[length++] = digits[count - 1U - i];
+    }
+  }
+  output[length] = '\0';
+  return length;
+}
+#endif
+
+size_t format_fixed(double const value, int const precision,
+                    char *const output)
+{
+#if defined(__SIZEOF_INT128__)
+  ScaledDecimal scaled = 0U;
+  if (scale_exact(std::fabs(value), precision, scaled))
+  {
+    return write_scaled(std::signbit(value), scaled, precision, false,
+                        output);
+  }
+#endif
+  return static_cast<size_t>(
+      snprintf(output, NMEA_NUMBER_BUFFER_LENGTH, "%.*f", precision, value));
+}
+
+size_t format_general(double const value, char *const output)
+{
+#if defined(__SIZEOF_INT128__)
+  // "%g" with the default precision of 6 prints fixed notation with
+  // 5 - X decimals when the rounded value has a decimal exponent X in
+  // [-4, 6), then drops trailing zeros.
+  double const magnitude = std::fabs(value);
+  if (0.0 == magnitude)
+  {
+    return write_scaled(std::signbit(value), 0U, 0, true, output);
+  }
+  if (std::isfinite(magnitude))
+  {
+    int exponent = static_cast<int>(std::floor(std::log10(magnitude)));
+    for (int attempt = 0; attempt < 3 && -4 <= exponent && 6 > exponent;
+         ++attempt)
+    {
+      ScaledDecimal scaled = 0U;
+      int const precision = 5 - exponent;
+      if (!scale_exact(magnitude, precision, scaled))
+      {
+        break;
+      }
+      else if (POWERS_OF_TEN[6] <= scaled)
+      {
+        ++exponent;
+      }
+      else if (POWERS_OF_TEN[5] > scaled)
+      {
+        --exponent;
+      }
+      else
+      {
+        return write_scaled(std::signbit(value), scaled, precision, true,
+                            output);
+      }
+    }
+  }
+#endif
+  return static_cast<size_t>(
+      snprintf(output, NMEA_NUMBER_BUFFER_LENGTH, "%g", value));
+}
+
+NmeaWriter::NmeaWriter(char *const buffer, size_t const capacity)
+    : buffer_(buffer)
+    , capacity_(capacity)
+    , length_(0U)
+    , overflowed_(false)
+{
+}
+
+void NmeaWriter::put(char const c)
+{
+  if (length_ < capacity_)
+  {
+    buffer_[length_++] = c;
+  }
+  else
+  {
+    overflowed_ = true;
+  }
+}
+
+void NmeaWriter::put(char const *const text, size_t const length)
+{
+  if (length <= capacity_ - length_)
+  {
+    memcpy(buffer_ + length_, text, length);
+    length_ += length;
+  }
+  else
+  {
+    overflowed_ = true;
+  }
+}
+
+void NmeaWriter::put_padded(char const *const text, size_t const length,
+                            size_t const width, char const fill)
+{
+  for (size_t i = length; i < width; ++i)
+  {
+    put(fill);
+  }
+  put(text, length);
+}
+
+void NmeaWriter::put_uint(uint32_t value, size_t const width, char const fill)
+{
+  char digits[10];
+  size_t count = 0U;
+  do
+  {
+    digits[sizeof(digits) - ++count] = static_cast<char>('0' + value % 10U);
+    value /= 10U;
+  } while (0U != value);
+  put_padded(digits + sizeof(digits) - count, count, width, fill);
+}
+
+void NmeaWriter::put_fixed(double const value, int const precision,
+                           size_t const width, char const fill)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  size_t const length = format_fixed(value, precision, text);
+  put_padded(text, length, width, fill);
+}
+
+void NmeaWriter::put_general(double const value)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  put(text, format_general(value, text));
+}
+
+void NmeaWriter::put_hex_byte(uint8_t const value)
+{
+  put(HEX_DIGITS[value >> 4]);
+  put(HEX_DIGITS[value & 0x0FU]);
+}
+
+void put_degrees_minutes(NmeaWriter &writer, double const angle_degrees,
+                         size_t const degree_digits)
+{
+  int64_t const nano_minutes = nmea_degrees_to_nano_minutes(angle_degrees, 8U);
+  char text[NMEA_COORDINATE_BUFFER_LENGTH];
+  size_t const length =
+      nmea_format_nano_minutes(nano_minutes, degree_digits, 8U, text);
+  writer.put(text, length);
+}
@@ -0,0 +1,55 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAFORMAT_HPP
+#define NMEALIB_NMEAFORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Bounded, allocation-free text output reproducing what the iostream
+// manipulators used by the original builders print: fill characters go in
+// front of the whole number, sign included, and a stream without
+// std::fixed prints like "%g".
+class NmeaWriter
+{
+public:
+  NmeaWriter(char *const buffer, size_t const capacity);
+
+  void put(char const c);
+  void put(char const *const text, size_t const length);
+  void put_uint(uint32_t const value, size_t const width = 0U,
+                char const fill = '0');
+  void put_fixed(double const value, int const precision,
+                 size_t const width = 0U, char const fill = '0');
+  void put_general(double const value);
+  void put_hex_byte(uint8_t const value);
+
+  // Bytes written so far, or 0 once anything failed to fit.
+  inline size_t length() const { return overflowed_ ? 0U : length_; }
+  inline bool overflowed() const { return overflowed_; }
+  inline char *data() const { return buffer_; }
+
+private:
+  void put_padded(char const *const text, size_t const length,
+                  size_t const width, char const fill);
+
+  char *buffer_;
+  size_t capacity_;
+  size_t length_;
+  bool overflowed_;
+};
+
+// The longest text format_fixed or format_general can produce, terminator
+// included: 309 integer digits for DBL_MAX, sign, point and 17 decimals.
+static size_t const NMEA_NUMBER_BUFFER_LENGTH = 336U;
+
+// Same characters as printf("%.*f") / printf("%g"); returns the length
+size_t format_fixed(double const value, int const precision,
+                    char *const output);
+size_t format_general(double const value, char *const output);
+
+// Unsigned "ddmm.mmmmmmmm", or "dddmm.mmmmmmmm" with 3 degree digits.
+void put_degrees_minutes(NmeaWriter &writer, double const angle_degrees,
+                         size_t const degree_digits);
+
+#endif // NMEALIB_NMEAFORMAT_HPP
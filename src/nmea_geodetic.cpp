@@ -0,0 +1,328 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cmath>
+#include "nmea_cpu_features.hpp"
+#include "nmea_geodetic.hpp"
+
+// First eccentricity squared.
+static double const E2 = NMEA_WGS84_F * (2.0 - NMEA_WGS84_F);
+static double const DEGREES_TO_RADIANS = 0.017453292519943295;
+// Rows whose heights are summed per pass in the GGA conversions.
+static size_t const TILE_ROWS = 256U;
+
+void nmea_geodetic_to_ecef(double const latitude_degrees,
+                           double const longitude_degrees,
+                           double const height_m, double &x, double &y,
+                           double &z)
+{
+  double const latitude = latitude_degrees * DEGREES_TO_RADIANS;
+  double const longitude = longitude_degrees * DEGREES_TO_RADIANS;
+  double const sin_latitude = std::sin(latitude);
+  double const cos_latitude = std::cos(latitude);
+  // prime vertical radius of curvature
+  double const n =
+      NMEA_WGS84_A / std::sqrt(1.0 - E2 * sin_latitude * sin_latitude);
+  x = (n + height_m) * cos_latitude * std::cos(longitude);
+  y = (n + height_m) * cos_latitude * std::sin(longitude);
+  z = (n * (1.0 - E2) + height_m) * sin_latitude;
+}
+
+NmeaLocalFrame::NmeaLocalFrame(double const latitude_degrees,
+                               double const longitude_degrees,
+                               double const height_m)
+    : originX_(0.0)
+    , originY_(0.0)
+    , originZ_(0.0)
+    , sinLatitude_(std::sin(latitude_degrees * DEGREES_TO_RADIANS))
+    , cosLatitude_(std::cos(latitude_degrees * DEGREES_TO_RADIANS))
+    , sinLongitude_(std::sin(longitude_degrees * DEGREES_TO_RADIANS))
+    , cosLongitude_(std::cos(longitude_degrees * DEGREES_TO_RADIANS))
+{
+  nmea_geodetic_to_ecef(latitude_degrees, longitude_degrees, height_m,
+                        originX_, originY_, originZ_);
+}
+
+void NmeaLocalFrame::ecef_to_enu(double const x, double const y,
+                                 double const z, double &east, double &north,
+                                 double &up) const
+{
+  double const dx = x - originX_;
+  double const dy = y - originY_;
+  double const dz = z - originZ_;
+  // the longitude's east, in the equatorial plane
+  double const radial = cosLongitude_ * dx + sinLongitude_ * dy;
+  east = cosLongitude_ * dy - sinLongitude_ * dx;
+  north = cosLatitude_ * dz - sinLatitude_ * radial;
+  up = cosLatitude_ * radial + sinLatitude_ * dz;
+}
+
+void nmea_geodetic_to_ecef_scalar(double const *const latitude_degrees,
+                                  double const *const longitude_degrees,
+                                  double const *const height_m,
+                                  size_t const count, double *const x,
+                                  double *const y, double *const z)
+{
+  for (size_t i = 0U; i < count; ++i)
+  {
+    nmea_geodetic_to_ecef(latitude_degrees[i], longitude_degrees[i],
+                          height_m[i], x[i], y[i], z[i]);
+  }
+}
+
+void nmea_geodetic_to_enu_scalar(double const *const latitude_degrees,
+                                 double const *const longitude_degrees,
+                                 double const *const height_m,
+                                 size_t const count,
+                                 NmeaLocalFrame const &frame,
+                                 double *const east, double *const north,
+                                 double *const up)
+{
+  for (size_t i = 0U; i < count; ++i)
+  {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    nmea_geodetic_to_ecef(latitude_degrees[i], longitude_degrees[i],
+                          height_m[i], x, y, z);
+    frame.ecef_to_enu(x, y, z, east[i], north[i], up[i]);
+  }
+}
+
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+// sin and cos of four angles of at most a few turns. The angle is reduced
+// by the nearest multiple of pi/2, split in two so the product is exact,
+// and the remainder of at most pi/4 goes through the Cephes minimax
+// polynomials, which are good to an ulp there.
+__attribute__((target("avx2,fma"))) static inline void
+sincos_avx2(__m256d const angle, __m256d &sine, __m256d &cosine)
+{
+  __m256d const quadrant = _mm256_round_pd(
+      _mm256_mul_pd(angle, _mm256_set1_pd(0.63661977236758134308)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256d const r = _mm256_fnmadd_pd(
+      quadrant, _mm256_set1_pd(6.07710050650619224932e-11),
+      _mm256_fnmadd_pd(quadrant, _mm256_set1_pd(1.57079632673412561417e+00),
+                       angle));
+  __m256d const z = _mm256_mul_pd(r, r);
+
+  __m256d s = _mm256_set1_pd(1.58962301576546568060e-10);
+  s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(-2.50507477628578072866e-8));
+  s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(2.75573136213857245213e-6));
+  s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(-1.98412698295895385996e-4));
+  s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(8.33333333332211858878e-3));
+  s = _mm256_fmadd_pd(s, z, _mm256_set1_pd(-1.66666666666666307295e-1));
+  s = _mm256_fmadd_pd(_mm256_mul_pd(r, z), s, r);
+
+  __m256d c = _mm256_set1_pd(-1.13585365213876817300e-11);
+  c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(2.08757008419747316778e-9));
+  c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(-2.75573141792967388112e-7));
+  c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(2.48015872888517045348e-5));
+  c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(-1.38888888888730564116e-3));
+  c = _mm256_fmadd_pd(c, z, _mm256_set1_pd(4.16666666666665929218e-2));
+  c = _mm256_fmadd_pd(_mm256_mul_pd(z, z), c,
+                      _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z,
+                                       _mm256_set1_pd(1.0)));
+
+  // Odd quadrants swap sine and cosine; quadrants 2 and 3 negate the sine,
+  // 1 and 2 the cosine.
+  __m256i const q = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(quadrant));
+  __m256i const zero = _mm256_setzero_si256();
+  __m256d const swap = _mm256_castsi256_pd(_mm256_cmpgt_epi64(
+      _mm256_and_si256(q, _mm256_set1_epi64x(1)), zero));
+  __m256d const sign = _mm256_set1_pd(-0.0);
+  __m256d const negate_sine = _mm256_and_pd(
+      sign, _mm256_castsi256_pd(_mm256_cmpgt_epi64(
+                _mm256_and_si256(q, _mm256_set1_epi64x(2)), zero)));
+  __m256d const negate_cosine = _mm256_and_pd(
+      sign,
+      _mm256_castsi256_pd(_mm256_cmpgt_epi64(
+          _mm256_and_si256(_mm256_add_epi64(q, _mm256_set1_epi64x(1)),
+                           _mm256_set1_epi64x(2)),
+          zero)));
+  sine = _mm256_xor_pd(_mm256_blendv_pd(s, c, swap), negate_sine);
+  cosine = _mm256_xor_pd(_mm256_blendv_pd(c, s, swap), negate_cosine);
+}
+
+__attribute__((target("avx2,fma"))) static inline void
+ecef_avx2(double const *const latitude_degrees,
+          double const *const longitude_degrees, double const *const height_m,
+          __m256d &x, __m256d &y, __m256d &z)
+{
+  __m256d const to_radians = _mm256_set1_pd(DEGREES_TO_RADIANS);
+  __m256d sin_latitude;
+  __m256d cos_latitude;
+  __m256d sin_longitude;
+  __m256d cos_longitude;
+  sincos_avx2(_mm256_mul_pd(_mm256_loadu_pd(latitude_degrees), to_radians),
+              sin_latitude, cos_latitude);
+  sincos_avx2(_mm256_mul_pd(_mm256_loadu_pd(longitude_degrees), to_radians),
+              sin_longitude, cos_longitude);
+  __m256d const height = _mm256_loadu_pd(height_m);
+  __m256d const n = _mm256_div_pd(
+      _mm256_set1_pd(NMEA_WGS84_A),
+      _mm256_sqrt_pd(_mm256_fnmadd_pd(
+          _mm256_mul_pd(_mm256_set1_pd(E2), sin_latitude), sin_latitude,
+          _mm256_set1_pd(1.0))));
+  __m256d const equatorial =
+      _mm256_mul_pd(_mm256_add_pd(n, height), cos_latitude);
+  x = _mm256_mul_pd(equatorial, cos_longitude);
+  y = _mm256_mul_pd(equatorial, sin_longitude);
+  z = _mm256_mul_pd(
+      _mm256_fmadd_pd(n, _mm256_set1_pd(1.0 - E2), height), sin_latitude);
+}
+
+__attribute__((target("avx2,fma"))) static void
+geodetic_to_ecef_avx2(double const *const latitude_degrees,
+                      double const *const longitude_degrees,
+                      double const *const height_m, size_t const count,
+                      double *const x, double *const y, double *const z)
+{
+  size_t i = 0U;
+  for (; i + 4U <= count; i += 4U)
+  {
+    __m256d ecef_x;
+    __m256d ecef_y;
+    __m256d ecef_z;
+    ecef_avx2(latitude_degrees + i, longitude_degrees + i, height_m + i,
+              ecef_x, ecef_y, ecef_z);
+    _mm256_storeu_pd(x + i, ecef_x);
+    _mm256_storeu_pd(y + i, ecef_y);
+    _mm256_storeu_pd(z + i, ecef_z);
+  }
+  _mm256_zeroupper();
+  nmea_geodetic_to_ecef_scalar(latitude_degrees + i, longitude_degrees + i,
+                               height_m + i, count - i, x + i, y + i, z + i);
+}
+
+__attribute__((target("avx2,fma"))) static void
+geodetic_to_enu_avx2(double const *const latitude_degrees,
+                     double const *const longitude_degrees,
+                     double const *const height_m, size_t const count,
+                     NmeaLocalFrame const &frame, double *const east,
+                     double *const north, double *const up)
+{
+  __m256d const origin_x = _mm256_set1_pd(frame.originX());
+  __m256d const origin_y = _mm256_set1_pd(frame.originY());
+  __m256d const origin_z = _mm256_set1_pd(frame.originZ());
+  __m256d const sin_latitude = _mm256_set1_pd(frame.sinLatitude());
+  __m256d const cos_latitude = _mm256_set1_pd(frame.cosLatitude());
+  __m256d const sin_longitude = _mm256_set1_pd(frame.sinLongitude());
+  __m256d const cos_longitude = _mm256_set1_pd(frame.cosLongitude());
+  size_t i = 0U;
+  for (; i + 4U <= count; i += 4U)
+  {
+    __m256d x;
+    __m256d y;
+    __m256d z;
+    ecef_avx2(latitude_degrees + i, longitude_degrees + i, height_m + i, x,
+              y, z);
+    __m256d const dx = _mm256_sub_pd(x, origin_x);
+    __m256d const dy = _mm256_sub_pd(y, origin_y);
+    __m256d const dz = _mm256_sub_pd(z, origin_z);
+    __m256d const radial = _mm256_fmadd_pd(
+        cos_longitude, dx, _mm256_mul_pd(sin_longitude, dy));
+    _mm256_storeu_pd(east + i,
+                     _mm256_fmsub_pd(cos_longitude, dy,
+                                     _mm256_mul_pd(sin_longitude, dx)));
+    _mm256_storeu_pd(north + i,
+                     _mm256_fmsub_pd(cos_latitude, dz,
+                                     _mm256_mul_pd(sin_latitude, radial)));
+    _mm256_storeu_pd(up + i,
+                     _mm256_fmadd_pd(cos_latitude, radial,
+                                     _mm256_mul_pd(sin_latitude, dz)));
+  }
+  _mm256_zeroupper();
+  nmea_geodetic_to_enu_scalar(latitude_degrees + i, longitude_degrees + i,
+                              height_m + i, count - i, frame, east + i,
+                              north + i, up + i);
+}
+#endif
+
+void nmea_geodetic_to_ecef(double const *const latitude_degrees,
+                           double const *const longitude_degrees,
+                           double const *const height_m, size_t const count,
+                           double *const x, double *const y, double *const z)
+{
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+  bool const use_avx2 = nmea_cpu_has_avx2_fma();
+  if (use_avx2)
+  {
+    geodetic_to_ecef_avx2(latitude_degrees, longitude_degrees, height_m,
+                          count, x, y, z);
+  }
+  else
+#endif
+  {
+    nmea_geodetic_to_ecef_scalar(latitude_degrees, longitude_degrees,
+                                 height_m, count, x, y, z);
+  }
+}
+
+void nmea_geodetic_to_enu(double const *const latitude_degrees,
+                          double const *const longitude_degrees,
+                          double const *const height_m, size_t const count,
+                          NmeaLocalFrame const &frame, double *const east,
+                          double *const north, double *const up)
+{
+#if defined(NMEALIB_HAVE_AVX2_TARGET)
+  bool const use_avx2 = nmea_cpu_has_avx2_fma();
+  if (use_avx2)
+  {
+    geodetic_to_enu_avx2(latitude_degrees, longitude_degrees, height_m,
+                         count, frame, east, north, up);
+  }
+  else
+#endif
+  {
+    nmea_geodetic_to_enu_scalar(latitude_degrees, longitude_degrees,
+                                height_m, count, frame, east, north, up);
+  }
+}
+
+void NmeaCartesianColumns::resize(size_t const rows)
+{
+  x.resize(rows);
+  y.resize(rows);
+  z.resize(rows);
+}
+
+// Ellipsoidal heights of rows [first, first + rows) of the fixes.
+static void fill_heights(GgaColumns const &fixes, size_t const first,
+                         size_t const rows, double *const heights)
+{
+  for (size_t i = 0U; i < rows; ++i)
+  {
+    heights[i] = fixes.altitude[first + i] + fixes.geoidHeight[first + i];
+  }
+}
+
+void nmea_gga_to_ecef(GgaColumns const &fixes, NmeaCartesianColumns &output)
+{
+  output.resize(fixes.size());
+  double heights[TILE_ROWS];
+  for (size_t first = 0U; first < fixes.size(); first += TILE_ROWS)
+  {
+    size_t const rows =
+        TILE_ROWS < fixes.size() - first ? TILE_ROWS : fixes.size() - first;
+    fill_heights(fixes, first, rows, heights);
+    nmea_geodetic_to_ecef(&fixes.latitude[first], &fixes.longitude[first],
+                          heights, rows, &output.x[first], &output.y[first],
+                          &output.z[first]);
+  }
+}
+
+void nmea_gga_to_enu(GgaColumns const &fixes, NmeaLocalFrame const &frame,
+                     NmeaCartesianColumns &output)
+{
+  output.resize(fixes.size());
+  double heights[TILE_ROWS];
+  for (size_t first = 0U; first < fixes.size(); first += TILE_ROWS)
+  {
+    size_t const rows =
+        TILE_ROWS < fixes.size() - first ? TILE_ROWS : fixes.size() - first;
+    fill_heights(fixes, first, rows, heights);
+    nmea_geodetic_to_enu(&fixes.latitude[first], &fixes.longitude[first],
+                         heights, rows, frame, &output.x[first],
+                         &output.y[first], &output.z[first]);
+  }
+}
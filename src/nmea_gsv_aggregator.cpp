@@ -0,0 +1,127 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_gsv_aggregator.hpp"
+
+NmeaGsvAggregator::NmeaGsvAggregator() { reset(); }
+
+void NmeaGsvAggregator::reset()
+{
+  for (size_t i = 0U; i < NMEA_GSV_MAX_GROUPS; ++i)
+  {
+    slots_[i].used = false;
+    slots_[i].totalMessages = 0U;
+    slots_[i].nextMessage = 0U;
+    slots_[i].lastUsed = 0U;
+  }
+  uses_ = 0U;
+  groups_ = 0U;
+  dropped_ = 0U;
+}
+
+NmeaGsvAggregator::Slot *
+NmeaGsvAggregator::find_slot(GsvMessageData const &message)
+{
+  bool const signal_id_valid = message.signalIdValid;
+  uint8_t const signal_id = signal_id_valid ? message.signalId : 0U;
+  Slot *found = nullptr;
+  Slot *unused = nullptr;
+  Slot *oldest = nullptr;
+  for (size_t i = 0U; nullptr == found && i < NMEA_GSV_MAX_GROUPS; ++i)
+  {
+    Slot &slot = slots_[i];
+    GsvSatelliteGroup const &group = slot.group;
+    if (slot.used && message.talker[0] == group.talker[0] &&
+        message.talker[1] == group.talker[1] &&
+        signal_id_valid == group.signalIdValid && signal_id == group.signalId)
+    {
+      found = &slot;
+    }
+    else if (!slot.used)
+    {
+      unused = nullptr == unused ? &slot : unused;
+    }
+    // Idle groups go first, then the least recently used one in progress.
+    else if (nullptr == oldest ||
+             (0U == slot.nextMessage && 0U != oldest->nextMessage) ||
+             ((0U == slot.nextMessage) == (0U == oldest->nextMessage) &&
+              slot.lastUsed < oldest->lastUsed))
+    {
+      oldest = &slot;
+    }
+  }
+  // Only the first sentence of a group can start one in a new slot.
+  if (nullptr == found && 1U == message.messageNumber)
+  {
+    if (nullptr == unused)
+    {
+      abandon(*oldest);
+      unused = oldest;
+    }
+    found = unused;
+    found->used = true;
+    found->group.talker[0] = message.talker[0];
+    found->group.talker[1] = message.talker[1];
+    found->group.signalIdValid = signal_id_valid;
+    found->group.signalId = signal_id;
+  }
+  if (nullptr != found)
+  {
+    found->lastUsed = uses_++;
+  }
+  return found;
+}
+
+void NmeaGsvAggregator::abandon(Slot &slot)
+{
+  if (0U != slot.nextMessage)
+  {
+    dropped_ += slot.nextMessage - 1U;
+  }
+  slot.nextMessage = 0U;
+}
+
+GsvSatelliteGroup const *NmeaGsvAggregator::add(GsvMessageData const &message)
+{
+  GsvSatelliteGroup const *complete = nullptr;
+  Slot *const slot = message.valid ? find_slot(message) : nullptr;
+  if (nullptr != slot && 1U == message.messageNumber)
+  {
+    abandon(*slot);
+    slot->totalMessages = message.totalMessages;
+    slot->nextMessage = 1U;
+    slot->group.numSatellites = 0U;
+  }
+  if (nullptr == slot || 0U == slot->nextMessage ||
+      message.messageNumber != slot->nextMessage ||
+      message.totalMessages != slot->totalMessages)
+  {
+    if (nullptr != slot)
+    {
+      abandon(*slot);
+    }
+    ++dropped_;
+  }
+  else
+  {
+    GsvSatelliteGroup &group = slot->group;
+    group.satellitesInView = message.satellitesInView;
+    for (size_t i = 0U; i < message.numSatellites &&
+                        NMEA_GSV_SATELLITES_PER_SENTENCE > i &&
+                        NMEA_GSV_MAX_SATELLITES > group.numSatellites;
+         ++i)
+    {
+      group.satellites[group.numSatellites++] = message.satellites[i];
+    }
+    if (message.messageNumber == message.totalMessages)
+    {
+      slot->nextMessage = 0U;
+      ++groups_;
+      complete = &group;
+    }
+    else
+    {
+      ++slot->nextMessage;
+    }
+  }
+  return complete;
+}
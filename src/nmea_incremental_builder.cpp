@@ -0,0 +1,267 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cstring>
+#include "nmea_checksum.hpp"
+#include "nmea_incremental_builder.hpp"
+#include "nmea_sentences.hpp"
+
+static char const HEX_DIGITS[] = "0123456789ABCDEF";
+// "*hh\n" after the last field.
+static size_t const TRAILER_LENGTH = 4U;
+static size_t const GGA_HEADER_LENGTH = 7U;
+static size_t const VTG_HEADER_LENGTH = 7U;
+// More wire fields than GGA or VTG have.
+static size_t const MAX_FIELDS = 16U;
+
+enum GgaSpan
+{
+  GGA_TIME,
+  GGA_LATITUDE,
+  GGA_LONGITUDE,
+  GGA_FIX,
+  GGA_SATELLITES,
+  GGA_HDOP,
+  GGA_ALTITUDE,
+  GGA_GEOID_HEIGHT,
+  GGA_SPAN_COUNT
+};
+
+enum VtgSpan
+{
+  VTG_TRACK,
+  VTG_KNOTS,
+  VTG_KPH,
+  VTG_SPAN_COUNT
+};
+
+// Wire fields of each span, in the order of the enums above.
+static NmeaIncrementalSentence::Span const GGA_SPANS[GGA_SPAN_COUNT] = {
+    {0U, 0U}, {1U, 2U}, {3U, 4U}, {5U, 5U},
+    {6U, 6U}, {7U, 7U}, {8U, 8U}, {10U, 10U}};
+static NmeaIncrementalSentence::Span const VTG_SPANS[VTG_SPAN_COUNT] = {
+    {0U, 0U}, {4U, 4U}, {6U, 6U}};
+
+// Bit for bit, so -0.0 and 0.0, which print differently, are not equal.
+static bool same(double const a, double const b)
+{
+  return 0 == std::memcmp(&a, &b, sizeof(a));
+}
+
+// Room for any one field the spans cover.
+static size_t const FIELD_BUFFER_LENGTH = NMEA_NUMBER_BUFFER_LENGTH;
+
+NmeaIncrementalSentence::NmeaIncrementalSentence()
+    : length_(0U)
+    , checksum_(0U)
+    , fullBuilds_(0U)
+    , patchedFields_(0U)
+{
+}
+
+void NmeaIncrementalSentence::reset() { length_ = 0U; }
+
+void NmeaIncrementalSentence::adopt(size_t const length,
+                                    size_t const header_length,
+                                    Span const *const spans,
+                                    size_t const count)
+{
+  ++fullBuilds_;
+  length_ = 0U;
+  if (header_length + TRAILER_LENGTH <= length && count <= MAX_SPANS &&
+      spans[count - 1U].last < MAX_FIELDS)
+  {
+    // Start of every wire field up to the one after the last span.
+    size_t const fields = spans[count - 1U].last + 2U;
+    size_t starts[MAX_FIELDS + 1U];
+    size_t found = 1U;
+    starts[0] = header_length;
+    size_t const end = length - TRAILER_LENGTH;
+    for (size_t i = header_length; i < end && found < fields; ++i)
+    {
+      if (',' == sentence_[i])
+      {
+        starts[found] = i + 1U;
+        ++found;
+      }
+    }
+    if (found < fields)
+    {
+      // The span ends with the last field.
+      starts[found] = end + 1U;
+      ++found;
+    }
+    if (found == fields)
+    {
+      for (size_t i = 0U; i < count; ++i)
+      {
+        offsets_[i] = static_cast<uint16_t>(starts[spans[i].first]);
+        widths_[i] = static_cast<uint16_t>(starts[spans[i].last + 1U] - 1U -
+                                           starts[spans[i].first]);
+      }
+      checksum_ = nmea_checksum(sentence_ + 1, end - 1U);
+      length_ = length;
+    }
+  }
+}
+
+bool NmeaIncrementalSentence::patch(size_t const span, char const *const text,
+                                    size_t const length)
+{
+  bool const fits = widths_[span] == length;
+  if (fits)
+  {
+    char *const field = sentence_ + offsets_[span];
+    uint8_t delta = 0U;
+    for (size_t i = 0U; i < length; ++i)
+    {
+      delta ^= static_cast<uint8_t>(field[i] ^ text[i]);
+      field[i] = text[i];
+    }
+    checksum_ ^= delta;
+    ++patchedFields_;
+  }
+  return fits;
+}
+
+template <typename Field, typename Message>
+bool NmeaIncrementalSentence::patch_field(size_t const span,
+                                          Message const &message)
+{
+  char text[FIELD_BUFFER_LENGTH];
+  NmeaWriter writer(text, sizeof(text));
+  Field::build(writer, message);
+  return patch(span, text, writer.length());
+}
+
+void NmeaIncrementalSentence::seal()
+{
+  sentence_[length_ - 3U] = HEX_DIGITS[checksum_ >> 4U];
+  sentence_[length_ - 2U] = HEX_DIGITS[checksum_ & 0x0FU];
+}
+
+GgaIncrementalBuilder::GgaIncrementalBuilder()
+    : utcHour_(0U)
+    , utcMinute_(0U)
+    , utcSeconds_(0.0)
+    , latitude_(0.0)
+    , longitude_(0.0)
+    , fixQuality_(GGA_INVALID)
+    , numSatellites_(0U)
+    , hdop_(0.0)
+    , altitude_(0.0)
+    , geoidHeight_(0.0)
+{
+}
+
+size_t GgaIncrementalBuilder::build(
+    uint8_t const utc_hour, uint8_t const utc_minute, double const utc_seconds,
+    double const latitude_degrees, double const longitude_degrees,
+    GgaFixQuality const fix_quality, uint16_t const num_satellites,
+    double const hdop, double const altitude_m, double const geoid_height)
+{
+  GgaMessageData const message(0.0, latitude_degrees, longitude_degrees,
+                               fix_quality, num_satellites, hdop, altitude_m,
+                               geoid_height);
+  bool rebuild = 0U == length_;
+  if (!rebuild && (utc_hour != utcHour_ || utc_minute != utcMinute_ ||
+                   !same(utc_seconds, utcSeconds_)))
+  {
+    // As build_gga prints it.
+    char text[FIELD_BUFFER_LENGTH];
+    NmeaWriter writer(text, sizeof(text));
+    writer.put_uint(utc_hour, 2U);
+    writer.put_uint(utc_minute, 2U);
+    writer.put_fixed(utc_seconds, 2, 5U);
+    rebuild = !patch(GGA_TIME, text, writer.length());
+  }
+  if (!rebuild && !same(latitude_degrees, latitude_))
+  {
+    rebuild = !patch_field<GgaLatitudeField>(GGA_LATITUDE, message);
+  }
+  if (!rebuild && !same(longitude_degrees, longitude_))
+  {
+    rebuild = !patch_field<GgaLongitudeField>(GGA_LONGITUDE, message);
+  }
+  if (!rebuild && fix_quality != fixQuality_)
+  {
+    rebuild = !patch_field<GgaFixQualityField>(GGA_FIX, message);
+  }
+  if (!rebuild && num_satellites != numSatellites_)
+  {
+    rebuild = !patch_field<GgaSatellitesField>(GGA_SATELLITES, message);
+  }
+  if (!rebuild && !same(hdop, hdop_))
+  {
+    rebuild = !patch_field<GgaHdopField>(GGA_HDOP, message);
+  }
+  if (!rebuild && !same(altitude_m, altitude_))
+  {
+    rebuild = !patch_field<GgaAltitudeField>(GGA_ALTITUDE, message);
+  }
+  if (!rebuild && !same(geoid_height, geoidHeight_))
+  {
+    rebuild = !patch_field<GgaGeoidHeightField>(GGA_GEOID_HEIGHT, message);
+  }
+  if (rebuild)
+  {
+    size_t const length =
+        build_gga(sentence_, sizeof(sentence_), utc_hour, utc_minute,
+                  utc_seconds, latitude_degrees, longitude_degrees,
+                  fix_quality, num_satellites, hdop, altitude_m, geoid_height);
+    adopt(length, GGA_HEADER_LENGTH, GGA_SPANS, GGA_SPAN_COUNT);
+  }
+  else
+  {
+    seal();
+  }
+  utcHour_ = utc_hour;
+  utcMinute_ = utc_minute;
+  utcSeconds_ = utc_seconds;
+  latitude_ = latitude_degrees;
+  longitude_ = longitude_degrees;
+  fixQuality_ = fix_quality;
+  numSatellites_ = num_satellites;
+  hdop_ = hdop;
+  altitude_ = altitude_m;
+  geoidHeight_ = geoid_height;
+  return length_;
+}
+
+VtgIncrementalBuilder::VtgIncrementalBuilder()
+    : trueTrack_(0.0)
+    , groundVelocity_(0.0)
+{
+}
+
+size_t VtgIncrementalBuilder::build(
+    double const true_track_made_good_ned_degrees,
+    double const ground_velocity_mps)
+{
+  VtgMessageData const message(true_track_made_good_ned_degrees, false, 0.0,
+                               ground_velocity_mps * MPS_TO_KNOTS,
+                               ground_velocity_mps * MPS_TO_KPH);
+  bool rebuild = 0U == length_;
+  if (!rebuild && !same(true_track_made_good_ned_degrees, trueTrack_))
+  {
+    rebuild = !patch_field<VtgTrackField>(VTG_TRACK, message);
+  }
+  if (!rebuild && !same(ground_velocity_mps, groundVelocity_))
+  {
+    rebuild = !patch_field<VtgKnotsField>(VTG_KNOTS, message) ||
+              !patch_field<VtgKphField>(VTG_KPH, message);
+  }
+  if (rebuild)
+  {
+    size_t const length = build_vtg(sentence_, sizeof(sentence_),
+                                    true_track_made_good_ned_degrees,
+                                    ground_velocity_mps);
+    adopt(length, VTG_HEADER_LENGTH, VTG_SPANS, VTG_SPAN_COUNT);
+  }
+  else
+  {
+    seal();
+  }
+  trueTrack_ = true_track_made_good_ned_degrees;
+  groundVelocity_ = ground_velocity_mps;
+  return length_;
+}
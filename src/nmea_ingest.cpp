@@ -0,0 +1,284 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#include "nmea_ingest.hpp"
+#include "nmea_pipeline.hpp"
+
+using std::string;
+
+static size_t const MAX_EVENTS = 64U;
+// epoll data for the wake descriptor; sources use their index.
+static uint64_t const WAKE_TOKEN = UINT64_MAX;
+
+static bool set_non_blocking(int const fd)
+{
+  int const flags = fcntl(fd, F_GETFL);
+  return 0 <= flags && 0 == fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static bool baud_to_speed(uint32_t const baud, speed_t &speed)
+{
+  static uint32_t const RATES[] = {1200U,  2400U,  4800U,   9600U,
+                                   19200U, 38400U, 57600U,  115200U,
+                                   230400U};
+  static speed_t const SPEEDS[] = {B1200,  B2400,  B4800,   B9600,
+                                   B19200, B38400, B57600,  B115200,
+                                   B230400};
+  bool found = false;
+  for (size_t i = 0U; !found && i < sizeof(RATES) / sizeof(RATES[0]); ++i)
+  {
+    found = baud == RATES[i];
+    speed = SPEEDS[i];
+  }
+  return found;
+}
+
+NmeaIngestEngine::Source::Source()
+    : fd(-1)
+    , callback()
+    , framer()
+    , stats()
+{
+}
+
+NmeaIngestEngine::NmeaIngestEngine(NmeaChecksumMode const checksum_mode,
+                                   size_t const read_bytes)
+    : checksumMode_(checksum_mode)
+    , epollFd_(epoll_create1(EPOLL_CLOEXEC))
+    , wakeFd_(eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC))
+    , sources_()
+    , openSources_(0U)
+    , readBuffer_(0U == read_bytes ? 1U : read_bytes)
+    , event_()
+    , stopping_(false)
+{
+  epoll_event wake;
+  memset(&wake, 0, sizeof(wake));
+  wake.events = EPOLLIN;
+  wake.data.u64 = WAKE_TOKEN;
+  if (0 > wakeFd_ || 0 > epollFd_ ||
+      0 != epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &wake))
+  {
+    if (0 <= epollFd_)
+    {
+      ::close(epollFd_);
+    }
+    epollFd_ = -1;
+  }
+}
+
+NmeaIngestEngine::~NmeaIngestEngine()
+{
+  for (size_t i = 0U; i < sources_.size(); ++i)
+  {
+    remove(i);
+  }
+  if (0 <= wakeFd_)
+  {
+    ::close(wakeFd_);
+  }
+  if (0 <= epollFd_)
+  {
+    ::close(epollFd_);
+  }
+}
+
+bool NmeaIngestEngine::add_fd(int const fd, NmeaIngestCallback const &callback,
+                              size_t &source)
+{
+  epoll_event readable;
+  memset(&readable, 0, sizeof(readable));
+  readable.events = EPOLLIN;
+  readable.data.u64 = sources_.size();
+  bool const added =
+      valid() && 0 <= fd && set_non_blocking(fd) &&
+      0 == epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &readable);
+  if (added)
+  {
+    source = sources_.size();
+    sources_.push_back(Source());
+    sources_.back().fd = fd;
+    sources_.back().callback = callback;
+    ++openSources_;
+  }
+  else if (0 <= fd)
+  {
+    ::close(fd);
+  }
+  return added;
+}
+
+bool NmeaIngestEngine::open_serial(string const &device, uint32_t const baud,
+                                   NmeaIngestCallback const &callback,
+                                   size_t &source)
+{
+  speed_t speed = B0;
+  int fd = baud_to_speed(baud, speed)
+               ? ::open(device.c_str(),
+                        O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)
+               : -1;
+  termios settings;
+  if (0 <= fd)
+  {
+    bool const configured = 0 == tcgetattr(fd, &settings);
+    if (configured)
+    {
+      cfmakeraw(&settings);
+      settings.c_cflag |= CLOCAL | CREAD;
+      settings.c_cflag &= ~static_cast<tcflag_t>(CSTOPB | PARENB);
+      cfsetispeed(&settings, speed);
+      cfsetospeed(&settings, speed);
+    }
+    if (!configured || 0 != tcsetattr(fd, TCSANOW, &settings))
+    {
+      ::close(fd);
+      fd = -1;
+    }
+  }
+  return 0 <= fd && add_fd(fd, callback, source);
+}
+
+bool NmeaIngestEngine::connect_tcp(string const &host, uint16_t const port,
+                                   NmeaIngestCallback const &callback,
+                                   size_t &source)
+{
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  char service[8];
+  snprintf(service, sizeof(service), "%u", static_cast<unsigned>(port));
+  addrinfo *addresses = nullptr;
+  int fd = -1;
+  if (0 == getaddrinfo(host.c_str(), service, &hints, &addresses))
+  {
+    for (addrinfo *address = addresses; 0 > fd && nullptr != address;
+         address = address->ai_next)
+    {
+      fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC,
+                  address->ai_protocol);
+      if (0 <= fd && 0 != connect(fd, address->ai_addr, address->ai_addrlen))
+      {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+    freeaddrinfo(addresses);
+  }
+  return 0 <= fd && add_fd(fd, callback, source);
+}
+
+bool NmeaIngestEngine::remove(size_t const source)
+{
+  bool const open = is_open(source);
+  if (open)
+  {
+    Source &closing = sources_[source];
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, closing.fd, nullptr);
+    ::close(closing.fd);
+    closing.fd = -1;
+    --openSources_;
+  }
+  return open;
+}
+
+size_t NmeaIngestEngine::read_source(size_t const source)
+{
+  Source &input = sources_[source];
+  ssize_t const count =
+      ::read(input.fd, readBuffer_.data(), readBuffer_.size());
+  size_t delivered = 0U;
+  if (0 < count)
+  {
+    ++input.stats.reads;
+    input.stats.bytes += static_cast<uint64_t>(count);
+    event_.source = source;
+    event_.arrivalNs = nmea_pipeline_now_ns();
+    input.framer.push(readBuffer_.data(), static_cast<size_t>(count));
+    // The callback may remove this source, which also ends its sentences.
+    while (0 <= input.fd && input.framer.next(event_.sentence))
+    {
+      event_.message = parse_nmea(event_.sentence.data, event_.sentence.length,
+                                  event_.error, checksumMode_);
+      ++input.stats.sentences;
+      if (NMEA_PARSE_OK != event_.error.code)
+      {
+        ++input.stats.parseErrors;
+      }
+      input.callback(event_);
+      ++delivered;
+    }
+  }
+  else if (0 == count || (EAGAIN != errno && EINTR != errno))
+  {
+    // End of stream, or a pty whose other side has closed (EIO).
+    remove(source);
+  }
+  return delivered;
+}
+
+size_t NmeaIngestEngine::poll(int const timeout_ms)
+{
+  epoll_event events[MAX_EVENTS];
+  int const ready =
+      valid() ? epoll_wait(epollFd_, events, MAX_EVENTS, timeout_ms) : 0;
+  size_t delivered = 0U;
+  for (int i = 0; i < ready; ++i)
+  {
+    uint64_t const token = events[i].data.u64;
+    if (WAKE_TOKEN == token)
+    {
+      uint64_t wakes = 0U;
+      ssize_t const drained = ::read(wakeFd_, &wakes, sizeof(wakes));
+      static_cast<void>(drained);
+    }
+    // Skip sources an earlier callback in this batch removed.
+    else if (is_open(static_cast<size_t>(token)))
+    {
+      delivered += read_source(static_cast<size_t>(token));
+    }
+  }
+  return delivered;
+}
+
+void NmeaIngestEngine::run()
+{
+  while (valid() && 0U != openSources_ && !stopping_.load())
+  {
+    poll(-1);
+  }
+  stopping_ = false;
+}
+
+void NmeaIngestEngine::stop()
+{
+  stopping_ = true;
+  uint64_t const wake = 1U;
+  ssize_t const written = ::write(wakeFd_, &wake, sizeof(wake));
+  static_cast<void>(written);
+}
+
+bool NmeaIngestEngine::is_open(size_t const source) const
+{
+  return source < sources_.size() && 0 <= sources_[source].fd;
+}
+
+NmeaIngestSourceStats const &
+NmeaIngestEngine::stats(size_t const source) const
+{
+  return sources_[source].stats;
+}
+
+NmeaStreamFramer const &NmeaIngestEngine::framer(size_t const source) const
+{
+  return sources_[source].framer;
+}
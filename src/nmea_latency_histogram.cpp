@@ -0,0 +1,107 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_latency_histogram.hpp"
+
+NmeaLatencyHistogram::NmeaLatencyHistogram() { reset(); }
+
+// Values below SUB_BUCKETS get a bucket each; above that, group g >= 1
+// covers [2^(g+2), 2^(g+3)) in SUB_BUCKETS equal steps.
+size_t NmeaLatencyHistogram::bucket_index(uint64_t const nanoseconds)
+{
+  size_t index = static_cast<size_t>(nanoseconds);
+  if (SUB_BUCKETS <= nanoseconds)
+  {
+    size_t const exponent =
+        63U - static_cast<size_t>(__builtin_clzll(nanoseconds));
+    size_t const shift = exponent - SUB_BUCKET_BITS;
+    size_t const sub_bucket =
+        static_cast<size_t>(nanoseconds >> shift) & (SUB_BUCKETS - 1U);
+    index = (shift + 1U) * SUB_BUCKETS + sub_bucket;
+  }
+  return index < BUCKETS ? index : BUCKETS - 1U;
+}
+
+uint64_t NmeaLatencyHistogram::bucket_upper_bound(size_t const index)
+{
+  uint64_t bound = index;
+  if (SUB_BUCKETS <= index)
+  {
+    size_t const shift = index / SUB_BUCKETS - 1U;
+    uint64_t const sub_bucket = index % SUB_BUCKETS;
+    bound = ((SUB_BUCKETS + sub_bucket + 1U) << shift) - 1U;
+  }
+  return bound;
+}
+
+void NmeaLatencyHistogram::record(uint64_t const nanoseconds)
+{
+  ++buckets_[bucket_index(nanoseconds)];
+  ++count_;
+  min_ = nanoseconds < min_ ? nanoseconds : min_;
+  max_ = nanoseconds > max_ ? nanoseconds : max_;
+  sum_ += static_cast<double>(nanoseconds);
+}
+
+void NmeaLatencyHistogram::record(uint64_t const nanoseconds,
+                                  uint64_t const samples)
+{
+  if (0U != samples)
+  {
+    buckets_[bucket_index(nanoseconds)] += samples;
+    count_ += samples;
+    min_ = nanoseconds < min_ ? nanoseconds : min_;
+    max_ = nanoseconds > max_ ? nanoseconds : max_;
+    sum_ += static_cast<double>(nanoseconds) * static_cast<double>(samples);
+  }
+}
+
+void NmeaLatencyHistogram::merge(NmeaLatencyHistogram const &other)
+{
+  for (size_t i = 0U; i < BUCKETS; ++i)
+  {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  min_ = other.min_ < min_ ? other.min_ : min_;
+  max_ = other.max_ > max_ ? other.max_ : max_;
+  sum_ += other.sum_;
+}
+
+void NmeaLatencyHistogram::reset()
+{
+  for (size_t i = 0U; i < BUCKETS; ++i)
+  {
+    buckets_[i] = 0U;
+  }
+  count_ = 0U;
+  min_ = UINT64_MAX;
+  max_ = 0U;
+  sum_ = 0.0;
+}
+
+double NmeaLatencyHistogram::mean() const
+{
+  return 0U == count_ ? 0.0 : sum_ / static_cast<double>(count_);
+}
+
+uint64_t NmeaLatencyHistogram::percentile(double const fraction) const
+{
+  uint64_t value = 0U;
+  if (0U != count_)
+  {
+    double const clamped =
+        fraction < 0.0 ? 0.0 : (fraction > 1.0 ? 1.0 : fraction);
+    uint64_t const rank = static_cast<uint64_t>(
+        clamped * static_cast<double>(count_ - 1U)) + 1U;
+    uint64_t seen = 0U;
+    size_t index = 0U;
+    while (seen + buckets_[index] < rank)
+    {
+      seen += buckets_[index];
+      ++index;
+    }
+    uint64_t const bound = bucket_upper_bound(index);
+    value = bound < max_ ? bound : max_;
+  }
+  return value;
+}
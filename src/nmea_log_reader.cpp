@@ -0,0 +1,259 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "nmea_fields.hpp"
+#include "nmea_log_reader.hpp"
+#include "nmea_mapped_file.hpp"
+#include "nmea_utc_resolver.hpp"
+
+using std::string;
+using std::vector;
+
+static char const INDEX_MAGIC[8] = {'N', 'M', 'E', 'A', 'I', 'D', 'X', '1'};
+// 2: RMC, GST, ZDA and GNS carry times and types.
+// 3: fields that are not a time of day, e.g. 126000, are stored as no time.
+static uint32_t const INDEX_VERSION = 3U;
+static char const INDEX_SUFFIX[] = ".idx";
+
+struct NmeaLogIndexHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t entrySize;
+  uint64_t logLength;
+  int64_t logModified;
+  uint64_t count;
+};
+
+static uint32_t sentence_time_ms(char const *const sentence,
+                                 size_t const length,
+                                 NmeaMessageType const type)
+{
+  uint32_t time_ms = NMEA_LOG_NO_TIME;
+  if (NMEA_GGA == type || NMEA_AVR == type || NMEA_RMC == type ||
+      NMEA_GST == type || NMEA_ZDA == type || NMEA_GNS == type)
+  {
+    // The time is the first field after "$ttSSS" or "$PTNL,AVR".
+    NmeaFieldReader fields(sentence, sentence + length);
+    NmeaField field;
+    double timestamp = 0.0;
+    uint32_t parsed_ms = 0U;
+    if (fields.skip(NMEA_AVR == type ? 2U : 1U) && fields.next(field) &&
+        parse_field_double(field, timestamp) &&
+        nmea_time_of_day_ms(timestamp, parsed_ms))
+    {
+      time_ms = parsed_ms;
+    }
+  }
+  return time_ms;
+}
+
+NmeaLogReader::NmeaLogReader()
+    : data_(nullptr)
+    , dataLength_(0U)
+    , indexMapping_(nullptr)
+    , indexMappingLength_(0U)
+    , entries_(nullptr)
+    , count_(0U)
+    , indexFromSidecar_(false)
+{
+}
+
+NmeaLogReader::~NmeaLogReader() { close(); }
+
+bool NmeaLogReader::open(string const &path)
+{
+  close();
+  int64_t modified = 0;
+  void *mapping = nullptr;
+  bool const opened =
+      nmea_map_file(path.c_str(), mapping, dataLength_, modified);
+  if (opened)
+  {
+    data_ = static_cast<char const *>(mapping);
+    string const index_path(path + INDEX_SUFFIX);
+    indexFromSidecar_ = load_index(index_path, modified);
+    if (!indexFromSidecar_)
+    {
+      build_index(index_path, modified);
+    }
+  }
+  return opened;
+}
+
+void NmeaLogReader::close()
+{
+  if (nullptr != data_)
+  {
+    munmap(const_cast<char *>(data_), dataLength_);
+  }
+  if (nullptr != indexMapping_)
+  {
+    munmap(indexMapping_, indexMappingLength_);
+  }
+  data_ = nullptr;
+  dataLength_ = 0U;
+  indexMapping_ = nullptr;
+  indexMappingLength_ = 0U;
+  builtEntries_.clear();
+  entries_ = nullptr;
+  count_ = 0U;
+  indexFromSidecar_ = false;
+}
+
+bool NmeaLogReader::load_index(string const &index_path,
+                               int64_t const modified)
+{
+  size_t length = 0U;
+  int64_t index_modified = 0;
+  void *mapping = nullptr;
+  bool loaded =
+      nmea_map_file(index_path.c_str(), mapping, length, index_modified) &&
+      sizeof(NmeaLogIndexHeader) <= length;
+  if (loaded)
+  {
+    NmeaLogIndexHeader header;
+    memcpy(&header, mapping, sizeof(header));
+    // The count is checked against the room left before it is multiplied,
+    // so a crafted one cannot wrap around to the right length.
+    size_t const room = (length - sizeof(header)) / sizeof(NmeaLogIndexEntry);
+    loaded = 0 == memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) &&
+             INDEX_VERSION == header.version &&
+             sizeof(NmeaLogIndexEntry) == header.entrySize &&
+             dataLength_ == header.logLength &&
+             modified == header.logModified && room >= header.count &&
+             length == sizeof(header) +
+                           header.count * sizeof(NmeaLogIndexEntry);
+    NmeaLogIndexEntry const *const entries =
+        reinterpret_cast<NmeaLogIndexEntry const *>(
+            static_cast<char const *>(mapping) + sizeof(header));
+    // Every entry must lie inside the log, or sentence() and decode() would
+    // read past the mapping of a corrupt sidecar.
+    for (size_t i = 0U; loaded && i < header.count; ++i)
+    {
+      loaded = dataLength_ >= entries[i].offset &&
+               dataLength_ - entries[i].offset >= entries[i].length;
+    }
+    if (loaded)
+    {
+      indexMapping_ = mapping;
+      indexMappingLength_ = length;
+      entries_ = entries;
+      count_ = static_cast<size_t>(header.count);
+    }
+  }
+  if (!loaded && nullptr != mapping)
+  {
+    munmap(mapping, length);
+  }
+  return loaded;
+}
+
+void NmeaLogReader::build_index(string const &index_path,
+                                int64_t const modified)
+{
+  uint32_t last_time_ms = NMEA_LOG_NO_TIME;
+  char const *position = data_;
+  char const *const end = data_ + dataLength_;
+  while (position < end)
+  {
+    char const *newline = static_cast<char const *>(
+        memchr(position, '\n', static_cast<size_t>(end - position)));
+    char const *const next = nullptr == newline ? end : newline + 1;
+    char const *stop = nullptr == newline ? end : newline;
+    while (stop != position && '\r' == stop[-1])
+    {
+      --stop;
+    }
+    size_t const length = static_cast<size_t>(stop - position);
+    if ('$' == *position && 0xFFFFU >= length)
+    {
+      NmeaMessageType const type = identify_nmea(position, length);
+      uint32_t const time_ms = sentence_time_ms(position, length, type);
+      last_time_ms = NMEA_LOG_NO_TIME == time_ms ? last_time_ms : time_ms;
+      NmeaLogIndexEntry entry;
+      entry.offset = static_cast<uint64_t>(position - data_);
+      entry.timeMs = last_time_ms;
+      entry.length = static_cast<uint16_t>(length);
+      entry.type = static_cast<uint8_t>(type);
+      entry.reserved = 0U;
+      builtEntries_.push_back(entry);
+    }
+    position = next;
+  }
+  entries_ = builtEntries_.data();
+  count_ = builtEntries_.size();
+
+  // Best effort: a read-only directory only costs a rescan next time. The
+  // sidecar is written under a unique name and renamed over the old one, so
+  // readers that still map the old one keep their pages and two processes
+  // rebuilding at once never interleave.
+  string temp_path(index_path + ".XXXXXX");
+  int const fd = mkstemp(&temp_path[0]);
+  FILE *const index_file = 0 <= fd ? fdopen(fd, "wb") : nullptr;
+  if (0 <= fd && nullptr == index_file)
+  {
+    ::close(fd);
+    remove(temp_path.c_str());
+  }
+  if (nullptr != index_file)
+  {
+    NmeaLogIndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.entrySize = sizeof(NmeaLogIndexEntry);
+    header.logLength = dataLength_;
+    header.logModified = modified;
+    header.count = count_;
+    bool const written =
+        0 == fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) &&
+        1U == fwrite(&header, sizeof(header), 1U, index_file) &&
+        (0U == count_ ||
+         count_ == fwrite(entries_, sizeof(NmeaLogIndexEntry), count_,
+                          index_file)) &&
+        0 == fflush(index_file) && 0 == fsync(fd);
+    if (0 != fclose(index_file) || !written ||
+        0 != rename(temp_path.c_str(), index_path.c_str()))
+    {
+      remove(temp_path.c_str());
+    }
+  }
+}
+
+NmeaMessage NmeaLogReader::decode(size_t const i,
+                                  NmeaChecksumMode const checksum_mode) const
+{
+  return parse_nmea(sentence(i), entries_[i].length, checksum_mode);
+}
+
+size_t NmeaLogReader::find(NmeaMessageType const type,
+                           double const begin_timestamp,
+                           double const end_timestamp,
+                           vector<size_t> &matches) const
+{
+  uint32_t begin_ms = 0U;
+  uint32_t end_ms = 0U;
+  bool const valid = nmea_time_of_day_ms(begin_timestamp, begin_ms) &&
+                     nmea_time_of_day_ms(end_timestamp, end_ms);
+  // A window across midnight is the two ranges on either side of it.
+  bool const wrapped = begin_ms > end_ms;
+  uint8_t const wanted = static_cast<uint8_t>(type);
+  size_t const before = matches.size();
+  for (size_t i = 0U; valid && i < count_; ++i)
+  {
+    NmeaLogIndexEntry const &candidate = entries_[i];
+    bool const after_begin = begin_ms <= candidate.timeMs;
+    bool const before_end = end_ms >= candidate.timeMs;
+    if (wanted == candidate.type && NMEA_LOG_NO_TIME != candidate.timeMs &&
+        (wrapped ? after_begin || before_end : after_begin && before_end))
+    {
+      matches.push_back(i);
+    }
+  }
+  return matches.size() - before;
+}
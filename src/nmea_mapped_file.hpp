@@ -0,0 +1,42 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAMAPPEDFILE_HPP
+#define NMEALIB_NMEAMAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Maps a whole file read-only. An empty file opens fine with a null mapping,
+// since mmap rejects zero lengths. modified is the file's mtime in ns.
+inline bool nmea_map_file(char const *const path, void *&mapping,
+                          size_t &length, int64_t &modified)
+{
+  bool mapped = false;
+  mapping = nullptr;
+  int const fd = ::open(path, O_RDONLY);
+  if (0 <= fd)
+  {
+    struct stat status;
+    if (0 == fstat(fd, &status))
+    {
+      length = static_cast<size_t>(status.st_size);
+      modified = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 +
+                 static_cast<int64_t>(status.st_mtim.tv_nsec);
+      mapped = 0U == length;
+      if (!mapped)
+      {
+        mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        mapped = MAP_FAILED != mapping;
+        mapping = mapped ? mapping : nullptr;
+      }
+    }
+    ::close(fd);
+  }
+  return mapped;
+}
+
+#endif // NMEALIB_NMEAMAPPEDFILE_HPP
@@ -0,0 +1,260 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cstdarg>
+#include <cstdio>
+#include "nmea_metrics.hpp"
+#include "nmea_metrics_probe.hpp"
+
+#if defined(NMEALIB_METRICS)
+#include <mutex>
+#include <vector>
+#endif
+
+using std::string;
+
+char const *nmea_message_type_name(NmeaMessageType const type)
+{
+  static char const *const NAMES[NMEA_MESSAGE_TYPE_COUNT] = {
+      "unknown", "avr", "gga", "vtg", "rmc", "gsa",
+      "gsv",     "gst", "zda", "hdt", "gns"};
+  return type < NMEA_MESSAGE_TYPE_COUNT ? NAMES[type] : NAMES[NMEA_UNKNOWN];
+}
+
+NmeaSentenceMetrics::NmeaSentenceMetrics()
+    : results()
+    , latency()
+{
+}
+
+uint64_t NmeaMetricsSnapshot::sentences_total() const
+{
+  uint64_t total = 0U;
+  for (size_t i = 0U; i < NMEA_MESSAGE_TYPE_COUNT; ++i)
+  {
+    total += sentences[i].results.sentences();
+  }
+  return total;
+}
+
+#if defined(NMEALIB_METRICS)
+
+// Live blocks, blocks of exited threads waiting for reuse, and the totals
+// those exited threads left behind.
+struct NmeaMetricsRegistry
+{
+  std::mutex mutex;
+  std::vector<NmeaThreadMetrics *> live;
+  std::vector<NmeaThreadMetrics *> free;
+  NmeaMetricsSnapshot retired;
+};
+
+static NmeaMetricsRegistry &registry()
+{
+  // Never destroyed, so threads exiting during static destruction still
+  // find it.
+  static NmeaMetricsRegistry *const instance = new NmeaMetricsRegistry();
+  return *instance;
+}
+
+static void add_block(NmeaThreadMetrics const &block,
+                      NmeaMetricsSnapshot &snapshot)
+{
+  for (size_t type = 0U; type < NMEA_MESSAGE_TYPE_COUNT; ++type)
+  {
+    NmeaSentenceMetrics &metrics = snapshot.sentences[type];
+    for (size_t code = 0U; code < NMEA_PARSE_ERROR_CODE_COUNT; ++code)
+    {
+      metrics.results.add(
+          static_cast<NmeaParseErrorCode>(code),
+          block.results[type][code].load(std::memory_order_relaxed));
+    }
+    for (size_t bucket = 0U; bucket < NmeaLatencyHistogram::BUCKETS; ++bucket)
+    {
+      metrics.latency.record(
+          NmeaLatencyHistogram::bucket_upper_bound(bucket),
+          block.latency[type][bucket].load(std::memory_order_relaxed));
+    }
+  }
+}
+
+// Folds an exiting thread's counts into the registry and recycles its block.
+class NmeaThreadMetricsOwner
+{
+public:
+  inline NmeaThreadMetricsOwner()
+      : block_(nullptr)
+  {
+  }
+
+  ~NmeaThreadMetricsOwner()
+  {
+    if (nullptr != block_)
+    {
+      NmeaMetricsRegistry &metrics = registry();
+      std::lock_guard<std::mutex> const lock(metrics.mutex);
+      add_block(*block_, metrics.retired);
+      block_->clear();
+      for (size_t i = 0U; i < metrics.live.size(); ++i)
+      {
+        if (block_ == metrics.live[i])
+        {
+          metrics.live[i] = metrics.live.back();
+          metrics.live.pop_back();
+          break;
+        }
+      }
+      metrics.free.push_back(block_);
+    }
+  }
+
+  NmeaThreadMetrics *block_;
+};
+
+NmeaThreadMetrics::NmeaThreadMetrics()
+    : untilSample(NMEA_METRICS_SAMPLE_PERIOD)
+{
+  clear();
+}
+
+void NmeaThreadMetrics::clear()
+{
+  for (size_t type = 0U; type < NMEA_MESSAGE_TYPE_COUNT; ++type)
+  {
+    for (size_t code = 0U; code < NMEA_PARSE_ERROR_CODE_COUNT; ++code)
+    {
+      results[type][code].store(0U, std::memory_order_relaxed);
+    }
+    for (size_t bucket = 0U; bucket < NmeaLatencyHistogram::BUCKETS; ++bucket)
+    {
+      latency[type][bucket].store(0U, std::memory_order_relaxed);
+    }
+  }
+}
+
+NmeaThreadMetrics *nmea_register_thread_metrics()
+{
+  static thread_local NmeaThreadMetricsOwner owner;
+  NmeaMetricsRegistry &metrics = registry();
+  std::lock_guard<std::mutex> const lock(metrics.mutex);
+  if (metrics.free.empty())
+  {
+    owner.block_ = new NmeaThreadMetrics();
+  }
+  else
+  {
+    owner.block_ = metrics.free.back();
+    metrics.free.pop_back();
+  }
+  metrics.live.push_back(owner.block_);
+  return owner.block_;
+}
+
+bool nmea_metrics_enabled() { return true; }
+
+void nmea_metrics_snapshot(NmeaMetricsSnapshot &snapshot)
+{
+  NmeaMetricsRegistry &metrics = registry();
+  std::lock_guard<std::mutex> const lock(metrics.mutex);
+  snapshot = metrics.retired;
+  for (size_t i = 0U; i < metrics.live.size(); ++i)
+  {
+    add_block(*metrics.live[i], snapshot);
+  }
+}
+
+#else
+
+bool nmea_metrics_enabled() { return false; }
+
+void nmea_metrics_snapshot(NmeaMetricsSnapshot &snapshot)
+{
+  snapshot = NmeaMetricsSnapshot();
+}
+
+#endif
+
+// Cumulative "le" buckets at powers of two from 64 ns to about 1 ms. Those
+// are edges of NmeaLatencyHistogram buckets, so the counts are exact.
+static size_t const FIRST_EDGE_BITS = 6U;
+static size_t const LAST_EDGE_BITS = 20U;
+
+static void append(string &output, char const *const format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void append(string &output, char const *const format, ...)
+{
+  char line[256];
+  va_list arguments;
+  va_start(arguments, format);
+  int const length = vsnprintf(line, sizeof(line), format, arguments);
+  va_end(arguments);
+  if (0 < length)
+  {
+    output.append(line, static_cast<size_t>(length) < sizeof(line)
+                            ? static_cast<size_t>(length)
+                            : sizeof(line) - 1U);
+  }
+}
+
+string nmea_metrics_prometheus(NmeaMetricsSnapshot const &snapshot)
+{
+  string output;
+  output += "# HELP nmea_sentences_total Sentences parsed, by type and "
+            "result.\n"
+            "# TYPE nmea_sentences_total counter\n";
+  for (size_t type = 0U; type < NMEA_MESSAGE_TYPE_COUNT; ++type)
+  {
+    char const *const name =
+        nmea_message_type_name(static_cast<NmeaMessageType>(type));
+    for (size_t code = 0U; code < NMEA_PARSE_ERROR_CODE_COUNT; ++code)
+    {
+      uint64_t const count = snapshot.sentences[type].results.count(
+          static_cast<NmeaParseErrorCode>(code));
+      if (0U != count)
+      {
+        append(output,
+               "nmea_sentences_total{type=\"%s\",result=\"%s\"} %llu\n",
+               name,
+               nmea_parse_error_name(static_cast<NmeaParseErrorCode>(code)),
+               static_cast<unsigned long long>(count));
+      }
+    }
+  }
+
+  output += "# HELP nmea_parse_duration_seconds Sampled time per parse call.\n"
+            "# TYPE nmea_parse_duration_seconds histogram\n";
+  for (size_t type = 0U; type < NMEA_MESSAGE_TYPE_COUNT; ++type)
+  {
+    NmeaLatencyHistogram const &latency = snapshot.sentences[type].latency;
+    if (0U != latency.count())
+    {
+      char const *const name =
+          nmea_message_type_name(static_cast<NmeaMessageType>(type));
+      uint64_t cumulative = 0U;
+      size_t bucket = 0U;
+      for (size_t bits = FIRST_EDGE_BITS; bits <= LAST_EDGE_BITS; ++bits)
+      {
+        uint64_t const edge = (1ULL << bits) - 1U;
+        for (; NmeaLatencyHistogram::bucket_upper_bound(bucket) <= edge;
+             ++bucket)
+        {
+          cumulative += latency.bucket(bucket);
+        }
+        append(output,
+               "nmea_parse_duration_seconds_bucket{type=\"%s\",le=\"%g\"} "
+               "%llu\n",
+               name, static_cast<double>(edge + 1U) * 1e-9,
+               static_cast<unsigned long long>(cumulative));
+      }
+      append(output,
+             "nmea_parse_duration_seconds_bucket{type=\"%s\",le=\"+Inf\"} "
+             "%llu\n"
+             "nmea_parse_duration_seconds_sum{type=\"%s\"} %.9g\n"
+             "nmea_parse_duration_seconds_count{type=\"%s\"} %llu\n",
+             name, static_cast<unsigned long long>(latency.count()), name,
+             latency.mean() * static_cast<double>(latency.count()) * 1e-9,
+             name, static_cast<unsigned long long>(latency.count()));
+    }
+  }
+  return output;
+}
@@ -0,0 +1,100 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEAMETRICSPROBE_HPP
+#define NMEALIB_NMEAMETRICSPROBE_HPP
+
+#include "nmea_metrics.hpp"
+
+#if defined(NMEALIB_METRICS)
+
+#include <atomic>
+#include <chrono>
+
+// One thread's counters. Only the owning thread writes them, so an increment
+// is a relaxed load and store rather than a locked add; snapshots read them
+// from other threads.
+struct NmeaThreadMetrics
+{
+  NmeaThreadMetrics();
+
+  void clear();
+
+  std::atomic<uint64_t> results[NMEA_MESSAGE_TYPE_COUNT]
+                               [NMEA_PARSE_ERROR_CODE_COUNT];
+  std::atomic<uint64_t> latency[NMEA_MESSAGE_TYPE_COUNT]
+                               [NmeaLatencyHistogram::BUCKETS];
+  uint32_t untilSample;
+};
+
+// Registers the calling thread on first use; the block is recycled, not
+// freed, when the thread exits.
+NmeaThreadMetrics *nmea_register_thread_metrics();
+
+inline NmeaThreadMetrics &nmea_thread_metrics()
+{
+  static thread_local NmeaThreadMetrics *metrics = nullptr;
+  if (nullptr == metrics)
+  {
+    metrics = nmea_register_thread_metrics();
+  }
+  return *metrics;
+}
+
+inline void nmea_metrics_increment(std::atomic<uint64_t> &counter)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + 1U,
+                std::memory_order_relaxed);
+}
+
+// Lives for one parse call: counts the result and, on sampled calls, the
+// time since construction.
+class NmeaMetricsProbe
+{
+public:
+  inline NmeaMetricsProbe()
+      : metrics_(nmea_thread_metrics())
+      , startNs_(0U)
+  {
+    if (0U == --metrics_.untilSample)
+    {
+      metrics_.untilSample = NMEA_METRICS_SAMPLE_PERIOD;
+      startNs_ = now_ns();
+    }
+  }
+
+  inline void finish(NmeaMessageType const type,
+                     NmeaParseErrorCode const code)
+  {
+    nmea_metrics_increment(metrics_.results[type][code]);
+    if (0U != startNs_)
+    {
+      nmea_metrics_increment(
+          metrics_.latency[type][NmeaLatencyHistogram::bucket_index(
+              now_ns() - startNs_)]);
+    }
+  }
+
+private:
+  static inline uint64_t now_ns()
+  {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  NmeaThreadMetrics &metrics_;
+  uint64_t startNs_;
+};
+
+#else
+
+class NmeaMetricsProbe
+{
+public:
+  inline void finish(NmeaMessageType const, NmeaParseErrorCode const) {}
+};
+
+#endif
+
+#endif // NMEALIB_NMEAMETRICSPROBE_HPP
@@ -0,0 +1,77 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_parse_error.hpp"
+
+char const *nmea_parse_error_name(NmeaParseErrorCode const code)
+{
+  char const *name = "unknown";
+  switch (code)
+  {
+  case NMEA_PARSE_OK:
+    name = "ok";
+    break;
+  case NMEA_PARSE_MALFORMED_HEADER:
+    name = "malformed_header";
+    break;
+  case NMEA_PARSE_UNSUPPORTED_SENTENCE:
+    name = "unsupported_sentence";
+    break;
+  case NMEA_PARSE_WRONG_SENTENCE:
+    name = "wrong_sentence";
+    break;
+  case NMEA_PARSE_CHECKSUM_MISMATCH:
+    name = "checksum_mismatch";
+    break;
+  case NMEA_PARSE_MISSING_FIELD:
+    name = "missing_field";
+    break;
+  case NMEA_PARSE_EMPTY_FIELD:
+    name = "empty_field";
+    break;
+  case NMEA_PARSE_BAD_NUMBER:
+    name = "bad_number";
+    break;
+  case NMEA_PARSE_OUT_OF_RANGE:
+    name = "out_of_range";
+    break;
+  case NMEA_PARSE_BAD_FLAG:
+    name = "bad_flag";
+    break;
+  default:
+    break;
+  }
+  return name;
+}
+
+NmeaParseStats::NmeaParseStats() { reset(); }
+
+uint64_t NmeaParseStats::sentences() const
+{
+  uint64_t total = 0U;
+  for (size_t i = 0U; i < NMEA_PARSE_ERROR_CODE_COUNT; ++i)
+  {
+    total += counts_[i];
+  }
+  return total;
+}
+
+uint64_t NmeaParseStats::failures() const
+{
+  return sentences() - counts_[NMEA_PARSE_OK];
+}
+
+void NmeaParseStats::merge(NmeaParseStats const &other)
+{
+  for (size_t i = 0U; i < NMEA_PARSE_ERROR_CODE_COUNT; ++i)
+  {
+    counts_[i] += other.counts_[i];
+  }
+}
+
+void NmeaParseStats::reset()
+{
+  for (size_t i = 0U; i < NMEA_PARSE_ERROR_CODE_COUNT; ++i)
+  {
+    counts_[i] = 0U;
+  }
+}
@@ -1,196 +1,480 @@
 // Copyright 2016 Geoffrey Lawrence Viola
 
-#include <vector>
-#include <tuple>
 #include <cstdint>
-#include <cmath>
-#include <algorithm>
 #include <string>
+#include "nmea_fields.hpp"
+#include "nmea_metrics_probe.hpp"
 #include "nmea_parser.hpp"
+#include "nmea_sentences.hpp"
 
 using std::string;
-using std::vector;
-using std::tuple;
-using std::get;
 
-static tuple<bool, double> parse_degrees_minutes_angle(string const &message);
+static char const PROPRIETARY_TRIMBLE[] = "$PTNL,";
+static size_t const STANDARD_HEADER_LENGTH = 7U;
+static size_t const PROPRIETARY_HEADER_LENGTH = 10U;
+static uint32_t const PROPRIETARY_KEY = 1U << 24;
 
-AvrMessageData parse_avr(string const &message)
+struct NmeaHeader
 {
-  static string const AVR_START("$PTNL,AVR,");
-  AvrMessageData output;
-  output.valid = false;
+  NmeaMessageType type;
+  char const *body;
+  char const *end;
+  NmeaParseErrorCode error;
+};
 
-  if (AVR_START == message.substr(0, AVR_START.length()))
+static constexpr uint32_t sentence_key(char const a, char const b,
+                                       char const c)
+{
+  return (static_cast<uint32_t>(static_cast<uint8_t>(a)) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+         static_cast<uint32_t>(static_cast<uint8_t>(c));
+}
+
+static bool is_talker_character(char const c)
+{
+  return ('A' <= c && 'Z' >= c) || ('0' <= c && '9' >= c);
+}
+
+// "$ttSSS," for standard sentences from any talker, "$PTNL,SSS," for Trimble
+// proprietary ones. The sentence ID is packed into one key so adding a type
+// costs one more case label rather than another prefix comparison.
+static NmeaHeader read_header(char const *const message, size_t const length,
+                              NmeaChecksumMode const checksum_mode)
+{
+  uint32_t key = 0U;
+  NmeaHeader header;
+  header.type = NMEA_UNKNOWN;
+  header.body = nullptr;
+  header.end = message + length;
+  header.error = NMEA_PARSE_MALFORMED_HEADER;
+  if (has_prefix(message, length, PROPRIETARY_TRIMBLE,
+                 sizeof(PROPRIETARY_TRIMBLE) - 1U))
+  {
+    if (PROPRIETARY_HEADER_LENGTH <= length && ',' == message[9])
+    {
+      key = PROPRIETARY_KEY | sentence_key(message[6], message[7], message[8]);
+      header.body = message + PROPRIETARY_HEADER_LENGTH;
+    }
+  }
+  else if (STANDARD_HEADER_LENGTH <= length && '$' == message[0] &&
+           is_talker_character(message[1]) &&
+           is_talker_character(message[2]) && ',' == message[6])
   {
-    string::size_type previous_n = AVR_START.length();
-    string::size_type next_n = message.find(",", previous_n);
-    output.timestamp = stod(message.substr(previous_n, next_n - previous_n));
-    ++next_n;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.yaw = stod(message.substr(previous_n, next_n - previous_n));
-    next_n += 5U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.tilt = stod(message.substr(previous_n, next_n - previous_n));
-    next_n += 8U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.range = stod(message.substr(previous_n, next_n - previous_n));
-    next_n += 1U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.fixQuality = static_cast<AvrFixQuality>(
-        stod(message.substr(previous_n, next_n - previous_n)));
-    next_n += 1U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.pdop = stod(message.substr(previous_n, next_n - previous_n));
-    next_n += 1U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.numSatellites = static_cast<uint16_t>(
-        stoi(message.substr(previous_n, next_n - previous_n)));
-    output.valid = true;
+    key = sentence_key(message[3], message[4], message[5]);
+    header.body = message + STANDARD_HEADER_LENGTH;
   }
 
-  return output;
+  switch (key)
+  {
+  case PROPRIETARY_KEY | sentence_key('A', 'V', 'R'):
+    header.type = NMEA_AVR;
+    break;
+  case sentence_key('G', 'G', 'A'):
+    header.type = NMEA_GGA;
+    break;
+  case sentence_key('V', 'T', 'G'):
+    header.type = NMEA_VTG;
+    break;
+  case sentence_key('R', 'M', 'C'):
+    header.type = NMEA_RMC;
+    break;
+  case sentence_key('G', 'S', 'A'):
+    header.type = NMEA_GSA;
+    break;
+  case sentence_key('G', 'S', 'V'):
+    header.type = NMEA_GSV;
+    break;
+  case sentence_key('G', 'S', 'T'):
+    header.type = NMEA_GST;
+    break;
+  case sentence_key('Z', 'D', 'A'):
+    header.type = NMEA_ZDA;
+    break;
+  case sentence_key('H', 'D', 'T'):
+    header.type = NMEA_HDT;
+    break;
+  case sentence_key('G', 'N', 'S'):
+    header.type = NMEA_GNS;
+    break;
+  default:
+    break;
+  }
+  if (NMEA_UNKNOWN != header.type)
+  {
+    header.error = NMEA_SKIP_CHECKSUM == checksum_mode ||
+                           nmea_checksum_valid(message, length)
+                       ? NMEA_PARSE_OK
+                       : NMEA_PARSE_CHECKSUM_MISMATCH;
+  }
+  else if (nullptr != header.body)
+  {
+    header.error = NMEA_PARSE_UNSUPPORTED_SENTENCE;
+  }
+  return header;
 }
 
-tuple<bool, double> parse_degrees_minutes_angle(string const &message)
+template <typename Schema, typename Message>
+static Message decode(NmeaHeader const &header, NmeaMessageType const type,
+                      NmeaParseError &error)
 {
-  string::size_type period_location = message.find(".");
-  bool const is_valid = period_location != message.length();
-  double angle_degrees = 0.0;
-
-  if (is_valid)
+  Message output;
+  error = NmeaParseError(header.error, 0U);
+  if (error.ok() && type != header.type)
   {
-    double const whole_degrees = stod(message.substr(0U, period_location - 2U));
-    double const whole_minutes =
-        stod(message.substr(period_location - 2U, period_location));
-    string const double_minutes_str =
-        message.substr(period_location + 1U, message.length());
-    double const decimal_minutes =
-        stod(double_minutes_str) / std::pow(10, double_minutes_str.size() - 1);
-    angle_degrees = whole_degrees + (whole_minutes + decimal_minutes) / 60.0;
+    error.code = NMEA_PARSE_WRONG_SENTENCE;
   }
+  if (error.ok())
+  {
+    NmeaFieldDecoder fields(header.body, header.end, error);
+    output.valid = Schema::parse(fields, output);
+  }
+  return output;
+}
+
+static AvrMessageData decode_avr(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<AvrSchema, AvrMessageData>(header, NMEA_AVR, error);
+}
 
-  return tuple<bool, double>(is_valid, angle_degrees);
+static GgaMessageData decode_gga(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<GgaSchema, GgaMessageData>(header, NMEA_GGA, error);
+}
+
+static VtgMessageData decode_vtg(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<VtgSchema, VtgMessageData>(header, NMEA_VTG, error);
 }
 
-GgaMessageData parse_gga(string const &message)
+static RmcMessageData decode_rmc(NmeaHeader const &header,
+                                 NmeaParseError &error)
 {
-  static string const GGA_START("$GPGGA,");
-  GgaMessageData output;
-  output.valid = false;
-  if (GGA_START == message.substr(0, GGA_START.length()))
+  return decode<RmcSchema, RmcMessageData>(header, NMEA_RMC, error);
+}
+
+static GsaMessageData decode_gsa(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<GsaSchema, GsaMessageData>(header, NMEA_GSA, error);
+}
+
+// The talker is kept so GPS, GLONASS and Galileo groups can be told apart.
+static GsvMessageData decode_gsv(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  GsvMessageData output(
+      decode<GsvSchema, GsvMessageData>(header, NMEA_GSV, error));
+  if (NMEA_GSV == header.type)
   {
-    string::size_type previous_n = GGA_START.length();
-    string::size_type next_n = message.find(",", previous_n);
-    output.timestamp = stod(message.substr(previous_n, next_n - previous_n));
-    previous_n = next_n;
-    next_n = message.find(",", next_n + 1U);
-    tuple<bool, double> const latitude_v_a(parse_degrees_minutes_angle(
-        message.substr(previous_n + 1, next_n - previous_n)));
-    if (get<0>(latitude_v_a))
-    {
-      previous_n = next_n;
-      next_n = message.find(",", next_n + 1U);
-      double const latitude_multiplier =
-          ("N" == message.substr(previous_n + 1, next_n - previous_n - 1)
-               ? 1.0
-               : -1.0);
-      output.latitude = get<1>(latitude_v_a) * latitude_multiplier;
-      previous_n = next_n;
-      next_n = message.find(",", next_n + 1U);
-      tuple<bool, double> const longitude_v_a(parse_degrees_minutes_angle(
-          message.substr(previous_n + 1, next_n - previous_n)));
-      if (get<0>(longitude_v_a))
-      {
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        double const longitude_multiplier =
-            ("E" == message.substr(previous_n + 1, next_n - previous_n - 1)
-                 ? 1.0
-                 : -1.0);
-        output.longitude = get<1>(longitude_v_a) * longitude_multiplier;
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        output.fixQuality = static_cast<GgaFixQuality>(
-            stoi(message.substr(previous_n + 1, next_n - previous_n - 1)));
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        output.numSatellites =
-            stoi(message.substr(previous_n + 1, next_n - previous_n - 1));
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        output.hdop =
-            stod(message.substr(previous_n + 1, next_n - previous_n - 1));
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        output.altitude =
-            stod(message.substr(previous_n + 1, next_n - previous_n - 1));
-        next_n += 2U;
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        output.geoidHeight =
-            stod(message.substr(previous_n + 1, next_n - previous_n - 1));
-        next_n += 2U;
-        previous_n = next_n;
-        next_n = message.find(",", next_n + 1U);
-        if (1 < next_n - previous_n)
-        {
-          output.SetTimeSinceLastDgps(
-              stod(message.substr(previous_n + 1, next_n - previous_n - 1)));
-        }
-        previous_n = next_n;
-        next_n = message.find("*", next_n + 1U);
-        if (1 < next_n - previous_n)
-        {
-          output.SetDgpsStationID(static_cast<uint16_t>(
-              stoi(message.substr(previous_n + 1, next_n - previous_n - 1))));
-        }
-        output.valid = true;
-      }
-    }
+    output.talker[0] = header.body[-6];
+    output.talker[1] = header.body[-5];
   }
+  return output;
+}
+
+static GstMessageData decode_gst(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<GstSchema, GstMessageData>(header, NMEA_GST, error);
+}
+
+static ZdaMessageData decode_zda(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<ZdaSchema, ZdaMessageData>(header, NMEA_ZDA, error);
+}
+
+static HdtMessageData decode_hdt(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<HdtSchema, HdtMessageData>(header, NMEA_HDT, error);
+}
 
+static GnsMessageData decode_gns(NmeaHeader const &header,
+                                 NmeaParseError &error)
+{
+  return decode<GnsSchema, GnsMessageData>(header, NMEA_GNS, error);
+}
+
+// Every typed parse goes through here so metrics see each call once.
+template <typename Message>
+static Message parse_one(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode,
+                         Message (*const decoder)(NmeaHeader const &,
+                                                  NmeaParseError &))
+{
+  NmeaMetricsProbe probe;
+  NmeaHeader const header(read_header(message, length, checksum_mode));
+  Message const output(decoder(header, error));
+  probe.finish(header.type, error.code);
   return output;
 }
 
-VtgMessageData parse_vtg(string const &message)
+AvrMessageData parse_avr(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_avr);
+}
+
+AvrMessageData parse_avr(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_avr(message, length, error, checksum_mode);
+}
+
+AvrMessageData parse_avr(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_avr(message.data(), message.length(), checksum_mode);
+}
+
+GgaMessageData parse_gga(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_gga);
+}
+
+GgaMessageData parse_gga(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_gga(message, length, error, checksum_mode);
+}
+
+GgaMessageData parse_gga(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_gga(message.data(), message.length(), checksum_mode);
+}
+
+VtgMessageData parse_vtg(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_vtg);
+}
+
+VtgMessageData parse_vtg(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_vtg(message, length, error, checksum_mode);
+}
+
+VtgMessageData parse_vtg(string const &message,
+                         NmeaChecksumMode const checksum_mode)
 {
-  static string const VTG_START("$GPVTG,");
-  VtgMessageData output;
-  output.valid = false;
+  return parse_vtg(message.data(), message.length(), checksum_mode);
+}
+
+RmcMessageData parse_rmc(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_rmc);
+}
+
+RmcMessageData parse_rmc(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_rmc(message, length, error, checksum_mode);
+}
+
+RmcMessageData parse_rmc(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_rmc(message.data(), message.length(), checksum_mode);
+}
 
-  if (VTG_START == message.substr(0, VTG_START.length()))
+GsaMessageData parse_gsa(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_gsa);
+}
+
+GsaMessageData parse_gsa(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_gsa(message, length, error, checksum_mode);
+}
+
+GsaMessageData parse_gsa(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_gsa(message.data(), message.length(), checksum_mode);
+}
+
+GsvMessageData parse_gsv(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_gsv);
+}
+
+GsvMessageData parse_gsv(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_gsv(message, length, error, checksum_mode);
+}
+
+GsvMessageData parse_gsv(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_gsv(message.data(), message.length(), checksum_mode);
+}
+
+GstMessageData parse_gst(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_gst);
+}
+
+GstMessageData parse_gst(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_gst(message, length, error, checksum_mode);
+}
+
+GstMessageData parse_gst(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_gst(message.data(), message.length(), checksum_mode);
+}
+
+ZdaMessageData parse_zda(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_zda);
+}
+
+ZdaMessageData parse_zda(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_zda(message, length, error, checksum_mode);
+}
+
+ZdaMessageData parse_zda(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_zda(message.data(), message.length(), checksum_mode);
+}
+
+HdtMessageData parse_hdt(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_hdt);
+}
+
+HdtMessageData parse_hdt(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_hdt(message, length, error, checksum_mode);
+}
+
+HdtMessageData parse_hdt(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_hdt(message.data(), message.length(), checksum_mode);
+}
+
+GnsMessageData parse_gns(char const *const message, size_t const length,
+                         NmeaParseError &error,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_one(message, length, error, checksum_mode, decode_gns);
+}
+
+GnsMessageData parse_gns(char const *const message, size_t const length,
+                         NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_gns(message, length, error, checksum_mode);
+}
+
+GnsMessageData parse_gns(string const &message,
+                         NmeaChecksumMode const checksum_mode)
+{
+  return parse_gns(message.data(), message.length(), checksum_mode);
+}
+
+NmeaMessageType identify_nmea(char const *const message, size_t const length)
+{
+  return read_header(message, length, NMEA_SKIP_CHECKSUM).type;
+}
+
+NmeaMessage parse_nmea(char const *const message, size_t const length,
+                       NmeaParseError &error,
+                       NmeaChecksumMode const checksum_mode)
+{
+  NmeaMetricsProbe probe;
+  NmeaHeader const header(read_header(message, length, checksum_mode));
+  NmeaMessage output;
+  switch (header.type)
   {
-    string::size_type previous_n = VTG_START.length();
-    string::size_type next_n = message.find(",", previous_n);
-    output.trueTrackMadeGood =
-        stod(message.substr(previous_n, next_n - previous_n));
-    next_n += 3;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    if (1 < next_n - previous_n)
-    {
-      output.SetMagneticTrackMadeGood(
-          stod(message.substr(previous_n, next_n - previous_n)));
-    }
-    next_n += 3U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.groundSpeedKnots =
-        stod(message.substr(previous_n, next_n - previous_n));
-    next_n += 3U;
-    previous_n = next_n;
-    next_n = message.find(",", next_n);
-    output.groundSpeedKph =
-        stod(message.substr(previous_n, next_n - previous_n));
-    output.valid = true;
+  case NMEA_AVR:
+    output = NmeaMessage(decode_avr(header, error));
+    break;
+  case NMEA_GGA:
+    output = NmeaMessage(decode_gga(header, error));
+    break;
+  case NMEA_VTG:
+    output = NmeaMessage(decode_vtg(header, error));
+    break;
+  case NMEA_RMC:
+    output = NmeaMessage(decode_rmc(header, error));
+    break;
+  case NMEA_GSA:
+    output = NmeaMessage(decode_gsa(header, error));
+    break;
+  case NMEA_GSV:
+    output = NmeaMessage(decode_gsv(header, error));
+    break;
+  case NMEA_GST:
+    output = NmeaMessage(decode_gst(header, error));
+    break;
+  case NMEA_ZDA:
+    output = NmeaMessage(decode_zda(header, error));
+    break;
+  case NMEA_HDT:
+    output = NmeaMessage(decode_hdt(header, error));
+    break;
+  case NMEA_GNS:
+    output = NmeaMessage(decode_gns(header, error));
+    break;
+  default:
+    error = NmeaParseError(header.error, 0U);
+    break;
   }
-
+  probe.finish(header.type, error.code);
   return output;
 }
+
+NmeaMessage parse_nmea(char const *const message, size_t const length,
+                       NmeaChecksumMode const checksum_mode)
+{
+  NmeaParseError error;
+  return parse_nmea(message, length, error, checksum_mode);
+}
+
+NmeaMessage parse_nmea(string const &message,
+                       NmeaChecksumMode const checksum_mode)
+{
+  return parse_nmea(message.data(), message.length(), checksum_mode);
+}
@@ -0,0 +1,276 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include "nmea_pipeline.hpp"
+
+static size_t round_up_power_of_two(size_t const value)
+{
+  size_t rounded = 1U;
+  while (rounded < value)
+  {
+    rounded <<= 1U;
+  }
+  return rounded;
+}
+
+uint64_t nmea_pipeline_now_ns()
+{
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+NmeaSentenceQueue::Cell::Cell()
+    : sequence(0U)
+{
+}
+
+NmeaSentenceQueue::NmeaSentenceQueue(size_t const capacity)
+    : cells_(round_up_power_of_two(capacity < 2U ? 2U : capacity))
+    , mask_(cells_.size() - 1U)
+    , enqueue_(0U)
+    , dequeue_(0U)
+{
+  for (size_t i = 0U; i < cells_.size(); ++i)
+  {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+// A cell is free for the producer claiming position p when its sequence is
+// p, and holds a sentence for the consumer claiming p when it is p + 1.
+bool NmeaSentenceQueue::try_push(char const *const data, size_t const length,
+                                 uint64_t const arrival_ns)
+{
+  Cell *cell = nullptr;
+  bool full = NMEA_QUEUED_SENTENCE_BYTES < length;
+  size_t position = enqueue_.load(std::memory_order_relaxed);
+  while (nullptr == cell && !full)
+  {
+    Cell &candidate = cells_[position & mask_];
+    size_t const sequence = candidate.sequence.load(std::memory_order_acquire);
+    intptr_t const difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (0 == difference)
+    {
+      if (enqueue_.compare_exchange_weak(position, position + 1U,
+                                         std::memory_order_relaxed))
+      {
+        cell = &candidate;
+      }
+    }
+    else if (0 > difference)
+    {
+      full = true;
+    }
+    else
+    {
+      position = enqueue_.load(std::memory_order_relaxed);
+    }
+  }
+  if (nullptr != cell)
+  {
+    cell->sentence.arrivalNs = arrival_ns;
+    cell->sentence.length = static_cast<uint16_t>(length);
+    memcpy(cell->sentence.data, data, length);
+    cell->sequence.store(position + 1U, std::memory_order_release);
+  }
+  return nullptr != cell;
+}
+
+bool NmeaSentenceQueue::try_pop(NmeaQueuedSentence &sentence)
+{
+  Cell *cell = nullptr;
+  bool empty = false;
+  size_t position = dequeue_.load(std::memory_order_relaxed);
+  while (nullptr == cell && !empty)
+  {
+    Cell &candidate = cells_[position & mask_];
+    size_t const sequence = candidate.sequence.load(std::memory_order_acquire);
+    intptr_t const difference = static_cast<intptr_t>(sequence) -
+                                static_cast<intptr_t>(position + 1U);
+    if (0 == difference)
+    {
+      if (dequeue_.compare_exchange_weak(position, position + 1U,
+                                         std::memory_order_relaxed))
+      {
+        cell = &candidate;
+      }
+    }
+    else if (0 > difference)
+    {
+      empty = true;
+    }
+    else
+    {
+      position = dequeue_.load(std::memory_order_relaxed);
+    }
+  }
+  if (nullptr != cell)
+  {
+    sentence.arrivalNs = cell->sentence.arrivalNs;
+    sentence.length = cell->sentence.length;
+    memcpy(sentence.data, cell->sentence.data, sentence.length);
+    cell->sequence.store(position + mask_ + 1U, std::memory_order_release);
+  }
+  return nullptr != cell;
+}
+
+size_t NmeaSentenceQueue::size() const
+{
+  size_t const enqueued = enqueue_.load(std::memory_order_relaxed);
+  size_t const dequeued = dequeue_.load(std::memory_order_relaxed);
+  return enqueued > dequeued ? enqueued - dequeued : 0U;
+}
+
+// Records are copied to and from the ring's words with memcpy.
+static_assert(std::is_trivially_copyable<NmeaRecord>::value,
+              "NmeaRecord must be trivially copyable");
+
+NmeaRecordRing::Cell::Cell()
+    : version(0U)
+{
+  for (size_t i = 0U; i < RECORD_WORDS; ++i)
+  {
+    words[i].store(0U, std::memory_order_relaxed);
+  }
+}
+
+NmeaRecordRing::NmeaRecordRing(size_t const capacity)
+    : cells_(round_up_power_of_two(capacity < 2U ? 2U : capacity))
+    , mask_(cells_.size() - 1U)
+    , head_(0U)
+{
+}
+
+void NmeaRecordRing::publish(NmeaRecord const &record)
+{
+  uint64_t const sequence = head_.load(std::memory_order_relaxed);
+  Cell &cell = cells_[sequence & mask_];
+  NmeaRecord stamped(record);
+  stamped.sequence = sequence;
+  uint64_t words[RECORD_WORDS];
+  words[RECORD_WORDS - 1U] = 0U;
+  memcpy(words, &stamped, sizeof(stamped));
+  cell.version.store(2U * sequence + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0U; i < RECORD_WORDS; ++i)
+  {
+    cell.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  cell.version.store(2U * sequence + 2U, std::memory_order_release);
+  head_.store(sequence + 1U, std::memory_order_release);
+}
+
+NmeaRecordSubscriber::NmeaRecordSubscriber(NmeaRecordRing const &ring)
+    : ring_(&ring)
+    , cursor_(ring.published())
+    , received_(0U)
+    , lost_(0U)
+{
+}
+
+// Seqlock read: copy, then check the version did not move while copying.
+bool NmeaRecordSubscriber::next(NmeaRecord &record)
+{
+  bool found = false;
+  bool available = true;
+  while (!found && available)
+  {
+    uint64_t const head = ring_->published();
+    uint64_t const capacity = ring_->capacity();
+    if (head - cursor_ > capacity)
+    {
+      lost_ += head - cursor_ - capacity;
+      cursor_ = head - capacity;
+    }
+    available = cursor_ != head;
+    if (available)
+    {
+      NmeaRecordRing::Cell const &cell = ring_->cells_[cursor_ & ring_->mask_];
+      uint64_t const expected = 2U * cursor_ + 2U;
+      uint64_t const before = cell.version.load(std::memory_order_acquire);
+      if (expected == before)
+      {
+        uint64_t words[NmeaRecordRing::RECORD_WORDS];
+        for (size_t i = 0U; i < NmeaRecordRing::RECORD_WORDS; ++i)
+        {
+          words[i] = cell.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        found =
+            expected == cell.version.load(std::memory_order_relaxed);
+        if (found)
+        {
+          memcpy(&record, words, sizeof(record));
+        }
+      }
+      if (found)
+      {
+        ++received_;
+      }
+      else
+      {
+        // Overwritten while we looked; the next pass skips ahead.
+        ++lost_;
+      }
+      ++cursor_;
+    }
+  }
+  return found;
+}
+
+NmeaPipeline::NmeaPipeline(size_t const sentence_capacity,
+                           size_t const record_capacity,
+                           NmeaChecksumMode const checksum_mode)
+    : sentences_(sentence_capacity)
+    , records_(record_capacity)
+    , checksumMode_(checksum_mode)
+    , dropped_(0U)
+    , pending_()
+    , record_()
+{
+}
+
+bool NmeaPipeline::submit(char const *const data, size_t const length,
+                          uint64_t const arrival_ns)
+{
+  bool const queued = sentences_.try_push(data, length, arrival_ns);
+  if (!queued)
+  {
+    dropped_.fetch_add(1U, std::memory_order_relaxed);
+  }
+  return queued;
+}
+
+size_t NmeaPipeline::submit(NmeaStreamFramer &framer, char const *const bytes,
+                            size_t const length)
+{
+  uint64_t const arrival_ns = nmea_pipeline_now_ns();
+  size_t queued = 0U;
+  NmeaSentence sentence;
+  framer.push(bytes, length);
+  while (framer.next(sentence))
+  {
+    queued += submit(sentence.data, sentence.length, arrival_ns) ? 1U : 0U;
+  }
+  return queued;
+}
+
+size_t NmeaPipeline::parse_pending(size_t const max_sentences)
+{
+  size_t parsed = 0U;
+  while (parsed < max_sentences && sentences_.try_pop(pending_))
+  {
+    record_.arrivalNs = pending_.arrivalNs;
+    record_.message = parse_nmea(pending_.data, pending_.length,
+                                 record_.error, checksumMode_);
+    record_.parsedNs = nmea_pipeline_now_ns();
+    records_.publish(record_);
+    ++parsed;
+  }
+  return parsed;
+}
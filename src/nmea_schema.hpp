@@ -0,0 +1,521 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEASCHEMA_HPP
+#define NMEALIB_NMEASCHEMA_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "nmea_checksum.hpp"
+#include "nmea_fields.hpp"
+#include "nmea_format.hpp"
+#include "nmea_parse_error.hpp"
+
+// Declarative sentence layouts. A sentence is a list of field kinds bound to
+// members of its message struct:
+//
+//   typedef NmeaFieldList<
+//       NmeaNumber<VtgMessageData, &VtgMessageData::trueTrackMadeGood,
+//                  NmeaFixed<1, 5> >,
+//       NmeaLabel<'T'>, ...> VtgSchema;
+//
+// VtgSchema::parse reads the fields in place and VtgSchema::build writes
+// them, both fully inlined. Each kind provides
+//
+//   static bool parse(NmeaFieldDecoder &fields, Message &message);
+//   static void build(NmeaWriter &writer, Message const &message);
+//
+// where build writes the text of its wire fields and the list inserts the
+// commas between kinds.
+
+// Reads the fields of one sentence in order and records the first one that
+// fails, so kinds can chain reads with && and still say what went wrong.
+class NmeaFieldDecoder
+{
+public:
+  inline NmeaFieldDecoder(char const *const begin, char const *const end,
+                          NmeaParseError &error)
+      : fields_(begin, end)
+      , error_(error)
+      , index_(0U)
+  {
+  }
+
+  inline bool skip()
+  {
+    ++index_;
+    return fields_.next(field_) || fail(NMEA_PARSE_MISSING_FIELD);
+  }
+
+  // Consumes a field if the sentence has one left.
+  inline bool skip_optional()
+  {
+    ++index_;
+    fields_.next(field_);
+    return true;
+  }
+
+  inline bool read_double(double &value)
+  {
+    return next_required() &&
+           (parse_field_double(field_, value) || fail(NMEA_PARSE_BAD_NUMBER));
+  }
+
+  inline bool read_int(int32_t &value, int32_t const minimum,
+                       int32_t const maximum)
+  {
+    return next_required() &&
+           (parse_field_int(field_, value) || fail(NMEA_PARSE_BAD_NUMBER)) &&
+           in_range(value, minimum, maximum);
+  }
+
+  inline bool read_degrees_minutes(double &value)
+  {
+    return next_required() && (parse_field_degrees_minutes(field_, value) ||
+                               fail(NMEA_PARSE_BAD_NUMBER));
+  }
+
+  inline bool read_hemisphere(char const positive, double &sign)
+  {
+    return next_required() && parse_field_hemisphere(field_, positive, sign);
+  }
+
+  inline bool read_character(char &value)
+  {
+    bool const valid = next_required() &&
+                       (1U == field_.length() || fail(NMEA_PARSE_BAD_FLAG));
+    value = valid ? *field_.begin : '\0';
+    return valid;
+  }
+
+  inline bool read_optional_character(char &value)
+  {
+    bool const present = next_present();
+    bool const valid =
+        !present || 1U == field_.length() || fail(NMEA_PARSE_BAD_FLAG);
+    value = present && valid ? *field_.begin : '\0';
+    return valid;
+  }
+
+  // A field that may be empty or, at the end of a sentence, left out.
+  inline bool read_optional_double(double &value, bool &present)
+  {
+    present = next_present();
+    return !present || parse_field_double(field_, value) ||
+           fail(NMEA_PARSE_BAD_NUMBER);
+  }
+
+  inline bool read_optional_int(int32_t &value, int32_t const minimum,
+                                int32_t const maximum, bool &present)
+  {
+    present = next_present();
+    return !present ||
+           ((parse_field_int(field_, value) || fail(NMEA_PARSE_BAD_NUMBER)) &&
+            in_range(value, minimum, maximum));
+  }
+
+  // Raw access for kinds with their own layout rules; false at the end of
+  // the sentence without recording an error.
+  inline bool next(NmeaField &field)
+  {
+    ++index_;
+    return fields_.next(field);
+  }
+
+  inline bool fail(NmeaParseErrorCode const code)
+  {
+    return fail_at(code, index_);
+  }
+
+  inline bool fail_at(NmeaParseErrorCode const code, uint8_t const field)
+  {
+    error_ = NmeaParseError(code, field);
+    return false;
+  }
+
+  // Position of the last field read, 1-based.
+  inline uint8_t index() const { return index_; }
+
+  inline bool in_range(int32_t const value, int32_t const minimum,
+                       int32_t const maximum)
+  {
+    return (minimum <= value && maximum >= value) ||
+           fail(NMEA_PARSE_OUT_OF_RANGE);
+  }
+
+private:
+  inline bool next_required()
+  {
+    ++index_;
+    return (fields_.next(field_) || fail(NMEA_PARSE_MISSING_FIELD)) &&
+           (!field_.empty() || fail(NMEA_PARSE_EMPTY_FIELD));
+  }
+
+  inline bool next_present()
+  {
+    ++index_;
+    return fields_.next(field_) && !field_.empty();
+  }
+
+  NmeaFieldReader fields_;
+  NmeaField field_;
+  NmeaParseError &error_;
+  uint8_t index_;
+};
+
+// Number formats
+
+template <int Precision, size_t Width = 0U> struct NmeaFixed
+{
+  static inline void put(NmeaWriter &writer, double const value)
+  {
+    writer.put_fixed(value, Precision, Width);
+  }
+};
+
+// Fixed with an explicit '+' on non-negative values, e.g. AVR yaw.
+template <int Precision> struct NmeaSignedFixed
+{
+  static inline void put(NmeaWriter &writer, double const value)
+  {
+    if (!std::signbit(value))
+    {
+      writer.put('+');
+    }
+    writer.put_fixed(value, Precision);
+  }
+};
+
+struct NmeaGeneral
+{
+  static inline void put(NmeaWriter &writer, double const value)
+  {
+    writer.put_general(value);
+  }
+};
+
+// Field kinds
+
+template <typename Message, double Message::*Member, typename Format>
+struct NmeaNumber
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    return fields.read_double(message.*Member);
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    Format::put(writer, message.*Member);
+  }
+};
+
+// Empty when the flag is clear.
+template <typename Message, double Message::*Member, bool Message::*Valid,
+          typename Format>
+struct NmeaOptionalNumber
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    return fields.read_optional_double(message.*Member, message.*Valid);
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    if (message.*Valid)
+    {
+      Format::put(writer, message.*Member);
+    }
+  }
+};
+
+// Integers and enums, rejected outside [Minimum, Maximum].
+template <typename Message, typename T, T Message::*Member, int32_t Minimum,
+          int32_t Maximum, size_t Width = 0U>
+struct NmeaInteger
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    int32_t value = 0;
+    bool const valid = fields.read_int(value, Minimum, Maximum);
+    message.*Member = static_cast<T>(value);
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    writer.put_uint(static_cast<uint32_t>(message.*Member), Width);
+  }
+};
+
+template <typename Message, typename T, T Message::*Member, bool Message::*Valid,
+          int32_t Minimum, int32_t Maximum, size_t Width = 0U>
+struct NmeaOptionalInteger
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    int32_t value = 0;
+    bool const valid =
+        fields.read_optional_int(value, Minimum, Maximum, message.*Valid);
+    message.*Member = static_cast<T>(value);
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    if (message.*Valid)
+    {
+      writer.put_uint(static_cast<uint32_t>(message.*Member), Width);
+    }
+  }
+};
+
+// Signed decimal degrees as "dddmm.mmmmmmmm,H": two wire fields.
+template <typename Message, double Message::*Member, size_t DegreeDigits,
+          char Positive, char Negative>
+struct NmeaAngle
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    double angle = 0.0;
+    double sign = 0.0;
+    bool const valid = fields.read_degrees_minutes(angle) &&
+                       fields.read_hemisphere(Positive, sign);
+    message.*Member = angle * sign;
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    double const angle = message.*Member;
+    put_degrees_minutes(writer, angle, DegreeDigits);
+    writer.put(',');
+    writer.put(angle > 0 ? Positive : Negative);
+  }
+};
+
+// Single letter flags such as the RMC status; '\0' when an optional one is
+// absent.
+template <typename Message, char Message::*Member> struct NmeaCharacter
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    return fields.read_character(message.*Member);
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    writer.put(message.*Member);
+  }
+};
+
+template <typename Message, char Message::*Member>
+struct NmeaOptionalCharacter
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    return fields.read_optional_character(message.*Member);
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    if ('\0' != message.*Member)
+    {
+      writer.put(message.*Member);
+    }
+  }
+};
+
+// Short free text kept null terminated in a char array, e.g. the GNS mode
+// letters; longer text is out of range.
+template <typename Message, size_t Size, char (Message::*Member)[Size]>
+struct NmeaText
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    NmeaField field;
+    char *const text = message.*Member;
+    text[0] = '\0';
+    bool const valid =
+        (fields.next(field) || fields.fail(NMEA_PARSE_MISSING_FIELD)) &&
+        (!field.empty() || fields.fail(NMEA_PARSE_EMPTY_FIELD)) &&
+        (field.length() < Size || fields.fail(NMEA_PARSE_OUT_OF_RANGE));
+    if (valid)
+    {
+      memcpy(text, field.begin, field.length());
+      text[field.length()] = '\0';
+    }
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    char const *const text = message.*Member;
+    writer.put(text, strnlen(text, Size));
+  }
+};
+
+// Count fields of IDs, e.g. the GSA satellites, where unused slots are
+// empty. Present IDs are packed to the front of the array.
+template <typename Message, size_t Count, uint16_t (Message::*Member)[Count],
+          uint8_t Message::*Used>
+struct NmeaIdList
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    uint16_t *const ids = message.*Member;
+    uint8_t used = 0U;
+    bool valid = true;
+    for (size_t i = 0U; valid && i < Count; ++i)
+    {
+      int32_t id = 0;
+      bool present = false;
+      valid = fields.read_optional_int(id, 0, UINT16_MAX, present);
+      if (valid && present)
+      {
+        ids[used++] = static_cast<uint16_t>(id);
+      }
+    }
+    message.*Used = used;
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    uint16_t const *const ids = message.*Member;
+    size_t const used = message.*Used < Count ? message.*Used : Count;
+    for (size_t i = 0U; i < Count; ++i)
+    {
+      if (i < used)
+      {
+        writer.put_uint(ids[i], 2U);
+      }
+      if (i + 1U < Count)
+      {
+        writer.put(',');
+      }
+    }
+  }
+};
+
+// A magnitude and a direction letter, e.g. RMC magnetic variation, stored
+// signed with Positive as +. Both fields are empty when the flag is clear.
+template <typename Message, double Message::*Member, bool Message::*Valid,
+          char Positive, char Negative, typename Format>
+struct NmeaOptionalDirectional
+{
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    double magnitude = 0.0;
+    bool present = false;
+    NmeaField direction;
+    bool const valid = fields.read_optional_double(magnitude, present);
+    bool const negative =
+        valid && fields.next(direction) && direction.equals(Negative);
+    message.*Valid = present;
+    message.*Member = negative ? -magnitude : magnitude;
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    if (message.*Valid)
+    {
+      double const value = message.*Member;
+      Format::put(writer, std::fabs(value));
+      writer.put(',');
+      writer.put(std::signbit(value) ? Negative : Positive);
+    }
+    else
+    {
+      writer.put(',');
+    }
+  }
+};
+
+// Fixed text such as a unit ('M') or a tag ("Yaw"); empty for a reserved
+// field. Receivers disagree on these, so parsing only steps over them, and a
+// missing one at the end of a sentence is accepted.
+template <char... Text> struct NmeaLabel
+{
+  template <typename Message>
+  static inline bool parse(NmeaFieldDecoder &fields, Message &)
+  {
+    return fields.skip_optional();
+  }
+
+  template <typename Message>
+  static inline void build(NmeaWriter &writer, Message const &)
+  {
+    static char const text[] = {Text..., '\0'};
+    writer.put(text, sizeof...(Text));
+  }
+};
+
+// Sentences
+
+template <typename... Fields> struct NmeaFieldList;
+
+template <typename Field> struct NmeaFieldList<Field>
+{
+  template <typename Message>
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    return Field::parse(fields, message);
+  }
+
+  template <typename Message>
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    Field::build(writer, message);
+  }
+};
+
+template <typename Field, typename... Rest> struct NmeaFieldList<Field, Rest...>
+{
+  // Every field after the first, for callers that write that one
+  // themselves.
+  typedef NmeaFieldList<Rest...> Tail;
+
+  template <typename Message>
+  static inline bool parse(NmeaFieldDecoder &fields, Message &message)
+  {
+    return Field::parse(fields, message) && Tail::parse(fields, message);
+  }
+
+  template <typename Message>
+  static inline void build(NmeaWriter &writer, Message const &message)
+  {
+    Field::build(writer, message);
+    writer.put(',');
+    Tail::build(writer, message);
+  }
+};
+
+// "*hh\n" over everything between the leading '$' and the '*'.
+inline size_t finish_sentence(NmeaWriter &writer)
+{
+  writer.put('*');
+  size_t const length = writer.length();
+  uint8_t const checksum =
+      2U <= length ? nmea_checksum(writer.data() + 1, length - 2U) : 0U;
+  writer.put_hex_byte(checksum);
+  writer.put('\n');
+  return writer.length();
+}
+
+// header is everything up to and including the first comma, e.g. "$GPVTG,".
+template <typename Schema, typename Message>
+inline size_t build_sentence(char *const buffer, size_t const capacity,
+                             char const *const header,
+                             size_t const header_length,
+                             Message const &message)
+{
+  NmeaWriter writer(buffer, capacity);
+  writer.put(header, header_length);
+  Schema::build(writer, message);
+  return finish_sentence(writer);
+}
+
+#endif // NMEALIB_NMEASCHEMA_HPP
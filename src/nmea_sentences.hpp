@@ -0,0 +1,372 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#ifndef NMEALIB_NMEASENTENCES_HPP
+#define NMEALIB_NMEASENTENCES_HPP
+
+#include "nmea_parser.hpp"
+#include "nmea_schema.hpp"
+
+// Wire layouts shared by the parsers and the builders. The field comments
+// give the text the builders produce.
+
+// build_vtg's ground velocity conversions.
+static double const MPS_TO_KNOTS = 1.94384;
+static double const MPS_TO_KPH = 3.6;
+
+typedef NmeaFieldList<
+    // hhmmss.ss
+    NmeaNumber<AvrMessageData, &AvrMessageData::timestamp, NmeaFixed<2, 9> >,
+    // +ddd.dddd,Yaw
+    NmeaNumber<AvrMessageData, &AvrMessageData::yaw, NmeaSignedFixed<4> >,
+    NmeaLabel<'Y', 'a', 'w'>,
+    NmeaNumber<AvrMessageData, &AvrMessageData::tilt, NmeaSignedFixed<4> >,
+    NmeaLabel<'T', 'i', 'l', 't'>, NmeaLabel<>, NmeaLabel<>,
+    NmeaNumber<AvrMessageData, &AvrMessageData::range, NmeaFixed<3> >,
+    NmeaInteger<AvrMessageData, AvrFixQuality, &AvrMessageData::fixQuality,
+                AVR_INVALID, AVR_DGPS>,
+    NmeaNumber<AvrMessageData, &AvrMessageData::pdop, NmeaFixed<1> >,
+    NmeaInteger<AvrMessageData, uint16_t, &AvrMessageData::numSatellites, 0,
+                UINT16_MAX> >
+    AvrSchema;
+
+// The GGA and VTG fields that change from one sentence to the next, named
+// so the incremental builders format them exactly as the schemas do.
+typedef NmeaAngle<GgaMessageData, &GgaMessageData::latitude, 2U, 'N', 'S'>
+    GgaLatitudeField;
+typedef NmeaAngle<GgaMessageData, &GgaMessageData::longitude, 3U, 'E', 'W'>
+    GgaLongitudeField;
+typedef NmeaInteger<GgaMessageData, GgaFixQuality, &GgaMessageData::fixQuality,
+                    GGA_INVALID, GGA_SIMULATION>
+    GgaFixQualityField;
+typedef NmeaInteger<GgaMessageData, uint16_t, &GgaMessageData::numSatellites,
+                    0, UINT16_MAX>
+    GgaSatellitesField;
+typedef NmeaNumber<GgaMessageData, &GgaMessageData::hdop, NmeaGeneral>
+    GgaHdopField;
+typedef NmeaNumber<GgaMessageData, &GgaMessageData::altitude, NmeaFixed<3, 6> >
+    GgaAltitudeField;
+typedef NmeaNumber<GgaMessageData, &GgaMessageData::geoidHeight, NmeaFixed<1> >
+    GgaGeoidHeightField;
+typedef NmeaNumber<VtgMessageData, &VtgMessageData::trueTrackMadeGood,
+                   NmeaFixed<1, 5> >
+    VtgTrackField;
+typedef NmeaNumber<VtgMessageData, &VtgMessageData::groundSpeedKnots,
+                   NmeaFixed<3> >
+    VtgKnotsField;
+typedef NmeaNumber<VtgMessageData, &VtgMessageData::groundSpeedKph,
+                   NmeaFixed<3> >
+    VtgKphField;
+
+typedef NmeaFieldList<
+    NmeaNumber<GgaMessageData, &GgaMessageData::timestamp, NmeaFixed<2, 9> >,
+    // ddmm.mmmmmmmm,N,dddmm.mmmmmmmm,E
+    GgaLatitudeField, GgaLongitudeField, GgaFixQualityField,
+    GgaSatellitesField, GgaHdopField,
+    // altitude and geoid height in meters
+    GgaAltitudeField, NmeaLabel<'M'>, GgaGeoidHeightField, NmeaLabel<'M'>,
+    // DGPS age and station ID, empty without DGPS
+    NmeaOptionalNumber<GgaMessageData, &GgaMessageData::timeSinceLastDgps,
+                       &GgaMessageData::timeSinceLastDgpsValid, NmeaFixed<1> >,
+    NmeaOptionalInteger<GgaMessageData, uint16_t,
+                        &GgaMessageData::dgpdStationID,
+                        &GgaMessageData::dgpdStationIDValid, 0, UINT16_MAX,
+                        4U> >
+    GgaSchema;
+
+typedef NmeaFieldList<
+    // ddd.d,T,ddd.d,M
+    VtgTrackField, NmeaLabel<'T'>,
+    NmeaOptionalNumber<VtgMessageData, &VtgMessageData::magneticTrackMadeGood,
+                       &VtgMessageData::magneticTrackMadeGoodValid,
+                       NmeaFixed<1, 5> >,
+    NmeaLabel<'M'>,
+    // speed in knots and kph
+    VtgKnotsField, NmeaLabel<'N'>, VtgKphField, NmeaLabel<'K'> >
+    VtgSchema;
+
+typedef NmeaFieldList<
+    NmeaNumber<RmcMessageData, &RmcMessageData::timestamp, NmeaFixed<2, 9> >,
+    NmeaCharacter<RmcMessageData, &RmcMessageData::status>,
+    NmeaAngle<RmcMessageData, &RmcMessageData::latitude, 2U, 'N', 'S'>,
+    NmeaAngle<RmcMessageData, &RmcMessageData::longitude, 3U, 'E', 'W'>,
+    NmeaNumber<RmcMessageData, &RmcMessageData::speedKnots, NmeaFixed<3> >,
+    NmeaOptionalNumber<RmcMessageData, &RmcMessageData::trackMadeGood,
+                       &RmcMessageData::trackMadeGoodValid, NmeaFixed<1, 5> >,
+    // ddmmyy
+    NmeaInteger<RmcMessageData, uint32_t, &RmcMessageData::date, 0, 311299,
+                6U>,
+    NmeaOptionalDirectional<RmcMessageData, &RmcMessageData::magneticVariation,
+                            &RmcMessageData::magneticVariationValid, 'E', 'W',
+                            NmeaFixed<1> >,
+    NmeaOptionalCharacter<RmcMessageData, &RmcMessageData::modeIndicator> >
+    RmcSchema;
+
+typedef NmeaFieldList<
+    NmeaCharacter<GsaMessageData, &GsaMessageData::selectionMode>,
+    NmeaInteger<GsaMessageData, uint8_t, &GsaMessageData::fixType, 1, 3>,
+    NmeaIdList<GsaMessageData, NMEA_GSA_MAX_SATELLITES,
+               &GsaMessageData::satelliteIds, &GsaMessageData::numSatellites>,
+    NmeaNumber<GsaMessageData, &GsaMessageData::pdop, NmeaFixed<2> >,
+    NmeaNumber<GsaMessageData, &GsaMessageData::hdop, NmeaFixed<2> >,
+    NmeaNumber<GsaMessageData, &GsaMessageData::vdop, NmeaFixed<2> >,
+    NmeaOptionalInteger<GsaMessageData, uint8_t, &GsaMessageData::systemId,
+                        &GsaMessageData::systemIdValid, 0, 15> >
+    GsaSchema;
+
+// Up to four "id,elevation,azimuth,snr" blocks, then the single signal ID
+// field of NMEA 4.10. Blocks with an empty ID pad out the last sentence of a
+// group and are dropped. Nothing at all is written for a sentence without
+// satellites, so build supplies the commas before each block.
+struct GsvSatellitesField
+{
+  static inline bool parse_optional(NmeaFieldDecoder &fields,
+                                    int32_t const minimum,
+                                    int32_t const maximum, bool &present,
+                                    int32_t &value)
+  {
+    NmeaField field;
+    bool const available =
+        fields.next(field) || fields.fail(NMEA_PARSE_MISSING_FIELD);
+    present = available && !field.empty();
+    return available &&
+           (!present ||
+            ((parse_field_int(field, value) ||
+              fields.fail(NMEA_PARSE_BAD_NUMBER)) &&
+             fields.in_range(value, minimum, maximum)));
+  }
+
+  // The ID and elevation fields are read by the caller, which needs the
+  // second one to tell a satellite from the trailing signal ID.
+  static inline bool parse_satellite(NmeaFieldDecoder &fields,
+                                     NmeaField const &id_field,
+                                     NmeaField const &elevation_field,
+                                     GsvSatellite &satellite)
+  {
+    int32_t id = 0;
+    int32_t elevation = 0;
+    int32_t azimuth = 0;
+    int32_t snr = 0;
+    uint8_t const elevation_index = fields.index();
+    satellite.elevationValid = !elevation_field.empty();
+    bool const valid =
+        ((parse_field_int(id_field, id) && 0 <= id && UINT16_MAX >= id) ||
+         fields.fail_at(NMEA_PARSE_BAD_NUMBER,
+                        static_cast<uint8_t>(elevation_index - 1U))) &&
+        (!satellite.elevationValid ||
+         ((parse_field_int(elevation_field, elevation) ||
+           fields.fail(NMEA_PARSE_BAD_NUMBER)) &&
+          fields.in_range(elevation, -90, 90))) &&
+        parse_optional(fields, 0, 360, satellite.azimuthValid, azimuth) &&
+        parse_optional(fields, 0, 99, satellite.snrValid, snr);
+    satellite.id = static_cast<uint16_t>(id);
+    satellite.elevation = static_cast<int8_t>(elevation);
+    satellite.azimuth = static_cast<uint16_t>(azimuth);
+    satellite.snr = static_cast<uint8_t>(snr);
+    return valid;
+  }
+
+  static inline bool parse_signal_id(NmeaFieldDecoder &fields,
+                                     NmeaField const &field,
+                                     GsvMessageData &message)
+  {
+    char const digit = field.empty() ? '\0' : *field.begin;
+    bool const decimal = '0' <= digit && '9' >= digit;
+    bool const hex = 'A' <= digit && 'F' >= digit;
+    message.signalIdValid = !field.empty();
+    message.signalId = static_cast<uint8_t>(
+        decimal ? digit - '0' : (hex ? digit - 'A' + 10 : 0));
+    return field.empty() || (1U == field.length() && (decimal || hex)) ||
+           fields.fail(NMEA_PARSE_BAD_NUMBER);
+  }
+
+  static inline bool parse(NmeaFieldDecoder &fields, GsvMessageData &message)
+  {
+    bool valid = true;
+    bool more = true;
+    message.numSatellites = 0U;
+    message.signalIdValid = false;
+    for (size_t block = 0U;
+         valid && more && block < NMEA_GSV_SATELLITES_PER_SENTENCE; ++block)
+    {
+      NmeaField id;
+      NmeaField elevation;
+      more = fields.next(id);
+      if (more && !fields.next(elevation))
+      {
+        valid = parse_signal_id(fields, id, message);
+        more = false;
+      }
+      else if (more && id.empty())
+      {
+        // padding block
+        valid = fields.next(elevation) && fields.next(elevation);
+        valid = valid || fields.fail(NMEA_PARSE_MISSING_FIELD);
+      }
+      else if (more)
+      {
+        valid = parse_satellite(fields, id, elevation,
+                                message.satellites[message.numSatellites]);
+        ++message.numSatellites;
+      }
+    }
+    NmeaField signal_id;
+    if (valid && more && fields.next(signal_id))
+    {
+      valid = parse_signal_id(fields, signal_id, message);
+    }
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, GsvMessageData const &message)
+  {
+    size_t const count =
+        message.numSatellites < NMEA_GSV_SATELLITES_PER_SENTENCE
+            ? message.numSatellites
+            : NMEA_GSV_SATELLITES_PER_SENTENCE;
+    for (size_t i = 0U; i < count; ++i)
+    {
+      GsvSatellite const &satellite = message.satellites[i];
+      writer.put(',');
+      writer.put_uint(satellite.id, 2U);
+      writer.put(',');
+      if (satellite.elevationValid)
+      {
+        if (0 > satellite.elevation)
+        {
+          writer.put('-');
+        }
+        writer.put_uint(static_cast<uint32_t>(std::abs(satellite.elevation)),
+                        2U);
+      }
+      writer.put(',');
+      if (satellite.azimuthValid)
+      {
+        writer.put_uint(satellite.azimuth, 3U);
+      }
+      writer.put(',');
+      if (satellite.snrValid)
+      {
+        writer.put_uint(satellite.snr, 2U);
+      }
+    }
+    if (message.signalIdValid)
+    {
+      uint8_t const digit = message.signalId & 0x0FU;
+      writer.put(',');
+      writer.put(
+          static_cast<char>(10U > digit ? '0' + digit : 'A' + digit - 10));
+    }
+  }
+};
+
+struct GsvSchema
+{
+  typedef NmeaFieldList<
+      NmeaInteger<GsvMessageData, uint8_t, &GsvMessageData::totalMessages, 1,
+                  9>,
+      NmeaInteger<GsvMessageData, uint8_t, &GsvMessageData::messageNumber, 1,
+                  9>,
+      NmeaInteger<GsvMessageData, uint16_t,
+                  &GsvMessageData::satellitesInView, 0, UINT16_MAX, 2U> >
+      Counts;
+
+  static inline bool parse(NmeaFieldDecoder &fields, GsvMessageData &message)
+  {
+    return Counts::parse(fields, message) &&
+           GsvSatellitesField::parse(fields, message);
+  }
+
+  static inline void build(NmeaWriter &writer, GsvMessageData const &message)
+  {
+    Counts::build(writer, message);
+    GsvSatellitesField::build(writer, message);
+  }
+};
+
+typedef NmeaFieldList<
+    NmeaNumber<GstMessageData, &GstMessageData::timestamp, NmeaFixed<2, 9> >,
+    // meters, except the orientation in degrees from true north
+    NmeaNumber<GstMessageData, &GstMessageData::rangeRms, NmeaFixed<3> >,
+    NmeaNumber<GstMessageData, &GstMessageData::semiMajorSigma, NmeaFixed<3> >,
+    NmeaNumber<GstMessageData, &GstMessageData::semiMinorSigma, NmeaFixed<3> >,
+    NmeaNumber<GstMessageData, &GstMessageData::semiMajorOrientation,
+               NmeaFixed<1> >,
+    NmeaNumber<GstMessageData, &GstMessageData::latitudeSigma, NmeaFixed<3> >,
+    NmeaNumber<GstMessageData, &GstMessageData::longitudeSigma, NmeaFixed<3> >,
+    NmeaNumber<GstMessageData, &GstMessageData::altitudeSigma, NmeaFixed<3> > >
+    GstSchema;
+
+// "+hh,mm" local zone; both fields are empty when the flag is clear.
+struct ZdaLocalZoneField
+{
+  static inline bool parse(NmeaFieldDecoder &fields, ZdaMessageData &message)
+  {
+    int32_t hours = 0;
+    int32_t minutes = 0;
+    bool hours_present = false;
+    bool minutes_present = false;
+    bool const valid =
+        fields.read_optional_int(hours, -13, 13, hours_present) &&
+        fields.read_optional_int(minutes, 0, 59, minutes_present);
+    message.localZoneValid = valid && hours_present;
+    message.localZoneHours = static_cast<int8_t>(hours);
+    message.localZoneMinutes = static_cast<uint8_t>(minutes);
+    return valid;
+  }
+
+  static inline void build(NmeaWriter &writer, ZdaMessageData const &message)
+  {
+    if (message.localZoneValid)
+    {
+      if (0 > message.localZoneHours)
+      {
+        writer.put('-');
+      }
+      writer.put_uint(
+          static_cast<uint32_t>(std::abs(message.localZoneHours)), 2U);
+      writer.put(',');
+      writer.put_uint(message.localZoneMinutes, 2U);
+    }
+    else
+    {
+      writer.put(',');
+    }
+  }
+};
+
+typedef NmeaFieldList<
+    NmeaNumber<ZdaMessageData, &ZdaMessageData::timestamp, NmeaFixed<2, 9> >,
+    // dd,mm,yyyy
+    NmeaInteger<ZdaMessageData, uint8_t, &ZdaMessageData::day, 1, 31, 2U>,
+    NmeaInteger<ZdaMessageData, uint8_t, &ZdaMessageData::month, 1, 12, 2U>,
+    NmeaInteger<ZdaMessageData, uint16_t, &ZdaMessageData::year, 0, 9999, 4U>,
+    ZdaLocalZoneField>
+    ZdaSchema;
+
+typedef NmeaFieldList<
+    NmeaNumber<HdtMessageData, &HdtMessageData::heading, NmeaFixed<3> >,
+    NmeaLabel<'T'> >
+    HdtSchema;
+
+typedef NmeaFieldList<
+    NmeaNumber<GnsMessageData, &GnsMessageData::timestamp, NmeaFixed<2, 9> >,
+    NmeaAngle<GnsMessageData, &GnsMessageData::latitude, 2U, 'N', 'S'>,
+    NmeaAngle<GnsMessageData, &GnsMessageData::longitude, 3U, 'E', 'W'>,
+    // one letter per constellation, e.g. "AAN"
+    NmeaText<GnsMessageData, NMEA_GNS_MAX_MODES + 1U,
+             &GnsMessageData::modeIndicator>,
+    NmeaInteger<GnsMessageData, uint16_t, &GnsMessageData::numSatellites, 0,
+                UINT16_MAX, 2U>,
+    NmeaNumber<GnsMessageData, &GnsMessageData::hdop, NmeaGeneral>,
+    NmeaNumber<GnsMessageData, &GnsMessageData::altitude, NmeaFixed<3> >,
+    NmeaNumber<GnsMessageData, &GnsMessageData::geoidHeight, NmeaFixed<2> >,
+    NmeaOptionalNumber<GnsMessageData, &GnsMessageData::timeSinceLastDgps,
+                       &GnsMessageData::timeSinceLastDgpsValid, NmeaFixed<1> >,
+    NmeaOptionalInteger<GnsMessageData, uint16_t,
+                        &GnsMessageData::dgpsStationID,
+                        &GnsMessageData::dgpsStationIDValid, 0, 1023, 4U>,
+    NmeaOptionalCharacter<GnsMessageData,
+                          &GnsMessageData::navigationalStatus> >
+    GnsSchema;
+
+#endif // NMEALIB_NMEASENTENCES_HPP
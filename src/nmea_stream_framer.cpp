@@ -0,0 +1,143 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cassert>
+#include <cstring>
+#include "nmea_stream_framer.hpp"
+
+static char const *find_sentence_stop(char const *position,
+                                      char const *const end)
+{
+  while (position != end && '\r' != *position && '\n' != *position &&
+         '$' != *position)
+  {
+    ++position;
+  }
+  return position;
+}
+
+NmeaStreamFramer::NmeaStreamFramer(size_t const capacity)
+    : carry_(capacity)
+    , carryLength_(0U)
+    , cursor_(nullptr)
+    , end_(nullptr)
+    , segment_(nullptr)
+    , inSentence_(false)
+    , sentences_(0U)
+    , discardedBytes_(0U)
+    , overflows_(0U)
+    , truncated_(0U)
+{
+}
+
+void NmeaStreamFramer::push(char const *const data, size_t const length)
+{
+  // The rest of the last chunk would be lost, and with it the start of a
+  // sentence the carry buffer has not taken yet.
+  assert(cursor_ == end_);
+  cursor_ = data;
+  end_ = data + length;
+  segment_ = data;
+}
+
+void NmeaStreamFramer::reset()
+{
+  carryLength_ = 0U;
+  cursor_ = nullptr;
+  end_ = nullptr;
+  segment_ = nullptr;
+  inSentence_ = false;
+}
+
+bool NmeaStreamFramer::append_to_carry(char const *const begin,
+                                       char const *const end)
+{
+  size_t const length = static_cast<size_t>(end - begin);
+  bool const fits = carryLength_ + length <= carry_.size();
+  if (fits)
+  {
+    memcpy(carry_.data() + carryLength_, begin, length);
+    carryLength_ += length;
+  }
+  return fits;
+}
+
+void NmeaStreamFramer::drop_sentence(char const *const resume)
+{
+  discardedBytes_ += carryLength_ + static_cast<size_t>(resume - segment_);
+  carryLength_ = 0U;
+  inSentence_ = false;
+  cursor_ = resume;
+}
+
+bool NmeaStreamFramer::next(NmeaSentence &sentence)
+{
+  bool found = false;
+  while (!found && cursor_ != end_)
+  {
+    if (!inSentence_)
+    {
+      while (cursor_ != end_ && ('\r' == *cursor_ || '\n' == *cursor_))
+      {
+        ++cursor_;
+      }
+      char const *const start = static_cast<char const *>(
+          memchr(cursor_, '$', static_cast<size_t>(end_ - cursor_)));
+      char const *const resume = nullptr == start ? end_ : start;
+      discardedBytes_ += static_cast<size_t>(resume - cursor_);
+      cursor_ = resume;
+      if (nullptr != start)
+      {
+        inSentence_ = true;
+        segment_ = start;
+        carryLength_ = 0U;
+        ++cursor_;
+        if (cursor_ == end_)
+        {
+          append_to_carry(segment_, end_);
+        }
+      }
+    }
+    else
+    {
+      char const *const stop = find_sentence_stop(cursor_, end_);
+      size_t const length =
+          carryLength_ + static_cast<size_t>(stop - segment_);
+      if (length > carry_.size())
+      {
+        // Longer than any sentence we are willing to hold; resync on the
+        // next '$'.
+        ++overflows_;
+        drop_sentence(stop);
+      }
+      else if (stop == end_)
+      {
+        append_to_carry(segment_, stop);
+        cursor_ = stop;
+      }
+      else if ('$' == *stop)
+      {
+        ++truncated_;
+        drop_sentence(stop);
+      }
+      else
+      {
+        if (0U == carryLength_)
+        {
+          sentence.data = segment_;
+        }
+        else
+        {
+          append_to_carry(segment_, stop);
+          sentence.data = carry_.data();
+        }
+        sentence.length = length;
+        carryLength_ = 0U;
+        inSentence_ = false;
+        cursor_ = stop + 1;
+        ++sentences_;
+        found = true;
+      }
+    }
+  }
+  return found;
+}
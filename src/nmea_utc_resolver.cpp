@@ -0,0 +1,299 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cmath>
+#include "nmea_utc_resolver.hpp"
+
+static int64_t const HOUR_NS = 3600000000000LL;
+static int64_t const MINUTE_NS = 60000000000LL;
+static int64_t const SECOND_NS = 1000000000LL;
+static int64_t const MS_NS = 1000000LL;
+static size_t const MAX_DECIMALS = 9U;
+// ns in a unit of the last of so many decimals.
+static int64_t const DECIMAL_SCALES[MAX_DECIMALS + 1U] = {
+    1000000000LL, 100000000LL, 10000000LL, 1000000LL, 100000LL,
+    10000LL,      1000LL,      100LL,      10LL,      1LL};
+// RMC's two digit years below this are 20yy, the rest 19yy.
+static uint32_t const RMC_CENTURY_PIVOT = 80U;
+
+static inline bool is_digit(char const c)
+{
+  return '0' <= c && '9' >= c;
+}
+
+static inline uint32_t two_digits(char const *const text)
+{
+  return static_cast<uint32_t>(text[0] - '0') * 10U +
+         static_cast<uint32_t>(text[1] - '0');
+}
+
+// hhmmss.ss in units of a second, which hhmmss.ss * units_per_second rounds
+// to; the division constants fold where units_per_second is a literal.
+static inline bool time_of_day_units(double const timestamp,
+                                     int64_t const units_per_second,
+                                     int64_t &units)
+{
+  bool valid = 0.0 <= timestamp && 240000.0 > timestamp;
+  if (valid)
+  {
+    int64_t const digits =
+        std::llround(timestamp * static_cast<double>(units_per_second));
+    int64_t const hours = digits / (10000 * units_per_second);
+    int64_t const minutes = digits / (100 * units_per_second) % 100;
+    int64_t const seconds = digits % (100 * units_per_second);
+    valid = 24 > hours && 60 > minutes && 60 * units_per_second > seconds;
+    units = (hours * 3600 + minutes * 60) * units_per_second + seconds;
+  }
+  return valid;
+}
+
+bool nmea_time_of_day_ns(double const timestamp, int64_t &time_ns)
+{
+  int64_t time_us = 0;
+  bool const valid = time_of_day_units(timestamp, 1000000, time_us);
+  time_ns = valid ? time_us * 1000 : time_ns;
+  return valid;
+}
+
+bool nmea_time_of_day_ms(double const timestamp, uint32_t &time_ms)
+{
+  int64_t units = 0;
+  bool const valid = time_of_day_units(timestamp, 1000, units);
+  time_ms = valid ? static_cast<uint32_t>(units) : time_ms;
+  return valid;
+}
+
+bool nmea_time_of_day_ns(char const *const text, size_t const length,
+                         int64_t &time_ns)
+{
+  bool valid = 6U <= length && is_digit(text[0]) && is_digit(text[1]) &&
+               is_digit(text[2]) && is_digit(text[3]) && is_digit(text[4]) &&
+               is_digit(text[5]) && (6U == length || '.' == text[6]);
+  size_t const decimals = 7U < length ? length - 7U : 0U;
+  size_t const used = MAX_DECIMALS < decimals ? MAX_DECIMALS : decimals;
+  int64_t fraction = 0;
+  for (size_t i = 7U; valid && i < length; ++i)
+  {
+    valid = is_digit(text[i]);
+    fraction = used + 7U > i ? fraction * 10 + (text[i] - '0') : fraction;
+  }
+  fraction *= DECIMAL_SCALES[used];
+  if (valid)
+  {
+    uint32_t const hours = two_digits(text);
+    uint32_t const minutes = two_digits(text + 2);
+    uint32_t const seconds = two_digits(text + 4);
+    valid = 24U > hours && 60U > minutes && 60U > seconds;
+    time_ns = static_cast<int64_t>(hours) * HOUR_NS +
+              static_cast<int64_t>(minutes) * MINUTE_NS +
+              static_cast<int64_t>(seconds) * SECOND_NS + fraction;
+  }
+  return valid;
+}
+
+bool nmea_days_since_epoch(int32_t const year, uint32_t const month,
+                           uint32_t const day, int64_t &days)
+{
+  static uint32_t const MONTH_DAYS[12] = {31U, 28U, 31U, 30U, 31U, 30U,
+                                          31U, 31U, 30U, 31U, 30U, 31U};
+  bool const leap = (0 == year % 4 && 0 != year % 100) || 0 == year % 400;
+  bool const valid =
+      1U <= month && 12U >= month && 1U <= day &&
+      (MONTH_DAYS[month - 1U] >= day || (2U == month && leap && 29U == day));
+  if (valid)
+  {
+    // Counted from March so the leap day ends the year; see Hinnant's
+    // days_from_civil.
+    int64_t const y = static_cast<int64_t>(year) - (2U >= month ? 1 : 0);
+    int64_t const era = (0 <= y ? y : y - 399) / 400;
+    int64_t const year_of_era = y - era * 400;
+    int64_t const day_of_year =
+        (153 * (static_cast<int64_t>(month) + (2U < month ? -3 : 9)) + 2) / 5 +
+        static_cast<int64_t>(day) - 1;
+    int64_t const day_of_era = year_of_era * 365 + year_of_era / 4 -
+                               year_of_era / 100 + day_of_year;
+    days = era * 146097 + day_of_era - 719468;
+  }
+  return valid;
+}
+
+NmeaUtcResolver::NmeaUtcResolver(NmeaUtcResolverConfig const &config)
+    : config_(config)
+    , windowNs_(static_cast<int64_t>(config.lateWindowMs) * MS_NS)
+{
+  if (NMEA_DAY_NS / 2 < windowNs_)
+  {
+    windowNs_ = NMEA_DAY_NS / 2;
+  }
+  reset();
+}
+
+void NmeaUtcResolver::reset()
+{
+  dayStart_ = 0;
+  latest_ = NMEA_NO_TIME;
+  dated_ = false;
+  rollovers_ = 0U;
+  lateTimes_ = 0U;
+  invalidTimes_ = 0U;
+}
+
+int64_t NmeaUtcResolver::place(int64_t const time_ns)
+{
+  int64_t time = dayStart_ + time_ns;
+  if (NMEA_NO_TIME == latest_)
+  {
+    latest_ = time;
+  }
+  else
+  {
+    // The time goes in [earliest, earliest + one day).
+    int64_t const earliest = latest_ - windowNs_;
+    if (earliest > time)
+    {
+      dayStart_ += NMEA_DAY_NS;
+      time += NMEA_DAY_NS;
+      latest_ = time;
+      ++rollovers_;
+    }
+    else if (earliest + NMEA_DAY_NS <= time)
+    {
+      time -= NMEA_DAY_NS;
+      ++lateTimes_;
+    }
+    else if (latest_ < time)
+    {
+      latest_ = time;
+    }
+  }
+  return time;
+}
+
+int64_t NmeaUtcResolver::anchor(int64_t const days, int64_t const time_ns)
+{
+  // A date is the truth, even if it moves the latest time back.
+  dayStart_ = days * NMEA_DAY_NS;
+  latest_ = dayStart_ + time_ns;
+  dated_ = true;
+  return latest_;
+}
+
+int64_t NmeaUtcResolver::resolve(double const timestamp)
+{
+  int64_t time_ns = 0;
+  int64_t time = NMEA_NO_TIME;
+  if (nmea_time_of_day_ns(timestamp, time_ns))
+  {
+    time = place(time_ns);
+  }
+  else
+  {
+    ++invalidTimes_;
+  }
+  return time;
+}
+
+int64_t NmeaUtcResolver::resolve(char const *const text, size_t const length)
+{
+  int64_t time_ns = 0;
+  int64_t time = NMEA_NO_TIME;
+  if (nmea_time_of_day_ns(text, length, time_ns))
+  {
+    time = place(time_ns);
+  }
+  else
+  {
+    ++invalidTimes_;
+  }
+  return time;
+}
+
+int64_t NmeaUtcResolver::resolve(NmeaMessage const &message)
+{
+  int64_t time = NMEA_NO_TIME;
+  int64_t days = 0;
+  int64_t time_ns = 0;
+  switch (message.type)
+  {
+  case NMEA_GGA:
+    time = message.gga.valid ? resolve(message.gga.timestamp) : NMEA_NO_TIME;
+    break;
+  case NMEA_AVR:
+    time = message.avr.valid ? resolve(message.avr.timestamp) : NMEA_NO_TIME;
+    break;
+  case NMEA_GST:
+    time = message.gst.valid ? resolve(message.gst.timestamp) : NMEA_NO_TIME;
+    break;
+  case NMEA_GNS:
+    time = message.gns.valid ? resolve(message.gns.timestamp) : NMEA_NO_TIME;
+    break;
+  case NMEA_ZDA:
+    if (message.zda.valid)
+    {
+      time = config_.useMessageDates &&
+                     nmea_days_since_epoch(message.zda.year, message.zda.month,
+                                           message.zda.day, days) &&
+                     nmea_time_of_day_ns(message.zda.timestamp, time_ns)
+                 ? anchor(days, time_ns)
+                 : resolve(message.zda.timestamp);
+    }
+    break;
+  case NMEA_RMC:
+    if (message.rmc.valid)
+    {
+      uint32_t const year = message.rmc.date % 100U;
+      time = config_.useMessageDates &&
+                     nmea_days_since_epoch(
+                         static_cast<int32_t>(
+                             year + (RMC_CENTURY_PIVOT > year ? 2000U : 1900U)),
+                         message.rmc.date / 100U % 100U,
+                         message.rmc.date / 10000U, days) &&
+                     nmea_time_of_day_ns(message.rmc.timestamp, time_ns)
+                 ? anchor(days, time_ns)
+                 : resolve(message.rmc.timestamp);
+    }
+    break;
+  default:
+    break;
+  }
+  return time;
+}
+
+size_t NmeaUtcResolver::resolve(double const *const timestamps,
+                                size_t const count, int64_t *const times)
+{
+  size_t resolved = 0U;
+  for (size_t i = 0U; i < count; ++i)
+  {
+    times[i] = resolve(timestamps[i]);
+    resolved += NMEA_NO_TIME != times[i] ? 1U : 0U;
+  }
+  return resolved;
+}
+
+size_t NmeaUtcResolver::resolve(NmeaMessage const *const messages,
+                                size_t const count, int64_t *const times)
+{
+  size_t resolved = 0U;
+  for (size_t i = 0U; i < count; ++i)
+  {
+    times[i] = resolve(messages[i]);
+    resolved += NMEA_NO_TIME != times[i] ? 1U : 0U;
+  }
+  return resolved;
+}
+
+bool NmeaUtcResolver::set_date(int32_t const year, uint32_t const month,
+                               uint32_t const day)
+{
+  int64_t days = 0;
+  bool const valid = nmea_days_since_epoch(year, month, day, days);
+  if (valid)
+  {
+    int64_t const day_start = days * NMEA_DAY_NS;
+    latest_ = NMEA_NO_TIME == latest_ ? latest_
+                                      : latest_ - dayStart_ + day_start;
+    dayStart_ = day_start;
+    dated_ = true;
+  }
+  return valid;
+}
@@ -0,0 +1,414 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include <cstdint>
+#include "nmea_checksum.hpp"
+#include "nmea_fields.hpp"
+#include "nmea_view.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static size_t const STANDARD_HEADER_LENGTH = 7U;
+static size_t const PROPRIETARY_HEADER_LENGTH = 10U;
+static size_t const MAX_VIEW_LENGTH = UINT16_MAX;
+
+// Fields up to where eager parsing stops needing them: the geoid height for
+// GGA, the speed in kph for VTG and the satellite count for AVR.
+static size_t const GGA_REQUIRED_FIELDS = 11U;
+static size_t const VTG_REQUIRED_FIELDS = 7U;
+static size_t const AVR_REQUIRED_FIELDS = 11U;
+
+enum GgaField
+{
+  GGA_TIMESTAMP = 0,
+  GGA_LATITUDE = 1,
+  GGA_LONGITUDE = 3,
+  GGA_FIX_QUALITY = 5,
+  GGA_NUM_SATELLITES = 6,
+  GGA_HDOP = 7,
+  GGA_ALTITUDE = 8,
+  GGA_GEOID_HEIGHT = 10,
+  GGA_DGPS_AGE = 12,
+  GGA_DGPS_STATION = 13
+};
+
+enum VtgField
+{
+  VTG_TRUE_TRACK = 0,
+  VTG_MAGNETIC_TRACK = 2,
+  VTG_SPEED_KNOTS = 4,
+  VTG_SPEED_KPH = 6
+};
+
+enum AvrField
+{
+  AVR_TIMESTAMP = 0,
+  AVR_YAW = 1,
+  AVR_TILT = 3,
+  AVR_RANGE = 7,
+  AVR_FIX_QUALITY = 8,
+  AVR_PDOP = 9,
+  AVR_NUM_SATELLITES = 10
+};
+
+static inline bool is_terminator(char const c)
+{
+  return '*' == c || '\r' == c || '\n' == c;
+}
+
+// Records where each field of the body starts, as NmeaFieldReader would
+// split it, and returns how many there are. The body ends at the first
+// terminator, or at the separator after the last field that fits.
+static size_t scan_fields(char const *const body, size_t const length,
+                          uint16_t *const starts, size_t const max_fields,
+                          uint16_t &last_end)
+{
+  size_t count = 1U;
+  size_t end = length;
+  bool done = false;
+  size_t i = 0U;
+  starts[0] = 0U;
+#if defined(__SSE2__)
+  __m128i const comma = _mm_set1_epi8(',');
+  __m128i const star = _mm_set1_epi8('*');
+  __m128i const carriage_return = _mm_set1_epi8('\r');
+  __m128i const line_feed = _mm_set1_epi8('\n');
+  for (; !done && i + 16U <= length; i += 16U)
+  {
+    __m128i const chunk =
+        _mm_loadu_si128(reinterpret_cast<__m128i const *>(body + i));
+    unsigned commas =
+        static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, comma)));
+    unsigned const stops = static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, star),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, carriage_return),
+                                  _mm_cmpeq_epi8(chunk, line_feed)))));
+    if (0U != stops)
+    {
+      unsigned const first = static_cast<unsigned>(__builtin_ctz(stops));
+      commas &= (1U << first) - 1U;
+      end = i + first;
+      done = true;
+    }
+    while (0U != commas)
+    {
+      size_t const separator =
+          i + static_cast<size_t>(__builtin_ctz(commas));
+      if (max_fields == count)
+      {
+        end = separator;
+        done = true;
+        commas = 0U;
+      }
+      else
+      {
+        starts[count++] = static_cast<uint16_t>(separator + 1U);
+        commas &= commas - 1U;
+      }
+    }
+  }
+#endif
+  for (; !done && i < length; ++i)
+  {
+    if (is_terminator(body[i]) || (',' == body[i] && max_fields == count))
+    {
+      end = i;
+      done = true;
+    }
+    else if (',' == body[i])
+    {
+      starts[count++] = static_cast<uint16_t>(i + 1U);
+    }
+  }
+  last_end = static_cast<uint16_t>(end);
+  return count;
+}
+
+NmeaSentenceView::NmeaSentenceView(char const *const message,
+                                   size_t const length,
+                                   NmeaChecksumMode const checksum_mode,
+                                   NmeaMessageType const type,
+                                   size_t const required_fields)
+    : body_(message)
+    , ok_(false)
+    , count_(0U)
+    , decoded_(0U)
+    , valid_(0U)
+    , present_(0U)
+{
+  if (MAX_VIEW_LENGTH >= length && type == identify_nmea(message, length) &&
+      (NMEA_SKIP_CHECKSUM == checksum_mode ||
+       nmea_checksum_valid(message, length)))
+  {
+    size_t const header = NMEA_AVR == type ? PROPRIETARY_HEADER_LENGTH
+                                           : STANDARD_HEADER_LENGTH;
+    body_ = message + header;
+    count_ = static_cast<uint8_t>(scan_fields(
+        body_, length - header, starts_, MAX_FIELDS, starts_[MAX_FIELDS]));
+    // The end of the last field goes after the start of the others.
+    starts_[count_] = starts_[MAX_FIELDS];
+    ok_ = required_fields <= count_;
+  }
+}
+
+bool NmeaSentenceView::decode(size_t const field, Kind const kind,
+                              int32_t const minimum, int32_t const maximum,
+                              char const positive) const
+{
+  uint16_t const bit = static_cast<uint16_t>(1U << field);
+  if (0U == (decoded_ & bit))
+  {
+    bool present = false;
+    bool valid = false;
+    double value = 0.0;
+    if (ok_ && field < count_)
+    {
+      // Every field but the last ends one before the next one starts.
+      NmeaField const text(body_ + starts_[field],
+                           body_ + starts_[field + 1U] -
+                               (field + 1U < count_ ? 1 : 0));
+      present = !text.empty();
+      int32_t integer = 0;
+      switch (kind)
+      {
+      case NUMBER:
+        valid = present && parse_field_double(text, value);
+        break;
+      case INTEGER:
+        valid = present && parse_field_int(text, integer) &&
+                minimum <= integer && maximum >= integer;
+        value = integer;
+        break;
+      case ANGLE:
+        if (present && field + 1U < count_)
+        {
+          NmeaField const hemisphere(
+              body_ + starts_[field + 1U],
+              body_ + starts_[field + 2U] - (field + 2U < count_ ? 1 : 0));
+          double sign = 0.0;
+          valid = parse_field_degrees_minutes(text, value) &&
+                  !hemisphere.empty() &&
+                  parse_field_hemisphere(hemisphere, positive, sign);
+          value *= sign;
+        }
+        break;
+      }
+    }
+    decoded_ |= bit;
+    valid_ |= valid ? bit : 0U;
+    present_ |= present ? bit : 0U;
+    values_[field] = value;
+  }
+  return 0U != (valid_ & bit);
+}
+
+bool NmeaSentenceView::number(size_t const field, double &value) const
+{
+  bool const valid = decode(field, NUMBER, 0, 0, '\0');
+  value = valid ? values_[field] : value;
+  return valid;
+}
+
+bool NmeaSentenceView::optional_number(size_t const field, double &value,
+                                       bool &present) const
+{
+  bool const valid = decode(field, NUMBER, 0, 0, '\0');
+  present = 0U != (present_ & (1U << field));
+  value = valid ? values_[field] : value;
+  return ok_ && (valid || !present);
+}
+
+bool NmeaSentenceView::integer(size_t const field, int32_t const minimum,
+                               int32_t const maximum, int32_t &value) const
+{
+  bool const valid = decode(field, INTEGER, minimum, maximum, '\0');
+  value = valid ? static_cast<int32_t>(values_[field]) : value;
+  return valid;
+}
+
+bool NmeaSentenceView::optional_integer(size_t const field,
+                                        int32_t const minimum,
+                                        int32_t const maximum, int32_t &value,
+                                        bool &present) const
+{
+  bool const valid = decode(field, INTEGER, minimum, maximum, '\0');
+  present = 0U != (present_ & (1U << field));
+  value = valid ? static_cast<int32_t>(values_[field]) : value;
+  return ok_ && (valid || !present);
+}
+
+bool NmeaSentenceView::angle(size_t const field, char const positive,
+                             double &value) const
+{
+  bool const valid = decode(field, ANGLE, 0, 0, positive);
+  value = valid ? values_[field] : value;
+  return valid;
+}
+
+GgaView::GgaView(char const *const message, size_t const length,
+                 NmeaChecksumMode const checksum_mode)
+    : NmeaSentenceView(message, length, checksum_mode, NMEA_GGA,
+                       GGA_REQUIRED_FIELDS)
+{
+}
+
+bool GgaView::timestamp(double &value) const
+{
+  return number(GGA_TIMESTAMP, value);
+}
+
+bool GgaView::latitude(double &value) const
+{
+  return angle(GGA_LATITUDE, 'N', value);
+}
+
+bool GgaView::longitude(double &value) const
+{
+  return angle(GGA_LONGITUDE, 'E', value);
+}
+
+bool GgaView::fix_quality(GgaFixQuality &value) const
+{
+  int32_t quality = 0;
+  bool const valid =
+      integer(GGA_FIX_QUALITY, GGA_INVALID, GGA_SIMULATION, quality);
+  value = valid ? static_cast<GgaFixQuality>(quality) : value;
+  return valid;
+}
+
+bool GgaView::num_satellites(uint16_t &value) const
+{
+  int32_t satellites = 0;
+  bool const valid = integer(GGA_NUM_SATELLITES, 0, UINT16_MAX, satellites);
+  value = valid ? static_cast<uint16_t>(satellites) : value;
+  return valid;
+}
+
+bool GgaView::hdop(double &value) const { return number(GGA_HDOP, value); }
+
+bool GgaView::altitude(double &value) const
+{
+  return number(GGA_ALTITUDE, value);
+}
+
+bool GgaView::geoid_height(double &value) const
+{
+  return number(GGA_GEOID_HEIGHT, value);
+}
+
+bool GgaView::time_since_last_dgps(double &value, bool &present) const
+{
+  return optional_number(GGA_DGPS_AGE, value, present);
+}
+
+bool GgaView::dgps_station_id(uint16_t &value, bool &present) const
+{
+  int32_t station = 0;
+  bool const valid =
+      optional_integer(GGA_DGPS_STATION, 0, UINT16_MAX, station, present);
+  value = valid ? static_cast<uint16_t>(station) : value;
+  return valid;
+}
+
+GgaMessageData GgaView::message() const
+{
+  GgaMessageData output;
+  output.dgpdStationID = 0U;
+  output.valid = timestamp(output.timestamp) && latitude(output.latitude) &&
+                 longitude(output.longitude) &&
+                 fix_quality(output.fixQuality) &&
+                 num_satellites(output.numSatellites) && hdop(output.hdop) &&
+                 altitude(output.altitude) &&
+                 geoid_height(output.geoidHeight) &&
+                 time_since_last_dgps(output.timeSinceLastDgps,
+                                      output.timeSinceLastDgpsValid) &&
+                 dgps_station_id(output.dgpdStationID,
+                                 output.dgpdStationIDValid);
+  return output;
+}
+
+VtgView::VtgView(char const *const message, size_t const length,
+                 NmeaChecksumMode const checksum_mode)
+    : NmeaSentenceView(message, length, checksum_mode, NMEA_VTG,
+                       VTG_REQUIRED_FIELDS)
+{
+}
+
+bool VtgView::true_track_made_good(double &value) const
+{
+  return number(VTG_TRUE_TRACK, value);
+}
+
+bool VtgView::magnetic_track_made_good(double &value, bool &present) const
+{
+  return optional_number(VTG_MAGNETIC_TRACK, value, present);
+}
+
+bool VtgView::ground_speed_knots(double &value) const
+{
+  return number(VTG_SPEED_KNOTS, value);
+}
+
+bool VtgView::ground_speed_kph(double &value) const
+{
+  return number(VTG_SPEED_KPH, value);
+}
+
+VtgMessageData VtgView::message() const
+{
+  VtgMessageData output;
+  output.valid =
+      true_track_made_good(output.trueTrackMadeGood) &&
+      magnetic_track_made_good(output.magneticTrackMadeGood,
+                               output.magneticTrackMadeGoodValid) &&
+      ground_speed_knots(output.groundSpeedKnots) &&
+      ground_speed_kph(output.groundSpeedKph);
+  return output;
+}
+
+AvrView::AvrView(char const *const message, size_t const length,
+                 NmeaChecksumMode const checksum_mode)
+    : NmeaSentenceView(message, length, checksum_mode, NMEA_AVR,
+                       AVR_REQUIRED_FIELDS)
+{
+}
+
+bool AvrView::timestamp(double &value) const
+{
+  return number(AVR_TIMESTAMP, value);
+}
+
+bool AvrView::yaw(double &value) const { return number(AVR_YAW, value); }
+
+bool AvrView::tilt(double &value) const { return number(AVR_TILT, value); }
+
+bool AvrView::range(double &value) const { return number(AVR_RANGE, value); }
+
+bool AvrView::fix_quality(AvrFixQuality &value) const
+{
+  int32_t quality = 0;
+  bool const valid = integer(AVR_FIX_QUALITY, AVR_INVALID, AVR_DGPS, quality);
+  value = valid ? static_cast<AvrFixQuality>(quality) : value;
+  return valid;
+}
+
+bool AvrView::pdop(double &value) const { return number(AVR_PDOP, value); }
+
+bool AvrView::num_satellites(uint16_t &value) const
+{
+  int32_t satellites = 0;
+  bool const valid = integer(AVR_NUM_SATELLITES, 0, UINT16_MAX, satellites);
+  value = valid ? static_cast<uint16_t>(satellites) : value;
+  return valid;
+}
+
+AvrMessageData AvrView::message() const
+{
+  AvrMessageData output;
+  output.valid = timestamp(output.timestamp) && yaw(output.yaw) &&
+                 tilt(output.tilt) && range(output.range) &&
+                 fix_quality(output.fixQuality) && pdop(output.pdop) &&
+                 num_satellites(output.numSatellites);
+  return output;
+}
@@ -0,0 +1,83 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "vtg_columns.hpp"
+
+using std::vector;
+
+template <typename T>
+static size_t heap_bytes(vector<T> const &column)
+{
+  return column.capacity() * sizeof(T);
+}
+
+void VtgColumns::reserve(size_t const rows)
+{
+  trueTrackMadeGood.reserve(rows);
+  magneticTrackMadeGood.reserve(rows);
+  groundSpeedKnots.reserve(rows);
+  groundSpeedKph.reserve(rows);
+  magneticTrackMadeGoodValid.reserve((rows + 63U) / 64U);
+}
+
+void VtgColumns::clear()
+{
+  trueTrackMadeGood.clear();
+  magneticTrackMadeGood.clear();
+  groundSpeedKnots.clear();
+  groundSpeedKph.clear();
+  magneticTrackMadeGoodValid.clear();
+}
+
+size_t VtgColumns::append(VtgMessageData const &vtg)
+{
+  size_t added = 0U;
+  if (vtg.valid)
+  {
+    size_t const i = size();
+    trueTrackMadeGood.push_back(vtg.trueTrackMadeGood);
+    magneticTrackMadeGood.push_back(
+        vtg.magneticTrackMadeGoodValid ? vtg.magneticTrackMadeGood : 0.0);
+    groundSpeedKnots.push_back(vtg.groundSpeedKnots);
+    groundSpeedKph.push_back(vtg.groundSpeedKph);
+    if (0U == i % 64U)
+    {
+      magneticTrackMadeGoodValid.push_back(0U);
+    }
+    if (vtg.magneticTrackMadeGoodValid)
+    {
+      magneticTrackMadeGoodValid.back() |= static_cast<uint64_t>(1U)
+                                           << (i % 64U);
+    }
+    added = 1U;
+  }
+  return added;
+}
+
+size_t VtgColumns::append(NmeaMessage const *const messages,
+                          size_t const count)
+{
+  size_t added = 0U;
+  for (size_t i = 0U; i < count; ++i)
+  {
+    if (NMEA_VTG == messages[i].type)
+    {
+      added += append(messages[i].vtg);
+    }
+  }
+  return added;
+}
+
+VtgMessageData VtgColumns::row(size_t const i) const
+{
+  bool const magnetic = hasMagneticTrackMadeGood(i);
+  return VtgMessageData(trueTrackMadeGood[i], magnetic,
+                        magnetic ? magneticTrackMadeGood[i] : 0.0,
+                        groundSpeedKnots[i], groundSpeedKph[i]);
+}
+
+size_t VtgColumns::memory_bytes() const
+{
+  return heap_bytes(trueTrackMadeGood) + heap_bytes(magneticTrackMadeGood) +
+         heap_bytes(groundSpeedKnots) + heap_bytes(groundSpeedKph) +
+         heap_bytes(magneticTrackMadeGoodValid);
+}
@@ -0,0 +1,72 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gga_columns.hpp"
+#include "nmea_batch_parser.hpp"
+#include "nmea_builder.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+TEST(GgaColumns, appendAndReadBackRows)
+{
+  GgaColumns columns;
+  columns.reserve(200U);
+  for (uint16_t i = 0U; i < 200U; ++i)
+  {
+    GgaMessageData fix(1000.0 + i, 48.0, -11.0, GGA_RTK_FIXED, i, 0.5, 100.0,
+                       46.9);
+    if (0U == i % 3U)
+    {
+      fix.SetTimeSinceLastDgps(0.5 * i);
+    }
+    if (0U == i % 5U)
+    {
+      fix.SetDgpsStationID(i);
+    }
+    EXPECT_EQ(1U, columns.append(fix));
+  }
+  EXPECT_EQ(0U, columns.append(GgaMessageData()));
+  ASSERT_EQ(200U, columns.size());
+  for (size_t i = 0U; i < columns.size(); ++i)
+  {
+    GgaMessageData const fix(columns.row(i));
+    EXPECT_TRUE(fix.valid);
+    EXPECT_DOUBLE_EQ(1000.0 + static_cast<double>(i), fix.timestamp);
+    EXPECT_EQ(GGA_RTK_FIXED, fix.fixQuality);
+    EXPECT_EQ(i, fix.numSatellites);
+    EXPECT_EQ(0U == i % 3U, fix.timeSinceLastDgpsValid);
+    EXPECT_EQ(0U == i % 5U, fix.dgpdStationIDValid);
+    if (fix.dgpdStationIDValid)
+    {
+      EXPECT_EQ(i, fix.dgpdStationID);
+    }
+  }
+  EXPECT_LT(columns.memory_bytes(), 200U * sizeof(GgaMessageData));
+}
+
+TEST(GgaColumns, appendFromBatchParse)
+{
+  string log;
+  for (uint8_t second = 0U; second < 10U; ++second)
+  {
+    log += build_gga(1U, 2U, second, 10.0, 20.0, GGA_GPS, 9U, 1.2, 5.0, 1.0);
+    log += build_vtg(1.0, 2.0);
+  }
+  vector<NmeaMessage> messages(count_nmea_lines(log.data(), log.length()));
+  parse_nmea_batch(log.data(), log.length(), messages.data(), messages.size());
+  GgaColumns columns;
+  EXPECT_EQ(10U, columns.append(messages.data(), messages.size()));
+  EXPECT_DOUBLE_EQ(10209.0, columns.timestamp[9]);
+  EXPECT_NEAR(20.0, columns.longitude[9], 1e-9);
+  columns.clear();
+  EXPECT_EQ(0U, columns.size());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
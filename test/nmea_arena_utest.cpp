@@ -0,0 +1,88 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_arena.hpp"
+#include "nmea_builder.hpp"
+#include "nmea_parser.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::string;
+
+TEST(NmeaArena, bumpsAlignsAndReuses)
+{
+  NmeaArena arena(256U);
+  char *const first = static_cast<char *>(arena.allocate(3U, 1U));
+  void *const aligned = arena.allocate(8U, 8U);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(aligned) % 8U);
+  EXPECT_LE(first + 3, static_cast<char *>(aligned));
+  EXPECT_EQ(1U, arena.blocks());
+
+  // Too big for a block: gets one of its own.
+  EXPECT_NE(nullptr, arena.allocate(1000U, 16U));
+  EXPECT_EQ(2U, arena.blocks());
+  EXPECT_GE(arena.capacity(), 1256U);
+
+  arena.reset();
+  EXPECT_EQ(0U, arena.used());
+  EXPECT_EQ(first, arena.allocate(3U, 1U));
+  EXPECT_EQ(2U, arena.blocks());
+
+  arena.release();
+  EXPECT_EQ(0U, arena.blocks());
+  EXPECT_EQ(0U, arena.capacity());
+}
+
+TEST(NmeaArena, buildersAndParsersUseIt)
+{
+  NmeaArena arena;
+  NmeaArenaAllocator<char> const allocator(arena);
+  NmeaArenaString const gga(build_gga(12U, 35U, 19.0, 48.1173, -11.5166667,
+                                      GGA_RTK_FIXED, 14U, 0.8, 545.4, 46.9,
+                                      allocator));
+  NmeaArenaString const vtg(build_vtg(54.7, 2.85, allocator));
+  EXPECT_EQ(build_gga(12U, 35U, 19.0, 48.1173, -11.5166667, GGA_RTK_FIXED,
+                      14U, 0.8, 545.4, 46.9),
+            string(gga.data(), gga.length()));
+  EXPECT_EQ(build_vtg(54.7, 2.85), string(vtg.data(), vtg.length()));
+  EXPECT_GE(arena.used(), gga.length() + vtg.length());
+
+  GgaMessageData const fix(parse_gga(gga));
+  EXPECT_TRUE(fix.valid);
+  EXPECT_EQ(14U, fix.numSatellites);
+  EXPECT_TRUE(parse_vtg(vtg).valid);
+  EXPECT_EQ(NMEA_GGA, parse_nmea(gga).type);
+}
+
+TEST(NmeaArena, oneArenaPerThread)
+{
+  NmeaArenaAllocator<int> const mine;
+  EXPECT_EQ(&nmea_thread_arena(), mine.arena());
+  NmeaArena *theirs = nullptr;
+  std::thread other([&theirs]() {
+    NmeaArenaAllocator<char> const allocator;
+    theirs = allocator.arena();
+  });
+  other.join();
+  EXPECT_NE(mine.arena(), theirs);
+  EXPECT_TRUE(mine == NmeaArenaAllocator<char>());
+
+  std::vector<int, NmeaArenaAllocator<int> > numbers(mine);
+  for (int i = 0; i < 1000; ++i)
+  {
+    numbers.push_back(i);
+  }
+  EXPECT_EQ(999, numbers.back());
+  EXPECT_GE(nmea_thread_arena().used(), 1000U * sizeof(int));
+  numbers.clear();
+  numbers.shrink_to_fit();
+  nmea_thread_arena().reset();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_batch_builder.hpp"
+#include "nmea_builder.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <string>
+
+using std::string;
+
+static string expected_text(GgaColumns const &gga,
+                            VtgColumns const *const vtg)
+{
+  string text;
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  for (size_t i = 0U; i < gga.size(); ++i)
+  {
+    text.append(buffer, build_gga(buffer, sizeof(buffer), gga.row(i)));
+    if (nullptr != vtg)
+    {
+      text.append(buffer, build_vtg(buffer, sizeof(buffer), vtg->row(i)));
+    }
+  }
+  return text;
+}
+
+static void add_row(GgaColumns &gga, VtgColumns &vtg, double const value,
+                    double const angle, size_t const i)
+{
+  GgaMessageData fix(std::fabs(value), angle, -2.0 * angle, GGA_DGPS,
+                     static_cast<uint16_t>(i % 40U), std::fabs(value) / 7.0,
+                     value, -value);
+  if (0U == i % 2U)
+  {
+    fix.SetTimeSinceLastDgps(value);
+  }
+  if (0U == i % 3U)
+  {
+    fix.SetDgpsStationID(static_cast<uint16_t>(i));
+  }
+  gga.append(fix);
+  vtg.append(
+      VtgMessageData(value, 0U == i % 5U, -value, value * 1.5, value * 2.5));
+}
+
+// Randomized values, and ones on the rounding edges: halves that printf
+// rounds to even, values just off them, signed zero, and numbers too large
+// or not finite to scale.
+static void fill_rows(GgaColumns &gga, VtgColumns &vtg, size_t const rows)
+{
+  double const edges[] = {0.0,
+                          -0.0,
+                          0.125,
+                          -0.125,
+                          0.0005,
+                          2.5,
+                          0.05,
+                          0.15,
+                          0.25,
+                          123456.7895,
+                          std::nextafter(0.25, 1.0),
+                          std::nextafter(0.0625, 0.0),
+                          99999.9995,
+                          2147483.6475,
+                          1e9,
+                          -3e12,
+                          1e300,
+                          std::numeric_limits<double>::infinity(),
+                          std::numeric_limits<double>::quiet_NaN(),
+                          4.9e-324};
+  size_t const edge_count = sizeof(edges) / sizeof(edges[0]);
+  std::mt19937 random(17U);
+  std::uniform_real_distribution<double> values(-2000.0, 2000.0);
+  std::uniform_real_distribution<double> angles(-180.0, 180.0);
+  for (size_t i = 0U; i < rows; ++i)
+  {
+    double const value = i < edge_count ? edges[i] : values(random);
+    double const angle = i < edge_count ? edges[i] / 1e3 : angles(random);
+    add_row(gga, vtg, value, angle, i);
+  }
+}
+
+TEST(NmeaBatchBuilder, matchesSingleSentenceBuilders)
+{
+  GgaColumns gga;
+  VtgColumns vtg;
+  fill_rows(gga, vtg, 3001U);
+  string const expected(expected_text(gga, &vtg));
+  for (unsigned threads = 0U; threads <= 4U; ++threads)
+  {
+    string output("prefix\n");
+    EXPECT_EQ(expected.size(), build_nmea_batch(gga, &vtg, output, threads));
+    EXPECT_EQ("prefix\n" + expected, output);
+  }
+}
+
+TEST(NmeaBatchBuilder, roundsLikePrintf)
+{
+  GgaColumns gga;
+  VtgColumns vtg;
+  std::mt19937 random(5U);
+  std::uniform_int_distribution<int> thousandths(-100000, 100000);
+  for (size_t i = 0U; i < 2000U; ++i)
+  {
+    // decimal halves are mostly not exact in binary
+    double const value = thousandths(random) / 1000.0 + 0.0005;
+    add_row(gga, vtg, value, value / 1e3, i);
+  }
+  string output;
+  build_nmea_batch(gga, &vtg, output);
+  EXPECT_EQ(expected_text(gga, &vtg), output);
+}
+
+TEST(NmeaBatchBuilder, ggaOnly)
+{
+  GgaColumns gga;
+  VtgColumns vtg;
+  fill_rows(gga, vtg, 100U);
+  string output;
+  build_nmea_batch(gga, nullptr, output);
+  EXPECT_EQ(expected_text(gga, nullptr), output);
+}
+
+TEST(NmeaBatchBuilder, rejectsMismatchedColumns)
+{
+  GgaColumns gga;
+  VtgColumns vtg;
+  fill_rows(gga, vtg, 10U);
+  vtg.append(VtgMessageData(1.0, false, 0.0, 2.0, 3.7));
+  string output("unchanged");
+  EXPECT_EQ(0U, build_nmea_batch(gga, &vtg, output, 2U));
+  EXPECT_EQ("unchanged", output);
+  GgaColumns const empty;
+  EXPECT_EQ(0U, build_nmea_batch(empty, nullptr, output));
+  EXPECT_EQ("unchanged", output);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
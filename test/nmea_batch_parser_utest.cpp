@@ -0,0 +1,99 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_batch_parser.hpp"
+#include "nmea_builder.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+static string make_log(size_t const epochs)
+{
+  string log;
+  for (size_t i = 0U; i < epochs; ++i)
+  {
+    double const seconds = static_cast<double>(i % 60U);
+    log += build_gga(12U, static_cast<uint8_t>(i / 60U % 60U), seconds,
+                     48.1 + 1e-6 * static_cast<double>(i), -11.5, GGA_GPS, 8U,
+                     0.9, 545.4, 46.9);
+    log += build_vtg(static_cast<double>(i % 360U), 10.0);
+    if (0U == i % 7U)
+    {
+      log += "garbage\r\n\r\n";
+    }
+  }
+  return log;
+}
+
+TEST(NmeaBatchParser, matchesSequentialParse)
+{
+  string const log(make_log(1000U));
+  vector<string> lines;
+  size_t begin = 0U;
+  while (begin < log.length())
+  {
+    size_t const end = log.find('\n', begin);
+    string line = log.substr(begin, end - begin);
+    if (!line.empty() && '\r' == line[line.length() - 1U])
+    {
+      line.erase(line.length() - 1U);
+    }
+    if (!line.empty())
+    {
+      lines.push_back(line);
+    }
+    begin = end + 1U;
+  }
+
+  ASSERT_TRUE(parse_nmea(lines[0]).valid());
+  ASSERT_TRUE(parse_nmea(lines[1]).valid());
+  for (unsigned threads = 1U; threads <= 8U; ++threads)
+  {
+    ASSERT_EQ(lines.size(), count_nmea_lines(log.data(), log.length(), threads));
+    vector<NmeaMessage> output(lines.size());
+    ASSERT_EQ(lines.size(), parse_nmea_batch(log.data(), log.length(),
+                                             output.data(), output.size(),
+                                             threads));
+    for (size_t i = 0U; i < lines.size(); ++i)
+    {
+      NmeaMessage const expected(parse_nmea(lines[i]));
+      ASSERT_EQ(expected.type, output[i].type) << threads << " " << i;
+      ASSERT_EQ(expected.valid(), output[i].valid());
+      if (NMEA_GGA == expected.type)
+      {
+        ASSERT_EQ(expected.gga.latitude, output[i].gga.latitude);
+      }
+    }
+  }
+}
+
+TEST(NmeaBatchParser, stopsAtCapacity)
+{
+  string const log(make_log(100U));
+  vector<NmeaMessage> output(10U);
+  EXPECT_EQ(10U, parse_nmea_batch(log.data(), log.length(), output.data(),
+                                  output.size(), 4U));
+  EXPECT_EQ(NMEA_GGA, output[0].type);
+  EXPECT_EQ(NMEA_VTG, output[1].type);
+  EXPECT_EQ(NMEA_UNKNOWN, output[2].type);
+}
+
+TEST(NmeaBatchParser, lastLineWithoutNewline)
+{
+  string const log("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\n"
+                   "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+  vector<NmeaMessage> output(2U);
+  EXPECT_EQ(2U, parse_nmea_batch(log.data(), log.length(), output.data(),
+                                 output.size(), 0U));
+  EXPECT_TRUE(output[1].valid());
+  EXPECT_EQ(0U, parse_nmea_batch(log.data(), 0U, output.data(),
+                                 output.size(), 3U));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -2,9 +2,84 @@
 
 #include "gtest/gtest.h"
 #include "nmea_builder.hpp"
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
 #include <string>
 
 using std::string;
+using std::stringstream;
+
+// The iostream reference the allocation-free builders have to reproduce byte
+// for byte. Angles are rounded once, to the nearest 1e-8 minute; the
+// original rounded the minute fraction on its own and so printed 59 minutes
+// for 59.999999999 or came out a digit low.
+static string reference_degrees(double const angle_degrees,
+                                bool const three_digits)
+{
+  long long const units = std::llround(std::fabs(angle_degrees) * 6e9);
+  stringstream ss;
+  ss << std::setfill('0') << std::setw(three_digits ? 3 : 2)
+     << units / 6000000000LL << std::setw(2) << units / 100000000LL % 60LL
+     << '.' << std::setw(8) << units % 100000000LL;
+  return ss.str();
+}
+
+static string reference_checksum(string const &in)
+{
+  uint8_t checksum = 0U;
+  for (size_t i = 1U; i + 1U < in.length(); ++i)
+  {
+    checksum = static_cast<uint8_t>(checksum ^ in[i]);
+  }
+  stringstream checksum_ss;
+  checksum_ss << std::hex << std::setfill('0') << std::uppercase
+              << std::setw(2) << static_cast<uint16_t>(checksum);
+  return checksum_ss.str();
+}
+
+static string reference_gga(uint8_t utc_hour, uint8_t utc_minute,
+                            double utc_seconds, double latitude_degrees,
+                            double longitude_degrees, GgaFixQuality fix_quality,
+                            uint16_t num_satellites, double hdop,
+                            double altitude_m, double geoid_height)
+{
+  stringstream utc_time, rest;
+  utc_time << std::setfill('0') << std::setw(2)
+           << static_cast<uint16_t>(utc_hour) << std::setw(2)
+           << static_cast<uint16_t>(utc_minute) << std::fixed << std::setw(5)
+           << std::setprecision(2) << utc_seconds;
+  string output = "$GPGGA," + utc_time.str() + ",";
+  output += reference_degrees(latitude_degrees, false) +
+            (latitude_degrees > 0 ? ",N," : ",S,");
+  output += reference_degrees(longitude_degrees, true) +
+            (longitude_degrees > 0 ? ",E," : ",W,");
+  stringstream fix_type, num_sats, hdop_ss, msl_alt, height_of_geoid;
+  fix_type << static_cast<uint16_t>(fix_quality);
+  num_sats << num_satellites;
+  hdop_ss << hdop;
+  msl_alt << std::setfill('0') << std::fixed << std::setw(6)
+          << std::setprecision(3) << altitude_m;
+  height_of_geoid << std::fixed << std::setprecision(1) << geoid_height;
+  output += fix_type.str() + "," + num_sats.str() + "," + hdop_ss.str() + "," +
+            msl_alt.str() + ",M," + height_of_geoid.str() + ",M,,*";
+  return output + reference_checksum(output) + "\n";
+}
+
+static string reference_vtg(double true_track_made_good_ned_degrees,
+                            double ground_velocity_mps)
+{
+  stringstream track_ss, knots_ss, kph_ss;
+  track_ss << std::setfill('0') << std::fixed << std::setw(5)
+           << std::setprecision(1) << true_track_made_good_ned_degrees;
+  knots_ss << std::fixed << std::setprecision(3)
+           << ground_velocity_mps * 1.94384;
+  kph_ss << std::fixed << std::setprecision(3) << ground_velocity_mps * 3.6;
+  string const output = "$GPVTG," + track_ss.str() + ",T,,M," +
+                        knots_ss.str() + ",N," + kph_ss.str() + ",K*";
+  return output + reference_checksum(output) + "\n";
+}
 
 TEST(NmeaBuilder, builGgaMsgNortheast)
 {
@@ -35,6 +110,125 @@ TEST(NmeaStramGenerator, createVtgMsg_10mpsEast)
   EXPECT_EQ("$GPVTG,090.0,T,,M,19.438,N,36.000,K*6B\n", output);
 }
 
+TEST(NmeaBuilder, bufferBuildersMatchReference)
+{
+  std::mt19937_64 generator(11U);
+  std::uniform_real_distribution<double> latitude(-90.0, 90.0);
+  std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+  std::uniform_real_distribution<double> seconds(0.0, 60.0);
+  std::uniform_real_distribution<double> hdop(0.0, 50.0);
+  std::uniform_real_distribution<double> altitude(-500.0, 9000.0);
+  std::uniform_real_distribution<double> track(-10.0, 370.0);
+  std::uniform_real_distribution<double> speed(-5.0, 500.0);
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  for (int i = 0; i < 20000; ++i)
+  {
+    uint8_t const hour = static_cast<uint8_t>(i % 24);
+    uint8_t const minute = static_cast<uint8_t>(i % 60);
+    double const utc_seconds =
+        0 == i % 4 ? std::round(seconds(generator) * 100.0) / 100.0
+                   : seconds(generator);
+    double const lat = latitude(generator);
+    double const lon = longitude(generator);
+    GgaFixQuality const quality = static_cast<GgaFixQuality>(i % 9);
+    uint16_t const sats = static_cast<uint16_t>(i % 40);
+    double const dop = 0 == i % 2 ? std::round(hdop(generator) * 10.0) / 10.0
+                                  : hdop(generator);
+    double const alt = altitude(generator);
+    double const geoid = altitude(generator) / 100.0;
+    string const expected_gga(reference_gga(hour, minute, utc_seconds, lat, lon,
+                                            quality, sats, dop, alt, geoid));
+    size_t const gga_length =
+        build_gga(buffer, sizeof(buffer), hour, minute, utc_seconds, lat, lon,
+                  quality, sats, dop, alt, geoid);
+    ASSERT_EQ(expected_gga, string(buffer, gga_length));
+    ASSERT_EQ(expected_gga, build_gga(hour, minute, utc_seconds, lat, lon,
+                                      quality, sats, dop, alt, geoid));
+
+    double const course = track(generator);
+    double const velocity = speed(generator);
+    string const expected_vtg(reference_vtg(course, velocity));
+    size_t const vtg_length =
+        build_vtg(buffer, sizeof(buffer), course, velocity);
+    ASSERT_EQ(expected_vtg, string(buffer, vtg_length));
+  }
+}
+
+TEST(NmeaBuilder, bufferBuildersMatchReferenceAtExtremes)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  double const values[] = {0.0, -0.0, 1e-9, 0.999999999, 59.9999999999,
+                           1e7, -1e12, 1e300, -1e300};
+  for (double const value : values)
+  {
+    size_t const gga_length =
+        build_gga(buffer, sizeof(buffer), 23U, 59U, value, 1.0, 2.0,
+                  GGA_DGPS, 65535U, value, value, value);
+    ASSERT_EQ(reference_gga(23U, 59U, value, 1.0, 2.0, GGA_DGPS, 65535U, value,
+                            value, value),
+              string(buffer, gga_length));
+    size_t const vtg_length = build_vtg(buffer, sizeof(buffer), value, value);
+    ASSERT_EQ(reference_vtg(value, value), string(buffer, vtg_length));
+  }
+}
+
+TEST(NmeaBuilder, bufferTooSmall)
+{
+  char buffer[16];
+  EXPECT_EQ(0U, build_vtg(buffer, sizeof(buffer), 90.0, 10.0));
+  char exact[39];
+  EXPECT_EQ(sizeof(exact), build_vtg(exact, sizeof(exact), 90.0, 10.0));
+  EXPECT_EQ("$GPVTG,090.0,T,,M,19.438,N,36.000,K*6B\n",
+            string(exact, sizeof(exact)));
+}
+
+TEST(NmeaBuilder, messageBuildersRoundTrip)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  GgaMessageData gga(123519.5, 48.1173, -11.5166667, GGA_DGPS, 12U, 0.9, 545.4,
+                     46.9);
+  gga.SetTimeSinceLastDgps(2.5);
+  gga.SetDgpsStationID(31U);
+  size_t length = build_gga(buffer, sizeof(buffer), gga);
+  EXPECT_EQ("$GPGGA,123519.50,4807.03800000,N,01131.00000200,W,2,12,0.9,"
+            "545.400,M,46.9,M,2.5,0031*5F\n",
+            string(buffer, length));
+  GgaMessageData const parsed_gga(parse_gga(string(buffer, length)));
+  ASSERT_TRUE(parsed_gga.valid);
+  EXPECT_EQ(gga.timestamp, parsed_gga.timestamp);
+  EXPECT_NEAR(gga.latitude, parsed_gga.latitude, 1e-9);
+  EXPECT_NEAR(gga.longitude, parsed_gga.longitude, 1e-9);
+  EXPECT_EQ(gga.fixQuality, parsed_gga.fixQuality);
+  EXPECT_EQ(gga.numSatellites, parsed_gga.numSatellites);
+  EXPECT_TRUE(parsed_gga.timeSinceLastDgpsValid);
+  EXPECT_EQ(2.5, parsed_gga.timeSinceLastDgps);
+  EXPECT_TRUE(parsed_gga.dgpdStationIDValid);
+  EXPECT_EQ(31U, parsed_gga.dgpdStationID);
+
+  VtgMessageData const vtg(54.7, true, 34.4, 5.5, 10.2);
+  length = build_vtg(buffer, sizeof(buffer), vtg);
+  EXPECT_EQ("$GPVTG,054.7,T,034.4,M,5.500,N,10.200,K*78\n",
+            string(buffer, length));
+  VtgMessageData const parsed_vtg(parse_vtg(string(buffer, length)));
+  ASSERT_TRUE(parsed_vtg.valid);
+  EXPECT_TRUE(parsed_vtg.magneticTrackMadeGoodValid);
+  EXPECT_EQ(34.4, parsed_vtg.magneticTrackMadeGood);
+  EXPECT_EQ(10.2, parsed_vtg.groundSpeedKph);
+
+  AvrMessageData const avr(212405.2, 52.1531, -0.0806, 12.575, AVR_RTK_FIXED,
+                           1.4, 16U);
+  length = build_avr(buffer, sizeof(buffer), avr);
+  EXPECT_EQ("$PTNL,AVR,212405.20,+52.1531,Yaw,-0.0806,Tilt,,,12.575,3,1.4,16*"
+            "39\n",
+            string(buffer, length));
+  AvrMessageData const parsed_avr(parse_avr(string(buffer, length)));
+  ASSERT_TRUE(parsed_avr.valid);
+  EXPECT_EQ(avr.yaw, parsed_avr.yaw);
+  EXPECT_EQ(avr.tilt, parsed_avr.tilt);
+  EXPECT_EQ(avr.fixQuality, parsed_avr.fixQuality);
+  EXPECT_EQ(avr.numSatellites, parsed_avr.numSatellites);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
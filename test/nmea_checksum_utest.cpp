@@ -0,0 +1,55 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_checksum.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+using std::string;
+
+TEST(NmeaChecksum, vectorizedMatchesScalarForAllLengths)
+{
+  std::mt19937 generator(7U);
+  string data(1024U, '\0');
+  for (size_t i = 0U; i < data.length(); ++i)
+  {
+    data[i] = static_cast<char>(generator());
+  }
+  for (size_t offset = 0U; offset < 4U; ++offset)
+  {
+    for (size_t length = 0U; length + offset <= data.length(); ++length)
+    {
+      ASSERT_EQ(nmea_checksum_scalar(data.data() + offset, length),
+                nmea_checksum(data.data() + offset, length))
+          << offset << " " << length;
+    }
+  }
+}
+
+TEST(NmeaChecksum, longerThan255Bytes)
+{
+  string const data(300U, 'A');
+  EXPECT_EQ(0U, nmea_checksum(data.data(), data.length()));
+  EXPECT_EQ(static_cast<uint8_t>('A'),
+            nmea_checksum(data.data(), data.length() - 1U));
+}
+
+TEST(NmeaChecksum, validSentence)
+{
+  string const vtg("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+  EXPECT_TRUE(nmea_checksum_valid(vtg.data(), vtg.length()));
+  string const lower("$GPVTG,054.7,T,,M,005.5,N,010.2,K*65\r\n");
+  EXPECT_TRUE(nmea_checksum_valid(lower.data(), lower.length()));
+  string const wrong("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*49");
+  EXPECT_FALSE(nmea_checksum_valid(wrong.data(), wrong.length()));
+  string const missing("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K");
+  EXPECT_FALSE(nmea_checksum_valid(missing.data(), missing.length()));
+  EXPECT_FALSE(nmea_checksum_valid("$*", 2U));
+  EXPECT_FALSE(nmea_checksum_valid("", 0U));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,176 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_builder.hpp"
+#include "nmea_coordinate.hpp"
+#include "nmea_parser.hpp"
+#include <random>
+#include <string>
+
+using std::string;
+
+static bool parse(string const &text, int64_t &nano_minutes)
+{
+  return nmea_parse_nano_minutes(text.data(), text.length(), nano_minutes);
+}
+
+static string format(int64_t const nano_minutes, size_t const degree_digits,
+                     size_t const decimals)
+{
+  char text[NMEA_COORDINATE_BUFFER_LENGTH];
+  return string(text, nmea_format_nano_minutes(nano_minutes, degree_digits,
+                                               decimals, text));
+}
+
+TEST(NmeaCoordinate, parseEightDigits)
+{
+  uint32_t value = 0U;
+  EXPECT_TRUE(nmea_parse_eight_digits("12345678", value));
+  EXPECT_EQ(12345678U, value);
+  EXPECT_TRUE(nmea_parse_eight_digits("00000009", value));
+  EXPECT_EQ(9U, value);
+  EXPECT_TRUE(nmea_parse_eight_digits("99999999", value));
+  EXPECT_EQ(99999999U, value);
+  char text[9] = "00000000";
+  for (size_t i = 0U; i < 8U; ++i)
+  {
+    for (int c = 0; c < 256; ++c)
+    {
+      text[i] = static_cast<char>(c);
+      EXPECT_EQ('0' <= c && '9' >= c, nmea_parse_eight_digits(text, value))
+          << i << " " << c;
+    }
+    text[i] = '0';
+  }
+}
+
+TEST(NmeaCoordinate, parseNanoMinutes)
+{
+  int64_t value = 0;
+  EXPECT_TRUE(parse("4807.038", value));
+  EXPECT_EQ(48 * NMEA_NANO_MINUTES_PER_DEGREE + 7038000000LL, value);
+  EXPECT_TRUE(parse("01131.000", value));
+  EXPECT_EQ(11 * NMEA_NANO_MINUTES_PER_DEGREE + 31 * 1000000000LL, value);
+  EXPECT_TRUE(parse("17959.999999999", value));
+  EXPECT_EQ(180 * NMEA_NANO_MINUTES_PER_DEGREE - 1, value);
+  EXPECT_TRUE(parse("000.", value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(parse("005.5", value));
+  EXPECT_EQ(5 * NMEA_NANO_MINUTES_PER_MINUTE + 500000000LL, value);
+
+  // a tenth decimal rounds, possibly all the way into the degrees
+  EXPECT_TRUE(parse("0000.0000000004", value));
+  EXPECT_EQ(0, value);
+  EXPECT_TRUE(parse("0000.0000000005", value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(parse("4759.99999999951234", value));
+  EXPECT_EQ(48 * NMEA_NANO_MINUTES_PER_DEGREE, value);
+
+  EXPECT_FALSE(parse("", value));
+  EXPECT_FALSE(parse("4807", value));
+  EXPECT_FALSE(parse("07.5", value));
+  EXPECT_FALSE(parse("4860.000", value));
+  EXPECT_FALSE(parse("123407.000", value));
+  EXPECT_FALSE(parse("-4807.038", value));
+  EXPECT_FALSE(parse("4807.03x", value));
+  EXPECT_FALSE(parse("4807.0380000001x", value));
+  EXPECT_FALSE(parse("48 7.038", value));
+}
+
+TEST(NmeaCoordinate, formatCarries)
+{
+  EXPECT_EQ("4807.03800000", format(48 * NMEA_NANO_MINUTES_PER_DEGREE +
+                                        7038000000LL,
+                                    2U, 8U));
+  EXPECT_EQ("00000.000", format(0, 3U, 3U));
+  EXPECT_EQ("0100.00000000", format(NMEA_NANO_MINUTES_PER_DEGREE - 5, 2U, 8U));
+  EXPECT_EQ("0059.99999999", format(NMEA_NANO_MINUTES_PER_DEGREE - 6, 2U, 8U));
+  EXPECT_EQ("0100.", format(NMEA_NANO_MINUTES_PER_DEGREE - 1, 2U, 0U));
+  EXPECT_EQ("4807.038000000", format(-(48 * NMEA_NANO_MINUTES_PER_DEGREE +
+                                       7038000000LL),
+                                     2U, 12U));
+  EXPECT_EQ("18000.0", format(180 * NMEA_NANO_MINUTES_PER_DEGREE, 2U, 1U));
+}
+
+TEST(NmeaCoordinate, degreesConversion)
+{
+  EXPECT_EQ(48 * NMEA_NANO_MINUTES_PER_DEGREE + 7038000000LL,
+            nmea_degrees_to_nano_minutes(48.1173));
+  EXPECT_EQ(-60000000000LL, nmea_degrees_to_nano_minutes(-1.0));
+  EXPECT_EQ(1000000000LL, nmea_degrees_to_nano_minutes(1.0 / 60.0 - 1e-12, 0U));
+  EXPECT_EQ(0, nmea_degrees_to_nano_minutes(std::nan("")));
+  EXPECT_LT(0, nmea_degrees_to_nano_minutes(1e300));
+  EXPECT_GT(0, nmea_degrees_to_nano_minutes(-1e300));
+  EXPECT_DOUBLE_EQ(48.1173, nmea_nano_minutes_to_degrees(
+                                48 * NMEA_NANO_MINUTES_PER_DEGREE +
+                                7038000000LL));
+}
+
+// Every nano-minute value survives text and back, and every nine decimal
+// text survives the value and back.
+TEST(NmeaCoordinate, textRoundTripIsExact)
+{
+  std::mt19937_64 generator(14U);
+  std::uniform_int_distribution<int64_t> angle(
+      0, 180 * NMEA_NANO_MINUTES_PER_DEGREE - 1);
+  for (int i = 0; i < 200000; ++i)
+  {
+    int64_t const value = angle(generator);
+    string const text(format(value, 3U, 9U));
+    int64_t parsed = -1;
+    ASSERT_TRUE(parse(text, parsed)) << text;
+    ASSERT_EQ(value, parsed) << text;
+    ASSERT_EQ(text, format(parsed, 3U, 9U));
+  }
+}
+
+// Property from the request: any "ddmm.mmmmmmmm" / "dddmm.mmmmmmmm" written
+// at the builder's 8 decimals reads back through parse_gga as the double
+// that build_gga turns into the same text.
+TEST(NmeaCoordinate, ggaRoundTripAtEightDecimals)
+{
+  std::mt19937_64 generator(8U);
+  std::uniform_int_distribution<int64_t> latitude(
+      0, 90 * NMEA_NANO_MINUTES_PER_DEGREE / 10);
+  std::uniform_int_distribution<int64_t> longitude(
+      0, 180 * NMEA_NANO_MINUTES_PER_DEGREE / 10);
+  std::uniform_int_distribution<int> hemisphere(0, 1);
+  for (int i = 0; i < 50000; ++i)
+  {
+    // steer some values onto the minute and degree boundaries
+    int64_t lat = latitude(generator) * 10;
+    int64_t lon = longitude(generator) * 10;
+    if (0 == i % 8)
+    {
+      lat -= lat % NMEA_NANO_MINUTES_PER_DEGREE;
+      lon -= lon % NMEA_NANO_MINUTES_PER_MINUTE + 10;
+      lon = lon < 0 ? 0 : lon;
+    }
+    double const north = 0 == hemisphere(generator) ? -1.0 : 1.0;
+    double const east = 0 == hemisphere(generator) ? -1.0 : 1.0;
+    string const lat_text(format(lat, 2U, 8U));
+    string const lon_text(format(lon, 3U, 8U));
+    GgaMessageData const original(
+        123519.0, north * nmea_nano_minutes_to_degrees(lat),
+        east * nmea_nano_minutes_to_degrees(lon), GGA_GPS, 8U, 0.9, 545.4,
+        46.9);
+    char buffer[NMEA_MAX_BUILD_LENGTH];
+    size_t const length = build_gga(buffer, sizeof(buffer), original);
+    string const sentence(buffer, length);
+    ASSERT_NE(string::npos, sentence.find("," + lat_text + ",")) << sentence;
+    ASSERT_NE(string::npos, sentence.find("," + lon_text + ",")) << sentence;
+
+    GgaMessageData const parsed(parse_gga(sentence));
+    ASSERT_TRUE(parsed.valid) << sentence;
+    EXPECT_EQ(original.latitude, parsed.latitude) << sentence;
+    EXPECT_EQ(original.longitude, parsed.longitude) << sentence;
+    ASSERT_EQ(length, build_gga(buffer, sizeof(buffer), parsed));
+    ASSERT_EQ(sentence, string(buffer, length));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
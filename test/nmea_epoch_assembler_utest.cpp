@@ -0,0 +1,183 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_epoch_assembler.hpp"
+#include <gtest/gtest.h>
+
+static GgaMessageData gga_at(double const timestamp)
+{
+  return GgaMessageData(timestamp, 48.0, 11.0, GGA_RTK_FIXED, 12U, 0.8, 500.0,
+                        46.9);
+}
+
+static AvrMessageData avr_at(double const timestamp, double const yaw)
+{
+  return AvrMessageData(timestamp, yaw, 0.5, 1.2, AVR_RTK_FIXED, 1.5, 12U);
+}
+
+static VtgMessageData vtg_of(double const track)
+{
+  return VtgMessageData(track, false, 0.0, 10.0, 18.52);
+}
+
+TEST(NmeaEpochAssembler, joinsOneEpochPerSecond)
+{
+  NmeaEpochAssembler assembler;
+  NmeaNavigationEpoch epoch;
+  EXPECT_EQ(0U, assembler.add(NmeaMessage(gga_at(123519.0))));
+  EXPECT_EQ(0U, assembler.add(NmeaMessage(vtg_of(45.0))));
+  EXPECT_FALSE(assembler.next(epoch));
+  EXPECT_EQ(1U, assembler.add(NmeaMessage(avr_at(123519.6, 90.0))));
+  ASSERT_TRUE(assembler.next(epoch));
+  EXPECT_EQ(12U * 3600000U + 35U * 60000U + 19000U, epoch.timeMs);
+  EXPECT_EQ(NMEA_EPOCH_ALL, epoch.parts);
+  EXPECT_DOUBLE_EQ(123519.0, epoch.position.timestamp);
+  EXPECT_DOUBLE_EQ(45.0, epoch.velocity.trueTrackMadeGood);
+  EXPECT_DOUBLE_EQ(90.0, epoch.heading.yaw);
+  EXPECT_FALSE(assembler.next(epoch));
+  EXPECT_EQ(1U, assembler.completed());
+  EXPECT_EQ(0U, assembler.pending());
+  EXPECT_EQ(0U, assembler.add(gga_at(123519.8)));
+  EXPECT_EQ(0U, assembler.add(vtg_of(47.0)));
+  EXPECT_EQ(2U, assembler.droppedMessages());
+  EXPECT_FALSE(assembler.next(epoch));
+
+  // AVR first this time; VTG follows it into the same epoch.
+  EXPECT_EQ(0U, assembler.add(avr_at(123520.0, 91.0)));
+  EXPECT_EQ(0U, assembler.add(vtg_of(46.0)));
+  EXPECT_EQ(1U, assembler.add(gga_at(123520.2)));
+  ASSERT_TRUE(assembler.next(epoch));
+  EXPECT_DOUBLE_EQ(46.0, epoch.velocity.trueTrackMadeGood);
+}
+
+TEST(NmeaEpochAssembler, timesOutIncompleteEpochs)
+{
+  NmeaEpochAssemblerConfig config;
+  config.timeoutMs = 1500U;
+  NmeaEpochAssembler assembler(config);
+  NmeaNavigationEpoch epoch;
+  EXPECT_EQ(0U, assembler.add(gga_at(100.0)));
+  EXPECT_EQ(0U, assembler.add(gga_at(101.0)));
+  EXPECT_EQ(2U, assembler.pending());
+  EXPECT_EQ(1U, assembler.add(gga_at(101.5)));
+  ASSERT_TRUE(assembler.next(epoch));
+  EXPECT_EQ(60000U, epoch.timeMs);
+  EXPECT_EQ(NMEA_EPOCH_POSITION, epoch.parts);
+  EXPECT_FALSE(epoch.heading.valid);
+  EXPECT_EQ(1U, assembler.timedOut());
+
+  // Too late to reopen the epoch that just timed out.
+  EXPECT_EQ(0U, assembler.add(avr_at(100.0, 1.0)));
+  EXPECT_EQ(1U, assembler.droppedMessages());
+  EXPECT_EQ(1U, assembler.flush());
+  EXPECT_EQ(0U, assembler.pending());
+
+  config.emitIncomplete = false;
+  NmeaEpochAssembler quiet(config);
+  quiet.add(gga_at(100.0));
+  EXPECT_EQ(0U, quiet.add(gga_at(102.0)));
+  EXPECT_EQ(1U, quiet.timedOut());
+  EXPECT_FALSE(quiet.next(epoch));
+}
+
+TEST(NmeaEpochAssembler, highRateAcrossMidnight)
+{
+  NmeaEpochAssemblerConfig config;
+  config.periodMs = 10U;
+  config.timeoutMs = 30U;
+  config.requiredParts = NMEA_EPOCH_POSITION | NMEA_EPOCH_VELOCITY;
+  NmeaEpochAssembler assembler(config);
+  NmeaNavigationEpoch epoch;
+  size_t epochs = 0U;
+  for (int i = -50; i < 50; ++i)
+  {
+    double const timestamp = i < 0 ? 235959.999 + (i + 1) * 0.01 : i * 0.01;
+    assembler.add(gga_at(timestamp));
+    epochs += assembler.add(vtg_of(i));
+    while (assembler.next(epoch))
+    {
+      EXPECT_EQ(NMEA_EPOCH_POSITION | NMEA_EPOCH_VELOCITY, epoch.parts);
+    }
+  }
+  EXPECT_EQ(100U, epochs);
+  EXPECT_EQ(0U, assembler.timedOut());
+  EXPECT_EQ(0U, assembler.droppedMessages());
+}
+
+TEST(NmeaEpochAssembler, dropsUnusableMessages)
+{
+  NmeaEpochAssembler assembler;
+  EXPECT_EQ(0U, assembler.add(vtg_of(1.0)));
+  EXPECT_EQ(0U, assembler.add(gga_at(126000.0)));
+  EXPECT_EQ(0U, assembler.add(gga_at(-1.0)));
+  EXPECT_EQ(0U, assembler.add(GgaMessageData()));
+  EXPECT_EQ(4U, assembler.droppedMessages());
+  EXPECT_EQ(0U, assembler.pending());
+  EXPECT_EQ(0U, assembler.add(NmeaMessage()));
+  EXPECT_EQ(4U, assembler.droppedMessages());
+}
+
+// A VTG after a dropped GGA or AVR is dropped too, never joining the epoch
+// before it.
+TEST(NmeaEpochAssembler, vtgAfterDroppedMessage)
+{
+  NmeaEpochAssemblerConfig config;
+  config.timeoutMs = 1500U;
+  NmeaEpochAssembler assembler(config);
+  EXPECT_EQ(0U, assembler.add(gga_at(100.0)));
+  EXPECT_EQ(0U, assembler.add(vtg_of(10.0)));
+  EXPECT_EQ(0U, assembler.add(gga_at(126000.0)));
+  EXPECT_EQ(0U, assembler.add(vtg_of(20.0)));
+  EXPECT_EQ(0U, assembler.add(GgaMessageData()));
+  EXPECT_EQ(0U, assembler.add(vtg_of(30.0)));
+  EXPECT_EQ(4U, assembler.droppedMessages());
+  // Gives up 00:01:00 with the first VTG's velocity.
+  EXPECT_EQ(1U, assembler.add(avr_at(101.6, 1.0)));
+  NmeaNavigationEpoch epoch;
+  ASSERT_TRUE(assembler.next(epoch));
+  EXPECT_EQ(60000U, epoch.timeMs);
+  EXPECT_EQ(NMEA_EPOCH_POSITION | NMEA_EPOCH_VELOCITY, epoch.parts);
+  EXPECT_DOUBLE_EQ(10.0, epoch.velocity.trueTrackMadeGood);
+
+  // Too late for 00:01:00, so neither joins 00:01:01.
+  EXPECT_EQ(0U, assembler.add(avr_at(100.0, 2.0)));
+  EXPECT_EQ(0U, assembler.add(vtg_of(50.0)));
+  EXPECT_EQ(6U, assembler.droppedMessages());
+  EXPECT_EQ(1U, assembler.flush());
+  ASSERT_TRUE(assembler.next(epoch));
+  EXPECT_EQ(61000U, epoch.timeMs);
+  EXPECT_EQ(NMEA_EPOCH_HEADING, epoch.parts);
+  EXPECT_FALSE(epoch.velocity.valid);
+}
+
+TEST(NmeaEpochAssembler, boundedStorage)
+{
+  NmeaEpochAssemblerConfig config;
+  config.timeoutMs = 3600000U;
+  NmeaEpochAssembler assembler(config);
+  for (size_t i = 0U; i < NMEA_EPOCH_MAX_PENDING + 2U; ++i)
+  {
+    assembler.add(gga_at(static_cast<double>(i)));
+  }
+  EXPECT_EQ(NMEA_EPOCH_MAX_PENDING, assembler.pending());
+  EXPECT_EQ(2U, assembler.timedOut());
+  NmeaNavigationEpoch epoch;
+  ASSERT_TRUE(assembler.next(epoch));
+  EXPECT_EQ(0U, epoch.timeMs);
+
+  config.requiredParts = NMEA_EPOCH_POSITION;
+  NmeaEpochAssembler unread(config);
+  for (size_t i = 0U; i < NMEA_EPOCH_MAX_READY + 3U; ++i)
+  {
+    EXPECT_EQ(1U, unread.add(gga_at(static_cast<double>(i))));
+  }
+  EXPECT_EQ(NMEA_EPOCH_MAX_READY, unread.ready());
+  EXPECT_EQ(3U, unread.overwritten());
+  ASSERT_TRUE(unread.next(epoch));
+  EXPECT_EQ(3000U, epoch.timeMs);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_fields.hpp"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+
+using std::string;
+
+static NmeaField make_field(string const &text)
+{
+  return NmeaField(text.data(), text.data() + text.length());
+}
+
+TEST(NmeaFields, readerSplitsOnCommasAndStopsAtChecksum)
+{
+  string const body("a,,bc,d*7F\r\n");
+  NmeaFieldReader fields(body.data(), body.data() + body.length());
+  NmeaField field;
+  ASSERT_TRUE(fields.next(field));
+  EXPECT_EQ("a", string(field.begin, field.end));
+  ASSERT_TRUE(fields.next(field));
+  EXPECT_TRUE(field.empty());
+  ASSERT_TRUE(fields.next(field));
+  EXPECT_EQ("bc", string(field.begin, field.end));
+  ASSERT_TRUE(fields.next(field));
+  EXPECT_EQ("d", string(field.begin, field.end));
+  EXPECT_FALSE(fields.next(field));
+}
+
+TEST(NmeaFields, parseDoubleMatchesStod)
+{
+  std::mt19937 generator(42U);
+  std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+  for (int i = 0; i < 10000; ++i)
+  {
+    std::stringstream ss;
+    ss.precision(i % 17);
+    ss << std::fixed << distribution(generator);
+    string const text(ss.str());
+    double value = 0.0;
+    ASSERT_TRUE(parse_field_double(make_field(text), value)) << text;
+    double const expected = std::stod(text);
+    EXPECT_EQ(0, memcmp(&expected, &value, sizeof(value))) << text;
+  }
+}
+
+TEST(NmeaFields, parseDoubleFallsBackForUnusualSyntax)
+{
+  double value = 0.0;
+  EXPECT_TRUE(parse_field_double(make_field("+149.4688"), value));
+  EXPECT_DOUBLE_EQ(149.4688, value);
+  EXPECT_TRUE(parse_field_double(make_field("1.5e3"), value));
+  EXPECT_DOUBLE_EQ(1500.0, value);
+  EXPECT_TRUE(parse_field_double(make_field("12345678901234567890.5"), value));
+  EXPECT_DOUBLE_EQ(12345678901234567890.5, value);
+  EXPECT_FALSE(parse_field_double(make_field(""), value));
+  EXPECT_FALSE(parse_field_double(make_field("N"), value));
+}
+
+TEST(NmeaFields, parseInt)
+{
+  int32_t value = 0;
+  EXPECT_TRUE(parse_field_int(make_field("0001"), value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(parse_field_int(make_field("-16"), value));
+  EXPECT_EQ(-16, value);
+  EXPECT_FALSE(parse_field_int(make_field(""), value));
+  EXPECT_FALSE(parse_field_int(make_field("99999999999"), value));
+}
+
+TEST(NmeaFields, parseDegreesMinutes)
+{
+  double value = 0.0;
+  EXPECT_TRUE(parse_field_degrees_minutes(make_field("4807.038"), value));
+  EXPECT_DOUBLE_EQ(48.1173, value);
+  EXPECT_TRUE(parse_field_degrees_minutes(make_field("4807.538"), value));
+  EXPECT_DOUBLE_EQ(48.0 + 7.538 / 60.0, value);
+  EXPECT_FALSE(parse_field_degrees_minutes(make_field("4807"), value));
+  EXPECT_FALSE(parse_field_degrees_minutes(make_field("07.5"), value));
+  EXPECT_FALSE(parse_field_degrees_minutes(make_field(""), value));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,275 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_builder.hpp"
+#include "nmea_fix_log.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using std::string;
+
+static char const GGA_DIFFERENTIAL[] =
+    "$GPGGA,123519.25,4807.03812345,S,01131.000,W,2,08,0.9,545.4,M,-46.9,M,"
+    "3.2,0120*52";
+static char const GGA_EDGE[] = "$GPGGA,235959.999,0000.000001,N,"
+                               "17959.999999999,E,4,12,1.25,-12.345,M,0.0,M,,"
+                               "*73";
+static char const VTG[] = "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48";
+static char const VTG_NO_MAGNETIC[] = "$GPVTG,054.7,T,,M,005.5,N,010.2,K*65";
+static char const AVR[] =
+    "$PTNL,AVR,181059.6,+149.4688,Yaw,-0.0134,Tilt,,,60.191,3,2.5,6*06";
+static char const RMC[] = "$GPRMC,101010.5,A,4807.038,N,01131.000,E,022.4,"
+                          "084.4,230394,003.1,W*7D";
+
+class NmeaFixLogTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path_ = testing::TempDir() + "nmea_fix_log_utest.nfx";
+    textPath_ = testing::TempDir() + "nmea_fix_log_utest.nmea";
+  }
+
+  void TearDown() override
+  {
+    remove(path_.c_str());
+    remove(textPath_.c_str());
+  }
+
+  string path_;
+  string textPath_;
+};
+
+static void expect_same(GgaMessageData const &expected,
+                        GgaMessageData const &actual)
+{
+  EXPECT_TRUE(actual.valid);
+  EXPECT_EQ(expected.timestamp, actual.timestamp);
+  EXPECT_EQ(expected.latitude, actual.latitude);
+  EXPECT_EQ(expected.longitude, actual.longitude);
+  EXPECT_EQ(expected.fixQuality, actual.fixQuality);
+  EXPECT_EQ(expected.numSatellites, actual.numSatellites);
+  EXPECT_EQ(expected.hdop, actual.hdop);
+  EXPECT_EQ(expected.altitude, actual.altitude);
+  EXPECT_EQ(expected.geoidHeight, actual.geoidHeight);
+  ASSERT_EQ(expected.timeSinceLastDgpsValid, actual.timeSinceLastDgpsValid);
+  if (expected.timeSinceLastDgpsValid)
+  {
+    EXPECT_EQ(expected.timeSinceLastDgps, actual.timeSinceLastDgps);
+  }
+  ASSERT_EQ(expected.dgpdStationIDValid, actual.dgpdStationIDValid);
+  if (expected.dgpdStationIDValid)
+  {
+    EXPECT_EQ(expected.dgpdStationID, actual.dgpdStationID);
+  }
+}
+
+TEST_F(NmeaFixLogTest, decodesExactlyWhatWasParsed)
+{
+  GgaMessageData const gga_dgps(parse_gga(GGA_DIFFERENTIAL));
+  GgaMessageData const gga_edge(parse_gga(GGA_EDGE));
+  VtgMessageData const vtg(parse_vtg(VTG));
+  VtgMessageData const vtg_no_magnetic(parse_vtg(VTG_NO_MAGNETIC));
+  AvrMessageData const avr(parse_avr(AVR));
+  ASSERT_TRUE(gga_dgps.valid && gga_edge.valid && vtg.valid &&
+              vtg_no_magnetic.valid && avr.valid);
+
+  NmeaFixLogWriter writer;
+  ASSERT_TRUE(writer.open(path_));
+  EXPECT_TRUE(writer.append(gga_dgps));
+  EXPECT_TRUE(writer.append(vtg));
+  EXPECT_TRUE(writer.append(avr));
+  EXPECT_TRUE(writer.append(vtg_no_magnetic));
+  EXPECT_TRUE(writer.append(NmeaMessage(gga_edge)));
+  ASSERT_TRUE(writer.close());
+  EXPECT_EQ(5U, writer.records());
+  EXPECT_EQ(0U, writer.skipped());
+
+  NmeaFixLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  // the edge GGA is far from the first one, so it opens a second block
+  ASSERT_EQ(4U, reader.blocks());
+  EXPECT_EQ(2U, reader.count(NMEA_GGA));
+  EXPECT_EQ(2U, reader.count(NMEA_VTG));
+  EXPECT_EQ(1U, reader.count(NMEA_AVR));
+
+  // blocks still open at close() are written GGA, VTG, AVR
+  ASSERT_EQ(NMEA_GGA, reader.block(0U).type);
+  ASSERT_NE(nullptr, reader.gga(0U));
+  EXPECT_EQ(nullptr, reader.vtg(0U));
+  expect_same(gga_dgps, nmea_fix_decode(reader.block(0U), reader.gga(0U)[0]));
+  ASSERT_EQ(NMEA_GGA, reader.block(1U).type);
+  expect_same(gga_edge, nmea_fix_decode(reader.block(1U), reader.gga(1U)[0]));
+
+  ASSERT_EQ(NMEA_VTG, reader.block(2U).type);
+  ASSERT_EQ(2U, reader.block(2U).count);
+  NmeaFixVtgRecord const *const vtgs = reader.vtg(2U);
+  ASSERT_NE(nullptr, vtgs);
+  VtgMessageData const first(nmea_fix_decode(reader.block(2U), vtgs[0]));
+  EXPECT_EQ(vtg.trueTrackMadeGood, first.trueTrackMadeGood);
+  EXPECT_TRUE(first.magneticTrackMadeGoodValid);
+  EXPECT_EQ(vtg.magneticTrackMadeGood, first.magneticTrackMadeGood);
+  EXPECT_EQ(vtg.groundSpeedKnots, first.groundSpeedKnots);
+  EXPECT_EQ(vtg.groundSpeedKph, first.groundSpeedKph);
+  EXPECT_FALSE(
+      nmea_fix_decode(reader.block(2U), vtgs[1]).magneticTrackMadeGoodValid);
+  // each VTG carries the time of the fix before it
+  EXPECT_EQ((12U * 3600U + 35U * 60U + 19U) * 1000U + 250U,
+            nmea_fix_time_ms(reader.block(2U), vtgs[0].timeMs));
+  EXPECT_EQ((18U * 3600U + 10U * 60U + 59U) * 1000U + 600U,
+            nmea_fix_time_ms(reader.block(2U), vtgs[1].timeMs));
+
+  ASSERT_EQ(NMEA_AVR, reader.block(3U).type);
+  AvrMessageData const decoded(
+      nmea_fix_decode(reader.block(3U), reader.avr(3U)[0]));
+  EXPECT_TRUE(decoded.valid);
+  EXPECT_EQ(avr.timestamp, decoded.timestamp);
+  EXPECT_EQ(avr.yaw, decoded.yaw);
+  EXPECT_EQ(avr.tilt, decoded.tilt);
+  EXPECT_EQ(avr.range, decoded.range);
+  EXPECT_EQ(avr.fixQuality, decoded.fixQuality);
+  EXPECT_EQ(avr.pdop, decoded.pdop);
+  EXPECT_EQ(avr.numSatellites, decoded.numSatellites);
+}
+
+TEST_F(NmeaFixLogTest, splitsFullBlocksAndKeepsTimePresenceUniform)
+{
+  NmeaFixLogWriter writer(2U);
+  ASSERT_TRUE(writer.open(path_));
+  VtgMessageData const vtg(parse_vtg(VTG));
+  // no time seen yet
+  EXPECT_TRUE(writer.append(vtg));
+  // an RMC only sets the time of later VTGs
+  EXPECT_FALSE(writer.append(parse_nmea(RMC)));
+  EXPECT_TRUE(writer.append(vtg));
+  for (uint8_t second = 0U; second < 5U; ++second)
+  {
+    EXPECT_TRUE(writer.append(parse_gga(build_gga(
+        1U, 2U, second, 48.0, 11.0, GGA_GPS, 8U, 0.9, 545.4, 46.9))));
+  }
+  ASSERT_TRUE(writer.close());
+  // the timed VTG could not join the untimed one
+  EXPECT_EQ(5U, writer.blocks());
+
+  NmeaFixLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  ASSERT_EQ(5U, reader.blocks());
+  ASSERT_EQ(NMEA_VTG, reader.block(0U).type);
+  EXPECT_EQ(NMEA_LOG_NO_TIME,
+            nmea_fix_time_ms(reader.block(0U), reader.vtg(0U)[0].timeMs));
+  ASSERT_EQ(NMEA_VTG, reader.block(4U).type);
+  EXPECT_EQ((10U * 3600U + 10U * 60U + 10U) * 1000U + 500U,
+            reader.block(4U).baseTimeMs);
+  size_t ggas = 0U;
+  for (size_t b = 0U; b < reader.blocks(); ++b)
+  {
+    EXPECT_GE(2U, reader.block(b).count);
+    NmeaFixGgaRecord const *const records = reader.gga(b);
+    for (uint32_t i = 0U; nullptr != records && i < reader.block(b).count;
+         ++i)
+    {
+      GgaMessageData const gga(nmea_fix_decode(reader.block(b), records[i]));
+      EXPECT_EQ(10200.0 + static_cast<double>(ggas), gga.timestamp);
+      EXPECT_NEAR(48.0, gga.latitude, 1e-9);
+      ++ggas;
+    }
+  }
+  EXPECT_EQ(5U, ggas);
+}
+
+TEST_F(NmeaFixLogTest, skipsWhatItCannotStore)
+{
+  NmeaFixLogWriter writer;
+  EXPECT_FALSE(writer.append(parse_vtg(VTG)));
+  ASSERT_TRUE(writer.open(path_));
+  EXPECT_FALSE(writer.append(GgaMessageData()));
+  GgaMessageData leap_second(parse_gga(GGA_DIFFERENTIAL));
+  leap_second.timestamp = 235960.0;
+  EXPECT_FALSE(writer.append(leap_second));
+  VtgMessageData reversing(parse_vtg(VTG));
+  reversing.groundSpeedKnots = -1.0;
+  EXPECT_FALSE(writer.append(reversing));
+  AvrMessageData far(parse_avr(AVR));
+  far.range = 1e7;
+  EXPECT_FALSE(writer.append(far));
+  EXPECT_FALSE(writer.append(parse_nmea("$GPHDT,274.07,T*03")));
+  ASSERT_TRUE(writer.close());
+  EXPECT_EQ(0U, writer.records());
+  EXPECT_EQ(4U, writer.skipped());
+
+  NmeaFixLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_EQ(0U, reader.blocks());
+}
+
+TEST_F(NmeaFixLogTest, convertsTextLogs)
+{
+  {
+    std::ofstream text(textPath_.c_str(), std::ios::binary);
+    text << "garbage\r\n" << GGA_DIFFERENTIAL << "\r\n" << VTG << "\r\n";
+    text << "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n";
+    text << GGA_DIFFERENTIAL << "0\r\n";
+    // the last line has no terminator
+    text << AVR;
+  }
+  NmeaFixLogConversion conversion;
+  ASSERT_TRUE(nmea_fix_log_convert(textPath_, path_, conversion));
+  EXPECT_EQ(5U, conversion.sentences);
+  EXPECT_EQ(3U, conversion.records);
+  EXPECT_EQ(1U, conversion.skipped);
+  EXPECT_LT(conversion.fixBytes, conversion.textBytes);
+
+  NmeaFixLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_EQ(1U, reader.count(NMEA_GGA));
+  EXPECT_EQ(1U, reader.count(NMEA_VTG));
+  EXPECT_EQ(1U, reader.count(NMEA_AVR));
+
+  EXPECT_FALSE(
+      nmea_fix_log_convert(textPath_ + ".missing", path_, conversion));
+}
+
+TEST_F(NmeaFixLogTest, rejectsOtherAndTruncatedFiles)
+{
+  NmeaFixLogReader reader;
+  EXPECT_FALSE(reader.open(path_));
+  {
+    std::ofstream empty(path_.c_str(), std::ios::binary);
+  }
+  EXPECT_FALSE(reader.open(path_));
+  {
+    std::ofstream text(path_.c_str(), std::ios::binary);
+    text << GGA_DIFFERENTIAL << "\r\n";
+  }
+  EXPECT_FALSE(reader.open(path_));
+
+  NmeaFixLogWriter writer;
+  ASSERT_TRUE(writer.open(path_));
+  ASSERT_TRUE(writer.append(parse_gga(GGA_DIFFERENTIAL)));
+  ASSERT_TRUE(writer.close());
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_EQ(1U, reader.blocks());
+
+  string contents;
+  {
+    std::ifstream file(path_.c_str(), std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+  ASSERT_EQ(sizeof(NmeaFixLogHeader) + sizeof(NmeaFixBlockHeader) +
+                sizeof(NmeaFixGgaRecord),
+            contents.size());
+  {
+    std::ofstream truncated(path_.c_str(), std::ios::binary);
+    truncated << contents.substr(0U, contents.size() - 1U);
+  }
+  EXPECT_FALSE(reader.open(path_));
+  EXPECT_EQ(0U, reader.blocks());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,220 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_fix_query.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using std::vector;
+
+// A drive heading north-east from Munich at 10 Hz with the quality, hdop
+// and satellites wandering, a few rows holding NaN or a quality past the
+// query bits, and a length that ends in a partial tile and word.
+static void drive(size_t const count, GgaColumns &fixes)
+{
+  std::mt19937 generator(7U);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  GgaFixQuality const qualities[] = {GGA_GPS, GGA_DGPS, GGA_RTK_FIXED,
+                                     GGA_RTK_FLOAT};
+  double latitude = 48.1173;
+  double longitude = 11.5166667;
+  for (size_t i = 0U; i < count; ++i)
+  {
+    latitude += 2e-6 + 1e-6 * (unit(generator) - 0.5);
+    longitude += 3e-6 + 1e-6 * (unit(generator) - 0.5);
+    size_t const tenths = 400000U + i;
+    double const timestamp = static_cast<double>(tenths / 36000U) * 10000.0 +
+                             static_cast<double>(tenths / 600U % 60U) * 100.0 +
+                             static_cast<double>(tenths % 600U) / 10.0;
+    fixes.append(GgaMessageData(
+        timestamp, latitude, longitude, qualities[i / 700U % 4U],
+        static_cast<uint16_t>(4U + i / 300U % 12U),
+        0.5 + 1.5 * unit(generator), 545.4, 46.9));
+  }
+  double const nan = std::numeric_limits<double>::quiet_NaN();
+  fixes.hdop[17] = nan;
+  fixes.latitude[5000] = nan;
+  fixes.timestamp[9001] = nan;
+  fixes.fixQuality[12345] = 40U;
+}
+
+// The selection read straight from the columns, one row at a time, with the
+// fence left to the index's own scalar path. Row 12345's quality is no
+// GgaFixQuality, so the columns are read raw rather than through row().
+static bool naive_match(GgaColumns const &fixes, size_t const i,
+                        NmeaFixQuery const &query)
+{
+  uint32_t const quality = fixes.fixQuality[i];
+  return quality < 32U && 0U != ((query.fixQualities >> quality) & 1U) &&
+         fixes.hdop[i] < query.hdopBelow &&
+         fixes.numSatellites[i] >= query.minSatellites &&
+         fixes.latitude[i] >= query.minLatitude &&
+         fixes.latitude[i] <= query.maxLatitude &&
+         fixes.longitude[i] >= query.minLongitude &&
+         fixes.longitude[i] <= query.maxLongitude &&
+         fixes.timestamp[i] >= query.minTimestamp &&
+         fixes.timestamp[i] <= query.maxTimestamp;
+}
+
+static bool test_bit(vector<uint64_t> const &bitmap, size_t const i)
+{
+  return 0U != ((bitmap[i / 64U] >> (i % 64U)) & 1U);
+}
+
+TEST(NmeaFixQuery, defaultsSelectEveryNumber)
+{
+  GgaColumns fixes;
+  drive(20000U, fixes);
+  NmeaFixIndex const index(fixes);
+  EXPECT_EQ((fixes.size() + NMEA_FIX_TILE_ROWS - 1U) / NMEA_FIX_TILE_ROWS,
+            index.tiles().size());
+  vector<uint64_t> bitmap;
+  // Every row but the three with a NaN and the one past the quality bits.
+  EXPECT_EQ(fixes.size() - 4U, index.select(NmeaFixQuery(), bitmap));
+  ASSERT_EQ((fixes.size() + 63U) / 64U, bitmap.size());
+  EXPECT_FALSE(test_bit(bitmap, 17U));
+  EXPECT_FALSE(test_bit(bitmap, 5000U));
+  EXPECT_FALSE(test_bit(bitmap, 9001U));
+  EXPECT_FALSE(test_bit(bitmap, 12345U));
+  EXPECT_TRUE(test_bit(bitmap, fixes.size() - 1U));
+  EXPECT_EQ(0U, bitmap.back() >> (fixes.size() % 64U));
+  EXPECT_EQ(index.tiles().size(), index.candidate_tiles(NmeaFixQuery()));
+
+  GgaColumns empty;
+  NmeaFixIndex const none(empty);
+  EXPECT_EQ(0U, none.select(NmeaFixQuery(), bitmap));
+  EXPECT_TRUE(bitmap.empty());
+}
+
+TEST(NmeaFixQuery, matchesNaiveLoop)
+{
+  GgaColumns fixes;
+  drive(30011U, fixes);
+  NmeaFixIndex const index(fixes);
+  std::mt19937 generator(3U);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  size_t const rows = fixes.size();
+  for (size_t q = 0U; q < 200U; ++q)
+  {
+    // Around a random fix, from a point to most of the drive.
+    size_t const center =
+        static_cast<size_t>(unit(generator) * static_cast<double>(rows - 1U));
+    double const span = std::pow(10.0, -5.0 + 4.0 * unit(generator));
+    NmeaFixQuery query;
+    uint32_t const some = static_cast<uint32_t>(unit(generator) * 64.0);
+    query.fixQualities = 0U == q % 3U ? ~0U : some;
+    query.hdopBelow = 0.5 + 2.0 * unit(generator);
+    query.minSatellites = static_cast<uint16_t>(unit(generator) * 16.0);
+    query.minLatitude = fixes.latitude[center] - span;
+    query.maxLatitude = fixes.latitude[center] + span * unit(generator);
+    query.minLongitude = fixes.longitude[center] - span * unit(generator);
+    query.maxLongitude = fixes.longitude[center] + span;
+    if (0U == q % 4U)
+    {
+      query.minTimestamp = fixes.timestamp[center] - 100.0 * unit(generator);
+      query.maxTimestamp = fixes.timestamp[center] + 100.0 * unit(generator);
+    }
+    if (0U == q % 5U)
+    {
+      query.fenceLatitudes.push_back(query.minLatitude);
+      query.fenceLongitudes.push_back(query.minLongitude);
+      query.fenceLatitudes.push_back(query.maxLatitude);
+      query.fenceLongitudes.push_back(query.minLongitude);
+      query.fenceLatitudes.push_back(query.minLatitude);
+      query.fenceLongitudes.push_back(query.maxLongitude);
+      query.minLatitude = -90.0;
+      query.maxLatitude = 90.0;
+    }
+    vector<uint64_t> bitmap;
+    vector<uint64_t> scalar;
+    size_t const selected = index.select(query, bitmap);
+    ASSERT_EQ(selected, index.select_scalar(query, scalar)) << q;
+    ASSERT_EQ(scalar, bitmap) << q;
+    size_t naive = 0U;
+    for (size_t i = 0U; i < rows; ++i)
+    {
+      bool const match = naive_match(fixes, i, query);
+      naive += match ? 1U : 0U;
+      ASSERT_TRUE(match || !test_bit(bitmap, i)) << q << ' ' << i;
+      ASSERT_TRUE(!query.fenceLatitudes.empty() || match == test_bit(bitmap, i))
+          << q << ' ' << i;
+    }
+    ASSERT_TRUE(query.fenceLatitudes.empty() ? naive == selected
+                                             : naive >= selected)
+        << q;
+  }
+}
+
+TEST(NmeaFixQuery, prunesTiles)
+{
+  GgaColumns fixes;
+  drive(50000U, fixes);
+  NmeaFixIndex const index(fixes);
+  // A box around the start of the drive: a few tiles are scanned and the
+  // rest never read.
+  NmeaFixQuery query;
+  query.minLatitude = 48.1170;
+  query.maxLatitude = 48.1173 + 2e-6 * 1500.0;
+  query.minLongitude = 11.5;
+  query.maxLongitude = 11.6;
+  EXPECT_GE(3U, index.candidate_tiles(query));
+  vector<uint64_t> bitmap;
+  vector<uint64_t> scalar;
+  EXPECT_EQ(index.select_scalar(query, scalar), index.select(query, bitmap));
+  EXPECT_EQ(scalar, bitmap);
+
+  // Quality runs of 700 fixes, so RTK fixed alone leaves out whole tiles.
+  NmeaFixQuery rtk;
+  rtk.fixQualities = nmea_fix_quality_bit(GGA_RTK_FIXED);
+  rtk.hdopBelow = 1.0;
+  EXPECT_GT(index.tiles().size(), index.candidate_tiles(rtk));
+  EXPECT_EQ(index.select_scalar(rtk, scalar), index.select(rtk, bitmap));
+  EXPECT_EQ(scalar, bitmap);
+}
+
+TEST(NmeaFixQuery, geofence)
+{
+  GgaColumns fixes;
+  fixes.append(GgaMessageData(120000.0, 1.0, 1.0, GGA_GPS, 8U, 0.9, 0.0, 0.0));
+  fixes.append(GgaMessageData(120001.0, 1.0, 3.0, GGA_GPS, 8U, 0.9, 0.0, 0.0));
+  fixes.append(GgaMessageData(120002.0, 3.0, 1.0, GGA_GPS, 8U, 0.9, 0.0, 0.0));
+  fixes.append(GgaMessageData(120003.0, 2.5, 2.5, GGA_GPS, 8U, 0.9, 0.0, 0.0));
+  fixes.append(GgaMessageData(120004.0, 0.5, 3.5, GGA_GPS, 8U, 0.9, 0.0, 0.0));
+  fixes.append(GgaMessageData(120005.0, 5.0, 5.0, GGA_GPS, 8U, 0.9, 0.0, 0.0));
+  NmeaFixIndex const index(fixes);
+  // An L: the square from 0 to 4 without its upper right quarter.
+  NmeaFixQuery query;
+  double const latitudes[] = {0.0, 0.0, 2.0, 2.0, 4.0, 4.0};
+  double const longitudes[] = {0.0, 4.0, 4.0, 2.0, 2.0, 0.0};
+  query.fenceLatitudes.assign(latitudes, latitudes + 6);
+  query.fenceLongitudes.assign(longitudes, longitudes + 6);
+  vector<size_t> rows;
+  EXPECT_EQ(4U, index.select_rows(query, rows));
+  vector<size_t> const inside = {0U, 1U, 2U, 4U};
+  EXPECT_EQ(inside, rows);
+
+  query.minTimestamp = 120001.0;
+  query.maxTimestamp = 120002.0;
+  EXPECT_EQ(2U, index.select_rows(query, rows));
+  vector<size_t> const during = {1U, 2U};
+  EXPECT_EQ(during, rows);
+}
+
+TEST(NmeaFixQuery, selectionRows)
+{
+  vector<uint64_t> bitmap(3U, 0U);
+  bitmap[0] = 0x8000000000000001ULL;
+  bitmap[2] = 0x10U;
+  vector<size_t> rows(5U, 9U);
+  nmea_selection_rows(bitmap, rows);
+  vector<size_t> const expected = {0U, 63U, 132U};
+  EXPECT_EQ(expected, rows);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_format.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+
+using std::string;
+
+static string printf_fixed(double const value, int const precision)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  snprintf(text, sizeof(text), "%.*f", precision, value);
+  return text;
+}
+
+static string printf_general(double const value)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  snprintf(text, sizeof(text), "%g", value);
+  return text;
+}
+
+static string fixed(double const value, int const precision)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  size_t const length = format_fixed(value, precision, text);
+  return string(text, length);
+}
+
+static string general(double const value)
+{
+  char text[NMEA_NUMBER_BUFFER_LENGTH];
+  size_t const length = format_general(value, text);
+  return string(text, length);
+}
+
+TEST(NmeaFormat, fixedMatchesPrintf)
+{
+  std::mt19937_64 generator(3U);
+  std::uniform_real_distribution<double> uniform(-1e4, 1e4);
+  std::uniform_int_distribution<int> decades(-12, 20);
+  for (int i = 0; i < 200000; ++i)
+  {
+    double const value = uniform(generator) * std::pow(10.0, decades(generator));
+    int const precision = i % 10;
+    ASSERT_EQ(printf_fixed(value, precision), fixed(value, precision))
+        << value;
+  }
+}
+
+TEST(NmeaFormat, fixedTiesAndSpecialValues)
+{
+  double const values[] = {0.125,
+                           0.375,
+                           2.5,
+                           -0.0,
+                           -0.001,
+                           1.005,
+                           0.999999999,
+                           59.999999999,
+                           1e300,
+                           -1e19,
+                           std::numeric_limits<double>::max(),
+                           std::numeric_limits<double>::denorm_min(),
+                           std::numeric_limits<double>::infinity(),
+                           std::numeric_limits<double>::quiet_NaN()};
+  for (double const value : values)
+  {
+    for (int precision = 0; precision <= 17; ++precision)
+    {
+      ASSERT_EQ(printf_fixed(value, precision), fixed(value, precision))
+          << value << " " << precision;
+    }
+  }
+}
+
+TEST(NmeaFormat, generalMatchesPrintf)
+{
+  std::mt19937_64 generator(5U);
+  std::uniform_real_distribution<double> uniform(-10.0, 10.0);
+  std::uniform_int_distribution<int> decades(-8, 9);
+  for (int i = 0; i < 200000; ++i)
+  {
+    double value = uniform(generator) * std::pow(10.0, decades(generator));
+    if (0 == i % 3)
+    {
+      // short decimals such as hdop readings
+      value = std::round(value * 100.0) / 100.0;
+    }
+    ASSERT_EQ(printf_general(value), general(value)) << value;
+  }
+  double const values[] = {0.0,      -0.0,   0.9,       999999.5, 9999995.0,
+                           0.0001,   1e-5,   0.99999949, 0.9999995, 100000.0,
+                           123456.5, 1e6,    44.4};
+  for (double const value : values)
+  {
+    ASSERT_EQ(printf_general(value), general(value)) << value;
+  }
+}
+
+TEST(NmeaFormat, writerPadsInFrontOfSign)
+{
+  char buffer[32];
+  NmeaWriter writer(buffer, sizeof(buffer));
+  writer.put_fixed(-5.0, 1, 5U);
+  writer.put(',');
+  writer.put_uint(7U, 2U);
+  writer.put(',');
+  writer.put_hex_byte(0x5AU);
+  EXPECT_EQ("0-5.0,07,5A", string(buffer, writer.length()));
+}
+
+TEST(NmeaFormat, writerReportsOverflow)
+{
+  char buffer[4];
+  NmeaWriter writer(buffer, sizeof(buffer));
+  writer.put("abc", 3U);
+  EXPECT_EQ(3U, writer.length());
+  writer.put_fixed(1.5, 2);
+  EXPECT_TRUE(writer.overflowed());
+  EXPECT_EQ(0U, writer.length());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_geodetic.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Far below any receiver's noise, yet a few ulps of an ECEF coordinate.
+static double const TOLERANCE_M = 1e-8;
+
+// The same formulas in long double, with pi and the conversion to radians
+// carried at that precision too.
+static void reference_ecef(double const latitude_degrees,
+                           double const longitude_degrees,
+                           double const height_m, long double ecef[3])
+{
+  long double const pi = 3.141592653589793238462643383279502884L;
+  long double const f = 1.0L / 298.257223563L;
+  long double const e2 = f * (2.0L - f);
+  long double const latitude = latitude_degrees * pi / 180.0L;
+  long double const longitude = longitude_degrees * pi / 180.0L;
+  long double const n =
+      6378137.0L / std::sqrt(1.0L - e2 * std::sin(latitude) *
+                                        std::sin(latitude));
+  ecef[0] = (n + height_m) * std::cos(latitude) * std::cos(longitude);
+  ecef[1] = (n + height_m) * std::cos(latitude) * std::sin(longitude);
+  ecef[2] = (n * (1.0L - e2) + height_m) * std::sin(latitude);
+}
+
+static void reference_enu(double const latitude_degrees,
+                          double const longitude_degrees,
+                          double const height_m, double const origin[3],
+                          long double enu[3])
+{
+  long double const pi = 3.141592653589793238462643383279502884L;
+  long double point[3];
+  long double base[3];
+  reference_ecef(latitude_degrees, longitude_degrees, height_m, point);
+  reference_ecef(origin[0], origin[1], origin[2], base);
+  long double const latitude = origin[0] * pi / 180.0L;
+  long double const longitude = origin[1] * pi / 180.0L;
+  long double const d[3] = {point[0] - base[0], point[1] - base[1],
+                            point[2] - base[2]};
+  enu[0] = -std::sin(longitude) * d[0] + std::cos(longitude) * d[1];
+  enu[1] = -std::sin(latitude) * std::cos(longitude) * d[0] -
+           std::sin(latitude) * std::sin(longitude) * d[1] +
+           std::cos(latitude) * d[2];
+  enu[2] = std::cos(latitude) * std::cos(longitude) * d[0] +
+           std::cos(latitude) * std::sin(longitude) * d[1] +
+           std::sin(latitude) * d[2];
+}
+
+struct Points
+{
+  explicit Points(size_t const count)
+  {
+    std::mt19937 generator(11U);
+    std::uniform_real_distribution<double> latitude(-90.0, 90.0);
+    std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+    std::uniform_real_distribution<double> height(-500.0, 9000.0);
+    // The poles, the equator, the antimeridian and the quadrant edges of
+    // the sine and cosine first.
+    double const edges[] = {-90.0, -45.0, 0.0, 45.0, 90.0, 135.0, 180.0,
+                            -180.0, -135.0};
+    for (size_t i = 0U; i < count; ++i)
+    {
+      bool const edge = i < sizeof(edges) / sizeof(edges[0]);
+      latitudes.push_back(edge ? std::max(-90.0, std::min(90.0, edges[i]))
+                               : latitude(generator));
+      longitudes.push_back(edge ? edges[i] : longitude(generator));
+      heights.push_back(edge ? 0.0 : height(generator));
+    }
+  }
+
+  std::vector<double> latitudes;
+  std::vector<double> longitudes;
+  std::vector<double> heights;
+};
+
+TEST(NmeaGeodetic, knownPoints)
+{
+  double x = 0.0;
+  double y = 0.0;
+  double z = 0.0;
+  nmea_geodetic_to_ecef(0.0, 0.0, 0.0, x, y, z);
+  EXPECT_NEAR(6378137.0, x, TOLERANCE_M);
+  EXPECT_NEAR(0.0, y, TOLERANCE_M);
+  EXPECT_NEAR(0.0, z, TOLERANCE_M);
+  nmea_geodetic_to_ecef(90.0, 0.0, 0.0, x, y, z);
+  EXPECT_NEAR(0.0, x, TOLERANCE_M);
+  EXPECT_NEAR(6356752.314245179, z, 1e-6);
+  nmea_geodetic_to_ecef(0.0, 90.0, 100.0, x, y, z);
+  EXPECT_NEAR(6378237.0, y, TOLERANCE_M);
+
+  NmeaLocalFrame const frame(48.1173, 11.5166667, 545.4 + 46.9);
+  double east = 1.0;
+  double north = 1.0;
+  double up = 1.0;
+  frame.ecef_to_enu(frame.originX(), frame.originY(), frame.originZ(), east,
+                    north, up);
+  EXPECT_EQ(0.0, east);
+  EXPECT_EQ(0.0, north);
+  EXPECT_EQ(0.0, up);
+  // About 111.2 m per thousandth of a degree of latitude there.
+  nmea_geodetic_to_ecef(48.1183, 11.5166667, 545.4 + 46.9, x, y, z);
+  frame.ecef_to_enu(x, y, z, east, north, up);
+  EXPECT_NEAR(0.0, east, 1e-6);
+  EXPECT_NEAR(111.2, north, 0.1);
+  EXPECT_NEAR(0.0, up, 0.01);
+}
+
+TEST(NmeaGeodetic, batchesMatchReference)
+{
+  Points const points(10003U);
+  size_t const count = points.latitudes.size();
+  double const origin[3] = {48.1173, 11.5166667, 592.3};
+  NmeaLocalFrame const frame(origin[0], origin[1], origin[2]);
+  std::vector<double> x(count), y(count), z(count);
+  std::vector<double> sx(count), sy(count), sz(count);
+  std::vector<double> e(count), n(count), u(count);
+  std::vector<double> se(count), sn(count), su(count);
+  nmea_geodetic_to_ecef(points.latitudes.data(), points.longitudes.data(),
+                        points.heights.data(), count, x.data(), y.data(),
+                        z.data());
+  nmea_geodetic_to_ecef_scalar(
+      points.latitudes.data(), points.longitudes.data(), points.heights.data(),
+      count, sx.data(), sy.data(), sz.data());
+  nmea_geodetic_to_enu(points.latitudes.data(), points.longitudes.data(),
+                       points.heights.data(), count, frame, e.data(), n.data(),
+                       u.data());
+  nmea_geodetic_to_enu_scalar(points.latitudes.data(),
+                              points.longitudes.data(), points.heights.data(),
+                              count, frame, se.data(), sn.data(), su.data());
+  for (size_t i = 0U; i < count; ++i)
+  {
+    long double ecef[3];
+    long double enu[3];
+    reference_ecef(points.latitudes[i], points.longitudes[i],
+                   points.heights[i], ecef);
+    reference_enu(points.latitudes[i], points.longitudes[i],
+                  points.heights[i], origin, enu);
+    double const batch[6] = {x[i], y[i], z[i], e[i], n[i], u[i]};
+    double const scalar[6] = {sx[i], sy[i], sz[i], se[i], sn[i], su[i]};
+    long double const expected[6] = {ecef[0], ecef[1], ecef[2],
+                                     enu[0],  enu[1],  enu[2]};
+    for (size_t j = 0U; j < 6U; ++j)
+    {
+      ASSERT_NEAR(static_cast<double>(expected[j]), batch[j], TOLERANCE_M)
+          << i << ' ' << j;
+      ASSERT_NEAR(static_cast<double>(expected[j]), scalar[j], TOLERANCE_M)
+          << i << ' ' << j;
+    }
+  }
+}
+
+TEST(NmeaGeodetic, ggaColumns)
+{
+  GgaColumns fixes;
+  for (size_t i = 0U; i < 600U; ++i)
+  {
+    double const step = static_cast<double>(i);
+    fixes.append(GgaMessageData(123519.0, 48.1173 + step * 1e-5,
+                                11.5166667 - step * 1e-5, GGA_RTK_FIXED, 14U,
+                                0.8, 545.4 + step * 0.01, 46.9));
+  }
+  NmeaLocalFrame const frame(48.1173, 11.5166667, 545.4 + 46.9);
+  NmeaCartesianColumns ecef;
+  NmeaCartesianColumns enu;
+  nmea_gga_to_ecef(fixes, ecef);
+  nmea_gga_to_enu(fixes, frame, enu);
+  ASSERT_EQ(fixes.size(), ecef.size());
+  ASSERT_EQ(fixes.size(), enu.size());
+  for (size_t i = 0U; i < fixes.size(); ++i)
+  {
+    double const height = fixes.altitude[i] + fixes.geoidHeight[i];
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    nmea_geodetic_to_ecef(fixes.latitude[i], fixes.longitude[i], height, x, y,
+                          z);
+    ASSERT_NEAR(x, ecef.x[i], TOLERANCE_M) << i;
+    ASSERT_NEAR(y, ecef.y[i], TOLERANCE_M) << i;
+    ASSERT_NEAR(z, ecef.z[i], TOLERANCE_M) << i;
+    double east = 0.0;
+    double north = 0.0;
+    double up = 0.0;
+    frame.ecef_to_enu(x, y, z, east, north, up);
+    ASSERT_NEAR(east, enu.x[i], TOLERANCE_M) << i;
+    ASSERT_NEAR(north, enu.y[i], TOLERANCE_M) << i;
+    ASSERT_NEAR(up, enu.z[i], TOLERANCE_M) << i;
+  }
+  EXPECT_NEAR(0.0, enu.z[0], 1e-6);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
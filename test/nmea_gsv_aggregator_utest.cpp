@@ -0,0 +1,146 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_gsv_aggregator.hpp"
+#include "nmea_parser.hpp"
+
+static GsvMessageData gsv(char const *const talker, uint8_t const total,
+                          uint8_t const number, uint8_t const satellites,
+                          uint16_t const first_id)
+{
+  GsvMessageData message;
+  message.valid = true;
+  message.talker[0] = talker[0];
+  message.talker[1] = talker[1];
+  message.totalMessages = total;
+  message.messageNumber = number;
+  message.satellitesInView = static_cast<uint16_t>(4U * total);
+  message.numSatellites = satellites;
+  for (uint8_t i = 0U; i < satellites; ++i)
+  {
+    message.satellites[i].id = static_cast<uint16_t>(first_id + i);
+  }
+  return message;
+}
+
+TEST(NmeaGsvAggregator, joinsParsedGroup)
+{
+  NmeaGsvAggregator aggregator;
+  EXPECT_EQ(nullptr,
+            aggregator.add(parse_gsv("$GPGSV,2,1,08,01,40,083,46,02,17,308,41,"
+                                     "12,07,344,39,14,22,228,45*75")));
+  GsvSatelliteGroup const *const group =
+      aggregator.add(parse_gsv("$GPGSV,2,2,08,15,10,050,30,16,,,*45"));
+  ASSERT_NE(nullptr, group);
+  EXPECT_EQ('P', group->talker[1]);
+  EXPECT_EQ(8U, group->satellitesInView);
+  ASSERT_EQ(6U, group->numSatellites);
+  EXPECT_EQ(1U, group->satellites[0].id);
+  EXPECT_EQ(16U, group->satellites[5].id);
+  EXPECT_FALSE(group->satellites[5].snrValid);
+  EXPECT_EQ(1U, aggregator.groups());
+  EXPECT_EQ(0U, aggregator.dropped());
+}
+
+TEST(NmeaGsvAggregator, talkersAreSeparate)
+{
+  NmeaGsvAggregator aggregator;
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GP", 2U, 1U, 4U, 1U)));
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GL", 2U, 1U, 4U, 65U)));
+  GsvSatelliteGroup const *group = aggregator.add(gsv("GP", 2U, 2U, 2U, 5U));
+  ASSERT_NE(nullptr, group);
+  EXPECT_EQ(6U, group->numSatellites);
+  EXPECT_EQ(6U, group->satellites[5].id);
+  group = aggregator.add(gsv("GL", 2U, 2U, 1U, 69U));
+  ASSERT_NE(nullptr, group);
+  EXPECT_EQ('L', group->talker[1]);
+  EXPECT_EQ(5U, group->numSatellites);
+  EXPECT_EQ(69U, group->satellites[4].id);
+  EXPECT_EQ(2U, aggregator.groups());
+}
+
+TEST(NmeaGsvAggregator, dropsOutOfSequence)
+{
+  NmeaGsvAggregator aggregator;
+  // no first sentence
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GP", 3U, 2U, 4U, 5U)));
+  EXPECT_EQ(1U, aggregator.dropped());
+
+  // the second sentence is lost, so the first and third go too
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GP", 3U, 1U, 4U, 1U)));
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GP", 3U, 3U, 4U, 9U)));
+  EXPECT_EQ(3U, aggregator.dropped());
+
+  // a new group restarts cleanly after an interrupted one
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GP", 2U, 1U, 4U, 1U)));
+  EXPECT_EQ(nullptr, aggregator.add(gsv("GP", 2U, 1U, 4U, 1U)));
+  EXPECT_EQ(4U, aggregator.dropped());
+  GsvSatelliteGroup const *const group =
+      aggregator.add(gsv("GP", 2U, 2U, 4U, 5U));
+  ASSERT_NE(nullptr, group);
+  EXPECT_EQ(8U, group->numSatellites);
+
+  GsvMessageData invalid(gsv("GP", 1U, 1U, 0U, 0U));
+  invalid.valid = false;
+  EXPECT_EQ(nullptr, aggregator.add(invalid));
+  EXPECT_EQ(5U, aggregator.dropped());
+  EXPECT_EQ(1U, aggregator.groups());
+
+  aggregator.reset();
+  EXPECT_EQ(0U, aggregator.dropped());
+  EXPECT_EQ(0U, aggregator.groups());
+}
+
+// NMEA 4.11 multi-band output: five talkers with four signals each, more
+// than NMEA_GSV_MAX_GROUPS pairs, cycling every epoch.
+TEST(NmeaGsvAggregator, reusesSlotsForNewSignals)
+{
+  char const *const talkers[] = {"GP", "GL", "GA", "GB", "GQ"};
+  NmeaGsvAggregator aggregator;
+  for (size_t epoch = 0U; epoch < 3U; ++epoch)
+  {
+    for (size_t t = 0U; t < 5U; ++t)
+    {
+      for (uint8_t signal = 1U; signal <= 4U; ++signal)
+      {
+        GsvMessageData first(gsv(talkers[t], 2U, 1U, 4U, 1U));
+        GsvMessageData second(gsv(talkers[t], 2U, 2U, 1U, 5U));
+        first.signalIdValid = second.signalIdValid = true;
+        first.signalId = second.signalId = signal;
+        EXPECT_EQ(nullptr, aggregator.add(first));
+        GsvSatelliteGroup const *const group = aggregator.add(second);
+        ASSERT_NE(nullptr, group) << epoch << ' ' << t << ' ' << signal;
+        EXPECT_EQ(talkers[t][1], group->talker[1]);
+        EXPECT_EQ(signal, group->signalId);
+        EXPECT_EQ(5U, group->numSatellites);
+      }
+    }
+  }
+  EXPECT_EQ(60U, aggregator.groups());
+  EXPECT_EQ(0U, aggregator.dropped());
+
+  // With every slot in the middle of a group, the oldest one gives way and
+  // its partial group counts as dropped.
+  NmeaGsvAggregator busy;
+  for (uint8_t signal = 0U; signal < NMEA_GSV_MAX_GROUPS + 1U; ++signal)
+  {
+    GsvMessageData first(gsv("GP", 2U, 1U, 4U, 1U));
+    first.signalIdValid = true;
+    first.signalId = signal;
+    EXPECT_EQ(nullptr, busy.add(first));
+  }
+  EXPECT_EQ(1U, busy.dropped());
+  // The rest of the group given way is dropped without taking another slot.
+  GsvMessageData second(gsv("GP", 2U, 2U, 1U, 5U));
+  second.signalIdValid = true;
+  second.signalId = 0U;
+  EXPECT_EQ(nullptr, busy.add(second));
+  second.signalId = 1U;
+  EXPECT_NE(nullptr, busy.add(second));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_builder.hpp"
+#include "nmea_incremental_builder.hpp"
+#include <cmath>
+#include <random>
+#include <string>
+
+using std::string;
+
+static string text(NmeaIncrementalSentence const &builder)
+{
+  return string(builder.data(), builder.length());
+}
+
+TEST(NmeaIncrementalBuilder, ggaTrajectoryMatchesBuilder)
+{
+  // 10 Hz drive south across the equator while climbing past 100 m, through
+  // an hour boundary, with the satellite count and hdop changing now and
+  // then.
+  GgaIncrementalBuilder builder;
+  uint8_t hour = 23U;
+  uint8_t minute = 59U;
+  double seconds = 50.0;
+  double latitude = 0.0005;
+  double altitude = 99.5;
+  for (size_t i = 0U; i < 400U; ++i)
+  {
+    uint16_t const satellites = static_cast<uint16_t>(9U + i / 50U % 3U);
+    double const hdop = 0 == i / 70U % 2U ? 0.9 : 1.0;
+    GgaFixQuality const fix = 300U > i ? GGA_RTK_FIXED : GGA_RTK_FLOAT;
+    size_t const length =
+        builder.build(hour, minute, seconds, latitude, -11.5166667, fix,
+                      satellites, hdop, altitude, 46.9);
+    string const expected(build_gga(hour, minute, seconds, latitude,
+                                    -11.5166667, fix, satellites, hdop,
+                                    altitude, 46.9));
+    ASSERT_EQ(expected.length(), length) << i;
+    ASSERT_EQ(expected, text(builder)) << i;
+
+    int const tenths = static_cast<int>(seconds * 10.0 + 0.5) + 1;
+    seconds = static_cast<double>(tenths % 600) / 10.0;
+    if (0.0 == seconds)
+    {
+      minute = static_cast<uint8_t>((minute + 1U) % 60U);
+      hour = 0U == minute ? static_cast<uint8_t>((hour + 1U) % 24U) : hour;
+    }
+    latitude -= 0.0000031;
+    altitude += 0.013;
+  }
+  // Time, latitude and altitude change every sentence; only the width
+  // changes, such as 99.999 to 100.000 m or 0.9 to 1 hdop, rebuild.
+  EXPECT_GT(20U, builder.fullBuilds());
+  EXPECT_LT(3U * 380U, builder.patchedFields());
+}
+
+TEST(NmeaIncrementalBuilder, vtgTrajectoryMatchesBuilder)
+{
+  // Accelerating from standstill through a turn that wraps past north.
+  VtgIncrementalBuilder builder;
+  double track = 350.0;
+  double speed = 0.0;
+  for (size_t i = 0U; i < 300U; ++i)
+  {
+    size_t const length = builder.build(track, speed);
+    string const expected(build_vtg(track, speed));
+    ASSERT_EQ(expected.length(), length) << i;
+    ASSERT_EQ(expected, text(builder)) << i;
+    track = 360.0 <= track + 0.3 ? track + 0.3 - 360.0 : track + 0.3;
+    speed = 25.0 < speed ? speed : speed + 0.11;
+  }
+  EXPECT_GT(20U, builder.fullBuilds());
+}
+
+TEST(NmeaIncrementalBuilder, randomInputsMatchBuilder)
+{
+  // Each field jumps at random, often changing width, and sometimes stays.
+  std::mt19937 generator(7U);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::uniform_int_distribution<int> pick(0, 3);
+  GgaIncrementalBuilder gga;
+  VtgIncrementalBuilder vtg;
+  double values[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  uint16_t satellites = 0U;
+  for (size_t i = 0U; i < 5000U; ++i)
+  {
+    for (size_t j = 0U; j < 6U; ++j)
+    {
+      int const change = pick(generator);
+      values[j] = 0 == change ? unit(generator) * 1000.0
+                              : 1 == change ? -values[j] : values[j];
+    }
+    values[5] = 0 == pick(generator) ? -0.0 : values[5];
+    satellites =
+        0 == pick(generator) ? static_cast<uint16_t>(i % 13U) : satellites;
+    double const seconds = static_cast<double>(i % 600U) / 10.0;
+    GgaFixQuality const fix = static_cast<GgaFixQuality>(i / 7U % 6U);
+    double const hdop = std::fabs(values[3]) / 100.0;
+    gga.build(12U, 35U, seconds, values[0] / 11.0, values[1] / 5.5, fix,
+              satellites, hdop, values[4], values[5]);
+    ASSERT_EQ(build_gga(12U, 35U, seconds, values[0] / 11.0, values[1] / 5.5,
+                        fix, satellites, hdop, values[4], values[5]),
+              text(gga))
+        << i;
+    vtg.build(values[2], values[5]);
+    ASSERT_EQ(build_vtg(values[2], values[5]), text(vtg)) << i;
+  }
+  EXPECT_LT(0U, gga.patchedFields());
+  EXPECT_LT(0U, vtg.patchedFields());
+}
+
+TEST(NmeaIncrementalBuilder, resetBuildsFromScratch)
+{
+  VtgIncrementalBuilder builder;
+  builder.build(90.0, 10.0);
+  builder.build(90.1, 10.0);
+  EXPECT_EQ(1U, builder.fullBuilds());
+  EXPECT_EQ(1U, builder.patchedFields());
+  builder.reset();
+  EXPECT_EQ(0U, builder.length());
+  builder.build(90.1, 10.0);
+  EXPECT_EQ(2U, builder.fullBuilds());
+  EXPECT_EQ(build_vtg(90.1, 10.0), text(builder));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,230 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_ingest.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+static string const GGA(
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+static string const VTG("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+
+struct Received
+{
+  vector<size_t> sources;
+  vector<NmeaMessageType> types;
+  vector<NmeaParseErrorCode> errors;
+
+  NmeaIngestCallback callback()
+  {
+    return [this](NmeaIngestEvent const &event) {
+      sources.push_back(event.source);
+      types.push_back(event.message.type);
+      errors.push_back(event.error.code);
+    };
+  }
+};
+
+static void write_all(int const fd, string const &text)
+{
+  ASSERT_EQ(static_cast<ssize_t>(text.length()),
+            write(fd, text.data(), text.length()));
+}
+
+static void poll_until(NmeaIngestEngine &engine, size_t const sentences,
+                       size_t &delivered)
+{
+  for (int i = 0; i < 100 && delivered < sentences; ++i)
+  {
+    delivered += engine.poll(100);
+  }
+}
+
+TEST(NmeaIngestEngine, socketPairsFramePerSource)
+{
+  NmeaIngestEngine engine;
+  ASSERT_TRUE(engine.valid());
+  Received received;
+  int writers[3];
+  size_t ids[3];
+  for (size_t i = 0U; i < 3U; ++i)
+  {
+    int pair[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+    writers[i] = pair[0];
+    ASSERT_TRUE(engine.add_fd(pair[1], received.callback(), ids[i]));
+    EXPECT_EQ(i, ids[i]);
+  }
+  EXPECT_EQ(3U, engine.open_sources());
+
+  // sentences split across writes on different sources must not mix
+  write_all(writers[0], GGA.substr(0U, 30U));
+  write_all(writers[1], VTG + "\r\n$GPGLL,junk\r\n");
+  size_t delivered = 0U;
+  poll_until(engine, 2U, delivered);
+  write_all(writers[0], GGA.substr(30U) + "\r\n");
+  write_all(writers[2], GGA + "\r\n" + VTG + "\r\n");
+  poll_until(engine, 5U, delivered);
+  EXPECT_EQ(5U, delivered);
+  EXPECT_EQ(0U, engine.poll(0));
+
+  ASSERT_EQ(5U, received.sources.size());
+  vector<NmeaMessageType> by_source[3];
+  for (size_t i = 0U; i < received.sources.size(); ++i)
+  {
+    by_source[received.sources[i]].push_back(received.types[i]);
+  }
+  EXPECT_EQ(vector<NmeaMessageType>{NMEA_GGA}, by_source[0]);
+  ASSERT_EQ(2U, by_source[1].size());
+  EXPECT_EQ(NMEA_VTG, by_source[1][0]);
+  EXPECT_EQ(2U, engine.stats(ids[1]).sentences);
+  EXPECT_EQ(1U, engine.stats(ids[1]).parseErrors);
+  EXPECT_EQ((vector<NmeaMessageType>{NMEA_GGA, NMEA_VTG}), by_source[2]);
+  EXPECT_EQ(GGA.length() + 2U, engine.stats(ids[0]).bytes);
+  EXPECT_LE(1U, engine.stats(ids[0]).reads);
+
+  // hang-ups close their source; run() returns once none are left
+  for (size_t i = 0U; i < 3U; ++i)
+  {
+    close(writers[i]);
+  }
+  engine.run();
+  EXPECT_EQ(0U, engine.open_sources());
+  EXPECT_FALSE(engine.is_open(ids[0]));
+  EXPECT_FALSE(engine.remove(ids[0]));
+}
+
+TEST(NmeaIngestEngine, ptyAsSerialPort)
+{
+  int const master = posix_openpt(O_RDWR | O_NOCTTY);
+  ASSERT_LE(0, master);
+  ASSERT_EQ(0, grantpt(master));
+  ASSERT_EQ(0, unlockpt(master));
+  string const slave(ptsname(master));
+
+  NmeaIngestEngine engine;
+  Received received;
+  size_t id = 0U;
+  EXPECT_FALSE(engine.open_serial(slave, 12345U, received.callback(), id));
+  EXPECT_FALSE(
+      engine.open_serial("/nonexistent/tty", 9600U, received.callback(), id));
+  ASSERT_TRUE(engine.open_serial(slave, 9600U, received.callback(), id));
+
+  write_all(master, GGA + "\r\n" + VTG + "\r\n");
+  size_t delivered = 0U;
+  poll_until(engine, 2U, delivered);
+  ASSERT_EQ(2U, received.types.size());
+  EXPECT_EQ(NMEA_GGA, received.types[0]);
+  EXPECT_EQ(NMEA_PARSE_OK, received.errors[0]);
+  EXPECT_EQ(NMEA_VTG, received.types[1]);
+
+  close(master);
+  engine.run();
+  EXPECT_FALSE(engine.is_open(id));
+}
+
+TEST(NmeaIngestEngine, loopbackTcpFeed)
+{
+  int const listener = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_LE(0, listener);
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(0, bind(listener, reinterpret_cast<sockaddr *>(&address),
+                    sizeof(address)));
+  ASSERT_EQ(0, listen(listener, 4));
+  socklen_t length = sizeof(address);
+  ASSERT_EQ(0, getsockname(listener, reinterpret_cast<sockaddr *>(&address),
+                           &length));
+
+  NmeaIngestEngine engine;
+  Received received;
+  size_t id = 0U;
+  ASSERT_TRUE(engine.connect_tcp("127.0.0.1", ntohs(address.sin_port),
+                                 received.callback(), id));
+  int const feed = accept(listener, nullptr, nullptr);
+  ASSERT_LE(0, feed);
+  close(listener);
+
+  string stream;
+  for (size_t i = 0U; i < 500U; ++i)
+  {
+    stream += 0U == i % 2U ? GGA + "\r\n" : VTG + "\r\n";
+  }
+  std::thread writer([feed, &stream]() {
+    // tiny writes so sentences arrive cut at arbitrary points
+    for (size_t i = 0U; i < stream.length(); i += 7U)
+    {
+      size_t const count = std::min<size_t>(7U, stream.length() - i);
+      EXPECT_EQ(static_cast<ssize_t>(count),
+                write(feed, stream.data() + i, count));
+    }
+    close(feed);
+  });
+  engine.run();
+  writer.join();
+  ASSERT_EQ(500U, received.types.size());
+  for (size_t i = 0U; i < received.types.size(); ++i)
+  {
+    EXPECT_EQ(0U == i % 2U ? NMEA_GGA : NMEA_VTG, received.types[i]);
+    EXPECT_EQ(NMEA_PARSE_OK, received.errors[i]);
+  }
+  EXPECT_EQ(stream.length(), engine.stats(id).bytes);
+  EXPECT_EQ(0U, engine.framer(id).discardedBytes());
+}
+
+TEST(NmeaIngestEngine, stopAndRemoveFromCallbacks)
+{
+  NmeaIngestEngine engine;
+  int pair[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+  size_t id = 0U;
+  size_t calls = 0U;
+  // removing itself ends the sentences already framed from that read
+  ASSERT_TRUE(engine.add_fd(pair[1],
+                            [&engine, &calls](NmeaIngestEvent const &event) {
+                              ++calls;
+                              engine.remove(event.source);
+                            },
+                            id));
+  write_all(pair[0], GGA + "\r\n" + VTG + "\r\n");
+  EXPECT_EQ(1U, engine.poll(1000));
+  EXPECT_EQ(1U, calls);
+  EXPECT_FALSE(engine.is_open(id));
+  close(pair[0]);
+
+  // stop() from another thread wakes a run() with nothing to read
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+  ASSERT_TRUE(engine.add_fd(pair[1], NmeaIngestCallback(
+                                         [](NmeaIngestEvent const &) {}),
+                            id));
+  std::thread stopper([&engine]() {
+    usleep(20000);
+    engine.stop();
+  });
+  engine.run();
+  stopper.join();
+  EXPECT_TRUE(engine.is_open(id));
+  close(pair[0]);
+
+  EXPECT_FALSE(engine.add_fd(-1, NmeaIngestCallback(), id));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
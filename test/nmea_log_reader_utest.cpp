@@ -0,0 +1,196 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_builder.hpp"
+#include "nmea_log_reader.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+class NmeaLogReaderTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    path_ = testing::TempDir() + "nmea_log_reader_utest.nmea";
+    remove((path_ + ".idx").c_str());
+    std::ofstream log(path_.c_str(), std::ios::binary);
+    log << "garbage before the first sentence\n";
+    log << build_vtg(10.0, 1.0);
+    for (uint8_t minute = 0U; minute < 10U; ++minute)
+    {
+      log << build_gga(23U, minute, 30.5, 48.0 + minute, 11.0, GGA_GPS, 8U,
+                       0.9, 545.4, 46.9);
+      log << build_vtg(10.0 * minute, 1.0);
+    }
+  }
+
+  void TearDown() override
+  {
+    remove(path_.c_str());
+    remove((path_ + ".idx").c_str());
+  }
+
+  string path_;
+};
+
+TEST_F(NmeaLogReaderTest, indexesAndFindsTimeWindow)
+{
+  NmeaLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_FALSE(reader.indexFromSidecar());
+  ASSERT_EQ(21U, reader.size());
+  EXPECT_EQ(NMEA_VTG, reader.entry(0U).type);
+  EXPECT_EQ(NMEA_LOG_NO_TIME, reader.entry(0U).timeMs);
+  EXPECT_EQ(NMEA_GGA, reader.entry(1U).type);
+  EXPECT_EQ((23U * 3600U + 30U) * 1000U + 500U, reader.entry(1U).timeMs);
+  EXPECT_EQ(reader.entry(1U).timeMs, reader.entry(2U).timeMs);
+
+  vector<size_t> matches;
+  EXPECT_EQ(3U, reader.find(NMEA_GGA, 230200.0, 230431.0, matches));
+  ASSERT_EQ(3U, matches.size());
+  NmeaMessage const first(reader.decode(matches[0]));
+  ASSERT_EQ(NMEA_GGA, first.type);
+  ASSERT_TRUE(first.valid());
+  EXPECT_DOUBLE_EQ(230230.5, first.gga.timestamp);
+  EXPECT_NEAR(50.0, first.gga.latitude, 1e-9);
+
+  matches.clear();
+  EXPECT_EQ(3U, reader.find(NMEA_VTG, 230200.0, 230431.0, matches));
+  // 12:60:00 is no time of day rather than 13:00:00.
+  EXPECT_EQ(0U, reader.find(NMEA_GGA, 126000.0, 235959.0, matches));
+  EXPECT_EQ(3U, matches.size());
+
+  // Across midnight: 23:08 until 00:10.
+  matches.clear();
+  EXPECT_EQ(2U, reader.find(NMEA_GGA, 230800.0, 1000.0, matches));
+  ASSERT_EQ(2U, matches.size());
+  EXPECT_DOUBLE_EQ(230830.5, reader.decode(matches[0]).gga.timestamp);
+  EXPECT_DOUBLE_EQ(230930.5, reader.decode(matches[1]).gga.timestamp);
+}
+
+TEST_F(NmeaLogReaderTest, reusesSidecarUntilLogChanges)
+{
+  vector<size_t> first_matches;
+  {
+    NmeaLogReader reader;
+    ASSERT_TRUE(reader.open(path_));
+    reader.find(NMEA_GGA, 0.0, 235959.0, first_matches);
+  }
+  {
+    NmeaLogReader reader;
+    ASSERT_TRUE(reader.open(path_));
+    EXPECT_TRUE(reader.indexFromSidecar());
+    vector<size_t> matches;
+    reader.find(NMEA_GGA, 0.0, 235959.0, matches);
+    EXPECT_EQ(first_matches, matches);
+    EXPECT_TRUE(reader.decode(matches.back()).valid());
+  }
+  {
+    std::ofstream log(path_.c_str(), std::ios::binary | std::ios::app);
+    log << build_vtg(1.0, 1.0);
+  }
+  NmeaLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_FALSE(reader.indexFromSidecar());
+  EXPECT_EQ(22U, reader.size());
+}
+
+// A reader mapping the old sidecar keeps it while another rebuilds it for the
+// grown log: the rebuild replaces the file rather than truncating it.
+TEST_F(NmeaLogReaderTest, rebuildLeavesMappedSidecarIntact)
+{
+  {
+    NmeaLogReader reader;
+    ASSERT_TRUE(reader.open(path_));
+  }
+  NmeaLogReader old_reader;
+  ASSERT_TRUE(old_reader.open(path_));
+  ASSERT_TRUE(old_reader.indexFromSidecar());
+  struct stat old_status;
+  ASSERT_EQ(0, stat((path_ + ".idx").c_str(), &old_status));
+  {
+    std::ofstream log(path_.c_str(), std::ios::binary | std::ios::app);
+    log << build_vtg(1.0, 1.0);
+  }
+  NmeaLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_FALSE(reader.indexFromSidecar());
+  EXPECT_EQ(22U, reader.size());
+  struct stat status;
+  ASSERT_EQ(0, stat((path_ + ".idx").c_str(), &status));
+  EXPECT_NE(old_status.st_ino, status.st_ino);
+  ASSERT_EQ(21U, old_reader.size());
+  EXPECT_EQ(NMEA_VTG, old_reader.entry(20U).type);
+  EXPECT_TRUE(old_reader.decode(20U).valid());
+  NmeaLogReader again;
+  ASSERT_TRUE(again.open(path_));
+  EXPECT_TRUE(again.indexFromSidecar());
+  EXPECT_EQ(22U, again.size());
+}
+
+// Overwrites 8 bytes of the sidecar at offset.
+static void patch_sidecar(string const &index_path, std::streamoff const offset,
+                          uint64_t const value)
+{
+  std::fstream index(index_path.c_str(),
+                     std::ios::binary | std::ios::in | std::ios::out);
+  index.seekp(offset);
+  index.write(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+TEST_F(NmeaLogReaderTest, rebuildsCorruptSidecar)
+{
+  string const index_path(path_ + ".idx");
+  size_t count = 0U;
+  {
+    NmeaLogReader reader;
+    ASSERT_TRUE(reader.open(path_));
+    count = reader.size();
+  }
+  // A count that wraps around to the file's length once multiplied by the
+  // entry size. The header's count is at byte 32.
+  patch_sidecar(index_path, 32, (static_cast<uint64_t>(1U) << 60) + count);
+  {
+    NmeaLogReader reader;
+    ASSERT_TRUE(reader.open(path_));
+    EXPECT_FALSE(reader.indexFromSidecar());
+    EXPECT_EQ(count, reader.size());
+  }
+  // The rebuilt sidecar, with its last entry's offset past the log. Entries
+  // start at byte 40 and are 16 bytes each.
+  patch_sidecar(index_path,
+                static_cast<std::streamoff>(40U + 16U * (count - 1U)),
+                1U << 30);
+  NmeaLogReader reader;
+  ASSERT_TRUE(reader.open(path_));
+  EXPECT_FALSE(reader.indexFromSidecar());
+  ASSERT_EQ(count, reader.size());
+  EXPECT_TRUE(reader.decode(count - 1U).valid());
+}
+
+TEST(NmeaLogReader, missingAndEmptyFiles)
+{
+  NmeaLogReader reader;
+  EXPECT_FALSE(reader.open(testing::TempDir() + "does_not_exist.nmea"));
+  string const empty_path(testing::TempDir() + "nmea_log_reader_empty.nmea");
+  {
+    std::ofstream empty(empty_path.c_str());
+  }
+  EXPECT_TRUE(reader.open(empty_path));
+  EXPECT_EQ(0U, reader.size());
+  reader.close();
+  remove(empty_path.c_str());
+  remove((empty_path + ".idx").c_str());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
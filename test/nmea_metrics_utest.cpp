@@ -0,0 +1,132 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_metrics.hpp"
+#include "nmea_parser.hpp"
+#include <string>
+#include <thread>
+
+using std::string;
+
+static string const GGA(
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+static string const VTG("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+static string const BAD_CHECKSUM(
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48");
+
+// Counters are process wide and only grow, so tests compare differences.
+static NmeaMetricsSnapshot snapshot()
+{
+  NmeaMetricsSnapshot taken;
+  nmea_metrics_snapshot(taken);
+  return taken;
+}
+
+TEST(NmeaMetrics, typeNames)
+{
+  EXPECT_STREQ("unknown", nmea_message_type_name(NMEA_UNKNOWN));
+  EXPECT_STREQ("gga", nmea_message_type_name(NMEA_GGA));
+  EXPECT_STREQ("gns", nmea_message_type_name(NMEA_GNS));
+  EXPECT_STREQ("unknown",
+               nmea_message_type_name(static_cast<NmeaMessageType>(99)));
+}
+
+TEST(NmeaMetrics, countsEveryParseByTypeAndResult)
+{
+  NmeaMetricsSnapshot const before(snapshot());
+  for (int i = 0; i < 200; ++i)
+  {
+    parse_gga(GGA);
+  }
+  parse_nmea(VTG);
+  parse_gga(VTG);
+  parse_gga(BAD_CHECKSUM);
+  parse_nmea("$GPXYZ,1,2,3*00");
+  parse_nmea("garbage");
+  NmeaMetricsSnapshot const after(snapshot());
+
+  if (!nmea_metrics_enabled())
+  {
+    EXPECT_EQ(0U, after.sentences_total());
+    EXPECT_EQ(0U, after[NMEA_GGA].latency.count());
+  }
+  else
+  {
+    EXPECT_EQ(205U, after.sentences_total() - before.sentences_total());
+    EXPECT_EQ(200U, after[NMEA_GGA].parsed() - before[NMEA_GGA].parsed());
+    EXPECT_EQ(1U, after[NMEA_GGA].checksumFailures() -
+                      before[NMEA_GGA].checksumFailures());
+    EXPECT_EQ(1U, after[NMEA_GGA].invalid() - before[NMEA_GGA].invalid());
+    // the VTG handed to parse_gga counts as a VTG
+    EXPECT_EQ(1U, after[NMEA_VTG].parsed() - before[NMEA_VTG].parsed());
+    EXPECT_EQ(1U, after[NMEA_VTG].results.count(NMEA_PARSE_WRONG_SENTENCE) -
+                      before[NMEA_VTG].results.count(
+                          NMEA_PARSE_WRONG_SENTENCE));
+    EXPECT_EQ(2U,
+              after[NMEA_UNKNOWN].invalid() - before[NMEA_UNKNOWN].invalid());
+    // one call in NMEA_METRICS_SAMPLE_PERIOD is timed
+    EXPECT_LE(200U / NMEA_METRICS_SAMPLE_PERIOD,
+              after[NMEA_GGA].latency.count() -
+                  before[NMEA_GGA].latency.count());
+  }
+}
+
+TEST(NmeaMetrics, threadsAreSummedAfterTheyExit)
+{
+  NmeaMetricsSnapshot const before(snapshot());
+  std::thread workers[4];
+  for (size_t i = 0U; i < 4U; ++i)
+  {
+    workers[i] = std::thread([]() {
+      for (int j = 0; j < 1000; ++j)
+      {
+        parse_nmea(VTG);
+      }
+    });
+  }
+  for (size_t i = 0U; i < 4U; ++i)
+  {
+    workers[i].join();
+  }
+  // a new thread reuses an exited thread's block without losing its counts
+  std::thread([]() { parse_nmea(VTG); }).join();
+  NmeaMetricsSnapshot const after(snapshot());
+  uint64_t const expected = nmea_metrics_enabled() ? 4001U : 0U;
+  EXPECT_EQ(expected, after[NMEA_VTG].parsed() - before[NMEA_VTG].parsed());
+}
+
+TEST(NmeaMetrics, prometheusText)
+{
+  NmeaMetricsSnapshot manual;
+  manual.sentences[NMEA_GGA].results.add(NMEA_PARSE_OK, 12U);
+  manual.sentences[NMEA_GGA].results.add(NMEA_PARSE_CHECKSUM_MISMATCH, 3U);
+  manual.sentences[NMEA_GGA].latency.record(100U, 4U);
+  manual.sentences[NMEA_GGA].latency.record(5000U);
+  string const text(nmea_metrics_prometheus(manual));
+  EXPECT_NE(string::npos, text.find("# TYPE nmea_sentences_total counter\n"));
+  EXPECT_NE(string::npos,
+            text.find("nmea_sentences_total{type=\"gga\",result=\"ok\"} 12\n"));
+  EXPECT_NE(string::npos, text.find("nmea_sentences_total{type=\"gga\","
+                                    "result=\"checksum_mismatch\"} 3\n"));
+  EXPECT_EQ(string::npos, text.find("type=\"vtg\""));
+  EXPECT_NE(string::npos,
+            text.find("# TYPE nmea_parse_duration_seconds histogram\n"));
+  EXPECT_NE(string::npos, text.find("nmea_parse_duration_seconds_bucket{"
+                                    "type=\"gga\",le=\"6.4e-08\"} 0\n"));
+  EXPECT_NE(string::npos, text.find("nmea_parse_duration_seconds_bucket{"
+                                    "type=\"gga\",le=\"1.28e-07\"} 4\n"));
+  EXPECT_NE(string::npos, text.find("nmea_parse_duration_seconds_bucket{"
+                                    "type=\"gga\",le=\"8.192e-06\"} 5\n"));
+  EXPECT_NE(string::npos, text.find("nmea_parse_duration_seconds_bucket{"
+                                    "type=\"gga\",le=\"+Inf\"} 5\n"));
+  EXPECT_NE(string::npos,
+            text.find("nmea_parse_duration_seconds_count{type=\"gga\"} 5\n"));
+  EXPECT_NE(string::npos,
+            text.find("nmea_parse_duration_seconds_sum{type=\"gga\"} 5.4e-06"));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,174 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_parser.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+static string const GGA(
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+static string const VTG("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+static string const AVR("$PTNL,AVR,212405.20,+52.1531,Yaw,-0.0806,Tilt,,,"
+                        "12.575,3,1.4,16*39");
+
+static NmeaParseError gga_error(string const &sentence)
+{
+  NmeaParseError error;
+  parse_gga(sentence.data(), sentence.length(), error, NMEA_SKIP_CHECKSUM);
+  return error;
+}
+
+TEST(NmeaParseError, validSentencesReportOk)
+{
+  NmeaParseError error(NMEA_PARSE_BAD_NUMBER, 3U);
+  EXPECT_TRUE(parse_gga(GGA.data(), GGA.length(), error).valid);
+  EXPECT_TRUE(error.ok());
+  EXPECT_TRUE(parse_vtg(VTG.data(), VTG.length(), error).valid);
+  EXPECT_TRUE(error.ok());
+  EXPECT_TRUE(parse_avr(AVR.data(), AVR.length(), error).valid);
+  EXPECT_TRUE(error.ok());
+}
+
+TEST(NmeaParseError, ggaWithoutFixNamesTheEmptyTimeField)
+{
+  NmeaParseError const error(gga_error("$GPGGA,,,,,,0,00,99.99,,,,,,*48"));
+  EXPECT_EQ(NMEA_PARSE_EMPTY_FIELD, error.code);
+  EXPECT_EQ(1U, error.field);
+}
+
+TEST(NmeaParseError, fieldPositions)
+{
+  NmeaParseError error(gga_error(
+      "$GPGGA,123519,4807,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47"));
+  EXPECT_EQ(NMEA_PARSE_BAD_NUMBER, error.code);
+  EXPECT_EQ(2U, error.field);
+
+  error = gga_error(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,70000,0.9,545.4,M,46.9,M,,*47");
+  EXPECT_EQ(NMEA_PARSE_OUT_OF_RANGE, error.code);
+  EXPECT_EQ(7U, error.field);
+
+  error = gga_error(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,x,*47");
+  EXPECT_EQ(NMEA_PARSE_BAD_NUMBER, error.code);
+  EXPECT_EQ(13U, error.field);
+
+  error = gga_error("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9*47");
+  EXPECT_EQ(NMEA_PARSE_MISSING_FIELD, error.code);
+  EXPECT_EQ(9U, error.field);
+
+  string const vtg("$GPVTG,054.7,T,034.4,M,,N,010.2,K*48");
+  parse_vtg(vtg.data(), vtg.length(), error, NMEA_SKIP_CHECKSUM);
+  EXPECT_EQ(NMEA_PARSE_EMPTY_FIELD, error.code);
+  EXPECT_EQ(5U, error.field);
+}
+
+TEST(NmeaParseError, headerErrors)
+{
+  NmeaParseError error;
+  string const gll("$GPGLL,4916.45,N,12311.12,W,225444,A*31");
+  parse_nmea(gll.data(), gll.length(), error);
+  EXPECT_EQ(NMEA_PARSE_UNSUPPORTED_SENTENCE, error.code);
+  EXPECT_EQ(0U, error.field);
+
+  parse_nmea("GPGGA", 5U, error);
+  EXPECT_EQ(NMEA_PARSE_MALFORMED_HEADER, error.code);
+
+  parse_gga(VTG.data(), VTG.length(), error);
+  EXPECT_EQ(NMEA_PARSE_WRONG_SENTENCE, error.code);
+
+  string bad_checksum(GGA);
+  bad_checksum[bad_checksum.length() - 1U] = '8';
+  parse_nmea(bad_checksum.data(), bad_checksum.length(), error);
+  EXPECT_EQ(NMEA_PARSE_CHECKSUM_MISMATCH, error.code);
+  EXPECT_TRUE(parse_nmea(bad_checksum.data(), bad_checksum.length(), error,
+                         NMEA_SKIP_CHECKSUM)
+                  .valid());
+  EXPECT_TRUE(error.ok());
+}
+
+TEST(NmeaParseError, statsCountEachCode)
+{
+  NmeaParseStats stats;
+  NmeaParseError error;
+  parse_nmea(GGA.data(), GGA.length(), error);
+  stats.record(error);
+  parse_nmea(VTG.data(), VTG.length() - 1U, error);
+  stats.record(error);
+  parse_nmea(VTG.data(), VTG.length(), error);
+  stats.record(error);
+  EXPECT_EQ(3U, stats.sentences());
+  EXPECT_EQ(1U, stats.failures());
+  EXPECT_EQ(2U, stats.count(NMEA_PARSE_OK));
+  EXPECT_EQ(1U, stats.count(NMEA_PARSE_CHECKSUM_MISMATCH));
+
+  NmeaParseStats other;
+  other.record(NmeaParseError(NMEA_PARSE_EMPTY_FIELD, 1U));
+  stats.merge(other);
+  EXPECT_EQ(2U, stats.failures());
+  EXPECT_STREQ("empty_field", nmea_parse_error_name(NMEA_PARSE_EMPTY_FIELD));
+  stats.reset();
+  EXPECT_EQ(0U, stats.sentences());
+}
+
+// Every mutation is parsed from an exactly sized heap copy so a sanitizer
+// build catches any read past the end; validity must always agree with the
+// reported error.
+TEST(NmeaParseError, randomMutationsNeverThrow)
+{
+  std::mt19937 generator(2016U);
+  string const seeds[] = {GGA, VTG, AVR};
+  char const alphabet[] = "0123456789.,-+*$NEWSMTKe\r\n\0\xff";
+  for (int i = 0; i < 200000; ++i)
+  {
+    string input(seeds[generator() % 3U]);
+    size_t const mutations = 1U + generator() % 4U;
+    for (size_t m = 0U; m < mutations && !input.empty(); ++m)
+    {
+      size_t const position = generator() % input.length();
+      char const c = alphabet[generator() % (sizeof(alphabet) - 1U)];
+      switch (generator() % 3U)
+      {
+      case 0U:
+        input[position] = c;
+        break;
+      case 1U:
+        input.insert(position, 1U, c);
+        break;
+      default:
+        input.erase(position, 1U + generator() % 8U);
+        break;
+      }
+    }
+    vector<char> const exact(input.begin(), input.end());
+    char const *const data = exact.empty() ? nullptr : exact.data();
+    NmeaParseError error;
+    for (int mode = 0; mode < 2; ++mode)
+    {
+      NmeaChecksumMode const checksum_mode =
+          0 == mode ? NMEA_VERIFY_CHECKSUM : NMEA_SKIP_CHECKSUM;
+      bool const nmea_valid =
+          parse_nmea(data, exact.size(), error, checksum_mode).valid();
+      ASSERT_EQ(nmea_valid, error.ok()) << input;
+      bool const gga_valid =
+          parse_gga(data, exact.size(), error, checksum_mode).valid;
+      ASSERT_EQ(gga_valid, error.ok()) << input;
+      bool const vtg_valid =
+          parse_vtg(data, exact.size(), error, checksum_mode).valid;
+      ASSERT_EQ(vtg_valid, error.ok()) << input;
+      bool const avr_valid =
+          parse_avr(data, exact.size(), error, checksum_mode).valid;
+      ASSERT_EQ(avr_valid, error.ok()) << input;
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -2,6 +2,45 @@
 
 #include "nmea_parser.hpp"
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static size_t allocation_count = 0U;
+
+__attribute__((noinline)) void *operator new(size_t size)
+{
+  ++allocation_count;
+  void *const memory = malloc(size);
+  if (nullptr == memory)
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+// Every delete is replaced along with new, or the library's own sized and
+// array deletes would free malloc'd memory, which ASan reports as a
+// mismatch. new and delete stay out of line so GCC does not pair malloc()
+// or free() with the operator at the other end.
+__attribute__((noinline)) void operator delete(void *memory) noexcept
+{
+  free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+  operator delete(memory);
+}
+
+void operator delete[](void *memory) noexcept { operator delete(memory); }
+
+void operator delete[](void *memory, size_t) noexcept
+{
+  operator delete(memory);
+}
 
 TEST(NmeaParser, parseInvalidAvr)
 {
@@ -49,7 +88,7 @@ TEST(NmeaParser, parseValidGgaNoTimeSinceLastDgpsNoDgpsStationIDValid)
 TEST(NmeaParser, parseValidGgaTimeSinceLastDgpsNoDgpsStationIDValid)
 {
   GgaMessageData const parsed_message(parse_gga(
-      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,5,*47"));
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,5,*72"));
   EXPECT_TRUE(parsed_message.valid);
   EXPECT_DOUBLE_EQ(123519.0, parsed_message.timestamp);
   EXPECT_DOUBLE_EQ(48.1173, parsed_message.latitude);
@@ -67,7 +106,7 @@ TEST(NmeaParser, parseValidGgaTimeSinceLastDgpsNoDgpsStationIDValid)
 TEST(NmeaParser, parseValidGgaNoTimeSinceLastDgpsDgpsStationIDValid)
 {
   GgaMessageData const parsed_message(parse_gga(
-      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,0001*47"));
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,0001*46"));
   EXPECT_TRUE(parsed_message.valid);
   EXPECT_DOUBLE_EQ(123519.0, parsed_message.timestamp);
   EXPECT_DOUBLE_EQ(48.1173, parsed_message.latitude);
@@ -103,7 +142,7 @@ TEST(NmeaParser, parseValidVtgMagneticTrackMadeGood)
 TEST(NmeaParser, parseValidVtgNoMagneticTrackMadeGood)
 {
   VtgMessageData const parsed_message(
-      parse_vtg("$GPVTG,054.7,T,,M,005.5,N,010.2,K*48"));
+      parse_vtg("$GPVTG,054.7,T,,M,005.5,N,010.2,K*65"));
   EXPECT_TRUE(parsed_message.valid);
   EXPECT_DOUBLE_EQ(54.7, parsed_message.trueTrackMadeGood);
   EXPECT_FALSE(parsed_message.magneticTrackMadeGoodValid);
@@ -111,6 +150,123 @@ TEST(NmeaParser, parseValidVtgNoMagneticTrackMadeGood)
   EXPECT_DOUBLE_EQ(10.2, parsed_message.groundSpeedKph);
 }
 
+TEST(NmeaParser, parseGgaFromUnterminatedBuffer)
+{
+  char const sentence[] =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47";
+  char buffer[sizeof(sentence) + 8U];
+  memset(buffer, '9', sizeof(buffer));
+  memcpy(buffer, sentence, sizeof(sentence) - 1U);
+  GgaMessageData const parsed_message(
+      parse_gga(buffer, sizeof(sentence) - 1U));
+  EXPECT_TRUE(parsed_message.valid);
+  EXPECT_DOUBLE_EQ(48.1173, parsed_message.latitude);
+  EXPECT_FALSE(parsed_message.dgpdStationIDValid);
+}
+
+TEST(NmeaParser, parseGgaMinutesWithFraction)
+{
+  GgaMessageData const parsed_message(parse_gga(
+      "$GPGGA,123519,4807.538,S,01131.750,W,1,08,0.9,545.4,M,46.9,M,,*4F"));
+  EXPECT_TRUE(parsed_message.valid);
+  EXPECT_DOUBLE_EQ(-(48.0 + 7.538 / 60.0), parsed_message.latitude);
+  EXPECT_DOUBLE_EQ(-(11.0 + 31.75 / 60.0), parsed_message.longitude);
+}
+
+TEST(NmeaParser, parseGgaEmptyFieldIsInvalid)
+{
+  GgaMessageData const parsed_message(
+      parse_gga("$GPGGA,,,,,,0,,,,,,,,*66"));
+  EXPECT_FALSE(parsed_message.valid);
+}
+
+TEST(NmeaParser, parseFromBufferDoesNotAllocate)
+{
+  char const gga[] =
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,5,0001*73";
+  char const vtg[] = "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48";
+  char const avr[] =
+      "$PTNL,AVR,181059.6,+149.4688,Yaw,+0.0134,Tilt,,,60.191,3,2.5,6*00";
+  size_t const allocations_before = allocation_count;
+  GgaMessageData const parsed_gga(parse_gga(gga, sizeof(gga) - 1U));
+  VtgMessageData const parsed_vtg(parse_vtg(vtg, sizeof(vtg) - 1U));
+  AvrMessageData const parsed_avr(parse_avr(avr, sizeof(avr) - 1U));
+  EXPECT_EQ(allocations_before, allocation_count);
+  EXPECT_TRUE(parsed_gga.valid);
+  EXPECT_TRUE(parsed_vtg.valid);
+  EXPECT_TRUE(parsed_avr.valid);
+}
+
+TEST(NmeaParser, parseGgaAnyTalker)
+{
+  GgaMessageData const parsed_message(parse_gga(
+      "$GNGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*59"));
+  EXPECT_TRUE(parsed_message.valid);
+  EXPECT_DOUBLE_EQ(48.1173, parsed_message.latitude);
+}
+
+TEST(NmeaParser, parseNmeaDispatchesByType)
+{
+  NmeaMessage const gga(parse_nmea(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47"));
+  EXPECT_EQ(NMEA_GGA, gga.type);
+  EXPECT_TRUE(gga.valid());
+  EXPECT_EQ(8U, gga.gga.numSatellites);
+
+  NmeaMessage const vtg(
+      parse_nmea("$BDVTG,054.7,T,034.4,M,005.5,N,010.2,K*59"));
+  EXPECT_EQ(NMEA_VTG, vtg.type);
+  EXPECT_TRUE(vtg.valid());
+  EXPECT_DOUBLE_EQ(10.2, vtg.vtg.groundSpeedKph);
+
+  NmeaMessage const avr(parse_nmea(
+      "$PTNL,AVR,181059.6,+149.4688,Yaw,+0.0134,Tilt,,,60.191,3,2.5,6*00"));
+  EXPECT_EQ(NMEA_AVR, avr.type);
+  EXPECT_TRUE(avr.valid());
+  EXPECT_DOUBLE_EQ(149.4688, avr.avr.yaw);
+}
+
+TEST(NmeaParser, parseNmeaUnknownSentence)
+{
+  NmeaMessage const gll(
+      parse_nmea("$GPGLL,4916.45,N,12311.12,W,225444,A*31"));
+  EXPECT_EQ(NMEA_UNKNOWN, gll.type);
+  EXPECT_FALSE(gll.valid());
+  EXPECT_EQ(NMEA_UNKNOWN, parse_nmea("junk").type);
+  EXPECT_EQ(NMEA_UNKNOWN, parse_nmea("$PTNL,AV").type);
+  EXPECT_EQ(NMEA_UNKNOWN, parse_nmea("$gpGGA,").type);
+}
+
+TEST(NmeaParser, rejectsBadChecksum)
+{
+  std::string const gga(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48");
+  EXPECT_FALSE(parse_gga(gga).valid);
+  EXPECT_FALSE(parse_vtg("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*00").valid);
+  EXPECT_FALSE(parse_avr(
+      "$PTNL,AVR,181059.6,+149.4688,Yaw,+0.0134,Tilt,,,60.191,3,2.5,6*01")
+                   .valid);
+  EXPECT_FALSE(parse_vtg("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K").valid);
+  NmeaMessage const message(parse_nmea(gga));
+  EXPECT_EQ(NMEA_GGA, message.type);
+  EXPECT_FALSE(message.valid());
+}
+
+TEST(NmeaParser, skipChecksum)
+{
+  std::string const gga(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*48");
+  EXPECT_TRUE(parse_gga(gga, NMEA_SKIP_CHECKSUM).valid);
+  EXPECT_TRUE(parse_gga(gga.data(), gga.length(), NMEA_SKIP_CHECKSUM).valid);
+  EXPECT_TRUE(parse_nmea(gga, NMEA_SKIP_CHECKSUM).valid());
+}
+
+TEST(NmeaParser, checksumWithLineTerminator)
+{
+  EXPECT_TRUE(
+      parse_vtg("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n").valid);
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,275 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_latency_histogram.hpp"
+#include "nmea_pipeline.hpp"
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+static string const GGA(
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+static string const VTG("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+
+TEST(NmeaSentenceQueue, fifoUntilFull)
+{
+  NmeaSentenceQueue queue(3U);
+  EXPECT_EQ(4U, queue.capacity());
+  for (uint64_t i = 0U; i < 4U; ++i)
+  {
+    EXPECT_TRUE(queue.try_push(GGA.data(), GGA.length(), i));
+  }
+  EXPECT_FALSE(queue.try_push(GGA.data(), GGA.length(), 4U));
+  EXPECT_EQ(4U, queue.size());
+
+  NmeaQueuedSentence sentence;
+  for (uint64_t i = 0U; i < 4U; ++i)
+  {
+    ASSERT_TRUE(queue.try_pop(sentence));
+    EXPECT_EQ(i, sentence.arrivalNs);
+    EXPECT_EQ(GGA, string(sentence.data, sentence.length));
+  }
+  EXPECT_FALSE(queue.try_pop(sentence));
+
+  string const too_long(NMEA_QUEUED_SENTENCE_BYTES + 1U, 'x');
+  EXPECT_FALSE(queue.try_push(too_long.data(), too_long.length(), 0U));
+}
+
+TEST(NmeaSentenceQueue, manyProducersAndConsumers)
+{
+  static size_t const PRODUCERS = 4U;
+  static size_t const CONSUMERS = 2U;
+  static uint64_t const PER_PRODUCER = 20000U;
+  NmeaSentenceQueue queue(64U);
+  std::atomic<uint64_t> popped(0U);
+  std::atomic<uint64_t> sum(0U);
+  vector<std::thread> threads;
+  for (size_t p = 0U; p < PRODUCERS; ++p)
+  {
+    threads.push_back(std::thread([&queue, p]() {
+      for (uint64_t i = 0U; i < PER_PRODUCER; ++i)
+      {
+        uint64_t const value = p * PER_PRODUCER + i;
+        while (!queue.try_push(VTG.data(), VTG.length(), value))
+        {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+  for (size_t c = 0U; c < CONSUMERS; ++c)
+  {
+    threads.push_back(std::thread([&queue, &popped, &sum]() {
+      NmeaQueuedSentence sentence;
+      while (popped.load() < PRODUCERS * PER_PRODUCER)
+      {
+        if (queue.try_pop(sentence))
+        {
+          EXPECT_EQ(VTG, string(sentence.data, sentence.length));
+          sum += sentence.arrivalNs;
+          ++popped;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+  for (size_t i = 0U; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+  uint64_t const total = PRODUCERS * PER_PRODUCER;
+  EXPECT_EQ(total, popped.load());
+  EXPECT_EQ(total * (total - 1U) / 2U, sum.load());
+}
+
+TEST(NmeaRecordRing, subscribersSeeEveryRecordInOrder)
+{
+  NmeaRecordRing ring(8U);
+  NmeaRecordSubscriber first(ring);
+  NmeaRecordSubscriber second(ring);
+  NmeaRecord record;
+  for (uint64_t i = 0U; i < 5U; ++i)
+  {
+    record.arrivalNs = 100U + i;
+    ring.publish(record);
+  }
+  for (uint64_t i = 0U; i < 5U; ++i)
+  {
+    ASSERT_TRUE(first.next(record));
+    EXPECT_EQ(i, record.sequence);
+    EXPECT_EQ(100U + i, record.arrivalNs);
+  }
+  EXPECT_FALSE(first.next(record));
+  ASSERT_TRUE(second.next(record));
+  EXPECT_EQ(0U, record.sequence);
+  EXPECT_EQ(5U, ring.published());
+
+  // a late subscriber starts at the head
+  NmeaRecordSubscriber late(ring);
+  EXPECT_FALSE(late.next(record));
+}
+
+TEST(NmeaRecordRing, slowSubscriberSkipsAhead)
+{
+  NmeaRecordRing ring(4U);
+  NmeaRecordSubscriber subscriber(ring);
+  NmeaRecord record;
+  for (uint64_t i = 0U; i < 10U; ++i)
+  {
+    ring.publish(record);
+  }
+  ASSERT_TRUE(subscriber.next(record));
+  EXPECT_EQ(6U, record.sequence);
+  EXPECT_EQ(6U, subscriber.lost());
+  size_t remaining = 0U;
+  while (subscriber.next(record))
+  {
+    ++remaining;
+  }
+  EXPECT_EQ(3U, remaining);
+  EXPECT_EQ(4U, subscriber.received());
+}
+
+TEST(NmeaPipeline, framesParsesAndPublishes)
+{
+  NmeaPipeline pipeline(16U, 16U);
+  NmeaRecordSubscriber subscriber(pipeline.records());
+  NmeaStreamFramer framer;
+  string const stream(GGA + "\r\n" + VTG + "\r\n$GPGLL,junk\r\n");
+  // split mid sentence
+  EXPECT_EQ(1U, pipeline.submit(framer, stream.data(), 70U));
+  EXPECT_EQ(2U, pipeline.submit(framer, stream.data() + 70U,
+                                stream.length() - 70U));
+  EXPECT_EQ(3U, pipeline.parse_pending(8U));
+  EXPECT_EQ(0U, pipeline.parse_pending(8U));
+
+  NmeaRecord record;
+  ASSERT_TRUE(subscriber.next(record));
+  EXPECT_EQ(NMEA_GGA, record.message.type);
+  EXPECT_TRUE(record.message.valid());
+  EXPECT_LE(record.arrivalNs, record.parsedNs);
+  ASSERT_TRUE(subscriber.next(record));
+  EXPECT_EQ(NMEA_VTG, record.message.type);
+  EXPECT_EQ(54.7, record.message.vtg.trueTrackMadeGood);
+  ASSERT_TRUE(subscriber.next(record));
+  EXPECT_EQ(NMEA_PARSE_UNSUPPORTED_SENTENCE, record.error.code);
+  EXPECT_FALSE(subscriber.next(record));
+  EXPECT_EQ(0U, pipeline.dropped());
+
+  NmeaPipeline small(2U, 2U);
+  EXPECT_TRUE(small.submit(GGA.data(), GGA.length(), 0U));
+  EXPECT_TRUE(small.submit(GGA.data(), GGA.length(), 0U));
+  EXPECT_FALSE(small.submit(GGA.data(), GGA.length(), 0U));
+  EXPECT_EQ(1U, small.dropped());
+}
+
+TEST(NmeaPipeline, threadedEndToEnd)
+{
+  static size_t const READERS = 4U;
+  static size_t const PER_READER = 5000U;
+  NmeaPipeline pipeline(256U, 1U << 16);
+  NmeaRecordSubscriber subscriber(pipeline.records());
+  std::atomic<bool> reading(true);
+  vector<std::thread> readers;
+  for (size_t r = 0U; r < READERS; ++r)
+  {
+    readers.push_back(std::thread([&pipeline]() {
+      NmeaStreamFramer framer;
+      string const line(GGA + "\r\n");
+      for (size_t i = 0U; i < PER_READER; ++i)
+      {
+        framer.push(line.data(), line.length());
+        NmeaSentence sentence;
+        while (framer.next(sentence))
+        {
+          while (!pipeline.submit(sentence.data, sentence.length,
+                                  nmea_pipeline_now_ns()))
+          {
+            std::this_thread::yield();
+          }
+        }
+      }
+    }));
+  }
+  std::thread parser([&pipeline, &reading]() {
+    bool more = true;
+    while (more)
+    {
+      // Read the flag first so nothing queued before it cleared is missed.
+      bool const still_reading = reading.load();
+      more = 0U != pipeline.parse_pending(64U) || still_reading;
+      std::this_thread::yield();
+    }
+  });
+  for (size_t r = 0U; r < READERS; ++r)
+  {
+    readers[r].join();
+  }
+  reading = false;
+  parser.join();
+
+  NmeaLatencyHistogram latency;
+  NmeaRecord record;
+  while (subscriber.next(record))
+  {
+    EXPECT_TRUE(record.message.valid());
+    latency.record(record.parsedNs - record.arrivalNs);
+  }
+  EXPECT_EQ(READERS * PER_READER, subscriber.received());
+  EXPECT_EQ(0U, subscriber.lost());
+  EXPECT_EQ(READERS * PER_READER, latency.count());
+  // dropped() counts refusals, which the readers retried
+  EXPECT_EQ(READERS * PER_READER, pipeline.records().published());
+}
+
+TEST(NmeaLatencyHistogram, percentilesWithinBucketError)
+{
+  NmeaLatencyHistogram histogram;
+  EXPECT_EQ(0U, histogram.percentile(0.5));
+  for (uint64_t i = 1U; i <= 1000U; ++i)
+  {
+    histogram.record(i * 1000U);
+  }
+  EXPECT_EQ(1000U, histogram.count());
+  EXPECT_EQ(1000U, histogram.min());
+  EXPECT_EQ(1000000U, histogram.max());
+  EXPECT_DOUBLE_EQ(500500.0, histogram.mean());
+  uint64_t const median = histogram.percentile(0.5);
+  EXPECT_LE(500000U, median);
+  EXPECT_GE(500000U * 1.125, median);
+  uint64_t const p99 = histogram.percentile(0.99);
+  EXPECT_LE(990000U, p99);
+  EXPECT_GE(1000000U, p99);
+  EXPECT_EQ(1000000U, histogram.percentile(1.0));
+
+  for (uint64_t i = 0U; i < 8U; ++i)
+  {
+    EXPECT_EQ(i, NmeaLatencyHistogram::bucket_index(i));
+  }
+  EXPECT_EQ(NmeaLatencyHistogram::BUCKETS - 1U,
+            NmeaLatencyHistogram::bucket_index(UINT64_MAX));
+
+  NmeaLatencyHistogram other;
+  other.record(5U);
+  histogram.merge(other);
+  EXPECT_EQ(1001U, histogram.count());
+  EXPECT_EQ(5U, histogram.min());
+  EXPECT_EQ(5U, histogram.percentile(0.0));
+  histogram.reset();
+  EXPECT_EQ(0U, histogram.count());
+  EXPECT_EQ(0U, histogram.min());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
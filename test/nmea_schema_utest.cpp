@@ -0,0 +1,126 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_schema.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+
+// A sentence declared only in this test, to show what adding a type takes.
+struct HeadingMessage
+{
+  HeadingMessage()
+      : valid(false)
+      , heading(0.0)
+      , rateValid(false)
+      , rate(0.0)
+      , quality(0U)
+      , latitude(0.0)
+  {
+  }
+
+  bool valid;
+  double heading;
+  bool rateValid;
+  double rate;
+  uint8_t quality;
+  double latitude;
+};
+
+typedef NmeaFieldList<
+    NmeaNumber<HeadingMessage, &HeadingMessage::heading, NmeaFixed<2> >,
+    NmeaLabel<'T'>,
+    NmeaOptionalNumber<HeadingMessage, &HeadingMessage::rate,
+                       &HeadingMessage::rateValid, NmeaSignedFixed<1> >,
+    NmeaInteger<HeadingMessage, uint8_t, &HeadingMessage::quality, 0, 9>,
+    NmeaAngle<HeadingMessage, &HeadingMessage::latitude, 2U, 'N', 'S'> >
+    HeadingSchema;
+
+static char const HEADER[] = "$XXHDG,";
+
+static HeadingMessage parse_heading(string const &body, NmeaParseError &error)
+{
+  HeadingMessage message;
+  NmeaFieldDecoder fields(body.data(), body.data() + body.length(), error);
+  message.valid = HeadingSchema::parse(fields, message);
+  return message;
+}
+
+TEST(NmeaSchema, parsesDeclaredFields)
+{
+  NmeaParseError error;
+  HeadingMessage const message(parse_heading("271.50,T,-0.5,4,4807.038,S*",
+                                             error));
+  ASSERT_TRUE(message.valid);
+  EXPECT_TRUE(error.ok());
+  EXPECT_DOUBLE_EQ(271.5, message.heading);
+  EXPECT_TRUE(message.rateValid);
+  EXPECT_DOUBLE_EQ(-0.5, message.rate);
+  EXPECT_EQ(4U, message.quality);
+  EXPECT_DOUBLE_EQ(-48.1173, message.latitude);
+}
+
+TEST(NmeaSchema, reportsFieldPositions)
+{
+  NmeaParseError error;
+  EXPECT_TRUE(parse_heading("271.50,T,,4,4807.038,N", error).valid);
+  EXPECT_FALSE(parse_heading("271.50,T,,12,4807.038,N", error).valid);
+  EXPECT_EQ(NMEA_PARSE_OUT_OF_RANGE, error.code);
+  EXPECT_EQ(4U, error.field);
+  EXPECT_FALSE(parse_heading("271.50,T,,4", error).valid);
+  EXPECT_EQ(NMEA_PARSE_MISSING_FIELD, error.code);
+  EXPECT_EQ(5U, error.field);
+  EXPECT_FALSE(parse_heading("271.50,T,x,4,4807.038,N", error).valid);
+  EXPECT_EQ(NMEA_PARSE_BAD_NUMBER, error.code);
+  EXPECT_EQ(3U, error.field);
+}
+
+TEST(NmeaSchema, buildsWithChecksum)
+{
+  HeadingMessage message;
+  message.heading = 271.5;
+  message.quality = 4U;
+  message.latitude = 48.1173;
+  char buffer[64];
+  size_t length = build_sentence<HeadingSchema>(
+      buffer, sizeof(buffer), HEADER, sizeof(HEADER) - 1U, message);
+  EXPECT_EQ("$XXHDG,271.50,T,,4,4807.03800000,N*54\n", string(buffer, length));
+  EXPECT_TRUE(nmea_checksum_valid(buffer, length));
+
+  message.rateValid = true;
+  message.rate = 0.25;
+  length = build_sentence<HeadingSchema>(buffer, sizeof(buffer), HEADER,
+                                         sizeof(HEADER) - 1U, message);
+  EXPECT_EQ("$XXHDG,271.50,T,+0.2,4,4807.03800000,N*53\n",
+            string(buffer, length));
+  EXPECT_EQ(0U, build_sentence<HeadingSchema>(buffer, 20U, HEADER,
+                                              sizeof(HEADER) - 1U, message));
+}
+
+TEST(NmeaSchema, roundTrips)
+{
+  HeadingMessage message;
+  message.heading = 12.25;
+  message.rateValid = true;
+  message.rate = -3.5;
+  message.quality = 9U;
+  message.latitude = -12.5;
+  char buffer[64];
+  size_t const length = build_sentence<HeadingSchema>(
+      buffer, sizeof(buffer), HEADER, sizeof(HEADER) - 1U, message);
+  NmeaParseError error;
+  HeadingMessage const parsed(parse_heading(
+      string(buffer + sizeof(HEADER) - 1U, length - sizeof(HEADER) + 1U),
+      error));
+  ASSERT_TRUE(parsed.valid);
+  EXPECT_EQ(message.heading, parsed.heading);
+  EXPECT_EQ(message.rate, parsed.rate);
+  EXPECT_EQ(message.quality, parsed.quality);
+  EXPECT_DOUBLE_EQ(message.latitude, parsed.latitude);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
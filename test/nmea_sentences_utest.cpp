@@ -0,0 +1,233 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_builder.hpp"
+#include "nmea_parser.hpp"
+#include <cstring>
+#include <string>
+
+using std::string;
+
+template <typename Message>
+static string build_message(size_t (*builder)(char *const, size_t const,
+                                              Message const &),
+                            Message const &message)
+{
+  char buffer[NMEA_MAX_BUILD_LENGTH];
+  return string(buffer, builder(buffer, sizeof(buffer), message));
+}
+
+TEST(NmeaSentences, parseRmc)
+{
+  RmcMessageData const rmc(parse_rmc("$GPRMC,123519,A,4807.038,N,01131.000,E,"
+                                     "022.4,084.4,230394,003.1,W*6A"));
+  ASSERT_TRUE(rmc.valid);
+  EXPECT_EQ(123519.0, rmc.timestamp);
+  EXPECT_TRUE(rmc.active());
+  EXPECT_NEAR(48.1173, rmc.latitude, 1e-9);
+  EXPECT_NEAR(11.5166667, rmc.longitude, 1e-7);
+  EXPECT_EQ(22.4, rmc.speedKnots);
+  EXPECT_TRUE(rmc.trackMadeGoodValid);
+  EXPECT_EQ(84.4, rmc.trackMadeGood);
+  EXPECT_EQ(230394U, rmc.date);
+  EXPECT_TRUE(rmc.magneticVariationValid);
+  EXPECT_EQ(-3.1, rmc.magneticVariation);
+  EXPECT_EQ('\0', rmc.modeIndicator);
+
+  NmeaMessage const any(parse_nmea("$GPRMC,123519,A,4807.038,N,01131.000,E,"
+                                   "022.4,084.4,230394,003.1,W*6A"));
+  EXPECT_EQ(NMEA_RMC, any.type);
+  EXPECT_TRUE(any.valid());
+
+  // no fix yet
+  NmeaParseError error;
+  string const empty("$GNRMC,,V,,,,,,,,,,N*4D");
+  EXPECT_FALSE(parse_rmc(empty.data(), empty.length(), error).valid);
+  EXPECT_EQ(NMEA_PARSE_EMPTY_FIELD, error.code);
+  EXPECT_EQ(1U, error.field);
+}
+
+TEST(NmeaSentences, parseGsa)
+{
+  GsaMessageData const gsa(
+      parse_gsa("$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39"));
+  ASSERT_TRUE(gsa.valid);
+  EXPECT_EQ('A', gsa.selectionMode);
+  EXPECT_EQ(3U, gsa.fixType);
+  ASSERT_EQ(5U, gsa.numSatellites);
+  EXPECT_EQ(4U, gsa.satelliteIds[0]);
+  EXPECT_EQ(5U, gsa.satelliteIds[1]);
+  EXPECT_EQ(9U, gsa.satelliteIds[2]);
+  EXPECT_EQ(12U, gsa.satelliteIds[3]);
+  EXPECT_EQ(24U, gsa.satelliteIds[4]);
+  EXPECT_EQ(2.5, gsa.pdop);
+  EXPECT_EQ(1.3, gsa.hdop);
+  EXPECT_EQ(2.1, gsa.vdop);
+  EXPECT_FALSE(gsa.systemIdValid);
+
+  NmeaParseError error;
+  string const bad_fix("$GPGSA,A,4,04,,,,,,,,,,,,2.5,1.3,2.1*32");
+  EXPECT_FALSE(
+      parse_gsa(bad_fix.data(), bad_fix.length(), error, NMEA_SKIP_CHECKSUM)
+          .valid);
+  EXPECT_EQ(NMEA_PARSE_OUT_OF_RANGE, error.code);
+  EXPECT_EQ(2U, error.field);
+}
+
+TEST(NmeaSentences, parseGsv)
+{
+  GsvMessageData const gsv(parse_gsv("$GPGSV,2,1,08,01,40,083,46,02,17,308,41,"
+                                     "12,07,344,39,14,22,228,45*75"));
+  ASSERT_TRUE(gsv.valid);
+  EXPECT_EQ('G', gsv.talker[0]);
+  EXPECT_EQ('P', gsv.talker[1]);
+  EXPECT_EQ(2U, gsv.totalMessages);
+  EXPECT_EQ(1U, gsv.messageNumber);
+  EXPECT_EQ(8U, gsv.satellitesInView);
+  ASSERT_EQ(4U, gsv.numSatellites);
+  EXPECT_EQ(12U, gsv.satellites[2].id);
+  EXPECT_EQ(7, gsv.satellites[2].elevation);
+  EXPECT_EQ(344U, gsv.satellites[2].azimuth);
+  EXPECT_EQ(39U, gsv.satellites[2].snr);
+  EXPECT_FALSE(gsv.signalIdValid);
+
+  // padding blocks and the NMEA 4.10 signal ID
+  GsvMessageData const padded(
+      parse_gsv("$GLGSV,2,2,08,70,-05,,,71,,,,,,,,,,,,1*59"));
+  ASSERT_TRUE(padded.valid);
+  EXPECT_EQ('L', padded.talker[1]);
+  ASSERT_EQ(2U, padded.numSatellites);
+  EXPECT_EQ(-5, padded.satellites[0].elevation);
+  EXPECT_FALSE(padded.satellites[0].azimuthValid);
+  EXPECT_FALSE(padded.satellites[1].elevationValid);
+  EXPECT_TRUE(padded.signalIdValid);
+  EXPECT_EQ(1U, padded.signalId);
+
+  GsvMessageData const none(parse_gsv("$GPGSV,1,1,00*79"));
+  EXPECT_TRUE(none.valid);
+  EXPECT_EQ(0U, none.numSatellites);
+
+  NmeaParseError error;
+  string const bad_snr("$GPGSV,1,1,01,01,40,083,460*00");
+  EXPECT_FALSE(
+      parse_gsv(bad_snr.data(), bad_snr.length(), error, NMEA_SKIP_CHECKSUM)
+          .valid);
+  EXPECT_EQ(NMEA_PARSE_OUT_OF_RANGE, error.code);
+  EXPECT_EQ(7U, error.field);
+}
+
+TEST(NmeaSentences, parseGstZdaHdtGns)
+{
+  GstMessageData const gst(
+      parse_gst("$GPGST,024603.00,3.2,6.6,4.7,47.3,5.8,5.6,22.0*58"));
+  ASSERT_TRUE(gst.valid);
+  EXPECT_EQ(24603.0, gst.timestamp);
+  EXPECT_EQ(6.6, gst.semiMajorSigma);
+  EXPECT_EQ(47.3, gst.semiMajorOrientation);
+  EXPECT_EQ(22.0, gst.altitudeSigma);
+
+  ZdaMessageData const zda(
+      parse_zda("$GPZDA,201530.00,04,07,2002,-05,30*4B"));
+  ASSERT_TRUE(zda.valid);
+  EXPECT_EQ(4U, zda.day);
+  EXPECT_EQ(7U, zda.month);
+  EXPECT_EQ(2002U, zda.year);
+  EXPECT_TRUE(zda.localZoneValid);
+  EXPECT_EQ(-5, zda.localZoneHours);
+  EXPECT_EQ(30U, zda.localZoneMinutes);
+
+  HdtMessageData const hdt(parse_hdt("$GPHDT,274.07,T*03"));
+  ASSERT_TRUE(hdt.valid);
+  EXPECT_EQ(274.07, hdt.heading);
+
+  GnsMessageData const gns(parse_gns("$GNGNS,014035.00,4332.69262,S,"
+                                     "17235.48549,E,RR,13,0.9,25.63,11.24,,*"
+                                     "70"));
+  ASSERT_TRUE(gns.valid);
+  EXPECT_NEAR(-43.544877, gns.latitude, 1e-6);
+  EXPECT_STREQ("RR", gns.modeIndicator);
+  EXPECT_EQ(13U, gns.numSatellites);
+  EXPECT_EQ(25.63, gns.altitude);
+  EXPECT_FALSE(gns.timeSinceLastDgpsValid);
+  EXPECT_FALSE(gns.dgpsStationIDValid);
+  EXPECT_EQ('\0', gns.navigationalStatus);
+}
+
+TEST(NmeaSentences, buildersRoundTrip)
+{
+  RmcMessageData rmc;
+  rmc.timestamp = 123519.0;
+  rmc.status = 'A';
+  rmc.latitude = 48.1173;
+  rmc.longitude = 11.5166667;
+  rmc.speedKnots = 22.4;
+  rmc.date = 230394U;
+  rmc.magneticVariationValid = true;
+  rmc.magneticVariation = -3.1;
+  rmc.modeIndicator = 'A';
+  string text(build_message(build_rmc, rmc));
+  EXPECT_EQ("$GPRMC,123519.00,A,4807.03800000,N,01131.00000200,E,22.400,,"
+            "230394,3.1,W,A*3D\n",
+            text);
+  RmcMessageData const parsed_rmc(parse_rmc(text));
+  ASSERT_TRUE(parsed_rmc.valid);
+  EXPECT_FALSE(parsed_rmc.trackMadeGoodValid);
+  EXPECT_EQ(rmc.magneticVariation, parsed_rmc.magneticVariation);
+  EXPECT_EQ('A', parsed_rmc.modeIndicator);
+
+  GsaMessageData const gsa(
+      parse_gsa("$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39"));
+  text = build_message(build_gsa, gsa);
+  EXPECT_EQ("$GPGSA,A,3,04,05,09,12,24,,,,,,,,2.50,1.30,2.10,*25\n", text);
+  GsaMessageData const parsed_gsa(parse_gsa(text));
+  ASSERT_TRUE(parsed_gsa.valid);
+  EXPECT_EQ(5U, parsed_gsa.numSatellites);
+  EXPECT_EQ(24U, parsed_gsa.satelliteIds[4]);
+
+  GsvMessageData const gsv(
+      parse_gsv("$GLGSV,2,2,08,70,-05,,,71,,,,,,,,,,,,1*59"));
+  text = build_message(build_gsv, gsv);
+  EXPECT_EQ("$GLGSV,2,2,08,70,-05,,,71,,,,1*59\n", text);
+  GsvMessageData const parsed_gsv(parse_gsv(text));
+  ASSERT_TRUE(parsed_gsv.valid);
+  EXPECT_EQ(2U, parsed_gsv.numSatellites);
+  EXPECT_EQ(-5, parsed_gsv.satellites[0].elevation);
+  EXPECT_EQ(1U, parsed_gsv.signalId);
+
+  GstMessageData const gst(
+      parse_gst("$GPGST,024603.00,3.2,6.6,4.7,47.3,5.8,5.6,22.0*58"));
+  text = build_message(build_gst, gst);
+  EXPECT_EQ("$GPGST,024603.00,3.200,6.600,4.700,47.3,5.800,5.600,22.000*58\n",
+            text);
+  EXPECT_TRUE(parse_gst(text).valid);
+
+  ZdaMessageData zda(parse_zda("$GPZDA,201530.00,04,07,2002,-05,30*4B"));
+  text = build_message(build_zda, zda);
+  EXPECT_EQ("$GPZDA,201530.00,04,07,2002,-05,30*4B\n", text);
+  zda.localZoneValid = false;
+  text = build_message(build_zda, zda);
+  EXPECT_EQ("$GPZDA,201530.00,04,07,2002,,*60\n", text);
+  EXPECT_FALSE(parse_zda(text).localZoneValid);
+
+  HdtMessageData const hdt(parse_hdt("$GPHDT,274.07,T*03"));
+  text = build_message(build_hdt, hdt);
+  EXPECT_EQ("$GPHDT,274.070,T*33\n", text);
+  EXPECT_EQ(274.07, parse_hdt(text).heading);
+
+  GnsMessageData const gns(parse_gns("$GNGNS,014035.00,4332.69262,S,"
+                                     "17235.48549,E,RR,13,0.9,25.63,11.24,,*"
+                                     "70"));
+  text = build_message(build_gns, gns);
+  GnsMessageData const parsed_gns(parse_gns(text));
+  ASSERT_TRUE(parsed_gns.valid);
+  EXPECT_NEAR(gns.latitude, parsed_gns.latitude, 1e-9);
+  EXPECT_NEAR(gns.longitude, parsed_gns.longitude, 1e-9);
+  EXPECT_STREQ("RR", parsed_gns.modeIndicator);
+  EXPECT_EQ(gns.hdop, parsed_gns.hdop);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,114 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_parser.hpp"
+#include "nmea_stream_framer.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+static vector<string> frame_in_chunks(NmeaStreamFramer &framer,
+                                      string const &stream,
+                                      size_t const chunk_size)
+{
+  vector<string> sentences;
+  for (size_t offset = 0U; offset < stream.length(); offset += chunk_size)
+  {
+    size_t const length = std::min(chunk_size, stream.length() - offset);
+    framer.push(stream.data() + offset, length);
+    NmeaSentence sentence;
+    while (framer.next(sentence))
+    {
+      sentences.push_back(string(sentence.data, sentence.length));
+    }
+  }
+  return sentences;
+}
+
+static string const GGA(
+    "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47");
+static string const VTG("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+
+TEST(NmeaStreamFramer, framesAnyChunkSize)
+{
+  string const stream = GGA + "\r\n" + VTG + "\r\n" + GGA + "\n";
+  for (size_t chunk_size = 1U; chunk_size <= stream.length(); ++chunk_size)
+  {
+    NmeaStreamFramer framer;
+    vector<string> const sentences(frame_in_chunks(framer, stream, chunk_size));
+    ASSERT_EQ(3U, sentences.size()) << chunk_size;
+    EXPECT_EQ(GGA, sentences[0]);
+    EXPECT_EQ(VTG, sentences[1]);
+    EXPECT_EQ(GGA, sentences[2]);
+    EXPECT_EQ(0U, framer.discardedBytes());
+  }
+}
+
+TEST(NmeaStreamFramer, completeSentenceIsNotCopied)
+{
+  string const stream = GGA + "\r\n";
+  NmeaStreamFramer framer;
+  framer.push(stream.data(), stream.length());
+  NmeaSentence sentence;
+  ASSERT_TRUE(framer.next(sentence));
+  EXPECT_EQ(stream.data(), sentence.data);
+  EXPECT_EQ(GGA.length(), sentence.length);
+  EXPECT_FALSE(framer.next(sentence));
+}
+
+#ifndef NDEBUG
+TEST(NmeaStreamFramerDeathTest, pushBeforeDrained)
+{
+  string const stream = GGA + "\r\n" + VTG + "\r\n";
+  NmeaStreamFramer framer;
+  framer.push(stream.data(), stream.length());
+  NmeaSentence sentence;
+  ASSERT_TRUE(framer.next(sentence));
+  EXPECT_DEATH(framer.push(stream.data(), stream.length()), "");
+}
+#endif
+
+TEST(NmeaStreamFramer, resyncsOnGarbageAndTruncatedSentence)
+{
+  string const stream = "noise" + GGA.substr(0U, 20U) + VTG + "\n" + GGA + "\n";
+  NmeaStreamFramer framer;
+  vector<string> const sentences(frame_in_chunks(framer, stream, 7U));
+  ASSERT_EQ(2U, sentences.size());
+  EXPECT_EQ(VTG, sentences[0]);
+  EXPECT_EQ(GGA, sentences[1]);
+  EXPECT_EQ(1U, framer.truncated());
+  EXPECT_EQ(25U, framer.discardedBytes());
+}
+
+TEST(NmeaStreamFramer, dropsOverlongSentence)
+{
+  string const stream = "$" + string(100U, 'x') + "\n" + VTG + "\n";
+  NmeaStreamFramer framer(64U);
+  vector<string> const sentences(frame_in_chunks(framer, stream, 16U));
+  ASSERT_EQ(1U, sentences.size());
+  EXPECT_EQ(VTG, sentences[0]);
+  EXPECT_EQ(1U, framer.overflows());
+}
+
+TEST(NmeaStreamFramer, feedsParser)
+{
+  string const stream = GGA + "\r\n";
+  NmeaStreamFramer framer;
+  framer.push(stream.data(), 30U);
+  NmeaSentence sentence;
+  EXPECT_FALSE(framer.next(sentence));
+  framer.push(stream.data() + 30U, stream.length() - 30U);
+  ASSERT_TRUE(framer.next(sentence));
+  GgaMessageData const parsed_message(
+      parse_gga(sentence.data, sentence.length));
+  EXPECT_TRUE(parsed_message.valid);
+  EXPECT_DOUBLE_EQ(48.1173, parsed_message.latitude);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,216 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "gtest/gtest.h"
+#include "nmea_utc_resolver.hpp"
+#include <cstring>
+#include <vector>
+
+static int64_t const MS = 1000000LL;
+static int64_t const SECOND = 1000000000LL;
+
+static int64_t text_time(char const *const text)
+{
+  int64_t time_ns = -1;
+  return nmea_time_of_day_ns(text, std::strlen(text), time_ns) ? time_ns
+                                                               : -1;
+}
+
+static int64_t double_time(double const timestamp)
+{
+  int64_t time_ns = -1;
+  return nmea_time_of_day_ns(timestamp, time_ns) ? time_ns : -1;
+}
+
+static int64_t gga_time(NmeaUtcResolver &resolver, double const timestamp)
+{
+  GgaMessageData fix(timestamp, 48.1173, 11.5166667, GGA_GPS, 8U, 0.9,
+                     545.4, 46.9);
+  return resolver.resolve(NmeaMessage(fix));
+}
+
+TEST(NmeaUtcResolver, timeOfDay)
+{
+  int64_t const expected = (12 * 3600 + 35 * 60 + 19) * SECOND + 250 * MS;
+  EXPECT_EQ(expected, text_time("123519.25"));
+  EXPECT_EQ(expected, double_time(123519.25));
+  EXPECT_EQ(expected - 250 * MS, text_time("123519"));
+  EXPECT_EQ(expected + 123456789 - 250 * MS, text_time("123519.1234567899"));
+  EXPECT_EQ(86399 * SECOND + 999 * MS, double_time(235959.999));
+  EXPECT_EQ(0, text_time("000000.00"));
+
+  EXPECT_EQ(-1, text_time("240000"));
+  EXPECT_EQ(-1, text_time("126000"));
+  EXPECT_EQ(-1, text_time("235960"));
+  EXPECT_EQ(-1, text_time("12351"));
+  EXPECT_EQ(-1, text_time("1235a9"));
+  EXPECT_EQ(-1, text_time("123519.2x"));
+  EXPECT_EQ(-1, text_time("123519,25"));
+  EXPECT_EQ(-1, double_time(240000.0));
+  EXPECT_EQ(-1, double_time(-1.0));
+  EXPECT_EQ(-1, double_time(126000.0));
+  EXPECT_EQ(-1, double_time(235960.0));
+
+  uint32_t time_ms = 7U;
+  EXPECT_TRUE(nmea_time_of_day_ms(123519.25, time_ms));
+  EXPECT_EQ(45319250U, time_ms);
+  EXPECT_TRUE(nmea_time_of_day_ms(235959.999, time_ms));
+  EXPECT_EQ(86399999U, time_ms);
+  EXPECT_FALSE(nmea_time_of_day_ms(235959.9996, time_ms));
+  EXPECT_FALSE(nmea_time_of_day_ms(126000.0, time_ms));
+  EXPECT_FALSE(nmea_time_of_day_ms(-0.5, time_ms));
+  EXPECT_EQ(86399999U, time_ms);
+}
+
+TEST(NmeaUtcResolver, daysSinceEpoch)
+{
+  int64_t days = 1;
+  ASSERT_TRUE(nmea_days_since_epoch(1970, 1U, 1U, days));
+  EXPECT_EQ(0, days);
+  ASSERT_TRUE(nmea_days_since_epoch(1969, 12U, 31U, days));
+  EXPECT_EQ(-1, days);
+  ASSERT_TRUE(nmea_days_since_epoch(2000, 3U, 1U, days));
+  EXPECT_EQ(11017, days);
+  ASSERT_TRUE(nmea_days_since_epoch(2016, 2U, 29U, days));
+  EXPECT_EQ(16860, days);
+  ASSERT_TRUE(nmea_days_since_epoch(2024, 12U, 31U, days));
+  EXPECT_EQ(20088, days);
+  EXPECT_FALSE(nmea_days_since_epoch(2015, 2U, 29U, days));
+  EXPECT_FALSE(nmea_days_since_epoch(1900, 2U, 29U, days));
+  EXPECT_FALSE(nmea_days_since_epoch(2016, 4U, 31U, days));
+  EXPECT_FALSE(nmea_days_since_epoch(2016, 13U, 1U, days));
+  EXPECT_FALSE(nmea_days_since_epoch(2016, 1U, 0U, days));
+}
+
+TEST(NmeaUtcResolver, rollsOverAtMidnight)
+{
+  // Sentences of one epoch straddle midnight, and one arrives late.
+  NmeaUtcResolver resolver;
+  int64_t const before = 86399 * SECOND;
+  EXPECT_EQ(before + 800 * MS, resolver.resolve(235959.8));
+  EXPECT_EQ(before + 900 * MS, resolver.resolve(235959.9));
+  EXPECT_EQ(86400 * SECOND, resolver.resolve(0.0));
+  EXPECT_EQ(before + 950 * MS, resolver.resolve(235959.95));
+  EXPECT_EQ(86400 * SECOND + 100 * MS, resolver.resolve(0.1));
+  EXPECT_EQ(86400 * SECOND + 100 * MS, resolver.latest());
+  EXPECT_EQ(1U, resolver.rollovers());
+  EXPECT_EQ(1U, resolver.lateTimes());
+
+  // Gaps of several hours, the last across the next midnight.
+  EXPECT_EQ(86400 * SECOND + 43000 * SECOND, resolver.resolve(115640.0));
+  EXPECT_EQ(86400 * SECOND + 72000 * SECOND, resolver.resolve(200000.0));
+  EXPECT_EQ(2 * 86400 * SECOND + 3 * 3600 * SECOND, resolver.resolve(30000.0));
+  EXPECT_EQ(2U, resolver.rollovers());
+  EXPECT_FALSE(resolver.dated());
+
+  EXPECT_EQ(NMEA_NO_TIME, resolver.resolve(250000.0));
+  EXPECT_EQ(NMEA_NO_TIME, resolver.resolve("25", 2U));
+  EXPECT_EQ(2U, resolver.invalidTimes());
+  EXPECT_EQ(2 * 86400 * SECOND + 3 * 3600 * SECOND, resolver.latest());
+}
+
+TEST(NmeaUtcResolver, lateWindow)
+{
+  NmeaUtcResolverConfig config;
+  config.lateWindowMs = 60000U;
+  NmeaUtcResolver resolver(config);
+  int64_t const noon = 12 * 3600 * SECOND;
+  EXPECT_EQ(noon, resolver.resolve(120000.0));
+  EXPECT_EQ(noon - 42 * SECOND, resolver.resolve(115918.0));
+  // Ten minutes back is more than the window: a new day.
+  EXPECT_EQ(86400 * SECOND + noon - 600 * SECOND, resolver.resolve(115000.0));
+  EXPECT_EQ(1U, resolver.rollovers());
+  EXPECT_EQ(0U, resolver.lateTimes());
+}
+
+TEST(NmeaUtcResolver, anchorsToDates)
+{
+  int64_t const march_15 = 16875 * 86400 * SECOND;
+  NmeaUtcResolver resolver;
+  EXPECT_EQ(12 * 3600 * SECOND, gga_time(resolver, 120000.0));
+
+  ZdaMessageData zda;
+  zda.valid = true;
+  zda.timestamp = 180001.0;
+  zda.day = 15U;
+  zda.month = 3U;
+  zda.year = 2016U;
+  EXPECT_EQ(march_15 + 64801 * SECOND, resolver.resolve(NmeaMessage(zda)));
+  EXPECT_TRUE(resolver.dated());
+  EXPECT_EQ(march_15 + 64802 * SECOND, gga_time(resolver, 180002.0));
+  EXPECT_EQ(march_15 + 86400 * SECOND + SECOND, gga_time(resolver, 1.0));
+
+  // RMC's date wins over the day counted so far.
+  RmcMessageData rmc;
+  rmc.valid = true;
+  rmc.timestamp = 2.0;
+  rmc.date = 170316U;
+  EXPECT_EQ(march_15 + 2 * 86400 * SECOND + 2 * SECOND,
+            resolver.resolve(NmeaMessage(rmc)));
+
+  // Without the dates in use, both are plain times.
+  NmeaUtcResolverConfig config;
+  config.useMessageDates = false;
+  NmeaUtcResolver undated(config);
+  EXPECT_EQ(64801 * SECOND, undated.resolve(NmeaMessage(zda)));
+  EXPECT_EQ(86400 * SECOND + 2 * SECOND, undated.resolve(NmeaMessage(rmc)));
+  EXPECT_FALSE(undated.dated());
+
+  // A caller supplied date moves the latest time and everything after it.
+  EXPECT_FALSE(undated.set_date(2016, 2U, 30U));
+  ASSERT_TRUE(undated.set_date(2016, 3U, 15U));
+  EXPECT_EQ(march_15 + 2 * SECOND, undated.latest());
+  EXPECT_EQ(march_15 + 3 * SECOND, undated.resolve(3.0));
+  EXPECT_TRUE(undated.dated());
+
+  EXPECT_EQ(NMEA_NO_TIME, undated.resolve(NmeaMessage(VtgMessageData())));
+  EXPECT_EQ(NMEA_NO_TIME, undated.resolve(NmeaMessage(GgaMessageData())));
+}
+
+TEST(NmeaUtcResolver, batchMatchesSingleCalls)
+{
+  std::vector<double> timestamps;
+  std::vector<NmeaMessage> messages;
+  for (size_t i = 0U; i < 2000U; ++i)
+  {
+    // 10 Hz from 23:58:30 with a bad time now and then.
+    size_t const tenths = (863100U + i) % 864000U;
+    double const timestamp =
+        0U == i % 97U
+            ? 990000.0
+            : static_cast<double>(tenths / 36000U * 10000U +
+                                  tenths / 600U % 60U * 100U) +
+                  static_cast<double>(tenths % 600U) / 10.0;
+    timestamps.push_back(timestamp);
+    messages.push_back(NmeaMessage(GgaMessageData(
+        timestamp, 48.1173, 11.5166667, GGA_GPS, 8U, 0.9, 545.4, 46.9)));
+  }
+  NmeaUtcResolver single;
+  NmeaUtcResolver from_doubles;
+  NmeaUtcResolver from_messages;
+  std::vector<int64_t> doubles(timestamps.size());
+  std::vector<int64_t> parsed(messages.size());
+  size_t const resolved = from_doubles.resolve(
+      timestamps.data(), timestamps.size(), doubles.data());
+  EXPECT_EQ(resolved, from_messages.resolve(messages.data(), messages.size(),
+                                            parsed.data()));
+  EXPECT_EQ(timestamps.size() - 21U, resolved);
+  int64_t previous = NMEA_NO_TIME;
+  for (size_t i = 0U; i < timestamps.size(); ++i)
+  {
+    int64_t const time = single.resolve(timestamps[i]);
+    ASSERT_EQ(time, doubles[i]) << i;
+    ASSERT_EQ(time, parsed[i]) << i;
+    if (NMEA_NO_TIME != time)
+    {
+      ASSERT_LT(previous, time) << i;
+      previous = time;
+    }
+  }
+  EXPECT_EQ(1U, from_doubles.rollovers());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
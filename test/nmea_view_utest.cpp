@@ -0,0 +1,184 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_builder.hpp"
+#include "nmea_parser.hpp"
+#include "nmea_view.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using std::string;
+
+static string const GGA(
+    "$GPGGA,123519,4807.038,N,01131.000,W,4,08,0.9,545.4,M,46.9,M,1.5,0042*"
+    "7C\r\n");
+static string const VTG("$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48");
+static string const AVR(
+    "$PTNL,AVR,181059.6,+149.4688,Yaw,+0.0134,Tilt,,,60.191,3,2.5,6*00");
+
+static void expect_same(GgaMessageData const &a, GgaMessageData const &b)
+{
+  ASSERT_EQ(a.valid, b.valid);
+  if (a.valid)
+  {
+    EXPECT_EQ(a.timestamp, b.timestamp);
+    EXPECT_EQ(a.latitude, b.latitude);
+    EXPECT_EQ(a.longitude, b.longitude);
+    EXPECT_EQ(a.fixQuality, b.fixQuality);
+    EXPECT_EQ(a.numSatellites, b.numSatellites);
+    EXPECT_EQ(a.hdop, b.hdop);
+    EXPECT_EQ(a.altitude, b.altitude);
+    EXPECT_EQ(a.geoidHeight, b.geoidHeight);
+    ASSERT_EQ(a.timeSinceLastDgpsValid, b.timeSinceLastDgpsValid);
+    if (a.timeSinceLastDgpsValid)
+    {
+      EXPECT_EQ(a.timeSinceLastDgps, b.timeSinceLastDgps);
+    }
+    ASSERT_EQ(a.dgpdStationIDValid, b.dgpdStationIDValid);
+    EXPECT_EQ(a.dgpdStationID, b.dgpdStationID);
+  }
+}
+
+static void expect_same(VtgMessageData const &a, VtgMessageData const &b)
+{
+  ASSERT_EQ(a.valid, b.valid);
+  if (a.valid)
+  {
+    EXPECT_EQ(a.trueTrackMadeGood, b.trueTrackMadeGood);
+    ASSERT_EQ(a.magneticTrackMadeGoodValid, b.magneticTrackMadeGoodValid);
+    if (a.magneticTrackMadeGoodValid)
+    {
+      EXPECT_EQ(a.magneticTrackMadeGood, b.magneticTrackMadeGood);
+    }
+    EXPECT_EQ(a.groundSpeedKnots, b.groundSpeedKnots);
+    EXPECT_EQ(a.groundSpeedKph, b.groundSpeedKph);
+  }
+}
+
+static void expect_same(AvrMessageData const &a, AvrMessageData const &b)
+{
+  ASSERT_EQ(a.valid, b.valid);
+  if (a.valid)
+  {
+    EXPECT_EQ(a.timestamp, b.timestamp);
+    EXPECT_EQ(a.yaw, b.yaw);
+    EXPECT_EQ(a.tilt, b.tilt);
+    EXPECT_EQ(a.range, b.range);
+    EXPECT_EQ(a.fixQuality, b.fixQuality);
+    EXPECT_EQ(a.pdop, b.pdop);
+    EXPECT_EQ(a.numSatellites, b.numSatellites);
+  }
+}
+
+TEST(NmeaView, readsOnlyWhatIsAsked)
+{
+  GgaView const gga(GGA.data(), GGA.length());
+  ASSERT_TRUE(gga.ok());
+  EXPECT_EQ(14U, gga.fields());
+  double latitude = 0.0;
+  double longitude = 0.0;
+  GgaFixQuality quality = GGA_INVALID;
+  EXPECT_TRUE(gga.latitude(latitude));
+  EXPECT_TRUE(gga.longitude(longitude));
+  EXPECT_TRUE(gga.fix_quality(quality));
+  EXPECT_DOUBLE_EQ(48.1173, latitude);
+  EXPECT_DOUBLE_EQ(-(11.0 + 31.0 / 60.0), longitude);
+  EXPECT_EQ(GGA_RTK_FIXED, quality);
+  // cached
+  latitude = 0.0;
+  EXPECT_TRUE(gga.latitude(latitude));
+  EXPECT_DOUBLE_EQ(48.1173, latitude);
+  uint16_t station = 0U;
+  bool present = false;
+  EXPECT_TRUE(gga.dgps_station_id(station, present));
+  EXPECT_TRUE(present);
+  EXPECT_EQ(42U, station);
+
+  VtgView const vtg(VTG.data(), VTG.length());
+  double kph = 0.0;
+  EXPECT_TRUE(vtg.ground_speed_kph(kph));
+  EXPECT_DOUBLE_EQ(10.2, kph);
+
+  AvrView const avr(AVR.data(), AVR.length());
+  double yaw = 0.0;
+  EXPECT_TRUE(avr.yaw(yaw));
+  EXPECT_DOUBLE_EQ(149.4688, yaw);
+}
+
+TEST(NmeaView, rejectsLikeTheParser)
+{
+  GgaView const wrong_type(VTG.data(), VTG.length());
+  double value = 1.0;
+  EXPECT_FALSE(wrong_type.ok());
+  EXPECT_FALSE(wrong_type.timestamp(value));
+  EXPECT_EQ(1.0, value);
+
+  string bad_checksum(VTG);
+  bad_checksum[bad_checksum.length() - 1U] = '0';
+  EXPECT_FALSE(VtgView(bad_checksum.data(), bad_checksum.length()).ok());
+  EXPECT_TRUE(VtgView(bad_checksum.data(), bad_checksum.length(),
+                      NMEA_SKIP_CHECKSUM)
+                  .ok());
+
+  string const short_gga("$GPGGA,123519,4807.038,N,01131.000,E,1,08*4F");
+  EXPECT_FALSE(GgaView(short_gga.data(), short_gga.length(),
+                       NMEA_SKIP_CHECKSUM)
+                   .ok());
+
+  // A bad field only fails its own accessor.
+  string const bad_hdop(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,x,545.4,M,46.9,M,,");
+  GgaView const gga(bad_hdop.data(), bad_hdop.length(), NMEA_SKIP_CHECKSUM);
+  EXPECT_TRUE(gga.ok());
+  EXPECT_FALSE(gga.hdop(value));
+  EXPECT_TRUE(gga.altitude(value));
+  EXPECT_EQ(545.4, value);
+  bool present = true;
+  EXPECT_TRUE(gga.time_since_last_dgps(value, present));
+  EXPECT_FALSE(present);
+  EXPECT_FALSE(gga.message().valid);
+}
+
+// Every single character substitution of the samples, through both the
+// view and the eager parser.
+TEST(NmeaView, messageMatchesParser)
+{
+  string const replacements(",*.-+0159ENSWx\n");
+  string const long_vtg(
+      "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,A,1,2,3,4,5,6,7,8,9,10,11");
+  string const samples[] = {GGA, VTG, AVR, long_vtg,
+                            build_gga(1U, 2U, 3.0, -45.0, 170.0, GGA_DGPS,
+                                      12U, 0.7, -20.0, -1.0)};
+  for (size_t s = 0U; s < sizeof(samples) / sizeof(samples[0]); ++s)
+  {
+    for (size_t i = 0U; i <= samples[s].length(); ++i)
+    {
+      for (size_t r = 0U; r < replacements.length(); ++r)
+      {
+        string text(samples[s]);
+        if (i < text.length())
+        {
+          text[i] = replacements[r];
+        }
+        char const *const data = text.data();
+        size_t const length = text.length();
+        SCOPED_TRACE(text);
+        expect_same(
+            parse_gga(data, length, NMEA_SKIP_CHECKSUM),
+            GgaView(data, length, NMEA_SKIP_CHECKSUM).message());
+        expect_same(
+            parse_vtg(data, length, NMEA_SKIP_CHECKSUM),
+            VtgView(data, length, NMEA_SKIP_CHECKSUM).message());
+        expect_same(
+            parse_avr(data, length, NMEA_SKIP_CHECKSUM),
+            AvrView(data, length, NMEA_SKIP_CHECKSUM).message());
+      }
+    }
+  }
+  expect_same(parse_gga(GGA), GgaView(GGA.data(), GGA.length()).message());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,65 @@
+// Copyright 2016 Geoffrey Lawrence Viola
+
+#include "nmea_batch_parser.hpp"
+#include "nmea_builder.hpp"
+#include "vtg_columns.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+TEST(VtgColumns, appendAndReadBackRows)
+{
+  VtgColumns columns;
+  columns.reserve(150U);
+  for (size_t i = 0U; i < 150U; ++i)
+  {
+    double const track = static_cast<double>(i);
+    EXPECT_EQ(1U, columns.append(VtgMessageData(track, 0U == i % 4U,
+                                                track + 0.5, 2.0 * track,
+                                                3.0 * track)));
+  }
+  EXPECT_EQ(0U, columns.append(VtgMessageData()));
+  ASSERT_EQ(150U, columns.size());
+  for (size_t i = 0U; i < columns.size(); ++i)
+  {
+    VtgMessageData const vtg(columns.row(i));
+    double const track = static_cast<double>(i);
+    EXPECT_TRUE(vtg.valid);
+    EXPECT_DOUBLE_EQ(track, vtg.trueTrackMadeGood);
+    EXPECT_EQ(0U == i % 4U, vtg.magneticTrackMadeGoodValid);
+    if (vtg.magneticTrackMadeGoodValid)
+    {
+      EXPECT_DOUBLE_EQ(track + 0.5, vtg.magneticTrackMadeGood);
+    }
+    EXPECT_DOUBLE_EQ(2.0 * track, vtg.groundSpeedKnots);
+    EXPECT_DOUBLE_EQ(3.0 * track, vtg.groundSpeedKph);
+  }
+  EXPECT_LT(columns.memory_bytes(), 150U * sizeof(VtgMessageData));
+  columns.clear();
+  EXPECT_EQ(0U, columns.size());
+}
+
+TEST(VtgColumns, appendFromBatchParse)
+{
+  string log;
+  for (uint8_t second = 0U; second < 10U; ++second)
+  {
+    log += build_gga(1U, 2U, second, 10.0, 20.0, GGA_GPS, 9U, 1.2, 5.0, 1.0);
+    log += build_vtg(1.0 + second, 2.0);
+  }
+  vector<NmeaMessage> messages(count_nmea_lines(log.data(), log.length()));
+  parse_nmea_batch(log.data(), log.length(), messages.data(), messages.size());
+  VtgColumns columns;
+  EXPECT_EQ(10U, columns.append(messages.data(), messages.size()));
+  ASSERT_EQ(10U, columns.size());
+  EXPECT_NEAR(10.0, columns.trueTrackMadeGood[9], 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}